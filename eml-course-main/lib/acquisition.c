@@ -0,0 +1,268 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for adaptive sampling
+ * \file      acquisition.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * A wearable is stationary most of the time. Sampling and classifying at the
+ * full output data rate (ODR) during those periods wastes energy. The
+ * acquisition controller therefore switches between two modes:
+ *
+ * - idle:   the sensor runs at a low ODR and only the activity is computed
+ * - active: the sensor runs at the full ODR and the pipeline classifies
+ *
+ * The activity is the largest peak-to-peak value of all channels in a block
+ * of samples, see peak_to_peak() in features.c. It is updated per sample with
+ * a running minimum and maximum, so no samples are buffered. The blocks have
+ * the same duration in both modes.
+ *
+ *  activity
+ *     ^
+ *     |         .   .
+ *     |   . . .   .   . .                      enter
+ *  - -|- - - - - - - - - - - - - - - - - - - - - - -
+ *     |  .                  .   .
+ *  - -|- - - - - - - - - - - - - - - - - - - - - - -  exit
+ *     |.                          .  .  .  .  .  .
+ *     +------------------------------------------------> t
+ *        |<------------ active ------------->|<- idle ...
+ *                                  |<- hold->|
+ *
+ * The mode becomes active as soon as the activity of one block exceeds enter.
+ * It becomes idle after the activity has been below exit for hold ms. Because
+ * exit is less than enter, and because of the hold time, noise and short
+ * pauses in a movement do not make the mode toggle.
+ *
+ * The application changes the ODR of the sensor when acquisition_update()
+ * reports a change of the mode. In between samples, it puts the
+ * microcontroller to sleep with WFI.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "acquisition.h"
+
+// Local function prototypes
+static void acquisition_block(acquisition_t *a);
+
+/*!
+ * \brief Initializes the acquisition controller
+ *
+ * The controller starts in the active mode, so the first movement is
+ * classified without delay. The thresholds have the unit of the samples, for
+ * example mg.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. n_channels must not exceed ACQUISITION_N_CHANNELS_MAX and exit
+ * should be less than enter.
+ *
+ * \param[out]  a           Pointer to the state
+ * \param[in]   n_channels  The number of channels of a sample
+ * \param[in]   odr_idle    The output data rate in Hz in the idle mode
+ * \param[in]   odr_active  The output data rate in Hz in the active mode
+ * \param[in]   block_ms    The duration of a block in ms, for example 200
+ * \param[in]   hold_ms     The time in ms that the activity must be below
+ *                          exit before the mode becomes idle, for example
+ *                          2000
+ * \param[in]   enter       The activity above which the mode becomes active
+ * \param[in]   exit        The activity below which a block is quiet
+ */
+void acquisition_init(acquisition_t *a, const uint32_t n_channels,
+    const float odr_idle, const float odr_active, const float block_ms,
+    const float hold_ms, const float enter, const float exit)
+{
+    a->n_channels = n_channels;
+    a->odr[ACQUISITION_IDLE] = odr_idle;
+    a->odr[ACQUISITION_ACTIVE] = odr_active;
+
+    // At least two samples are needed for a peak-to-peak value
+    for(uint32_t m=0; m<2; ++m)
+    {
+        const uint32_t n = (uint32_t)((block_ms * a->odr[m] / 1000.0f) + 0.5f);
+        a->block[m] = (n < 2) ? 2 : n;
+    }
+
+    a->hold = (uint32_t)((hold_ms / block_ms) + 0.5f);
+    a->hold = (a->hold < 1) ? 1 : a->hold;
+    a->enter = enter;
+    a->exit = exit;
+
+    a->mode = ACQUISITION_ACTIVE;
+    a->n = 0;
+    a->quiet = 0;
+    a->activity = 0.0f;
+
+    a->samples[ACQUISITION_IDLE] = 0;
+    a->samples[ACQUISITION_ACTIVE] = 0;
+    a->transitions = 0;
+}
+
+/*!
+ * \brief Updates the acquisition controller with a sample
+ *
+ * Call this function for every sample, in both modes. If the mode changes,
+ * the application must set the output data rate of the sensor to
+ * acquisition_odr(). Samples that arrive before the new rate is effective are
+ * counted in the new mode.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  a       Pointer to the state
+ * \param[in]     sample  The values of all channels
+ *
+ * \return True if the mode has changed
+ */
+bool acquisition_update(acquisition_t *a, const float *sample)
+{
+    const acquisition_mode_t mode = a->mode;
+
+    a->samples[mode]++;
+
+    if(a->n == 0)
+    {
+        for(uint32_t c=0; c<a->n_channels; ++c)
+        {
+            a->min[c] = sample[c];
+            a->max[c] = sample[c];
+        }
+    }
+    else
+    {
+        for(uint32_t c=0; c<a->n_channels; ++c)
+        {
+            a->min[c] = (sample[c] < a->min[c]) ? sample[c] : a->min[c];
+            a->max[c] = (sample[c] > a->max[c]) ? sample[c] : a->max[c];
+        }
+    }
+
+    a->n++;
+
+    if(a->n >= a->block[mode])
+    {
+        acquisition_block(a);
+    }
+
+    return (a->mode != mode);
+}
+
+/*!
+ * \brief Returns the current mode of the acquisition controller
+ *
+ * \param[in]  a  Pointer to the state
+ *
+ * \return The current mode
+ */
+acquisition_mode_t acquisition_mode(const acquisition_t *a)
+{
+    return a->mode;
+}
+
+/*!
+ * \brief Returns the output data rate of the current mode
+ *
+ * \param[in]  a  Pointer to the state
+ *
+ * \return The output data rate in Hz
+ */
+float acquisition_odr(const acquisition_t *a)
+{
+    return a->odr[a->mode];
+}
+
+/*!
+ * \brief Sets the mode of the acquisition controller
+ *
+ * Use this function if something else than the activity detects a change,
+ * for example the wake-up interrupt of the sensor, which detects motion while
+ * no samples are read in the idle mode. The current block is discarded.
+ *
+ * \param[inout]  a     Pointer to the state
+ * \param[in]     mode  The new mode
+ *
+ * \return True if the mode has changed
+ */
+bool acquisition_set_mode(acquisition_t *a, const acquisition_mode_t mode)
+{
+    a->n = 0;
+    a->quiet = 0;
+
+    if(a->mode == mode)
+    {
+        return false;
+    }
+
+    a->mode = mode;
+    a->transitions++;
+
+    return true;
+}
+
+/*!
+ * \brief Computes the activity of a complete block and updates the mode
+ *
+ * \param[inout]  a  Pointer to the state
+ */
+static void acquisition_block(acquisition_t *a)
+{
+    float activity = 0.0f;
+
+    for(uint32_t c=0; c<a->n_channels; ++c)
+    {
+        const float p2p = a->max[c] - a->min[c];
+        activity = (p2p > activity) ? p2p : activity;
+    }
+
+    a->activity = activity;
+    a->n = 0;
+
+    if(activity > a->enter)
+    {
+        a->quiet = 0;
+
+        if(a->mode == ACQUISITION_IDLE)
+        {
+            a->mode = ACQUISITION_ACTIVE;
+            a->transitions++;
+        }
+    }
+    else if(activity < a->exit)
+    {
+        a->quiet++;
+
+        if((a->mode == ACQUISITION_ACTIVE) && (a->quiet >= a->hold))
+        {
+            a->mode = ACQUISITION_IDLE;
+            a->transitions++;
+        }
+    }
+    else
+    {
+        // Between the thresholds, the mode does not change
+        a->quiet = 0;
+    }
+}
@@ -0,0 +1,99 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for adaptive sampling
+ * \file      acquisition.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _ACQUISITION_H_
+#define _ACQUISITION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Maximum number of channels
+#define ACQUISITION_N_CHANNELS_MAX (9)
+
+/*!
+ * \brief Type definition of the acquisition modes
+ */
+typedef enum
+{
+    ACQUISITION_IDLE = 0,   ///< Low output data rate, no classification
+    ACQUISITION_ACTIVE = 1, ///< Full output data rate, classification
+
+}acquisition_mode_t;
+
+/*!
+ * \brief Type definition of the state of the acquisition controller
+ */
+typedef struct
+{
+    // Parameters
+    uint32_t n_channels;  ///< Number of channels
+    float odr[2];         ///< Output data rate in Hz per mode
+    uint32_t block[2];    ///< Number of samples of a block per mode
+    uint32_t hold;        ///< Number of quiet blocks before becoming idle
+    float enter;          ///< Activity above which the mode becomes active
+    float exit;           ///< Activity below which a block is quiet
+
+    // State
+    acquisition_mode_t mode;  ///< Current mode
+    uint32_t n;               ///< Number of samples in the current block
+    uint32_t quiet;           ///< Number of consecutive quiet blocks
+    float min[ACQUISITION_N_CHANNELS_MAX];  ///< Minimum per channel
+    float max[ACQUISITION_N_CHANNELS_MAX];  ///< Maximum per channel
+    float activity;           ///< Activity of the last block
+
+    // Statistics
+    uint32_t samples[2];      ///< Number of samples per mode
+    uint32_t transitions;     ///< Number of mode changes
+
+}acquisition_t;
+
+// Functions are documented in the source file
+
+void acquisition_init(acquisition_t *a, const uint32_t n_channels,
+    const float odr_idle, const float odr_active, const float block_ms,
+    const float hold_ms, const float enter, const float exit);
+bool acquisition_update(acquisition_t *a, const float *sample);
+acquisition_mode_t acquisition_mode(const acquisition_t *a);
+float acquisition_odr(const acquisition_t *a);
+bool acquisition_set_mode(acquisition_t *a, const acquisition_mode_t mode);
+
+#endif // _ACQUISITION_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,249 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for prototype based classifiers
+ * \file      classifiers.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \see       Wikipedia contributors. (2024, September 12). Nearest centroid
+ *            classifier. In Wikipedia, The Free Encyclopedia.
+ *            https://en.wikipedia.org/wiki/Nearest_centroid_classifier
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "classifiers.h"
+
+// Local function prototypes
+static uint32_t knn_insert(float *dist, uint8_t *label, uint32_t n,
+    const uint32_t k, const float d, const uint8_t l);
+static uint8_t knn_vote(const uint8_t *label, const uint32_t n);
+
+/*!
+ * \brief k-nearest neighbour classification with float prototypes
+ *
+ * The input is first scaled per feature with x' = (x - offset) * scale. Next,
+ * the squared euclidean distance to every prototype in the table is computed.
+ * The label that occurs most among the k nearest prototypes is returned. With
+ * k = 1 and one prototype per class this is a nearest centroid classifier.
+ *
+ * The distance computation of a prototype is terminated as soon as the
+ * partial sum exceeds the distance of the k-th nearest prototype found so
+ * far. Because all terms are positive, that prototype can never become one
+ * of the k nearest. The more prototypes in the table, the more computations
+ * are saved this way.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of features must not exceed KNN_N_FEATURES_MAX,
+ * the number of classes must not exceed KNN_N_CLASSES_MAX and k must not
+ * exceed KNN_K_MAX.
+ *
+ * \param[in]  x      A pointer to the feature vector
+ * \param[in]  model  A pointer to the prototype table
+ * \param[in]  k      The number of neighbours that take part in the vote
+ *
+ * \return The label of the classified feature vector
+ */
+uint8_t knn(const float *x, const knn_model_t *model, const uint32_t k)
+{
+    float xs[KNN_N_FEATURES_MAX];
+    float best_dist[KNN_K_MAX];
+    uint8_t best_label[KNN_K_MAX];
+    uint32_t n_best = 0;
+
+    const uint32_t n_features = model->n_features;
+
+    // Scale the input once, instead of for every prototype
+    for(uint32_t f=0; f<n_features; ++f)
+    {
+        xs[f] = (x[f] - model->offset[f]) * model->scale[f];
+    }
+
+    const float *p = model->prototypes;
+
+    for(uint32_t i=0; i<model->n_prototypes; ++i, p+=n_features)
+    {
+        // Distance that must be beaten to become one of the k nearest
+        const float limit = (n_best < k) ? 3.4e38f : best_dist[n_best-1];
+
+        float d = 0.0f;
+        uint32_t f;
+
+        for(f=0; f<n_features; ++f)
+        {
+            const float diff = xs[f] - p[f];
+            d += diff * diff;
+
+            // Early termination
+            if(d >= limit)
+            {
+                break;
+            }
+        }
+
+        if(f == n_features)
+        {
+            n_best = knn_insert(best_dist, best_label, n_best, k, d,
+                model->labels[i]);
+        }
+    }
+
+    return knn_vote(best_label, n_best);
+}
+
+/*!
+ * \brief k-nearest neighbour classification with int8 prototypes
+ *
+ * Identical to knn(), but the prototypes are stored as int8. This reduces the
+ * size of the table by a factor four. The scaled input is rounded and
+ * saturated to the int8 range, after which all distances are computed with
+ * integer arithmetic only. This is especially beneficial on devices without
+ * a floating point unit.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of features must not exceed KNN_N_FEATURES_MAX,
+ * the number of classes must not exceed KNN_N_CLASSES_MAX and k must not
+ * exceed KNN_K_MAX.
+ *
+ * \param[in]  x      A pointer to the feature vector
+ * \param[in]  model  A pointer to the quantized prototype table
+ * \param[in]  k      The number of neighbours that take part in the vote
+ *
+ * \return The label of the classified feature vector
+ */
+uint8_t knn_q7(const float *x, const knn_q7_model_t *model, const uint32_t k)
+{
+    int32_t xq[KNN_N_FEATURES_MAX];
+    float best_dist[KNN_K_MAX];
+    uint8_t best_label[KNN_K_MAX];
+    uint32_t n_best = 0;
+
+    const uint32_t n_features = model->n_features;
+
+    // Scale, round and saturate the input
+    for(uint32_t f=0; f<n_features; ++f)
+    {
+        float v = (x[f] - model->offset[f]) * model->scale[f];
+        v = (v < -128.0f) ? -128.0f : v;
+        v = (v > 127.0f) ? 127.0f : v;
+        xq[f] = (int32_t)((v < 0.0f) ? (v - 0.5f) : (v + 0.5f));
+    }
+
+    const int8_t *p = model->prototypes;
+
+    for(uint32_t i=0; i<model->n_prototypes; ++i, p+=n_features)
+    {
+        // Distance that must be beaten to become one of the k nearest
+        const uint32_t limit = (n_best < k) ?
+            UINT32_MAX : (uint32_t)best_dist[n_best-1];
+
+        uint32_t d = 0;
+        uint32_t f;
+
+        for(f=0; f<n_features; ++f)
+        {
+            const int32_t diff = xq[f] - (int32_t)p[f];
+            d += (uint32_t)(diff * diff);
+
+            // Early termination
+            if(d >= limit)
+            {
+                break;
+            }
+        }
+
+        if(f == n_features)
+        {
+            n_best = knn_insert(best_dist, best_label, n_best, k, (float)d,
+                model->labels[i]);
+        }
+    }
+
+    return knn_vote(best_label, n_best);
+}
+
+/*!
+ * \brief Inserts a distance in the sorted list of nearest prototypes
+ *
+ * \param[inout]  dist   Sorted distances, nearest first
+ * \param[inout]  label  Labels corresponding to the distances
+ * \param[in]     n      Number of items in the list
+ * \param[in]     k      Maximum number of items in the list
+ * \param[in]     d      Distance to insert
+ * \param[in]     l      Label to insert
+ *
+ * \return The new number of items in the list
+ */
+static uint32_t knn_insert(float *dist, uint8_t *label, uint32_t n,
+    const uint32_t k, const float d, const uint8_t l)
+{
+    // Drop the farthest item if the list is full
+    uint32_t i = (n < k) ? n++ : (n - 1);
+
+    // Shift farther items one position
+    for(; (i > 0) && (dist[i-1] > d); --i)
+    {
+        dist[i] = dist[i-1];
+        label[i] = label[i-1];
+    }
+
+    dist[i] = d;
+    label[i] = l;
+
+    return n;
+}
+
+/*!
+ * \brief Majority vote among the nearest prototypes
+ *
+ * On a tie, the label of the nearest prototype among the tied labels wins.
+ *
+ * \param[in]  label  Labels sorted by distance, nearest first
+ * \param[in]  n      Number of labels
+ *
+ * \return The label with the most votes
+ */
+static uint8_t knn_vote(const uint8_t *label, const uint32_t n)
+{
+    uint8_t votes[KNN_N_CLASSES_MAX] = {0};
+    uint8_t winner = label[0];
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        votes[label[i]]++;
+    }
+
+    // Visit the labels from near to far, so the nearest wins a tie
+    for(uint32_t i=1; i<n; ++i)
+    {
+        if(votes[label[i]] > votes[winner])
+        {
+            winner = label[i];
+        }
+    }
+
+    return winner;
+}
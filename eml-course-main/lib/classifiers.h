@@ -0,0 +1,100 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for prototype based classifiers
+ * \file      classifiers.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \see       Wikipedia contributors. (2024, September 12). Nearest centroid
+ *            classifier. In Wikipedia, The Free Encyclopedia.
+ *            https://en.wikipedia.org/wiki/Nearest_centroid_classifier
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _CLASSIFIERS_H_
+#define _CLASSIFIERS_H_
+
+#include <stdint.h>
+
+/// Maximum number of neighbours that can be used by the k-NN functions
+#define KNN_K_MAX (8)
+
+/// Maximum number of features supported by the k-NN functions
+#define KNN_N_FEATURES_MAX (32)
+
+/// Maximum number of classes supported by the k-NN functions
+#define KNN_N_CLASSES_MAX (32)
+
+/*!
+ * \brief Type definition of a prototype table with float prototypes
+ *
+ * The table is generated by
+ * ./tools/model_embedding/code_generator_knn2c.py
+ */
+typedef struct
+{
+    const float *prototypes; ///< n_prototypes x n_features, row major
+    const uint8_t *labels;   ///< Class of each prototype
+    const float *offset;     ///< Per feature offset, subtracted from the input
+    const float *scale;      ///< Per feature scale, applied after the offset
+    uint32_t n_prototypes;   ///< Number of rows in the table
+    uint32_t n_features;     ///< Number of columns in the table
+
+}knn_model_t;
+
+/*!
+ * \brief Type definition of a prototype table with int8 prototypes
+ *
+ * Identical to knn_model_t, but the prototypes are quantized to int8. The
+ * quantization factor is included in the scale of each feature.
+ */
+typedef struct
+{
+    const int8_t *prototypes; ///< n_prototypes x n_features, row major
+    const uint8_t *labels;    ///< Class of each prototype
+    const float *offset;      ///< Per feature offset, subtracted from the input
+    const float *scale;       ///< Per feature scale, applied after the offset
+    uint32_t n_prototypes;    ///< Number of rows in the table
+    uint32_t n_features;      ///< Number of columns in the table
+
+}knn_q7_model_t;
+
+// Functions are documented in the source file
+
+uint8_t knn(const float *x, const knn_model_t *model, const uint32_t k);
+uint8_t knn_q7(const float *x, const knn_q7_model_t *model, const uint32_t k);
+
+#endif // _CLASSIFIERS_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,148 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for computing features on demand
+ * \file      feature_cache.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * A decision tree compares one feature per node, so a path from the root to
+ * a leaf reads only a few of the features that the tree uses. Instead of
+ * computing all features of a window before the classifier is called, the
+ * tree that code_generator_dtc2c.py generates with LAZY set, requests each
+ * feature from a feature cache when a node needs it:
+ *
+ *   static float feature(const uint32_t k, void *context)
+ *   {
+ *       switch(k)
+ *       {
+ *           case DTC_X_OUT_VARIANCE: return variance(buffer_x_out, N);
+ *           case DTC_Y_OUT_VARIANCE: return variance(buffer_y_out, N);
+ *       }
+ *       return 0.0f;
+ *   }
+ *
+ *   feature_cache_init(&cache, DTC_N_FEATURES, feature, NULL);
+ *
+ *   // Every window
+ *   feature_cache_reset(&cache);
+ *   dtc_t label = dtc_lazy(&cache);
+ *
+ * The first request of a feature in a window computes it, the next requests
+ * return the stored value. The number of features that are computed in a
+ * window is counted, and the generator reports the expected number.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "feature_cache.h"
+
+/*!
+ * \brief Initializes a feature cache
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. n_features must not exceed FEATURE_CACHE_N_MAX.
+ *
+ * \param[out]  c           Pointer to the feature cache
+ * \param[in]   n_features  Number of features
+ * \param[in]   compute     Function that computes feature k of the window
+ * \param[in]   context     Pointer that is passed to compute, may be NULL
+ */
+void feature_cache_init(feature_cache_t *c, const uint32_t n_features,
+    float (*compute)(const uint32_t k, void *context), void *context)
+{
+    c->compute = compute;
+    c->context = context;
+    c->n_features = n_features;
+
+    for(uint32_t i=0; i<FEATURE_CACHE_N_MAX; ++i)
+    {
+        c->values[i] = 0.0f;
+    }
+
+    feature_cache_reset(c);
+}
+
+/*!
+ * \brief Starts a new window
+ *
+ * The features of the previous window are discarded.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  c  Pointer to the feature cache
+ */
+void feature_cache_reset(feature_cache_t *c)
+{
+    for(uint32_t i=0; i<((FEATURE_CACHE_N_MAX + 31) / 32); ++i)
+    {
+        c->valid[i] = 0;
+    }
+
+    c->computed = 0;
+}
+
+/*!
+ * \brief Returns a feature of the window, and computes it if it has not been
+ *        computed in the window yet
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. k must be less than the number of features.
+ *
+ * \param[inout]  c  Pointer to the feature cache
+ * \param[in]     k  The index of the feature
+ *
+ * \return The value of feature k
+ */
+float feature_cache_get(feature_cache_t *c, const uint32_t k)
+{
+    const uint32_t mask = 1u << (k % 32);
+
+    if((c->valid[k / 32] & mask) == 0)
+    {
+        c->values[k] = c->compute(k, c->context);
+        c->valid[k / 32] |= mask;
+        c->computed++;
+    }
+
+    return c->values[k];
+}
+
+/*!
+ * \brief Checks if a feature has been computed in the window
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  c  Pointer to the feature cache
+ * \param[in]  k  The index of the feature
+ *
+ * \return True if feature k has been computed
+ */
+bool feature_cache_valid(const feature_cache_t *c, const uint32_t k)
+{
+    return (c->valid[k / 32] & (1u << (k % 32))) != 0;
+}
@@ -0,0 +1,80 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for computing features on demand
+ * \file      feature_cache.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _FEATURE_CACHE_H_
+#define _FEATURE_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Maximum number of features of a window
+#define FEATURE_CACHE_N_MAX (64)
+
+/*!
+ * \brief Type definition of the features of a window, which are computed on
+ *        demand
+ */
+typedef struct
+{
+    float (*compute)(const uint32_t k, void *context); ///< Computes feature k
+    void *context;               ///< Passed to compute, for example the
+                                 ///< buffers of the window
+    uint32_t n_features;         ///< Number of features
+
+    float values[FEATURE_CACHE_N_MAX];             ///< Computed values
+    uint32_t valid[(FEATURE_CACHE_N_MAX + 31) / 32]; ///< Bit k is set if
+                                                     ///< feature k is computed
+    uint32_t computed;           ///< Number of features computed in the
+                                 ///< window
+
+}feature_cache_t;
+
+// Functions are documented in the source file
+
+void feature_cache_init(feature_cache_t *c, const uint32_t n_features,
+    float (*compute)(const uint32_t k, void *context), void *context);
+void feature_cache_reset(feature_cache_t *c);
+float feature_cache_get(feature_cache_t *c, const uint32_t k);
+bool feature_cache_valid(const feature_cache_t *c, const uint32_t k);
+
+#endif // _FEATURE_CACHE_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -34,8 +34,34 @@
  *
  *****************************************************************************/
 
+#include <math.h>
+
 #include "features.h"
 
+/*!
+ * \brief Type definition of the sums of the multi-channel features
+ */
+typedef struct
+{
+    float shift[MC_N_CHANNELS_MAX];   ///< First sample of each channel
+    float sum[MC_N_CHANNELS_MAX];     ///< Sum of shifted samples
+    float square[MC_N_CHANNELS_MAX];  ///< Sum of squared shifted samples
+    float product[MC_N_PAIRS_MAX];    ///< Sum of products of shifted samples
+    float magnitude;                  ///< Sum of vector magnitudes
+    float sma;                        ///< Sum of absolute values
+
+}multichannel_sums_t;
+
+// Local function prototypes
+static void multichannel_init(multichannel_sums_t *s, const float *x,
+    const uint32_t n_channels);
+static inline void multichannel_add(multichannel_sums_t *s, const float *x,
+    const uint32_t n_channels);
+static void multichannel_finish(multichannel_t *r,
+    const multichannel_sums_t *s, const uint32_t n_channels, const uint32_t n);
+static inline uint32_t pair_index(const uint32_t a, const uint32_t b,
+    const uint32_t n_channels);
+
 /*!
  * \brief Finds the minimum value in the input data
  *
@@ -251,3 +277,782 @@ float peak_to_peak(float *data, const uint32_t n)
 
     return max - min;
 }
+
+/*!
+ * \brief Computes the energy in a frequency band
+ *
+ * The feature band energy is the sum of the power of all bins with a
+ * frequency in the range f_low <= f < f_high. For example, walking
+ * (typically 1 - 2 Hz) and jogging (2.5 - 4 Hz) have their energy in a
+ * different band.
+ *
+ * The power spectrum is calculated with power_spectrum() in fft.c. The
+ * frequency of bin k is k * fs / m.
+ *
+ *     power
+ *       ^            band
+ *       |        |<------->|
+ *       |        |   .     |
+ *       |        |  . .    |
+ *       |   .    | .   .   |
+ *       |  . .   |.     .  |.
+ *       | .   . .|       . |  .     .
+ *       |.     . |        .|    . .   .  .
+ *       ---------------------------------------> f
+ *       0     f_low      f_high            fs/2
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  power   A pointer to the power spectrum, m/2+1 items
+ * \param[in]  m       The size of the transform
+ * \param[in]  fs      The sample frequency
+ * \param[in]  f_low   The lower frequency of the band
+ * \param[in]  f_high  The upper frequency of the band
+ *
+ * \return The energy in the frequency band
+ */
+float band_energy(const float *power, const uint32_t m, const float fs,
+    const float f_low, const float f_high)
+{
+    const float bins_per_hz = (float)m / fs;
+    float energy = 0.0f;
+
+    // First bin with a frequency of at least f_low
+    uint32_t k = (uint32_t)(f_low * bins_per_hz);
+    k += ((float)k < (f_low * bins_per_hz)) ? 1 : 0;
+
+    for(; (k <= (m/2)) && ((float)k < (f_high * bins_per_hz)); ++k)
+    {
+        energy += power[k];
+    }
+
+    return energy;
+}
+
+/*!
+ * \brief Finds the frequency with the most power
+ *
+ * The feature dominant frequency returns the frequency of the bin with the
+ * largest power, ignoring the DC bin. For periodic movements, such as CPR
+ * compressions or steps, this is the rate of the movement.
+ *
+ * The power spectrum is calculated with power_spectrum() in fft.c. The
+ * resolution is fs / m, so a window of m = 128 samples at 66.7 Hz has a
+ * resolution of about 0.5 Hz.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  power  A pointer to the power spectrum, m/2+1 items
+ * \param[in]  m      The size of the transform
+ * \param[in]  fs     The sample frequency
+ *
+ * \return The dominant frequency
+ */
+float dominant_frequency(const float *power, const uint32_t m, const float fs)
+{
+    uint32_t dominant = 1;
+
+    for(uint32_t k=2; k<=(m/2); ++k)
+    {
+        dominant = (power[k] > power[dominant]) ? k : dominant;
+    }
+
+    return (float)dominant * fs / (float)m;
+}
+
+/*!
+ * \brief Computes the spectral centroid
+ *
+ * The spectral centroid is the power weighted mean frequency. It indicates
+ * where the center of mass of the spectrum is. Smooth signals have a low
+ * centroid, whereas abrupt signals have a high centroid.
+ *
+ * The feature spectral centroid is computed with the following formula:
+ * centroid = (f_0*p_0 + f_1*p_1 + ... + f_(m/2)*p_(m/2)) / (p_0 + ... +
+ * p_(m/2)) where f_k = k * fs / m and p_k is the power of bin k. If there is
+ * no power at all, zero is returned.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  power  A pointer to the power spectrum, m/2+1 items
+ * \param[in]  m      The size of the transform
+ * \param[in]  fs     The sample frequency
+ *
+ * \return The spectral centroid
+ */
+float spectral_centroid(const float *power, const uint32_t m, const float fs)
+{
+    float weighted = 0.0f;
+    float total = 0.0f;
+
+    for(uint32_t k=0; k<=(m/2); ++k)
+    {
+        weighted += (float)k * power[k];
+        total += power[k];
+    }
+
+    return (total > 0.0f) ? (weighted * fs / ((float)m * total)) : 0.0f;
+}
+
+/*!
+ * \brief Initializes the state of the repetitive motion features
+ *
+ * The repetitive motion features, such as the number of CPR compressions or
+ * squats and their rate, are updated per sample with motion_update(). No
+ * window of samples is buffered, so the memory per channel is constant.
+ *
+ * A sample is above the band if it exceeds mean + hysteresis * std and below
+ * the band if it is less than mean - hysteresis * std, where the mean and the
+ * standard deviation are exponentially weighted with forgetting factor alpha.
+ * The band prevents noise from generating extra crossings and peaks. Because
+ * it scales with the standard deviation, the same parameters can be used for
+ * channels with a different range.
+ *
+ * \param[out]  m           Pointer to the state
+ * \param[in]   alpha       Forgetting factor, for example 0.02
+ * \param[in]   hysteresis  Half width of the band in standard deviations,
+ *                          for example 0.5
+ */
+void motion_init(motion_t *m, const float alpha, const float hysteresis)
+{
+    m->alpha = alpha;
+    m->hysteresis = hysteresis;
+
+    m->mean = 0.0f;
+    m->variance = 0.0f;
+    m->above = false;
+    m->started = false;
+    m->t = 0;
+    m->last_peak = 0;
+    m->has_peak = false;
+    m->candidate = 0.0f;
+    m->candidate_t = 0;
+
+    motion_reset(m);
+}
+
+/*!
+ * \brief Clears the window statistics of the repetitive motion features
+ *
+ * Call this function at the start of every window. The running mean and
+ * variance are kept, so they do not need to settle again. An interval that
+ * started in the previous window is counted in the window in which it ends.
+ *
+ * \param[inout]  m  Pointer to the state
+ */
+void motion_reset(motion_t *m)
+{
+    m->n = 0;
+    m->crossings = 0;
+    m->peaks = 0;
+    m->intervals = 0;
+    m->interval_mean = 0.0f;
+    m->interval_m2 = 0.0f;
+}
+
+/*!
+ * \brief Updates the repetitive motion features with a data sample
+ *
+ * A crossing is counted every time the signal moves from one side of the
+ * band to the other. While the signal is above the band, the largest value is
+ * tracked. When the signal drops below the band, that value is a peak. So
+ * every cycle of the motion results in exactly one peak and two crossings.
+ *
+ *          peak               peak
+ *           X                  X
+ *         .   .              .   .
+ *  - - - . - - . - - - - - -. - - . - - - - -   mean + hysteresis * std
+ *       .       .          .       .
+ *  - - - - - - - . - - - -. - - - - . - - - -   mean - hysteresis * std
+ *                  .    .             .    .
+ *                     .                  .
+ *  ---------------------------------------------------------- ->t
+ *                   |<-- interval -->|
+ *
+ * The interval between consecutive peaks is tracked with Welford's algorithm,
+ * so its mean and standard deviation do not require buffering either.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  m     Pointer to the state
+ * \param[in]     data  Data sample
+ *
+ * \return True if a peak was detected
+ */
+bool motion_update(motion_t *m, const float data)
+{
+    bool peak = false;
+
+    if(!m->started)
+    {
+        m->mean = data;
+        m->started = true;
+    }
+
+    // Exponentially weighted mean and variance
+    const float delta = data - m->mean;
+    m->mean += m->alpha * delta;
+    m->variance = (1.0f - m->alpha) * (m->variance + (m->alpha * delta * delta));
+
+    const float band = m->hysteresis * sqrtf(m->variance);
+
+    if(m->above)
+    {
+        if(data > m->candidate)
+        {
+            m->candidate = data;
+            m->candidate_t = m->t;
+        }
+
+        if(data < (m->mean - band))
+        {
+            m->above = false;
+            m->crossings++;
+            m->peaks++;
+            peak = true;
+
+            if(m->has_peak)
+            {
+                // Welford's algorithm on the intervals
+                const float interval = (float)(m->candidate_t - m->last_peak);
+                const float d = interval - m->interval_mean;
+
+                m->intervals++;
+                m->interval_mean += d / (float)m->intervals;
+                m->interval_m2 += d * (interval - m->interval_mean);
+            }
+
+            m->last_peak = m->candidate_t;
+            m->has_peak = true;
+        }
+    }
+    else if(data > (m->mean + band))
+    {
+        m->above = true;
+        m->crossings++;
+        m->candidate = data;
+        m->candidate_t = m->t;
+    }
+
+    m->t++;
+    m->n++;
+
+    return peak;
+}
+
+/*!
+ * \brief Returns the zero-crossing rate of the window
+ *
+ * The zero-crossing rate is the number of crossings of the band around the
+ * running mean divided by the number of samples in the window.
+ *
+ * \param[in]  m  Pointer to the state
+ *
+ * \return The number of crossings per sample
+ */
+float zero_crossing_rate(const motion_t *m)
+{
+    return (m->n > 0) ? ((float)m->crossings / (float)m->n) : 0.0f;
+}
+
+/*!
+ * \brief Returns the number of peaks in the window
+ *
+ * \param[in]  m  Pointer to the state
+ *
+ * \return The number of peaks
+ */
+uint32_t peak_count(const motion_t *m)
+{
+    return m->peaks;
+}
+
+/*!
+ * \brief Returns the mean interval between peaks in the window
+ *
+ * \param[in]  m  Pointer to the state
+ *
+ * \return The mean interval in samples, or zero if there are no intervals
+ */
+float peak_interval_mean(const motion_t *m)
+{
+    return m->interval_mean;
+}
+
+/*!
+ * \brief Returns the standard deviation of the interval between peaks in the
+ * window
+ *
+ * A small standard deviation indicates a regular rhythm.
+ *
+ * \param[in]  m  Pointer to the state
+ *
+ * \return The standard deviation in samples, or zero if there are less than
+ *         two intervals
+ */
+float peak_interval_std(const motion_t *m)
+{
+    return (m->intervals > 1) ?
+        sqrtf(m->interval_m2 / (float)m->intervals) : 0.0f;
+}
+
+/*!
+ * \brief Returns the cadence of the window
+ *
+ * The cadence is the number of cycles per minute, calculated from the mean
+ * interval between peaks. For CPR this is the compression rate, which should
+ * be 100 - 120 per minute.
+ *
+ * \param[in]  m   Pointer to the state
+ * \param[in]  fs  The sample frequency
+ *
+ * \return The cadence in cycles per minute, or zero if there are no intervals
+ */
+float cadence(const motion_t *m, const float fs)
+{
+    return (m->intervals > 0) ? (60.0f * fs / m->interval_mean) : 0.0f;
+}
+
+/*!
+ * \brief Clears the central moments
+ *
+ * \param[out]  m  Pointer to the central moments
+ */
+void moments_reset(moments_t *m)
+{
+    m->n = 0;
+    m->mean = 0.0f;
+    m->m2 = 0.0f;
+    m->m3 = 0.0f;
+    m->m4 = 0.0f;
+    m->peak = 0.0f;
+}
+
+/*!
+ * \brief Updates the central moments with a data sample
+ *
+ * The sums of the differences from the mean to the second, third and fourth
+ * power are updated with the one pass algorithm of Terriberry, which extends
+ * Welford's algorithm. Unlike the sums of x^3 and x^4, these do not suffer
+ * from cancellation, so the skewness and kurtosis are accurate in single
+ * precision, also for data with a large offset such as the ToF distance.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  m     Pointer to the central moments
+ * \param[in]     data  Data sample
+ */
+void moments_update(moments_t *m, const float data)
+{
+    const float n1 = (float)m->n;
+    const float n = n1 + 1.0f;
+
+    const float delta = data - m->mean;
+    const float delta_n = delta / n;
+    const float delta_n2 = delta_n * delta_n;
+    const float term = delta * delta_n * n1;
+
+    m->n++;
+    m->mean += delta_n;
+    m->m4 += (term * delta_n2 * ((n * n) - (3.0f * n) + 3.0f)) +
+        (6.0f * delta_n2 * m->m2) - (4.0f * delta_n * m->m3);
+    m->m3 += (term * delta_n * (n - 2.0f)) - (3.0f * delta_n * m->m2);
+    m->m2 += term;
+
+    const float a = fabsf(data);
+
+    if(a > m->peak)
+    {
+        m->peak = a;
+    }
+}
+
+/*!
+ * \brief Merges the central moments of another part of the window
+ *
+ * The central moments of two parts of a window are combined with the
+ * pairwise formulas of Pebay, as if all samples were passed to
+ * moments_update(). The moments of sub-blocks can thus be computed once and
+ * merged into the moments of every window that contains them.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  m      Pointer to the central moments, which are updated
+ * \param[in]     other  Pointer to the central moments of the other part
+ */
+void moments_merge(moments_t *m, const moments_t *other)
+{
+    if(other->n == 0)
+    {
+        return;
+    }
+
+    if(m->n == 0)
+    {
+        *m = *other;
+        return;
+    }
+
+    const float na = (float)m->n;
+    const float nb = (float)other->n;
+    const float n = na + nb;
+
+    const float delta = other->mean - m->mean;
+    const float delta_n = delta / n;
+    const float delta_n2 = delta_n * delta_n;
+    const float term = delta * delta_n * na * nb;
+
+    const float m2 = m->m2 + other->m2 + term;
+    const float m3 = m->m3 + other->m3 + (term * delta_n * (na - nb)) +
+        (3.0f * delta_n * ((na * other->m2) - (nb * m->m2)));
+    const float m4 = m->m4 + other->m4 +
+        (term * delta_n2 * ((na * na) - (na * nb) + (nb * nb))) +
+        (6.0f * delta_n2 * ((na * na * other->m2) + (nb * nb * m->m2))) +
+        (4.0f * delta_n * ((na * other->m3) - (nb * m->m3)));
+
+    m->n += other->n;
+    m->mean += delta_n * nb;
+    m->m2 = m2;
+    m->m3 = m3;
+    m->m4 = m4;
+
+    if(other->peak > m->peak)
+    {
+        m->peak = other->peak;
+    }
+}
+
+/*!
+ * \brief Computes the central moments of a window
+ *
+ * Computes the mean and the central moments up to order four in a single
+ * pass over the window, so the RMS, crest factor, skewness and kurtosis do
+ * not need a pass each.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  m     Pointer to the central moments
+ * \param[in]   data  A pointer to the data array
+ * \param[in]   n     The number of data items in the array
+ */
+void moments(moments_t *m, const float *data, const uint32_t n)
+{
+    moments_reset(m);
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        moments_update(m, data[i]);
+    }
+}
+
+/*!
+ * \brief Returns the root mean square of the window
+ *
+ * The mean of the squares is the squared mean plus the variance.
+ *
+ * \param[in]  m  Pointer to the central moments
+ *
+ * \return The root mean square, or zero if there are no samples
+ */
+float rms(const moments_t *m)
+{
+    return (m->n > 0) ?
+        sqrtf((m->mean * m->mean) + (m->m2 / (float)m->n)) : 0.0f;
+}
+
+/*!
+ * \brief Returns the crest factor of the window
+ *
+ * The crest factor is the largest absolute value divided by the RMS. It is
+ * 1.0 for a constant, about 1.41 for a sine and larger for a signal with
+ * peaks, such as impacts.
+ *
+ * \param[in]  m  Pointer to the central moments
+ *
+ * \return The crest factor, or zero if the RMS is zero
+ */
+float crest_factor(const moments_t *m)
+{
+    const float r = rms(m);
+
+    return (r > 0.0f) ? (m->peak / r) : 0.0f;
+}
+
+/*!
+ * \brief Returns the skewness of the window
+ *
+ * The skewness sqrt(n) * m3 / m2^(3/2) is zero for a symmetric distribution,
+ * positive if the samples above the mean are further away and negative
+ * otherwise. Identical to scipy.stats.skew().
+ *
+ * \param[in]  m  Pointer to the central moments
+ *
+ * \return The skewness, or zero if the variance is zero
+ */
+float skewness(const moments_t *m)
+{
+    return (m->m2 > 0.0f) ?
+        (sqrtf((float)m->n) * m->m3 / (m->m2 * sqrtf(m->m2))) : 0.0f;
+}
+
+/*!
+ * \brief Returns the excess kurtosis of the window
+ *
+ * The excess kurtosis n * m4 / m2^2 - 3 is zero for a normal distribution,
+ * positive for a distribution with outliers and negative for a distribution
+ * without tails, such as a sine. Identical to scipy.stats.kurtosis().
+ *
+ * \param[in]  m  Pointer to the central moments
+ *
+ * \return The excess kurtosis, or zero if the variance is zero
+ */
+float kurtosis(const moments_t *m)
+{
+    return (m->m2 > 0.0f) ?
+        (((float)m->n * m->m4 / (m->m2 * m->m2)) - 3.0f) : 0.0f;
+}
+
+/*!
+ * \brief Computes the multi-channel features of a window in structure of
+ * arrays layout
+ *
+ * Multi-axis and multi-pad sensors, such as x/y/z or FP1..FP8 and ToF, are
+ * often stored in a separate array per channel. This function computes the
+ * following features of all channels in a single pass over the window:
+ *
+ *   - mean and variance per channel
+ *   - covariance of every channel pair, see channel_covariance() and
+ *     channel_correlation()
+ *   - mean vector magnitude: (1/n) * sum_i sqrt(x_0,i^2 + x_1,i^2 + ...)
+ *   - signal magnitude area: (1/n) * sum_i (|x_0,i| + |x_1,i| + ...)
+ *
+ * Computing the cross-channel terms separately would require a pass over the
+ * data per feature. To keep the one pass sums numerically stable, the first
+ * sample of every channel is subtracted before the sums are updated.
+ *
+ *   data[0] --> | x_0,0 | x_0,1 | x_0,2 | ... | x_0,n-1 |
+ *   data[1] --> | x_1,0 | x_1,1 | x_1,2 | ... | x_1,n-1 |
+ *   data[2] --> | x_2,0 | x_2,1 | x_2,2 | ... | x_2,n-1 |
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of channels must be in the range
+ * 1 .. MC_N_CHANNELS_MAX.
+ *
+ * \param[out]  r           A pointer to the multi-channel features
+ * \param[in]   data        An array of pointers to the data of each channel
+ * \param[in]   n_channels  The number of channels
+ * \param[in]   n           The number of data items per channel
+ */
+void multichannel_soa(multichannel_t *r, const float *const *data,
+    const uint32_t n_channels, const uint32_t n)
+{
+    multichannel_sums_t s;
+    float x[MC_N_CHANNELS_MAX];
+
+    for(uint32_t c=0; c<n_channels; ++c)
+    {
+        x[c] = data[c][0];
+    }
+
+    multichannel_init(&s, x, n_channels);
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        // Gather the sample of every channel
+        for(uint32_t c=0; c<n_channels; ++c)
+        {
+            x[c] = data[c][i];
+        }
+
+        multichannel_add(&s, x, n_channels);
+    }
+
+    multichannel_finish(r, &s, n_channels, n);
+}
+
+/*!
+ * \brief Computes the multi-channel features of a window in array of
+ * structures layout
+ *
+ * Identical to multichannel_soa(), but the samples of all channels are
+ * interleaved in a single array, as they are read from the sensor.
+ *
+ *   data --> | x_0,0 | x_1,0 | x_2,0 | x_0,1 | x_1,1 | x_2,1 | ... |
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of channels must be in the range
+ * 1 .. MC_N_CHANNELS_MAX.
+ *
+ * \param[out]  r           A pointer to the multi-channel features
+ * \param[in]   data        A pointer to the interleaved data array
+ * \param[in]   n_channels  The number of channels
+ * \param[in]   n           The number of data items per channel
+ */
+void multichannel_aos(multichannel_t *r, const float *data,
+    const uint32_t n_channels, const uint32_t n)
+{
+    multichannel_sums_t s;
+
+    multichannel_init(&s, data, n_channels);
+
+    for(uint32_t i=0; i<n; ++i, data+=n_channels)
+    {
+        multichannel_add(&s, data, n_channels);
+    }
+
+    multichannel_finish(r, &s, n_channels, n);
+}
+
+/*!
+ * \brief Returns the covariance of two channels
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  r  A pointer to the multi-channel features
+ * \param[in]  a  The index of the first channel
+ * \param[in]  b  The index of the second channel
+ *
+ * \return The covariance of the channels
+ */
+float channel_covariance(const multichannel_t *r, const uint32_t a,
+    const uint32_t b)
+{
+    if(a == b)
+    {
+        return r->variance[a];
+    }
+
+    return r->covariance[pair_index(a, b, r->n_channels)];
+}
+
+/*!
+ * \brief Returns the correlation of two channels
+ *
+ * The Pearson correlation is the covariance divided by the product of the
+ * standard deviations. It is +1 if two channels move together, -1 if they
+ * move in opposite directions and 0 if they are unrelated. For example,
+ * pressing with a single finger on one side correlates the pads on that side
+ * differently than pressing with the palm.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  r  A pointer to the multi-channel features
+ * \param[in]  a  The index of the first channel
+ * \param[in]  b  The index of the second channel
+ *
+ * \return The correlation of the channels, or zero if a channel is constant
+ */
+float channel_correlation(const multichannel_t *r, const uint32_t a,
+    const uint32_t b)
+{
+    const float v = r->variance[a] * r->variance[b];
+
+    return (v > 0.0f) ? (channel_covariance(r, a, b) / sqrtf(v)) : 0.0f;
+}
+
+/*!
+ * \brief Clears the sums and sets the shift of every channel
+ */
+static void multichannel_init(multichannel_sums_t *s, const float *x,
+    const uint32_t n_channels)
+{
+    for(uint32_t c=0; c<n_channels; ++c)
+    {
+        s->shift[c] = x[c];
+        s->sum[c] = 0.0f;
+        s->square[c] = 0.0f;
+    }
+
+    for(uint32_t p=0; p<((n_channels * (n_channels - 1)) / 2); ++p)
+    {
+        s->product[p] = 0.0f;
+    }
+
+    s->magnitude = 0.0f;
+    s->sma = 0.0f;
+}
+
+/*!
+ * \brief Adds the sample of every channel to the sums
+ */
+static inline void multichannel_add(multichannel_sums_t *s, const float *x,
+    const uint32_t n_channels)
+{
+    float d[MC_N_CHANNELS_MAX];
+    float magnitude = 0.0f;
+    uint32_t p = 0;
+
+    for(uint32_t c=0; c<n_channels; ++c)
+    {
+        d[c] = x[c] - s->shift[c];
+        s->sum[c] += d[c];
+        s->square[c] += d[c] * d[c];
+
+        magnitude += x[c] * x[c];
+        s->sma += (x[c] < 0.0f) ? -x[c] : x[c];
+    }
+
+    s->magnitude += sqrtf(magnitude);
+
+    // Upper triangle of the cross products, in the order of pair_index()
+    for(uint32_t a=0; a<n_channels; ++a)
+    {
+        for(uint32_t b=a+1; b<n_channels; ++b)
+        {
+            s->product[p++] += d[a] * d[b];
+        }
+    }
+}
+
+/*!
+ * \brief Computes the features from the sums
+ */
+static void multichannel_finish(multichannel_t *r,
+    const multichannel_sums_t *s, const uint32_t n_channels, const uint32_t n)
+{
+    const float inv_n = 1.0f / (float)n;
+    uint32_t p = 0;
+
+    r->n_channels = n_channels;
+
+    for(uint32_t c=0; c<n_channels; ++c)
+    {
+        const float m = s->sum[c] * inv_n;
+
+        r->mean[c] = s->shift[c] + m;
+        r->variance[c] = (s->square[c] * inv_n) - (m * m);
+    }
+
+    for(uint32_t a=0; a<n_channels; ++a)
+    {
+        for(uint32_t b=a+1; b<n_channels; ++b, ++p)
+        {
+            r->covariance[p] = (s->product[p] * inv_n) -
+                (s->sum[a] * inv_n * s->sum[b] * inv_n);
+        }
+    }
+
+    r->magnitude = s->magnitude * inv_n;
+    r->sma = s->sma * inv_n;
+}
+
+/*!
+ * \brief Returns the index of the channel pair a, b in the covariance array
+ */
+static inline uint32_t pair_index(const uint32_t a, const uint32_t b,
+    const uint32_t n_channels)
+{
+    const uint32_t lo = (a < b) ? a : b;
+    const uint32_t hi = (a < b) ? b : a;
+
+    return (lo * n_channels) - ((lo * (lo + 1)) / 2) + (hi - lo - 1);
+}
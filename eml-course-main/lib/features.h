@@ -42,16 +42,114 @@ extern "C" {
 #ifndef _FEATURES_H_
 #define _FEATURES_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/*!
+ * \brief Type definition of the state of the repetitive motion features
+ */
+typedef struct
+{
+    // Parameters
+    float alpha;          ///< Forgetting factor of the running mean and variance
+    float hysteresis;     ///< Half width of the band around the mean, in std
+
+    // Running statistics, kept across windows
+    float mean;           ///< Running mean
+    float variance;       ///< Running variance
+    bool above;           ///< True if the signal was last above the band
+    bool started;         ///< True after the first sample
+    uint32_t t;           ///< Sample counter
+    uint32_t last_peak;   ///< Sample counter of the last peak
+    bool has_peak;        ///< True if last_peak is valid
+    float candidate;      ///< Largest value since the signal went above the band
+    uint32_t candidate_t; ///< Sample counter of the candidate
+
+    // Window statistics, cleared by motion_reset()
+    uint32_t n;           ///< Number of samples in the window
+    uint32_t crossings;   ///< Number of crossings of the band
+    uint32_t peaks;       ///< Number of peaks
+    uint32_t intervals;   ///< Number of inter-peak intervals
+    float interval_mean;  ///< Mean inter-peak interval in samples
+    float interval_m2;    ///< Sum of squared differences from interval_mean
+
+}motion_t;
+
+/*!
+ * \brief Type definition of the central moments of a window
+ */
+typedef struct
+{
+    uint32_t n; ///< Number of samples
+    float mean; ///< Mean
+    float m2;   ///< Sum of squared differences from the mean
+    float m3;   ///< Sum of cubed differences from the mean
+    float m4;   ///< Sum of differences from the mean to the fourth power
+    float peak; ///< Largest absolute value
+
+}moments_t;
+
+/// Maximum number of channels of the multi-channel features
+#define MC_N_CHANNELS_MAX (9)
+
+/// Number of channel pairs
+#define MC_N_PAIRS_MAX ((MC_N_CHANNELS_MAX * (MC_N_CHANNELS_MAX - 1)) / 2)
+
+/*!
+ * \brief Type definition of the multi-channel features of a window
+ */
+typedef struct
+{
+    uint32_t n_channels;                ///< Number of channels
+    float mean[MC_N_CHANNELS_MAX];      ///< Mean per channel
+    float variance[MC_N_CHANNELS_MAX];  ///< Variance per channel
+    float covariance[MC_N_PAIRS_MAX];   ///< Covariance per channel pair
+    float magnitude;                    ///< Mean vector magnitude
+    float sma;                          ///< Signal magnitude area
+
+}multichannel_t;
+
 // Functions are documented in the source file
 
 float min(float *data, const uint32_t n);
+float max(float *data, const uint32_t n);
 float mean(float *data, const uint32_t n);
 float variance(float *data, const uint32_t n);
 float energy(float *data, const uint32_t n);
 float peak_to_peak(float *data, const uint32_t n);
 
+float band_energy(const float *power, const uint32_t m, const float fs,
+    const float f_low, const float f_high);
+float dominant_frequency(const float *power, const uint32_t m, const float fs);
+float spectral_centroid(const float *power, const uint32_t m, const float fs);
+
+void motion_init(motion_t *m, const float alpha, const float hysteresis);
+void motion_reset(motion_t *m);
+bool motion_update(motion_t *m, const float data);
+float zero_crossing_rate(const motion_t *m);
+uint32_t peak_count(const motion_t *m);
+float peak_interval_mean(const motion_t *m);
+float peak_interval_std(const motion_t *m);
+float cadence(const motion_t *m, const float fs);
+
+void moments_reset(moments_t *m);
+void moments_update(moments_t *m, const float data);
+void moments_merge(moments_t *m, const moments_t *other);
+void moments(moments_t *m, const float *data, const uint32_t n);
+float rms(const moments_t *m);
+float crest_factor(const moments_t *m);
+float skewness(const moments_t *m);
+float kurtosis(const moments_t *m);
+
+void multichannel_soa(multichannel_t *r, const float *const *data,
+    const uint32_t n_channels, const uint32_t n);
+void multichannel_aos(multichannel_t *r, const float *data,
+    const uint32_t n_channels, const uint32_t n);
+float channel_covariance(const multichannel_t *r, const uint32_t a,
+    const uint32_t b);
+float channel_correlation(const multichannel_t *r, const uint32_t a,
+    const uint32_t b);
+
 #endif // _FEATURES_H_
 
 #ifdef __cplusplus
@@ -0,0 +1,521 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for calculating fast Fourier transforms
+ * \file      fft.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \see       Wikipedia contributors. (2024, May 31). Cooley-Tukey FFT
+ *            algorithm. In Wikipedia, The Free Encyclopedia.
+ *            https://en.wikipedia.org/wiki/Cooley%E2%80%93Tukey_FFT_algorithm
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include <math.h>
+
+#include "fft.h"
+
+/// Number of entries in a quarter of a period of the twiddle tables
+#define FFT_QUARTER (FFT_N_MAX / 4)
+
+/// Pi
+#define FFT_PI (3.14159265358979f)
+
+/*!
+ * \brief Quarter period of cos(2*pi*i/FFT_N_MAX)
+ *
+ * The other quarters are derived from symmetry, which saves 75% of the memory
+ * of a full table.
+ */
+static const float twiddle[FFT_QUARTER + 1] =
+{
+    1.000000000f, 0.999698819f, 0.998795456f, 0.997290457f, 0.995184727f, 0.992479535f,
+    0.989176510f, 0.985277642f, 0.980785280f, 0.975702130f, 0.970031253f, 0.963776066f,
+    0.956940336f, 0.949528181f, 0.941544065f, 0.932992799f, 0.923879533f, 0.914209756f,
+    0.903989293f, 0.893224301f, 0.881921264f, 0.870086991f, 0.857728610f, 0.844853565f,
+    0.831469612f, 0.817584813f, 0.803207531f, 0.788346428f, 0.773010453f, 0.757208847f,
+    0.740951125f, 0.724247083f, 0.707106781f, 0.689540545f, 0.671558955f, 0.653172843f,
+    0.634393284f, 0.615231591f, 0.595699304f, 0.575808191f, 0.555570233f, 0.534997620f,
+    0.514102744f, 0.492898192f, 0.471396737f, 0.449611330f, 0.427555093f, 0.405241314f,
+    0.382683432f, 0.359895037f, 0.336889853f, 0.313681740f, 0.290284677f, 0.266712757f,
+    0.242980180f, 0.219101240f, 0.195090322f, 0.170961889f, 0.146730474f, 0.122410675f,
+    0.098017140f, 0.073564564f, 0.049067674f, 0.024541229f, 0.000000000f,
+};
+
+/*!
+ * \brief Quarter period of cos(2*pi*i/FFT_N_MAX) in Q15 format
+ */
+static const int16_t twiddle_q15[FFT_QUARTER + 1] =
+{
+     32767,  32758,  32729,  32679,  32610,  32522,  32413,  32286,  32138,  31972,
+     31786,  31581,  31357,  31114,  30853,  30572,  30274,  29957,  29622,  29269,
+     28899,  28511,  28106,  27684,  27246,  26791,  26320,  25833,  25330,  24812,
+     24279,  23732,  23170,  22595,  22006,  21403,  20788,  20160,  19520,  18868,
+     18205,  17531,  16846,  16151,  15447,  14733,  14010,  13279,  12540,  11793,
+     11039,  10279,   9512,   8740,   7962,   7180,   6393,   5602,   4808,   4011,
+      3212,   2411,   1608,    804,      0,
+};
+
+// Local function prototypes
+static inline float fft_cos(uint32_t i);
+static inline float fft_sin(const uint32_t i);
+static inline int32_t fft_cos_q15(uint32_t i);
+static inline int32_t fft_sin_q15(const uint32_t i);
+static inline int16_t q15_saturate(const int32_t x);
+static void cfft(float *data, const uint32_t n);
+static void cfft_q15(int16_t *data, const uint32_t n);
+
+/*!
+ * \brief Real fast Fourier transform
+ *
+ * Calculates the discrete Fourier transform X[k] of n real samples in place.
+ * The samples are treated as n/2 complex numbers, which are transformed with
+ * a radix-2 complex FFT of half the size. The result is then split into the
+ * spectrum of the real input. This is about twice as fast as a complex FFT of
+ * size n.
+ *
+ * Only the bins 0 to n/2 are returned, because the spectrum of real data is
+ * symmetric. The bins 0 and n/2 are real, so the result fits in the input
+ * array. The output is packed as follows:
+ *
+ *   data[0]      Re(X[0])
+ *   data[1]      Re(X[n/2])
+ *   data[2k]     Re(X[k]), for k = 1 .. n/2-1
+ *   data[2k+1]   Im(X[k]), for k = 1 .. n/2-1
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of samples must be a power of two in the range
+ * 4 .. FFT_N_MAX.
+ *
+ * \param[inout]  data  A pointer to the data array, replaced by the spectrum
+ * \param[in]     n     The number of data items in the array
+ */
+void rfft(float *data, const uint32_t n)
+{
+    const uint32_t half = n / 2;
+    const uint32_t step = FFT_N_MAX / n;
+
+    cfft(data, half);
+
+    // DC and Nyquist bins
+    const float z0r = data[0];
+    const float z0i = data[1];
+    data[0] = z0r + z0i;
+    data[1] = z0r - z0i;
+
+    // Split the bins k and n/2-k at the same time
+    for(uint32_t k=1; k<(half/2); ++k)
+    {
+        float *a = &data[2*k];
+        float *b = &data[2*(half-k)];
+
+        // Spectrum of the even and odd samples
+        const float evr = 0.5f * (a[0] + b[0]);
+        const float evi = 0.5f * (a[1] - b[1]);
+        const float odr = 0.5f * (a[1] + b[1]);
+        const float odi = 0.5f * (b[0] - a[0]);
+
+        // Twiddle factor exp(-j*2*pi*k/n)
+        const float wr = fft_cos(k * step);
+        const float wi = -fft_sin(k * step);
+
+        const float tr = (wr * odr) - (wi * odi);
+        const float ti = (wr * odi) + (wi * odr);
+
+        a[0] = evr + tr;
+        a[1] = evi + ti;
+        b[0] = evr - tr;
+        b[1] = ti - evi;
+    }
+
+    // The bin n/4 is the complex conjugate
+    data[half + 1] = -data[half + 1];
+}
+
+/*!
+ * \brief Real fast Fourier transform in Q15 format
+ *
+ * Identical to rfft(), but with 16-bit fixed-point data and integer
+ * arithmetic only. This is especially beneficial on devices without a
+ * floating point unit.
+ *
+ * To prevent overflow, intermediate results are halved after every stage.
+ * The result is therefore X[k] / n. Results are saturated to the Q15 range.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of samples must be a power of two in the range
+ * 4 .. FFT_N_MAX.
+ *
+ * \param[inout]  data  A pointer to the data array, replaced by the spectrum
+ * \param[in]     n     The number of data items in the array
+ */
+void rfft_q15(int16_t *data, const uint32_t n)
+{
+    const uint32_t half = n / 2;
+    const uint32_t step = FFT_N_MAX / n;
+
+    cfft_q15(data, half);
+
+    // DC and Nyquist bins
+    const int32_t z0r = data[0];
+    const int32_t z0i = data[1];
+    data[0] = q15_saturate((z0r + z0i) >> 1);
+    data[1] = q15_saturate((z0r - z0i) >> 1);
+
+    // Split the bins k and n/2-k at the same time
+    for(uint32_t k=1; k<(half/2); ++k)
+    {
+        int16_t *a = &data[2*k];
+        int16_t *b = &data[2*(half-k)];
+
+        // Spectrum of the even and odd samples
+        const int32_t evr = ((int32_t)a[0] + b[0]) >> 1;
+        const int32_t evi = ((int32_t)a[1] - b[1]) >> 1;
+        const int32_t odr = ((int32_t)a[1] + b[1]) >> 1;
+        const int32_t odi = ((int32_t)b[0] - a[0]) >> 1;
+
+        // Twiddle factor exp(-j*2*pi*k/n)
+        const int32_t wr = fft_cos_q15(k * step);
+        const int32_t wi = -fft_sin_q15(k * step);
+
+        const int32_t tr = ((wr * odr) - (wi * odi)) >> 15;
+        const int32_t ti = ((wr * odi) + (wi * odr)) >> 15;
+
+        a[0] = q15_saturate((evr + tr) >> 1);
+        a[1] = q15_saturate((evi + ti) >> 1);
+        b[0] = q15_saturate((evr - tr) >> 1);
+        b[1] = q15_saturate((ti - evi) >> 1);
+    }
+
+    // The bin n/4 is the complex conjugate
+    data[half] = (int16_t)(data[half] >> 1);
+    data[half + 1] = q15_saturate(-((int32_t)data[half + 1] >> 1));
+}
+
+/*!
+ * \brief Calculates the power spectrum
+ *
+ * The mean is removed from the data, after which it is zero-padded to the
+ * next power of two m. The power |X[k]|^2 of the bins k = 0 .. m/2 is
+ * written to the power array, so it must be able to hold m/2+1 items. The
+ * frequency of bin k is k * fs / m, where fs is the sample frequency.
+ *
+ * Calculate the spectrum once for a window and pass it to all spectral
+ * features, such as band_energy(), dominant_frequency() and
+ * spectral_centroid().
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. The number of samples must be in the range 2 .. FFT_N_MAX.
+ *
+ * \param[in]   data   A pointer to the data array
+ * \param[in]   n      The number of data items in the array
+ * \param[out]  power  A pointer to the power array
+ *
+ * \return The size m of the transform
+ */
+uint32_t power_spectrum(const float *data, const uint32_t n, float *power)
+{
+    float buffer[FFT_N_MAX];
+    uint32_t m = 4;
+    float mean = 0.0f;
+
+    while(m < n)
+    {
+        m <<= 1;
+    }
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        mean += data[i];
+    }
+
+    mean /= (float)n;
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        buffer[i] = data[i] - mean;
+    }
+
+    for(uint32_t i=n; i<m; ++i)
+    {
+        buffer[i] = 0.0f;
+    }
+
+    rfft(buffer, m);
+
+    power[0] = buffer[0] * buffer[0];
+    power[m/2] = buffer[1] * buffer[1];
+
+    for(uint32_t k=1; k<(m/2); ++k)
+    {
+        power[k] = (buffer[2*k] * buffer[2*k]) + (buffer[2*k+1] * buffer[2*k+1]);
+    }
+
+    return m;
+}
+
+/*!
+ * \brief Calculates the coefficient of the Goertzel algorithm
+ *
+ * Calculate the coefficient once, for example during initialization, because
+ * the cosine is expensive.
+ *
+ * \param[in]  f   The frequency of interest
+ * \param[in]  fs  The sample frequency
+ *
+ * \return The coefficient 2*cos(2*pi*f/fs)
+ */
+float goertzel_coefficient(const float f, const float fs)
+{
+    return 2.0f * cosf(2.0f * FFT_PI * f / fs);
+}
+
+/*!
+ * \brief Calculates the power of a single frequency with the Goertzel
+ * algorithm
+ *
+ * The Goertzel algorithm is a second order filter that costs a single
+ * multiply per sample. If only a few frequencies are needed, it is cheaper
+ * than a full FFT. Moreover, the number of samples does not have to be a
+ * power of two and the frequency does not have to be exactly on a bin.
+ *
+ * For f = k * fs / n, the result equals |X[k]|^2 of the discrete Fourier
+ * transform, so it has the same scale as power_spectrum().
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  data   A pointer to the data array
+ * \param[in]  n      The number of data items in the array
+ * \param[in]  coeff  The coefficient from goertzel_coefficient()
+ *
+ * \return The power of the frequency
+ */
+float goertzel(const float *data, const uint32_t n, const float coeff)
+{
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        const float s0 = data[i] + (coeff * s1) - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    return (s1 * s1) + (s2 * s2) - (coeff * s1 * s2);
+}
+
+/*!
+ * \brief Looks up cos(2*pi*i/FFT_N_MAX) in the quarter period table
+ */
+static inline float fft_cos(uint32_t i)
+{
+    i &= (FFT_N_MAX - 1);
+
+    if(i <= FFT_QUARTER)
+    {
+        return twiddle[i];
+    }
+    else if(i <= (2 * FFT_QUARTER))
+    {
+        return -twiddle[(2 * FFT_QUARTER) - i];
+    }
+    else if(i <= (3 * FFT_QUARTER))
+    {
+        return -twiddle[i - (2 * FFT_QUARTER)];
+    }
+
+    return twiddle[(4 * FFT_QUARTER) - i];
+}
+
+/*!
+ * \brief Looks up sin(2*pi*i/FFT_N_MAX) in the quarter period table
+ */
+static inline float fft_sin(const uint32_t i)
+{
+    return fft_cos(i + (3 * FFT_QUARTER));
+}
+
+/*!
+ * \brief Looks up cos(2*pi*i/FFT_N_MAX) in the Q15 quarter period table
+ */
+static inline int32_t fft_cos_q15(uint32_t i)
+{
+    i &= (FFT_N_MAX - 1);
+
+    if(i <= FFT_QUARTER)
+    {
+        return twiddle_q15[i];
+    }
+    else if(i <= (2 * FFT_QUARTER))
+    {
+        return -twiddle_q15[(2 * FFT_QUARTER) - i];
+    }
+    else if(i <= (3 * FFT_QUARTER))
+    {
+        return -twiddle_q15[i - (2 * FFT_QUARTER)];
+    }
+
+    return twiddle_q15[(4 * FFT_QUARTER) - i];
+}
+
+/*!
+ * \brief Looks up sin(2*pi*i/FFT_N_MAX) in the Q15 quarter period table
+ */
+static inline int32_t fft_sin_q15(const uint32_t i)
+{
+    return fft_cos_q15(i + (3 * FFT_QUARTER));
+}
+
+/*!
+ * \brief Saturates a value to the Q15 range
+ */
+static inline int16_t q15_saturate(const int32_t x)
+{
+    return (int16_t)((x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : x));
+}
+
+/*!
+ * \brief In place radix-2 decimation in time complex FFT
+ *
+ * \param[inout]  data  Interleaved real and imaginary parts
+ * \param[in]     n     The number of complex items, a power of two
+ */
+static void cfft(float *data, const uint32_t n)
+{
+    // Bit reversal permutation
+    for(uint32_t i=1, j=0; i<n; ++i)
+    {
+        uint32_t bit = n >> 1;
+
+        for(; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if(i < j)
+        {
+            const float re = data[2*i];
+            const float im = data[2*i+1];
+            data[2*i] = data[2*j];
+            data[2*i+1] = data[2*j+1];
+            data[2*j] = re;
+            data[2*j+1] = im;
+        }
+    }
+
+    // Butterflies
+    for(uint32_t len=2; len<=n; len<<=1)
+    {
+        const uint32_t half = len >> 1;
+        const uint32_t step = FFT_N_MAX / len;
+
+        for(uint32_t k=0; k<half; ++k)
+        {
+            const float wr = fft_cos(k * step);
+            const float wi = -fft_sin(k * step);
+
+            for(uint32_t i=k; i<n; i+=len)
+            {
+                const uint32_t j = i + half;
+
+                const float tr = (wr * data[2*j]) - (wi * data[2*j+1]);
+                const float ti = (wr * data[2*j+1]) + (wi * data[2*j]);
+
+                data[2*j] = data[2*i] - tr;
+                data[2*j+1] = data[2*i+1] - ti;
+                data[2*i] += tr;
+                data[2*i+1] += ti;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief In place radix-2 decimation in time complex FFT in Q15 format
+ *
+ * The result is scaled by 1/n, because the butterflies are halved.
+ *
+ * \param[inout]  data  Interleaved real and imaginary parts
+ * \param[in]     n     The number of complex items, a power of two
+ */
+static void cfft_q15(int16_t *data, const uint32_t n)
+{
+    // Bit reversal permutation
+    for(uint32_t i=1, j=0; i<n; ++i)
+    {
+        uint32_t bit = n >> 1;
+
+        for(; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if(i < j)
+        {
+            const int16_t re = data[2*i];
+            const int16_t im = data[2*i+1];
+            data[2*i] = data[2*j];
+            data[2*i+1] = data[2*j+1];
+            data[2*j] = re;
+            data[2*j+1] = im;
+        }
+    }
+
+    // Butterflies
+    for(uint32_t len=2; len<=n; len<<=1)
+    {
+        const uint32_t half = len >> 1;
+        const uint32_t step = FFT_N_MAX / len;
+
+        for(uint32_t k=0; k<half; ++k)
+        {
+            const int32_t wr = fft_cos_q15(k * step);
+            const int32_t wi = -fft_sin_q15(k * step);
+
+            for(uint32_t i=k; i<n; i+=len)
+            {
+                const uint32_t j = i + half;
+
+                const int32_t tr = ((wr * data[2*j]) - (wi * data[2*j+1])) >> 15;
+                const int32_t ti = ((wr * data[2*j+1]) + (wi * data[2*j])) >> 15;
+                const int32_t re = data[2*i];
+                const int32_t im = data[2*i+1];
+
+                data[2*j] = q15_saturate((re - tr) >> 1);
+                data[2*j+1] = q15_saturate((im - ti) >> 1);
+                data[2*i] = q15_saturate((re + tr) >> 1);
+                data[2*i+1] = q15_saturate((im + ti) >> 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for calculating fast Fourier transforms
+ * \file      fft.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \see       Wikipedia contributors. (2024, May 31). Cooley-Tukey FFT
+ *            algorithm. In Wikipedia, The Free Encyclopedia.
+ *            https://en.wikipedia.org/wiki/Cooley%E2%80%93Tukey_FFT_algorithm
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _FFT_H_
+#define _FFT_H_
+
+#include <stdint.h>
+
+/// Maximum number of samples of a transform, must be a power of two
+#define FFT_N_MAX (256)
+
+// Functions are documented in the source file
+
+void rfft(float *data, const uint32_t n);
+void rfft_q15(int16_t *data, const uint32_t n);
+uint32_t power_spectrum(const float *data, const uint32_t n, float *power);
+float goertzel_coefficient(const float f, const float fs);
+float goertzel(const float *data, const uint32_t n, const float coeff);
+
+#endif // _FFT_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -77,3 +77,695 @@ float fir(const float data, const float *coefs, float *x, const uint32_t n)
     
     return y;
 }
+
+/*!
+ * \brief Saturates a value to the Q15 range
+ */
+static inline int16_t q15_saturate(const int32_t x)
+{
+    return (int16_t)((x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : x));
+}
+
+/*!
+ * \brief Initializes a polyphase FIR decimator
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  d       Pointer to the decimator
+ * \param[in]   coefs   The coefficients of the FIR filter, which must remain
+ *                      valid
+ * \param[out]  state   Pointer to an array of FIR_POLYPHASE_N_STATE(n, factor)
+ *                      elements, which must remain valid
+ * \param[in]   n       The number of coefficients of the FIR filter
+ * \param[in]   factor  The decimation factor
+ */
+void fir_decimator_init(fir_decimator_t *d, const float *coefs, float *state,
+    const uint32_t n, const uint32_t factor)
+{
+    d->coefs = coefs;
+    d->state = state;
+    d->n = n;
+    d->factor = factor;
+    d->n_state = FIR_POLYPHASE_N_STATE(n, factor);
+    d->phase = 0;
+    d->next = 0;
+
+    for(uint32_t i=0; i<d->n_state; ++i)
+    {
+        state[i] = 0.0f;
+    }
+}
+
+/*!
+ * \brief FIR filtered and decimated data
+ *
+ * Keeps one of every factor outputs of fir(): the outputs of input sample 0,
+ * factor, 2*factor, and so on. Only the outputs that are kept are computed:
+ * y[m] = c_0*x[m*factor] + c_1*x[m*factor-1] + ... + c_(n-1)*x[m*factor-n+1].
+ *
+ * The coefficients are split in factor phases. An input sample is multiplied
+ * by the coefficients of its phase, c_k, c_(k+factor), c_(k+2*factor) and so
+ * on, and added to the partial sums of the next outputs. An output therefore
+ * costs n multiplications, where fir() needs n multiplications and n moves
+ * for every input sample. The work is spread evenly over the input samples.
+ *
+ * To prevent aliasing, design a low pass filter with a cutoff frequency below
+ * half the output sample frequency, for example with firwin() from the scipy
+ * Signal processing library.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  d     Pointer to the decimator
+ * \param[in]     data  Data sample
+ * \param[out]    y     The filtered data sample, if the return value is true
+ *
+ * \return True if an output is computed, for one of every factor samples
+ */
+bool fir_decimate(fir_decimator_t *d, const float data, float *y)
+{
+    const uint32_t m = d->n_state;
+    const bool ready = (d->phase == 0);
+
+    // Add the contribution of this sample to the next outputs
+    uint32_t j = d->next;
+
+    for(uint32_t k = (ready ? 0 : (d->factor - d->phase)); k < d->n;
+        k += d->factor)
+    {
+        d->state[j] += d->coefs[k] * data;
+        j = ((j + 1) == m) ? 0 : (j + 1);
+    }
+
+    // The last sample of an output has coefficient c_0
+    if(ready)
+    {
+        *y = d->state[d->next];
+        d->state[d->next] = 0.0f;
+        d->next = ((d->next + 1) == m) ? 0 : (d->next + 1);
+    }
+
+    d->phase = ((d->phase + 1) == d->factor) ? 0 : (d->phase + 1);
+
+    return ready;
+}
+
+/*!
+ * \brief Initializes a polyphase FIR decimator in Q15 format
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  d       Pointer to the decimator
+ * \param[in]   coefs   The coefficients of the FIR filter in Q15 format, which
+ *                      must remain valid
+ * \param[out]  state   Pointer to an array of FIR_POLYPHASE_N_STATE(n, factor)
+ *                      elements, which must remain valid
+ * \param[in]   n       The number of coefficients of the FIR filter
+ * \param[in]   factor  The decimation factor
+ */
+void fir_decimator_q15_init(fir_decimator_q15_t *d, const int16_t *coefs,
+    int32_t *state, const uint32_t n, const uint32_t factor)
+{
+    d->coefs = coefs;
+    d->state = state;
+    d->n = n;
+    d->factor = factor;
+    d->n_state = FIR_POLYPHASE_N_STATE(n, factor);
+    d->phase = 0;
+    d->next = 0;
+
+    for(uint32_t i=0; i<d->n_state; ++i)
+    {
+        state[i] = 0;
+    }
+}
+
+/*!
+ * \brief FIR filtered and decimated data in Q15 format
+ *
+ * Identical to fir_decimate(), but with Q15 coefficients and data. The
+ * partial sums are kept in 32 bits, which do not overflow if the sum of the
+ * absolute values of the coefficients is less than 2.0. The output is rounded
+ * and saturated to the Q15 range.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  d     Pointer to the decimator
+ * \param[in]     data  Data sample
+ * \param[out]    y     The filtered data sample, if the return value is true
+ *
+ * \return True if an output is computed, for one of every factor samples
+ */
+bool fir_decimate_q15(fir_decimator_q15_t *d, const int16_t data, int16_t *y)
+{
+    const uint32_t m = d->n_state;
+    const bool ready = (d->phase == 0);
+
+    // Add the contribution of this sample to the next outputs
+    uint32_t j = d->next;
+
+    for(uint32_t k = (ready ? 0 : (d->factor - d->phase)); k < d->n;
+        k += d->factor)
+    {
+        d->state[j] += (int32_t)d->coefs[k] * data;
+        j = ((j + 1) == m) ? 0 : (j + 1);
+    }
+
+    // The last sample of an output has coefficient c_0
+    if(ready)
+    {
+        *y = q15_saturate((d->state[d->next] + (1 << 14)) >> 15);
+        d->state[d->next] = 0;
+        d->next = ((d->next + 1) == m) ? 0 : (d->next + 1);
+    }
+
+    d->phase = ((d->phase + 1) == d->factor) ? 0 : (d->phase + 1);
+
+    return ready;
+}
+
+/*!
+ * \brief Initializes a polyphase FIR interpolator
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  f       Pointer to the interpolator
+ * \param[in]   coefs   The coefficients of the FIR filter, which must remain
+ *                      valid
+ * \param[out]  state   Pointer to an array of FIR_POLYPHASE_N_STATE(n, factor)
+ *                      elements, which must remain valid
+ * \param[in]   n       The number of coefficients of the FIR filter
+ * \param[in]   factor  The interpolation factor
+ */
+void fir_interpolator_init(fir_interpolator_t *f, const float *coefs,
+    float *state, const uint32_t n, const uint32_t factor)
+{
+    f->coefs = coefs;
+    f->state = state;
+    f->n = n;
+    f->factor = factor;
+    f->n_state = FIR_POLYPHASE_N_STATE(n, factor);
+    f->head = 0;
+
+    for(uint32_t i=0; i<f->n_state; ++i)
+    {
+        state[i] = 0.0f;
+    }
+}
+
+/*!
+ * \brief FIR interpolated data
+ *
+ * Computes factor outputs for every input sample. The outputs are identical
+ * to fir() of the input with factor-1 zeros inserted after every sample, but
+ * the multiplications by the zeros are skipped: output p of a sample only
+ * uses the coefficients of phase p, c_p, c_(p+factor), c_(p+2*factor) and so
+ * on. The outputs of a sample therefore cost n multiplications, instead of
+ * n for every output.
+ *
+ * The zeros divide the gain by factor, so design a low pass filter with a
+ * cutoff frequency below half the input sample frequency and multiply the
+ * coefficients by factor.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  f     Pointer to the interpolator
+ * \param[in]     data  Data sample
+ * \param[out]    y     Pointer to an array of factor elements for the
+ *                      interpolated data samples
+ */
+void fir_interpolate(fir_interpolator_t *f, const float data, float *y)
+{
+    const uint32_t m = f->n_state;
+
+    f->head = ((f->head + 1) == m) ? 0 : (f->head + 1);
+    f->state[f->head] = data;
+
+    for(uint32_t p=0; p<f->factor; ++p)
+    {
+        float sum = 0.0f;
+        uint32_t j = f->head;
+
+        // Going back one input sample is going back factor coefficients
+        for(uint32_t k=p; k<f->n; k+=f->factor)
+        {
+            sum += f->coefs[k] * f->state[j];
+            j = (j == 0) ? (m - 1) : (j - 1);
+        }
+
+        y[p] = sum;
+    }
+}
+
+/*!
+ * \brief Initializes a polyphase FIR interpolator in Q15 format
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  f       Pointer to the interpolator
+ * \param[in]   coefs   The coefficients of the FIR filter in Q15 format, which
+ *                      must remain valid
+ * \param[out]  state   Pointer to an array of FIR_POLYPHASE_N_STATE(n, factor)
+ *                      elements, which must remain valid
+ * \param[in]   n       The number of coefficients of the FIR filter
+ * \param[in]   factor  The interpolation factor
+ */
+void fir_interpolator_q15_init(fir_interpolator_q15_t *f,
+    const int16_t *coefs, int16_t *state, const uint32_t n,
+    const uint32_t factor)
+{
+    f->coefs = coefs;
+    f->state = state;
+    f->n = n;
+    f->factor = factor;
+    f->n_state = FIR_POLYPHASE_N_STATE(n, factor);
+    f->head = 0;
+
+    for(uint32_t i=0; i<f->n_state; ++i)
+    {
+        state[i] = 0;
+    }
+}
+
+/*!
+ * \brief FIR interpolated data in Q15 format
+ *
+ * Identical to fir_interpolate(), but with Q15 coefficients and data. The
+ * coefficients are multiplied by factor, so a coefficient must not exceed
+ * the Q15 range. The sums are kept in 32 bits, which do not overflow if the
+ * sum of the absolute values of the coefficients of a phase is less than 2.0.
+ * The outputs are rounded and saturated to the Q15 range.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  f     Pointer to the interpolator
+ * \param[in]     data  Data sample
+ * \param[out]    y     Pointer to an array of factor elements for the
+ *                      interpolated data samples
+ */
+void fir_interpolate_q15(fir_interpolator_q15_t *f, const int16_t data,
+    int16_t *y)
+{
+    const uint32_t m = f->n_state;
+
+    f->head = ((f->head + 1) == m) ? 0 : (f->head + 1);
+    f->state[f->head] = data;
+
+    for(uint32_t p=0; p<f->factor; ++p)
+    {
+        int32_t sum = 0;
+        uint32_t j = f->head;
+
+        // Going back one input sample is going back factor coefficients
+        for(uint32_t k=p; k<f->n; k+=f->factor)
+        {
+            sum += (int32_t)f->coefs[k] * f->state[j];
+            j = (j == 0) ? (m - 1) : (j - 1);
+        }
+
+        y[p] = q15_saturate((sum + (1 << 14)) >> 15);
+    }
+}
+
+/*!
+ * \brief Returns log2(n) for a power of two
+ */
+static uint32_t log2_pow2(const uint32_t n)
+{
+    uint32_t shift = 0;
+
+    while((1UL << shift) < n)
+    {
+        ++shift;
+    }
+
+    return shift;
+}
+
+/*!
+ * \brief Initializes a moving average filter
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  m  Pointer to the moving average filter
+ * \param[out]  x  Pointer to an array of n elements, which must remain valid
+ * \param[in]   n  The number of data samples that are averaged
+ */
+void moving_average_init(moving_average_t *m, float *x, const uint32_t n)
+{
+    m->x = x;
+    m->sum = 0.0f;
+    m->partial = 0.0f;
+    m->scale = 1.0f / (float)n;
+    m->n = n;
+    m->head = 0;
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        x[i] = 0.0f;
+    }
+}
+
+/*!
+ * \brief Moving average filtered data
+ *
+ * Identical to fir() with n coefficients of 1/n, but the sum of the last n
+ * data samples is updated by adding the new data sample and subtracting the
+ * oldest, so the cost does not depend on n. For n = 32 this replaces 32
+ * multiplications and additions by three additions and a multiplication.
+ *
+ * Rounding errors of the running sum would accumulate, so once every n
+ * samples the running sum is replaced by the sum of the data samples since
+ * the previous time.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  m     Pointer to the moving average filter
+ * \param[in]     data  Data sample
+ *
+ * \return Moving average filtered data sample
+ */
+float moving_average(moving_average_t *m, const float data)
+{
+    m->sum += data - m->x[m->head];
+    m->partial += data;
+    m->x[m->head] = data;
+
+    if(++m->head == m->n)
+    {
+        m->head = 0;
+        m->sum = m->partial;
+        m->partial = 0.0f;
+    }
+
+    return m->sum * m->scale;
+}
+
+/*!
+ * \brief Initializes a moving average filter in Q15 format
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  m  Pointer to the moving average filter
+ * \param[out]  x  Pointer to an array of n elements, which must remain valid
+ * \param[in]   n  The number of data samples that are averaged, which must be
+ *                 a power of two up to 65536
+ */
+void moving_average_q15_init(moving_average_q15_t *m, int16_t *x,
+    const uint32_t n)
+{
+    m->x = x;
+    m->sum = 0;
+    m->n = n;
+    m->shift = log2_pow2(n);
+    m->head = 0;
+
+    for(uint32_t i=0; i<n; ++i)
+    {
+        x[i] = 0;
+    }
+}
+
+/*!
+ * \brief Moving average filtered data in Q15 format
+ *
+ * Identical to moving_average(), but with Q15 data. The running sum is
+ * exact, so it is never summed again, and dividing by n is a rounded shift.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  m     Pointer to the moving average filter
+ * \param[in]     data  Data sample
+ *
+ * \return Moving average filtered data sample
+ */
+int16_t moving_average_q15(moving_average_q15_t *m, const int16_t data)
+{
+    m->sum += (int32_t)data - m->x[m->head];
+    m->x[m->head] = data;
+
+    if(++m->head == m->n)
+    {
+        m->head = 0;
+    }
+
+    // Round to nearest
+    const int32_t half = ((int32_t)1 << m->shift) >> 1;
+
+    return (int16_t)((m->sum + half) >> m->shift);
+}
+
+/*!
+ * \brief Initializes a cascaded integrator-comb (CIC) decimator
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  c       Pointer to the CIC decimator
+ * \param[out]  stages  Pointer to an array of order elements, which must
+ *                      remain valid
+ * \param[out]  x       Pointer to an array of order*factor elements, which
+ *                      must remain valid
+ * \param[in]   order   The number of stages
+ * \param[in]   factor  The decimation factor
+ */
+void cic_init(cic_t *c, moving_average_t *stages, float *x,
+    const uint32_t order, const uint32_t factor)
+{
+    c->stages = stages;
+    c->order = order;
+    c->factor = factor;
+    c->phase = 0;
+
+    for(uint32_t i=0; i<order; ++i)
+    {
+        moving_average_init(&stages[i], &x[i * factor], factor);
+    }
+}
+
+/*!
+ * \brief CIC filtered and decimated data
+ *
+ * A CIC decimator of order N is N moving averages of factor data samples,
+ * followed by keeping one of every factor outputs: the outputs of input
+ * sample 0, factor, 2*factor, and so on. It is a low pass filter without
+ * multiplications by coefficients, for example to decimate a sensor that is
+ * sampled at a high rate for anti-aliasing.
+ *
+ * A CIC decimator in fixed point integrates at the input rate and
+ * differentiates at the output rate, see cic_decimate_q15(). The integrators
+ * rely on wrap around, which floats do not have, so this version runs the
+ * moving averages themselves, which cost the same additions per data sample.
+ * The gain is 1.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  c     Pointer to the CIC decimator
+ * \param[in]     data  Data sample
+ * \param[out]    y     The filtered data sample, if the return value is true
+ *
+ * \return True if an output is computed, for one of every factor samples
+ */
+bool cic_decimate(cic_t *c, const float data, float *y)
+{
+    float v = data;
+
+    for(uint32_t i=0; i<c->order; ++i)
+    {
+        v = moving_average(&c->stages[i], v);
+    }
+
+    const bool ready = (c->phase == 0);
+
+    if(ready)
+    {
+        *y = v;
+    }
+
+    c->phase = ((c->phase + 1) == c->factor) ? 0 : (c->phase + 1);
+
+    return ready;
+}
+
+/*!
+ * \brief Initializes a cascaded integrator-comb (CIC) decimator in Q15 format
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  c            Pointer to the CIC decimator
+ * \param[out]  integrators  Pointer to an array of order elements, which must
+ *                           remain valid
+ * \param[out]  combs        Pointer to an array of order elements, which must
+ *                           remain valid
+ * \param[in]   order        The number of stages
+ * \param[in]   factor       The decimation factor, which must be a power of
+ *                           two with order*log2(factor) <= 16
+ */
+void cic_q15_init(cic_q15_t *c, uint32_t *integrators, uint32_t *combs,
+    const uint32_t order, const uint32_t factor)
+{
+    c->integrators = integrators;
+    c->combs = combs;
+    c->order = order;
+    c->factor = factor;
+    c->shift = order * log2_pow2(factor);
+    c->phase = 0;
+
+    for(uint32_t i=0; i<order; ++i)
+    {
+        integrators[i] = 0;
+        combs[i] = 0;
+    }
+}
+
+/*!
+ * \brief CIC filtered and decimated data in Q15 format
+ *
+ * Identical to cic_decimate(), but with Q15 data. The data samples are added
+ * to a cascade of order integrators. For one of every factor data samples,
+ * the output of the integrators passes a cascade of order combs, which
+ * subtract their previous input. This costs 2*order additions per output
+ * and order additions per data sample, whatever the decimation factor.
+ *
+ * The integrators overflow, but the output is exact because the arithmetic
+ * is modulo 2^32 and the output fits in 16 + order*log2(factor) bits. The
+ * gain of factor^order is removed with a rounded shift.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  c     Pointer to the CIC decimator
+ * \param[in]     data  Data sample
+ * \param[out]    y     The filtered data sample, if the return value is true
+ *
+ * \return True if an output is computed, for one of every factor samples
+ */
+bool cic_decimate_q15(cic_q15_t *c, const int16_t data, int16_t *y)
+{
+    uint32_t v = (uint32_t)(int32_t)data;
+
+    for(uint32_t i=0; i<c->order; ++i)
+    {
+        c->integrators[i] += v;
+        v = c->integrators[i];
+    }
+
+    const bool ready = (c->phase == 0);
+
+    if(ready)
+    {
+        for(uint32_t i=0; i<c->order; ++i)
+        {
+            const uint32_t previous = c->combs[i];
+            c->combs[i] = v;
+            v -= previous;
+        }
+
+        // Remove the gain, rounded to nearest
+        const int32_t half = ((int32_t)1 << c->shift) >> 1;
+
+        *y = q15_saturate(((int32_t)v + half) >> c->shift);
+    }
+
+    c->phase = ((c->phase + 1) == c->factor) ? 0 : (c->phase + 1);
+
+    return ready;
+}
+
+/*!
+ * \brief Initializes a DC blocker
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  b      Pointer to the DC blocker
+ * \param[in]   alpha  Pole of the filter, for a cutoff frequency f_c at a
+ *                     sample frequency f_s about 1 - 2*pi*f_c/f_s
+ */
+void dc_blocker_init(dc_blocker_t *b, const float alpha)
+{
+    b->alpha = alpha;
+    b->x = 0.0f;
+    b->y = 0.0f;
+}
+
+/*!
+ * \brief DC blocked data
+ *
+ * A first order high pass filter y[n] = x[n] - x[n-1] + alpha*y[n-1], which
+ * removes the DC offset, for example gravity from accelerometer data. The
+ * closer alpha is to 1, the lower the cutoff frequency and the longer it
+ * takes to settle.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  b     Pointer to the DC blocker
+ * \param[in]     data  Data sample
+ *
+ * \return DC blocked data sample
+ */
+float dc_blocker(dc_blocker_t *b, const float data)
+{
+    b->y = data - b->x + (b->alpha * b->y);
+    b->x = data;
+
+    return b->y;
+}
+
+/*!
+ * \brief Initializes a DC blocker in Q15 format
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  b      Pointer to the DC blocker
+ * \param[in]   alpha  Pole of the filter in Q15 format, see dc_blocker_init()
+ */
+void dc_blocker_q15_init(dc_blocker_q15_t *b, const int16_t alpha)
+{
+    b->alpha = alpha;
+    b->x = 0;
+    b->y = 0;
+    b->fraction = 0;
+}
+
+/*!
+ * \brief DC blocked data in Q15 format
+ *
+ * Identical to dc_blocker(), but with Q15 data. Truncating the feedback
+ * alpha*y[n-1] to 16 bits would leave a DC offset at the output, so the
+ * fraction that is truncated is added to the feedback of the next data
+ * sample. The output is saturated to the Q15 range.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  b     Pointer to the DC blocker
+ * \param[in]     data  Data sample
+ *
+ * \return DC blocked data sample
+ */
+int16_t dc_blocker_q15(dc_blocker_q15_t *b, const int16_t data)
+{
+    const int32_t feedback = ((int32_t)b->alpha * b->y) + b->fraction;
+
+    b->fraction = feedback & 0x7FFF;
+    b->y = q15_saturate((int32_t)data - b->x + (feedback >> 15));
+    b->x = data;
+
+    return b->y;
+}
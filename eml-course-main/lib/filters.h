@@ -44,12 +44,190 @@ extern "C" {
 #ifndef _FILTERS_H_
 #define _FILTERS_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/// Number of elements of the state of a polyphase decimator or interpolator
+/// with n coefficients
+#define FIR_POLYPHASE_N_STATE(n, factor) (((n) + (factor) - 1) / (factor))
+
+/*!
+ * \brief Type definition of a polyphase FIR decimator
+ */
+typedef struct
+{
+    const float *coefs; ///< The coefficients of the FIR filter
+    float *state;       ///< Partial sums of the next outputs, of
+                        ///< FIR_POLYPHASE_N_STATE(n, factor) elements
+    uint32_t n;         ///< The number of coefficients
+    uint32_t factor;    ///< The decimation factor
+    uint32_t n_state;   ///< The number of partial sums
+    uint32_t phase;     ///< Input sample in the period of an output
+    uint32_t next;      ///< Partial sum of the next output
+
+}fir_decimator_t;
+
+/*!
+ * \brief Type definition of a polyphase FIR decimator in Q15 format
+ */
+typedef struct
+{
+    const int16_t *coefs; ///< The coefficients of the FIR filter
+    int32_t *state;       ///< Partial sums of the next outputs, of
+                          ///< FIR_POLYPHASE_N_STATE(n, factor) elements
+    uint32_t n;           ///< The number of coefficients
+    uint32_t factor;      ///< The decimation factor
+    uint32_t n_state;     ///< The number of partial sums
+    uint32_t phase;       ///< Input sample in the period of an output
+    uint32_t next;        ///< Partial sum of the next output
+
+}fir_decimator_q15_t;
+
+/*!
+ * \brief Type definition of a polyphase FIR interpolator
+ */
+typedef struct
+{
+    const float *coefs; ///< The coefficients of the FIR filter
+    float *state;       ///< The last input samples, of
+                        ///< FIR_POLYPHASE_N_STATE(n, factor) elements
+    uint32_t n;         ///< The number of coefficients
+    uint32_t factor;    ///< The interpolation factor
+    uint32_t n_state;   ///< The number of input samples in the state
+    uint32_t head;      ///< Position of the last input sample
+
+}fir_interpolator_t;
+
+/*!
+ * \brief Type definition of a polyphase FIR interpolator in Q15 format
+ */
+typedef struct
+{
+    const int16_t *coefs; ///< The coefficients of the FIR filter
+    int16_t *state;       ///< The last input samples, of
+                          ///< FIR_POLYPHASE_N_STATE(n, factor) elements
+    uint32_t n;           ///< The number of coefficients
+    uint32_t factor;      ///< The interpolation factor
+    uint32_t n_state;     ///< The number of input samples in the state
+    uint32_t head;        ///< Position of the last input sample
+
+}fir_interpolator_q15_t;
+
+/*!
+ * \brief Type definition of a moving average filter
+ */
+typedef struct
+{
+    float *x;       ///< The last n data samples
+    float sum;      ///< Running sum of the last n data samples
+    float partial;  ///< Sum of the data samples since the start of x
+    float scale;    ///< 1/n
+    uint32_t n;     ///< The number of data samples that are averaged
+    uint32_t head;  ///< Position of the oldest data sample
+
+}moving_average_t;
+
+/*!
+ * \brief Type definition of a moving average filter in Q15 format
+ */
+typedef struct
+{
+    int16_t *x;     ///< The last n data samples
+    int32_t sum;    ///< Running sum of the last n data samples
+    uint32_t n;     ///< The number of data samples that are averaged
+    uint32_t shift; ///< log2(n)
+    uint32_t head;  ///< Position of the oldest data sample
+
+}moving_average_q15_t;
+
+/*!
+ * \brief Type definition of a cascaded integrator-comb (CIC) decimator
+ */
+typedef struct
+{
+    moving_average_t *stages; ///< The moving averages of the cascade
+    uint32_t order;           ///< The number of stages
+    uint32_t factor;          ///< The decimation factor
+    uint32_t phase;           ///< Input sample in the period of an output
+
+}cic_t;
+
+/*!
+ * \brief Type definition of a cascaded integrator-comb (CIC) decimator in
+ *        Q15 format
+ */
+typedef struct
+{
+    uint32_t *integrators; ///< The integrators, of order elements
+    uint32_t *combs;       ///< Previous inputs of the combs, of order elements
+    uint32_t order;        ///< The number of stages
+    uint32_t factor;       ///< The decimation factor
+    uint32_t shift;        ///< log2 of the gain, order*log2(factor)
+    uint32_t phase;        ///< Input sample in the period of an output
+
+}cic_q15_t;
+
+/*!
+ * \brief Type definition of a DC blocker
+ */
+typedef struct
+{
+    float alpha; ///< Pole of the filter
+    float x;     ///< The previous data sample
+    float y;     ///< The previous filtered data sample
+
+}dc_blocker_t;
+
+/*!
+ * \brief Type definition of a DC blocker in Q15 format
+ */
+typedef struct
+{
+    int16_t alpha;    ///< Pole of the filter
+    int16_t x;        ///< The previous data sample
+    int16_t y;        ///< The previous filtered data sample
+    int32_t fraction; ///< Fraction of the feedback that is not in y
+
+}dc_blocker_q15_t;
+
 // Functions are documented in the source file
 
 float fir(const float data, const float *coefs, float *x, const uint32_t n);
 
+void fir_decimator_init(fir_decimator_t *d, const float *coefs, float *state,
+    const uint32_t n, const uint32_t factor);
+bool fir_decimate(fir_decimator_t *d, const float data, float *y);
+void fir_decimator_q15_init(fir_decimator_q15_t *d, const int16_t *coefs,
+    int32_t *state, const uint32_t n, const uint32_t factor);
+bool fir_decimate_q15(fir_decimator_q15_t *d, const int16_t data, int16_t *y);
+
+void fir_interpolator_init(fir_interpolator_t *f, const float *coefs,
+    float *state, const uint32_t n, const uint32_t factor);
+void fir_interpolate(fir_interpolator_t *f, const float data, float *y);
+void fir_interpolator_q15_init(fir_interpolator_q15_t *f,
+    const int16_t *coefs, int16_t *state, const uint32_t n,
+    const uint32_t factor);
+void fir_interpolate_q15(fir_interpolator_q15_t *f, const int16_t data,
+    int16_t *y);
+
+void moving_average_init(moving_average_t *m, float *x, const uint32_t n);
+float moving_average(moving_average_t *m, const float data);
+void moving_average_q15_init(moving_average_q15_t *m, int16_t *x,
+    const uint32_t n);
+int16_t moving_average_q15(moving_average_q15_t *m, const int16_t data);
+
+void cic_init(cic_t *c, moving_average_t *stages, float *x,
+    const uint32_t order, const uint32_t factor);
+bool cic_decimate(cic_t *c, const float data, float *y);
+void cic_q15_init(cic_q15_t *c, uint32_t *integrators, uint32_t *combs,
+    const uint32_t order, const uint32_t factor);
+bool cic_decimate_q15(cic_q15_t *c, const int16_t data, int16_t *y);
+
+void dc_blocker_init(dc_blocker_t *b, const float alpha);
+float dc_blocker(dc_blocker_t *b, const float data);
+void dc_blocker_q15_init(dc_blocker_q15_t *b, const int16_t alpha);
+int16_t dc_blocker_q15(dc_blocker_q15_t *b, const int16_t data);
+
 #endif // _FILTERS_H_
 
 #ifdef __cplusplus
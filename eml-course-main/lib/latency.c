@@ -0,0 +1,251 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for benchmarking the latency of a pipeline
+ * \file      latency.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * The latency from a sample becoming available to the output of a label is
+ * the sum of the latencies of the stages of the pipeline, for example
+ * acquisition, filtering, windowing, features, classification and output.
+ * The application takes a timestamp in us when the sample is ready and at the
+ * end of every stage, and records these with latency_record().
+ *
+ * The latencies are counted in a histogram with LATENCY_SUB_BINS bins per
+ * power of two. The relative resolution of a percentile is therefore 25%,
+ * which is sufficient to judge the tail latency, while the memory usage is
+ * fixed and independent of the number of recorded windows.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+
+#include "latency.h"
+
+/// Number of bits of the mantissa of the histogram bins
+#define LATENCY_SUB_BITS (2)
+
+/*!
+ * \brief Initializes the latency statistics
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. n_stages must not exceed LATENCY_N_STAGES_MAX.
+ *
+ * \param[out]  l         The latency statistics
+ * \param[in]   n_stages  The number of stages of the pipeline
+ */
+void latency_init(latency_t *l, const uint32_t n_stages)
+{
+    l->n_stages = n_stages;
+    l->count = 0;
+
+    for(uint32_t s=0; s<=n_stages; ++s)
+    {
+        l->max[s] = 0;
+
+        for(uint32_t b=0; b<LATENCY_N_BINS; ++b)
+        {
+            l->histogram[s][b] = 0;
+        }
+    }
+}
+
+/*!
+ * \brief Records the latencies of one window
+ *
+ * The timestamps are unsigned, so a wrap of the timer between two timestamps
+ * is handled correctly. When a bin of the histogram is full, the window is not
+ * recorded at all, so the histograms of all stages keep the same count.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  l  The latency statistics
+ * \param[in]     t  n_stages + 1 timestamps in us. t[0] is the moment the
+ *                   sample was ready and t[i] the end of stage i.
+ */
+void latency_record(latency_t *l, const uint32_t *t)
+{
+    const uint32_t n = l->n_stages;
+    uint32_t bins[LATENCY_N_STAGES_MAX + 1];
+
+    // Stages followed by the total latency
+    for(uint32_t s=0; s<=n; ++s)
+    {
+        const uint32_t us = (s < n) ? (t[s+1] - t[s]) : (t[n] - t[0]);
+
+        bins[s] = latency_bin(us);
+
+        if(l->histogram[s][bins[s]] == UINT16_MAX)
+        {
+            return;
+        }
+
+        l->max[s] = (us > l->max[s]) ? us : l->max[s];
+    }
+
+    for(uint32_t s=0; s<=n; ++s)
+    {
+        l->histogram[s][bins[s]]++;
+    }
+
+    l->count++;
+}
+
+/*!
+ * \brief Returns a percentile of the latency of a stage
+ *
+ * The result is the upper bound of the histogram bin that contains the
+ * percentile, but never more than the maximum latency.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  l      The latency statistics
+ * \param[in]  stage  The stage, or n_stages for the total latency
+ * \param[in]  p      The percentile, from 0.0f to 100.0f
+ *
+ * \return The percentile in us, or 0 if nothing was recorded
+ */
+uint32_t latency_percentile(const latency_t *l, const uint32_t stage,
+    const float p)
+{
+    // Rank of the percentile, starting at 1
+    const float rank = p * (float)l->count / 100.0f;
+    uint32_t sum = 0;
+
+    if(l->count == 0)
+    {
+        return 0;
+    }
+
+    for(uint32_t b=0; b<LATENCY_N_BINS; ++b)
+    {
+        sum += l->histogram[stage][b];
+
+        if((sum > 0) && ((float)sum >= rank))
+        {
+            const uint32_t upper = (b < (LATENCY_N_BINS - 1)) ?
+                (latency_bin_lower(b + 1) - 1) : UINT32_MAX;
+
+            return (upper < l->max[stage]) ? upper : l->max[stage];
+        }
+    }
+
+    return l->max[stage];
+}
+
+/*!
+ * \brief Returns the histogram bin of a latency
+ *
+ * Latencies below 2 * LATENCY_SUB_BINS us have their own bin. Larger
+ * latencies share a bin with the latencies that have the same most
+ * significant bit and the same LATENCY_SUB_BITS bits after it.
+ *
+ * \param[in]  us  The latency in us
+ *
+ * \return The bin, from 0 to LATENCY_N_BINS - 1
+ */
+uint32_t latency_bin(const uint32_t us)
+{
+    if(us < LATENCY_SUB_BINS)
+    {
+        return us;
+    }
+
+    // Position of the most significant bit
+    uint32_t e = LATENCY_SUB_BITS;
+
+    while((e < 31) && ((us >> (e + 1)) != 0))
+    {
+        e++;
+    }
+
+    const uint32_t m = (us >> (e - LATENCY_SUB_BITS)) & (LATENCY_SUB_BINS - 1);
+
+    return ((e - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BINS) + m;
+}
+
+/*!
+ * \brief Returns the smallest latency that is counted in a bin
+ *
+ * \param[in]  bin  The bin, from 0 to LATENCY_N_BINS - 1
+ *
+ * \return The lower bound of the bin in us
+ */
+uint32_t latency_bin_lower(const uint32_t bin)
+{
+    if(bin < LATENCY_SUB_BINS)
+    {
+        return bin;
+    }
+
+    const uint32_t e = (bin / LATENCY_SUB_BINS) + LATENCY_SUB_BITS - 1;
+    const uint32_t m = bin % LATENCY_SUB_BINS;
+
+    return (LATENCY_SUB_BINS + m) << (e - LATENCY_SUB_BITS);
+}
+
+/*!
+ * \brief Prints the latency statistics
+ *
+ * For every stage and the total latency, two lines are printed to stdout:
+ *
+ *   #latency,<name>,<count>,<p50>,<p99>,<max>
+ *   #histogram,<name>,<lower>:<count>,<lower>:<count>,...
+ *
+ * All values are in us. The histogram only contains the bins that are not
+ * empty. Lines starting with # are easy to separate from the data, see
+ * tools/capturing/latency_inspector.py.
+ *
+ * \param[in]  l      The latency statistics
+ * \param[in]  names  n_stages + 1 names, the last one for the total latency
+ */
+void latency_report(const latency_t *l, const char *const *names)
+{
+    for(uint32_t s=0; s<=l->n_stages; ++s)
+    {
+        printf("#latency,%s,%lu,%lu,%lu,%lu\n", names[s],
+            (unsigned long)l->count,
+            (unsigned long)latency_percentile(l, s, 50.0f),
+            (unsigned long)latency_percentile(l, s, 99.0f),
+            (unsigned long)l->max[s]);
+
+        printf("#histogram,%s", names[s]);
+
+        for(uint32_t b=0; b<LATENCY_N_BINS; ++b)
+        {
+            if(l->histogram[s][b] > 0)
+            {
+                printf(",%lu:%u", (unsigned long)latency_bin_lower(b),
+                    (unsigned int)l->histogram[s][b]);
+            }
+        }
+
+        printf("\n");
+    }
+}
@@ -0,0 +1,83 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for benchmarking the latency of a pipeline
+ * \file      latency.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+#include <stdint.h>
+
+/// Maximum number of stages of a pipeline
+#define LATENCY_N_STAGES_MAX (8)
+
+/// Number of histogram bins per power of two
+#define LATENCY_SUB_BINS (4)
+
+/// Number of histogram bins, covering the full range of 32-bit values
+#define LATENCY_N_BINS (LATENCY_SUB_BINS * 31)
+
+/*!
+ * \brief Type definition of the latency statistics of a pipeline
+ *
+ * The statistics of the stages are followed by the statistics of the total
+ * latency. A histogram with logarithmic bins is used, so percentiles are
+ * available without storing the individual latencies.
+ */
+typedef struct
+{
+    uint32_t n_stages;  ///< Number of stages
+    uint32_t count;     ///< Number of recorded windows
+    uint32_t max[LATENCY_N_STAGES_MAX + 1];  ///< Maximum latency in us
+    uint16_t histogram[LATENCY_N_STAGES_MAX + 1][LATENCY_N_BINS];
+
+}latency_t;
+
+// Functions are documented in the source file
+
+void latency_init(latency_t *l, const uint32_t n_stages);
+void latency_record(latency_t *l, const uint32_t *t);
+uint32_t latency_percentile(const latency_t *l, const uint32_t stage,
+    const float p);
+uint32_t latency_bin(const uint32_t us);
+uint32_t latency_bin_lower(const uint32_t bin);
+void latency_report(const latency_t *l, const char *const *names);
+
+#endif // _LATENCY_H_
+
+#ifdef __cplusplus
+}
+#endif
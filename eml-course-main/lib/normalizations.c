@@ -35,8 +35,13 @@
  *
  *****************************************************************************/
 
+#include <math.h>
+
 #include "normalizations.h"
 
+/// Lower bound of the variance, prevents a division by zero for flat signals
+#define ZSCORE_MIN_VARIANCE (1e-12f)
+
 /*!
  * \brief Normalizes the input data by rescaling it
  *
@@ -85,3 +90,130 @@ float clip(const float data, const float min[1], const float max[1])
     float val = (data < *min) ? *min : data;
     return (val > *max) ? *max : val;
 }
+
+/*!
+ * \brief Initializes the running statistics of a single channel
+ *
+ * The running statistics are used to normalize data with parameters that are
+ * learned on the device, instead of parameters that are fixed at design time.
+ * This compensates for sensor offset drift and differences between users.
+ * Use one welford_t per channel.
+ *
+ * With alpha = 0.0f all samples have equal weight. With 0 < alpha < 1 older
+ * samples are exponentially forgotten, so the statistics follow slow changes.
+ * The time constant is about 1/alpha samples.
+ *
+ * \param[out]  w      Pointer to the running statistics
+ * \param[in]   alpha  Forgetting factor
+ */
+void welford_init(welford_t *w, const float alpha)
+{
+    w->n = 0.0f;
+    w->mean = 0.0f;
+    w->variance = 0.0f;
+    w->alpha = alpha;
+    w->frozen = false;
+}
+
+/*!
+ * \brief Updates the running statistics with a data sample
+ *
+ * The mean and the variance are updated with Welford's algorithm, which is
+ * numerically stable and does not require any of the previous samples:
+ * mean' = mean + k * (x - mean) and
+ * variance' = (1 - k) * (variance + k * (x - mean)^2), where k = 1/n.
+ *
+ * With forgetting, k does not drop below alpha. The same formula then yields
+ * the exponentially weighted mean and variance. For the first 1/alpha samples
+ * k = 1/n is used, so the statistics do not start biased towards zero.
+ *
+ * When the statistics are frozen, the sample is ignored.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  w     Pointer to the running statistics
+ * \param[in]     data  Data sample
+ */
+void welford_update(welford_t *w, const float data)
+{
+    if(w->frozen)
+    {
+        return;
+    }
+
+    // Stop counting once the forgetting factor takes over
+    if((w->alpha * w->n) < 1.0f)
+    {
+        w->n += 1.0f;
+    }
+
+    float k = 1.0f / w->n;
+    k = (k < w->alpha) ? w->alpha : k;
+
+    const float delta = data - w->mean;
+
+    w->mean += k * delta;
+    w->variance = (1.0f - k) * (w->variance + (k * delta * delta));
+}
+
+/*!
+ * \brief Freezes or unfreezes the running statistics
+ *
+ * Freeze the statistics once they are representative, for example after a
+ * calibration period, or while the signal is known to be atypical.
+ *
+ * \param[inout]  w       Pointer to the running statistics
+ * \param[in]     freeze  True to freeze, false to unfreeze
+ */
+void welford_freeze(welford_t *w, const bool freeze)
+{
+    w->frozen = freeze;
+}
+
+/*!
+ * \brief Computes the z-score normalization parameters
+ *
+ * The z-score, also known as standardization, is calculated with the
+ * following formula: x' = (x - mean) / std. This is rewritten as
+ * x' = x * scale + offset, where scale = 1/std and offset = -mean/std, so
+ * normalizing a sample only costs a multiply-add.
+ *
+ * The square root and division are only computed in this function. Call it
+ * whenever the parameters must follow the running statistics, for example
+ * once per window, and not for every sample.
+ *
+ * \param[out]  z  Pointer to the z-score normalization parameters
+ * \param[in]   w  Pointer to the running statistics
+ */
+void zscore_update(zscore_t *z, const welford_t *w)
+{
+    float variance = w->variance;
+    variance = (variance < ZSCORE_MIN_VARIANCE) ? ZSCORE_MIN_VARIANCE : variance;
+
+    z->scale = 1.0f / sqrtf(variance);
+    z->offset = -w->mean * z->scale;
+}
+
+/*!
+ * \brief Normalizes the input data by standardizing it
+ *
+ * Standardization converts data values to the number of standard deviations
+ * they are away from the mean. Parameters are computed by zscore_update().
+ *
+ * One advantage of standardization is that channels with a very different
+ * range end up in the same range. A disadvantage is that the result is not
+ * bound to a fixed range.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  data Data item to be standardized
+ * \param[in]  z    Pointer to the z-score normalization parameters
+ *
+ * \return Standardized data
+ */
+float zscore(const float data, const zscore_t *z)
+{
+    return (data * z->scale) + z->offset;
+}
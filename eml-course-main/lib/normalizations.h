@@ -43,13 +43,43 @@ extern "C" {
 #ifndef _NORMALIZATION_H_
 #define _NORMALIZATION_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/*!
+ * \brief Type definition of the running statistics of a single channel
+ */
+typedef struct
+{
+    float n;        ///< Number of samples, saturates at 1/alpha
+    float mean;     ///< Running mean
+    float variance; ///< Running (population) variance
+    float alpha;    ///< Forgetting factor, 0.0f for no forgetting
+    bool frozen;    ///< If true, updates are ignored
+
+}welford_t;
+
+/*!
+ * \brief Type definition of the z-score normalization parameters
+ */
+typedef struct
+{
+    float scale;  ///< 1 / standard deviation
+    float offset; ///< -mean / standard deviation
+
+}zscore_t;
+
 // Functions are documented in the source file
 
 float rescale(const float data, const float from[2], const float to[2]);
 float clip(const float data, const float min[1], const float max[1]);
 
+void welford_init(welford_t *w, const float alpha);
+void welford_update(welford_t *w, const float data);
+void welford_freeze(welford_t *w, const bool freeze);
+void zscore_update(zscore_t *z, const welford_t *w);
+float zscore(const float data, const zscore_t *z);
+
 #endif // _NORMALIZATION_H_
 
 #ifdef __cplusplus
@@ -0,0 +1,360 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for percentiles of a sliding window
+ * \file      order_statistics.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \see       Hardle, W., & Steiger, W. (1995). Algorithm AS 296: Optimal
+ *            median smoothing. Journal of the Royal Statistical Society.
+ *            Series C (Applied Statistics), 44(2), 258-264.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "order_statistics.h"
+
+/*
+ * The data samples of the window are split in two heaps, which are stored in
+ * one array: positions 0 to k are a max-heap of the k+1 smallest data
+ * samples, positions k+1 to n-1 are a min-heap of the others. The root of the
+ * max-heap is the data sample of rank k, the root of the min-heap the data
+ * sample of rank k+1. Replacing the oldest data sample moves it up or down
+ * its own heap, and if it crosses the other root, the roots are swapped. Both
+ * take at most log2(n) steps.
+ */
+
+static inline float value(const sliding_percentile_t *s, const uint32_t i);
+static inline void swap(sliding_percentile_t *s, const uint32_t a,
+    const uint32_t b);
+static void max_heap_up(sliding_percentile_t *s, uint32_t i);
+static void max_heap_down(sliding_percentile_t *s, uint32_t i);
+static void min_heap_up(sliding_percentile_t *s, uint32_t i);
+static void min_heap_down(sliding_percentile_t *s, uint32_t i);
+
+/*!
+ * \brief Initializes a percentile of a sliding window
+ *
+ * The window starts with n data samples of 0.0f, like the intermediate
+ * results of fir().
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  s      Pointer to the sliding percentile
+ * \param[out]  x      Pointer to an array of n elements, which must remain
+ *                     valid
+ * \param[out]  heap   Pointer to an array of n elements, which must remain
+ *                     valid
+ * \param[out]  index  Pointer to an array of n elements, which must remain
+ *                     valid
+ * \param[in]   n      The number of data samples in the window, up to 65535
+ * \param[in]   p      The percentile, from 0.0f to 100.0f
+ */
+void sliding_percentile_init(sliding_percentile_t *s, float *x,
+    uint16_t *heap, uint16_t *index, const uint32_t n, const float p)
+{
+    // Linear interpolation between the closest ranks, like numpy.percentile()
+    const float rank = p * (float)(n - 1) / 100.0f;
+
+    s->x = x;
+    s->heap = heap;
+    s->index = index;
+    s->n = n;
+    s->k = (uint32_t)rank;
+    s->fraction = rank - (float)s->k;
+    s->head = 0;
+
+    if(s->k >= (n - 1))
+    {
+        s->k = n - 1;
+        s->fraction = 0.0f;
+    }
+
+    // Equal data samples are valid heaps in any order
+    for(uint32_t i=0; i<n; ++i)
+    {
+        x[i] = 0.0f;
+        heap[i] = (uint16_t)i;
+        index[i] = (uint16_t)i;
+    }
+}
+
+/*!
+ * \brief Adds a data sample to a sliding window
+ *
+ * Replaces the oldest data sample in the window in O(log n) steps.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  s     Pointer to the sliding percentile
+ * \param[in]     data  Data sample
+ */
+void sliding_percentile_update(sliding_percentile_t *s, const float data)
+{
+    const uint32_t slot = s->head;
+    const uint32_t i = s->index[slot];
+    const float previous = s->x[slot];
+
+    s->x[slot] = data;
+    s->head = ((slot + 1) == s->n) ? 0 : (slot + 1);
+
+    // Restore the heap of the data sample
+    if(i <= s->k)
+    {
+        if(data > previous)
+        {
+            max_heap_up(s, i);
+        }
+        else
+        {
+            max_heap_down(s, i);
+        }
+    }
+    else
+    {
+        if(data < previous)
+        {
+            min_heap_up(s, i);
+        }
+        else
+        {
+            min_heap_down(s, i);
+        }
+    }
+
+    // Swap the roots if the data sample crossed the other root
+    if(((s->k + 1) < s->n) && (value(s, 0) > value(s, s->k + 1)))
+    {
+        swap(s, 0, s->k + 1);
+        max_heap_down(s, 0);
+        min_heap_down(s, s->k + 1);
+    }
+}
+
+/*!
+ * \brief Percentile of a sliding window
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  s  Pointer to the sliding percentile
+ *
+ * \return The percentile of the data samples in the window
+ */
+float sliding_percentile(const sliding_percentile_t *s)
+{
+    const float a = value(s, 0);
+
+    if(s->fraction == 0.0f)
+    {
+        return a;
+    }
+
+    return a + (s->fraction * (value(s, s->k + 1) - a));
+}
+
+/*!
+ * \brief Initializes a median filter
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  s      Pointer to the median filter
+ * \param[out]  x      Pointer to an array of n elements, which must remain
+ *                     valid
+ * \param[out]  heap   Pointer to an array of n elements, which must remain
+ *                     valid
+ * \param[out]  index  Pointer to an array of n elements, which must remain
+ *                     valid
+ * \param[in]   n      The number of data samples in the window, up to 65535
+ */
+void median_filter_init(sliding_percentile_t *s, float *x, uint16_t *heap,
+    uint16_t *index, const uint32_t n)
+{
+    sliding_percentile_init(s, x, heap, index, n, 50.0f);
+}
+
+/*!
+ * \brief Median filtered data
+ *
+ * The median of the last n data samples. Unlike fir(), a single spike does
+ * not change the output, which makes it suitable for sensors with outliers,
+ * such as a time-of-flight distance sensor. For an even n, the median is the
+ * mean of the two middle data samples.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  s     Pointer to the median filter
+ * \param[in]     data  Data sample
+ *
+ * \return Median filtered data sample
+ */
+float median_filter(sliding_percentile_t *s, const float data)
+{
+    sliding_percentile_update(s, data);
+
+    return sliding_percentile(s);
+}
+
+/*!
+ * \brief Returns the data sample at position i of the heaps
+ */
+static inline float value(const sliding_percentile_t *s, const uint32_t i)
+{
+    return s->x[s->heap[i]];
+}
+
+/*!
+ * \brief Swaps the data samples at positions a and b of the heaps
+ */
+static inline void swap(sliding_percentile_t *s, const uint32_t a,
+    const uint32_t b)
+{
+    const uint16_t t = s->heap[a];
+
+    s->heap[a] = s->heap[b];
+    s->heap[b] = t;
+
+    s->index[s->heap[a]] = (uint16_t)a;
+    s->index[s->heap[b]] = (uint16_t)b;
+}
+
+/*!
+ * \brief Moves the data sample at position i up the max-heap
+ */
+static void max_heap_up(sliding_percentile_t *s, uint32_t i)
+{
+    while(i > 0)
+    {
+        const uint32_t parent = (i - 1) / 2;
+
+        if(value(s, parent) >= value(s, i))
+        {
+            break;
+        }
+
+        swap(s, parent, i);
+        i = parent;
+    }
+}
+
+/*!
+ * \brief Moves the data sample at position i down the max-heap
+ */
+static void max_heap_down(sliding_percentile_t *s, uint32_t i)
+{
+    const uint32_t size = s->k + 1;
+
+    while(1)
+    {
+        const uint32_t left = (2 * i) + 1;
+
+        if(left >= size)
+        {
+            break;
+        }
+
+        // The largest child
+        uint32_t child = left;
+
+        if(((left + 1) < size) && (value(s, left + 1) > value(s, left)))
+        {
+            child = left + 1;
+        }
+
+        if(value(s, child) <= value(s, i))
+        {
+            break;
+        }
+
+        swap(s, child, i);
+        i = child;
+    }
+}
+
+/*!
+ * \brief Moves the data sample at position i up the min-heap
+ */
+static void min_heap_up(sliding_percentile_t *s, uint32_t i)
+{
+    // Position in the min-heap
+    const uint32_t base = s->k + 1;
+    uint32_t j = i - base;
+
+    while(j > 0)
+    {
+        const uint32_t parent = (j - 1) / 2;
+
+        if(value(s, base + parent) <= value(s, base + j))
+        {
+            break;
+        }
+
+        swap(s, base + parent, base + j);
+        j = parent;
+    }
+}
+
+/*!
+ * \brief Moves the data sample at position i down the min-heap
+ */
+static void min_heap_down(sliding_percentile_t *s, uint32_t i)
+{
+    // Position in the min-heap
+    const uint32_t base = s->k + 1;
+    const uint32_t size = s->n - base;
+    uint32_t j = i - base;
+
+    while(1)
+    {
+        const uint32_t left = (2 * j) + 1;
+
+        if(left >= size)
+        {
+            break;
+        }
+
+        // The smallest child
+        uint32_t child = left;
+
+        if(((left + 1) < size) &&
+            (value(s, base + left + 1) < value(s, base + left)))
+        {
+            child = left + 1;
+        }
+
+        if(value(s, base + child) >= value(s, base + j))
+        {
+            break;
+        }
+
+        swap(s, base + child, base + j);
+        j = child;
+    }
+}
@@ -0,0 +1,75 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for percentiles of a sliding window
+ * \file      order_statistics.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _ORDER_STATISTICS_H_
+#define _ORDER_STATISTICS_H_
+
+#include <stdint.h>
+
+/*!
+ * \brief Type definition of a percentile of a sliding window
+ */
+typedef struct
+{
+    float *x;        ///< The last n data samples
+    uint16_t *heap;  ///< Positions in x, the k+1 smallest data samples in a
+                     ///< max-heap followed by the others in a min-heap
+    uint16_t *index; ///< Position in heap of every data sample in x
+    uint32_t n;      ///< The number of data samples in the window
+    uint32_t k;      ///< Rank of the root of the max-heap
+    float fraction;  ///< Interpolation between rank k and rank k+1
+    uint32_t head;   ///< Position of the oldest data sample in x
+
+}sliding_percentile_t;
+
+// Functions are documented in the source file
+
+void sliding_percentile_init(sliding_percentile_t *s, float *x,
+    uint16_t *heap, uint16_t *index, const uint32_t n, const float p);
+void sliding_percentile_update(sliding_percentile_t *s, const float data);
+float sliding_percentile(const sliding_percentile_t *s);
+
+void median_filter_init(sliding_percentile_t *s, float *x, uint16_t *heap,
+    uint16_t *index, const uint32_t n);
+float median_filter(sliding_percentile_t *s, const float data);
+
+#endif // _ORDER_STATISTICS_H_
+
+#ifdef __cplusplus
+}
+#endif
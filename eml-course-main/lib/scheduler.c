@@ -0,0 +1,258 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for an event scheduler
+ * \file      scheduler.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * A main loop that polls every source in turn never sleeps, and a sample has
+ * to wait for all checks in front of it, which adds jitter to the latency.
+ * With the scheduler, interrupt handlers post events and the main loop runs
+ * the handler of each posted event:
+ *
+ *   ISR:        scheduler_post(&s, EVENT_SAMPLE);
+ *
+ *   main loop:  while(1)
+ *               {
+ *                   scheduler_run(&s);
+ *               }
+ *
+ * scheduler_run() runs the handlers of all posted events, in the order of
+ * priority. Event 0 has the highest priority. After each handler, it starts
+ * again at the highest priority, so an event posted while a handler runs is
+ * handled next if it has a higher priority. If an event is posted more than
+ * once before its handler runs, the handler runs once and the events are
+ * counted as coalesced. When no event is posted, the microcontroller sleeps
+ * until the next interrupt.
+ *
+ * Going to sleep must not miss an event that is posted just before the
+ * sleep instruction. The sleep function of the port is therefore called with
+ * the interrupts disabled, and must wake up on an interrupt that becomes
+ * pending:
+ *
+ * - Cortex-M: WFI, which wakes up on a pending interrupt while the
+ *   interrupts are disabled. The interrupt is taken when they are enabled.
+ * - AVR: sleep_enable(), sei(), sleep_cpu(), sleep_disable(). The
+ *   instruction after sei() is always executed before an interrupt.
+ * - Host: pthread_cond_wait() on the mutex that disabling the interrupts
+ *   locks.
+ *
+ * If the port has a time source, the time sleeping and the time not sleeping
+ * are measured. The fraction of the time not sleeping is the utilization of
+ * the CPU, see scheduler_utilization(). Interrupt handlers are counted as
+ * sleeping or not sleeping, depending on when they run.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "scheduler.h"
+
+/*!
+ * \brief Initializes the scheduler
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  s     Pointer to the scheduler
+ * \param[in]   port  Pointer to the functions of the microcontroller, which
+ *                    must remain valid
+ */
+void scheduler_init(scheduler_t *s, const scheduler_port_t *port)
+{
+    s->port = port;
+
+    for(uint32_t i=0; i<SCHEDULER_N_EVENTS; ++i)
+    {
+        s->handlers[i] = NULL;
+        s->posted[i] = 0;
+        s->handled[i] = 0;
+        s->runs[i] = 0;
+    }
+
+    s->coalesced = 0;
+    s->sleeps = 0;
+    s->busy_us = 0;
+    s->idle_us = 0;
+    s->mark = (port->now != NULL) ? port->now() : 0;
+}
+
+/*!
+ * \brief Sets the handler of an event
+ *
+ * The event number is the priority of the event, 0 is the highest. Events
+ * that are posted before their handler is set, are discarded by
+ * scheduler_run().
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. event must be less than SCHEDULER_N_EVENTS.
+ *
+ * \param[inout]  s        Pointer to the scheduler
+ * \param[in]     event    The event number
+ * \param[in]     handler  The function that handles the event, or NULL
+ */
+void scheduler_set(scheduler_t *s, const uint32_t event,
+    void (*handler)(void))
+{
+    s->handlers[event] = handler;
+}
+
+/*!
+ * \brief Posts an event
+ *
+ * Can be called from an interrupt handler and from an event handler. Each
+ * event must be posted from one context only, for example one interrupt
+ * handler.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. event must be less than SCHEDULER_N_EVENTS.
+ *
+ * \param[inout]  s      Pointer to the scheduler
+ * \param[in]     event  The event number
+ */
+void scheduler_post(scheduler_t *s, const uint32_t event)
+{
+    s->posted[event]++;
+}
+
+/*!
+ * \brief Checks if an event is posted and not handled yet
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  s  Pointer to the scheduler
+ *
+ * \return True if an event is pending
+ */
+bool scheduler_pending(const scheduler_t *s)
+{
+    for(uint32_t i=0; i<SCHEDULER_N_EVENTS; ++i)
+    {
+        if(s->posted[i] != s->handled[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Runs the handlers of the posted events and sleeps if there are none
+ *
+ * Call this function from the main loop.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  s  Pointer to the scheduler
+ */
+void scheduler_run(scheduler_t *s)
+{
+    uint32_t i = 0;
+
+    while(i < SCHEDULER_N_EVENTS)
+    {
+        const uint8_t posted = s->posted[i];
+        const uint8_t n = (uint8_t)(posted - s->handled[i]);
+
+        if(n == 0)
+        {
+            i++;
+            continue;
+        }
+
+        s->handled[i] = posted;
+        s->coalesced += n - 1u;
+
+        if(s->handlers[i] != NULL)
+        {
+            s->runs[i]++;
+            s->handlers[i]();
+        }
+
+        // Start again at the highest priority
+        i = 0;
+    }
+
+    const scheduler_port_t *port = s->port;
+    const uint32_t start = (port->now != NULL) ? port->now() : 0;
+
+    // An event that is posted after the check wakes up the sleep function
+    port->disable();
+
+    const bool idle = !scheduler_pending(s);
+
+    if(idle)
+    {
+        port->sleep();
+        s->sleeps++;
+    }
+
+    port->enable();
+
+    if(idle && (port->now != NULL))
+    {
+        const uint32_t end = port->now();
+
+        s->busy_us += start - s->mark;
+        s->idle_us += end - start;
+        s->mark = end;
+    }
+}
+
+/*!
+ * \brief Returns the utilization of the CPU and starts a new measurement
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  s  Pointer to the scheduler
+ *
+ * \return The fraction of the time not sleeping since the previous call, or
+ *         0 if the port has no time source
+ */
+float scheduler_utilization(scheduler_t *s)
+{
+    if(s->port->now == NULL)
+    {
+        return 0.0f;
+    }
+
+    const uint32_t now = s->port->now();
+
+    s->busy_us += now - s->mark;
+    s->mark = now;
+
+    const uint32_t total = s->busy_us + s->idle_us;
+    const float utilization = (total > 0) ?
+        ((float)s->busy_us / (float)total) : 0.0f;
+
+    s->busy_us = 0;
+    s->idle_us = 0;
+
+    return utilization;
+}
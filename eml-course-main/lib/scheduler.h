@@ -0,0 +1,102 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for an event scheduler
+ * \file      scheduler.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Maximum number of events
+#define SCHEDULER_N_EVENTS (8)
+
+/*!
+ * \brief Type definition of the functions of the microcontroller that the
+ *        scheduler uses
+ */
+typedef struct
+{
+    void (*disable)(void);   ///< Disables the interrupts
+    void (*enable)(void);    ///< Enables the interrupts
+    void (*sleep)(void);     ///< Sleeps until an interrupt, called with the
+                             ///< interrupts disabled
+    uint32_t (*now)(void);   ///< Returns the time in us, may be NULL
+
+}scheduler_port_t;
+
+/*!
+ * \brief Type definition of the scheduler
+ *
+ * An event is posted by incrementing its counter and handled by copying the
+ * counter. Both are 8 bits, written by one context only, so no critical
+ * section is needed, also not on an 8-bit microcontroller.
+ */
+typedef struct
+{
+    const scheduler_port_t *port;
+    void (*handlers[SCHEDULER_N_EVENTS])(void);
+
+    volatile uint8_t posted[SCHEDULER_N_EVENTS];
+    uint8_t handled[SCHEDULER_N_EVENTS];
+
+    uint32_t runs[SCHEDULER_N_EVENTS];  ///< Number of runs of each handler
+    uint32_t coalesced;  ///< Number of events posted again before they ran
+    uint32_t sleeps;     ///< Number of times the scheduler slept
+
+    uint32_t busy_us;    ///< Time in us not sleeping since the last report
+    uint32_t idle_us;    ///< Time in us sleeping since the last report
+    uint32_t mark;       ///< Time in us of the last update of busy_us
+
+}scheduler_t;
+
+// Functions are documented in the source file
+
+void scheduler_init(scheduler_t *s, const scheduler_port_t *port);
+void scheduler_set(scheduler_t *s, const uint32_t event,
+    void (*handler)(void));
+void scheduler_post(scheduler_t *s, const uint32_t event);
+bool scheduler_pending(const scheduler_t *s);
+void scheduler_run(scheduler_t *s);
+float scheduler_utilization(scheduler_t *s);
+
+#endif // _SCHEDULER_H_
+
+#ifdef __cplusplus
+}
+#endif
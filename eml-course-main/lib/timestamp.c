@@ -0,0 +1,194 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for timestamps in us
+ * \file      timestamp.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * A tick counter of 1 ms quantizes the period between samples at 100 Hz in
+ * steps of 10%, which hides the jitter. The timer that generates the tick
+ * interrupt counts with a much higher resolution, so the time in us is the
+ * number of ticks plus the counter of the timer:
+ *
+ *   counter |    /|    /|    /|
+ *           |   / |   / |   / |
+ *           |  /  |  /  |  /  |
+ *           | /   | /   | /   |
+ *           |/    |/    |/    |
+ *           +-----+-----+-----+---> t
+ *    ticks     n    n+1   n+2
+ *
+ * The number of ticks and the counter are read one after the other, so the
+ * tick interrupt can occur in between. Instead of disabling the interrupts,
+ * timestamp_us() reads the number of ticks again and retries if it has
+ * changed. This also detects a 32-bit number of ticks that is read with
+ * multiple instructions on an 8-bit microcontroller, while the interrupt
+ * handler changes it.
+ *
+ * If the interrupt cannot be taken, because timestamp_us() is called with
+ * the interrupts disabled or from an interrupt handler with the same or a
+ * higher priority, the counter wraps without the number of ticks being
+ * incremented. The pending flag of the tick interrupt shows this, and the
+ * missing tick is added. At most one tick can be pending, so the interrupts
+ * must not be disabled for longer than a tick.
+ *
+ * The number of ticks is extended with an epoch to 64 bits, so the
+ * timestamps do not wrap. With 32 bits, the time in us wraps after 71
+ * minutes and the time in ms after 49 days.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "timestamp.h"
+
+/*!
+ * \brief Initializes a timestamp source
+ *
+ * Start the timer after calling this function, and call timestamp_tick()
+ * from its interrupt handler.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance. period * tick_us must be less than 2^32.
+ *
+ * \param[out]  t        Pointer to the timestamp source
+ * \param[in]   count    Function that returns the counter of the timer
+ * \param[in]   pending  Function that returns true if the tick interrupt is
+ *                       pending, or NULL if timestamp_us() is never called
+ *                       with the interrupts disabled
+ * \param[in]   period   The number of counts per tick, for example 48000 for
+ *                       SysTick at 48 MHz and a tick of 1 ms
+ * \param[in]   tick_us  The duration of a tick in us, for example 1000
+ * \param[in]   down     True if the counter counts down from period-1 to 0,
+ *                       such as SysTick, false if it counts up from 0 to
+ *                       period-1
+ */
+void timestamp_init(timestamp_t *t, uint32_t (*count)(void),
+    bool (*pending)(void), const uint32_t period, const uint32_t tick_us,
+    const bool down)
+{
+    t->count = count;
+    t->pending = pending;
+    t->period = period;
+    t->tick_us = tick_us;
+    t->down = down;
+
+    t->ticks = 0;
+    t->epoch = 0;
+}
+
+/*!
+ * \brief Counts a tick
+ *
+ * Call this function from the interrupt handler of the timer.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  t  Pointer to the timestamp source
+ */
+void timestamp_tick(timestamp_t *t)
+{
+    const uint32_t ticks = t->ticks + 1;
+
+    t->ticks = ticks;
+
+    if(ticks == 0)
+    {
+        t->epoch++;
+    }
+}
+
+/*!
+ * \brief Returns the number of ticks
+ *
+ * Does not disable the interrupts, see timestamp_us(). A tick that is
+ * pending is not counted.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  t  Pointer to the timestamp source
+ *
+ * \return The number of ticks since timestamp_init()
+ */
+uint64_t timestamp_ticks(const timestamp_t *t)
+{
+    uint32_t epoch;
+    uint32_t ticks;
+
+    do
+    {
+        epoch = t->epoch;
+        ticks = t->ticks;
+    }
+    while((ticks != t->ticks) || (epoch != t->epoch));
+
+    return ((uint64_t)epoch << 32) | ticks;
+}
+
+/*!
+ * \brief Returns the time in us
+ *
+ * The time is monotonic and does not wrap. The interrupts are not disabled,
+ * so the function can be called from the main loop and from interrupt
+ * handlers.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  t  Pointer to the timestamp source
+ *
+ * \return The time in us since timestamp_init()
+ */
+uint64_t timestamp_us(const timestamp_t *t)
+{
+    uint32_t epoch;
+    uint32_t ticks;
+    uint32_t count;
+    bool pending;
+
+    do
+    {
+        epoch = t->epoch;
+        ticks = t->ticks;
+        count = t->count();
+        pending = (t->pending != NULL) && t->pending();
+
+        // The counter wrapped before the pending flag was read, but maybe
+        // after the counter was read. Read the counter again, so it is from
+        // after the wrap.
+        if(pending)
+        {
+            count = t->count();
+        }
+    }
+    while((ticks != t->ticks) || (epoch != t->epoch));
+
+    const uint32_t elapsed = t->down ? (t->period - 1 - count) : count;
+    const uint64_t n = (((uint64_t)epoch << 32) | ticks) + (pending ? 1 : 0);
+
+    return (n * t->tick_us) + ((elapsed * t->tick_us) / t->period);
+}
@@ -0,0 +1,82 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for timestamps in us
+ * \file      timestamp.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _TIMESTAMP_H_
+#define _TIMESTAMP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * \brief Type definition of a timestamp source
+ *
+ * A timer generates an interrupt every tick, for example every ms. The
+ * interrupt handler counts the ticks and the timer counts the time within a
+ * tick. The number of ticks is 64 bits, split in the least significant part
+ * ticks and the number of times that ticks wrapped, so it does not wrap.
+ */
+typedef struct
+{
+    uint32_t (*count)(void);   ///< Returns the counter of the timer
+    bool (*pending)(void);     ///< Returns true if the tick interrupt is
+                               ///< pending, may be NULL
+    uint32_t period;           ///< The number of counts per tick
+    uint32_t tick_us;          ///< The duration of a tick in us
+    bool down;                 ///< The counter counts down from period-1 to 0
+                               ///< instead of up from 0 to period-1
+
+    volatile uint32_t ticks;   ///< The number of ticks
+    volatile uint32_t epoch;   ///< The number of times that ticks wrapped
+
+}timestamp_t;
+
+// Functions are documented in the source file
+
+void timestamp_init(timestamp_t *t, uint32_t (*count)(void),
+    bool (*pending)(void), const uint32_t period, const uint32_t tick_us,
+    const bool down);
+void timestamp_tick(timestamp_t *t);
+uint64_t timestamp_ticks(const timestamp_t *t);
+uint64_t timestamp_us(const timestamp_t *t);
+
+#endif // _TIMESTAMP_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,396 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for the wake-up engines of accelerometers
+ * \file      wakeup.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * The MMA8451 and the LSM6DSO can detect motion themselves and signal it with
+ * an interrupt. While stationary, the microcontroller can therefore sleep
+ * without reading samples, until the sensor detects motion. See ADAPTIVE and
+ * WAKE_ON_MOTION in the demo applications.
+ *
+ * Both engines compare high-pass filtered acceleration with a threshold, so a
+ * constant orientation does not trigger them. The threshold is set in mg,
+ * like the thresholds of the activity in acquisition.c, and the duration in
+ * ms. Both are quantized to the resolution of the registers:
+ *
+ * - MMA8451 transient detection: 63 mg per LSB, up to 127 LSB. The debounce
+ *   counter counts samples at the ODR, at most 80 ms per count in the normal
+ *   oversampling mode.
+ * - LSM6DSO wake-up detection: full scale / 256 or full scale / 64 per LSB,
+ *   up to 63 LSB. The duration counts samples at the ODR, up to 3.
+ *
+ * The registers are accessed with the functions of a wakeup_bus_t, so the
+ * configuration can be tested on the host with a register map instead of a
+ * sensor. The functions only change the bits they need, so the rest of the
+ * configuration is preserved.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "wakeup.h"
+
+/// MMA8451 bits
+#define MMA8451_CTRL_REG1_ACTIVE   (0x01)
+#define MMA8451_CTRL_REG4_DRDY     (0x01)
+#define MMA8451_CTRL_REG4_TRANS    (0x20)
+#define MMA8451_CTRL_REG5_TRANS    (0x20)
+#define MMA8451_TRANSIENT_CFG_XYZ  (0x0E)
+#define MMA8451_TRANSIENT_CFG_ELE  (0x10)
+#define MMA8451_TRANSIENT_SRC_EA   (0x40)
+
+/// Longest period in ms of the MMA8451 debounce counter per oversampling
+/// mode: normal, low noise low power, high resolution and low power. See
+/// table 43 of the datasheet, the low power mode counts at the ODR.
+static const float mma8451_count_ms_max[4] = {20.0f, 80.0f, 2.5f, 640.0f};
+
+/// LSM6DSO bits
+#define LSM6DSO_TAP_CFG0_LIR       (0x01)
+#define LSM6DSO_TAP_CFG0_SLOPE_FDS (0x10)
+#define LSM6DSO_TAP_CFG2_INT_EN    (0x80)
+#define LSM6DSO_WAKE_UP_THS_MASK   (0x3F)
+#define LSM6DSO_WAKE_UP_DUR_MASK   (0x60)
+#define LSM6DSO_WAKE_UP_DUR_POS    (5)
+#define LSM6DSO_WAKE_THS_W         (0x10)
+#define LSM6DSO_MD1_CFG_INT1_WU    (0x20)
+#define LSM6DSO_WAKE_UP_SRC_WU_IA  (0x08)
+
+// Local function prototypes
+static bool wakeup_modify(const wakeup_bus_t *bus, const uint8_t reg,
+    const uint8_t clear, const uint8_t set);
+static uint32_t wakeup_round(const float value, const uint32_t min,
+    const uint32_t max);
+
+/*!
+ * \brief Converts a threshold in mg to the TRANSIENT_THS of the MMA8451
+ *
+ * The threshold is rounded to the nearest multiple of 63 mg. It is at least
+ * one LSB, because a threshold of 0 would detect motion continuously.
+ *
+ * \param[in]  threshold_mg  The threshold in mg
+ *
+ * \return The threshold in LSB, 1 to 127
+ */
+uint8_t wakeup_mma8451_ths(const float threshold_mg)
+{
+    return (uint8_t)wakeup_round(threshold_mg / WAKEUP_MMA8451_MG_PER_LSB, 1,
+        127);
+}
+
+/*!
+ * \brief Returns the period in ms of the TRANSIENT_COUNT of the MMA8451
+ *
+ * The debounce counter counts at the ODR, but at most every 20 ms in the
+ * normal mode, 80 ms in the low noise low power mode and 2.5 ms in the high
+ * resolution mode, which is used by the driver. In the low power mode it
+ * counts at the ODR. See table 43 of the datasheet.
+ *
+ * \param[in]  odr   The output data rate in Hz
+ * \param[in]  mods  The oversampling mode, the MODS bits of CTRL_REG2
+ *
+ * \return The period in ms
+ */
+float wakeup_mma8451_count_ms(const float odr, const uint8_t mods)
+{
+    const float period_ms = 1000.0f / odr;
+    const float max_ms = mma8451_count_ms_max[mods & WAKEUP_MMA8451_MODS_MASK];
+
+    return (period_ms > max_ms) ? max_ms : period_ms;
+}
+
+/*!
+ * \brief Converts a duration in ms to the TRANSIENT_COUNT of the MMA8451
+ *
+ * \param[in]  duration_ms  The duration in ms that the threshold must be
+ *                          exceeded
+ * \param[in]  odr          The output data rate in Hz
+ * \param[in]  mods         The oversampling mode, see
+ *                          wakeup_mma8451_count_ms()
+ *
+ * \return The number of counts, 0 to 255
+ */
+uint8_t wakeup_mma8451_count(const float duration_ms, const float odr,
+    const uint8_t mods)
+{
+    return (uint8_t)wakeup_round(duration_ms / wakeup_mma8451_count_ms(odr,
+        mods), 0, 255);
+}
+
+/*!
+ * \brief Configures the transient detection of the MMA8451
+ *
+ * Motion is detected on all axes after the high-pass filter. The event is
+ * latched until wakeup_mma8451_source() is called, and the interrupt is
+ * routed to INT2, so INT1 remains the data ready interrupt. The duration is
+ * converted with the oversampling mode that is read from CTRL_REG2. The
+ * sensor is put in standby while the registers are written and its mode is
+ * restored afterwards.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  bus           The register access of the sensor
+ * \param[in]  threshold_mg  The threshold in mg, see wakeup_mma8451_ths()
+ * \param[in]  duration_ms   The duration in ms, see wakeup_mma8451_count()
+ * \param[in]  odr           The output data rate in Hz while waiting for
+ *                           motion
+ *
+ * \return False if a register could not be accessed
+ */
+bool wakeup_mma8451_init(const wakeup_bus_t *bus, const float threshold_mg,
+    const float duration_ms, const float odr)
+{
+    uint8_t ctrl_reg1;
+    uint8_t ctrl_reg2;
+
+    if(!bus->read(bus->handle, WAKEUP_MMA8451_CTRL_REG1, &ctrl_reg1) ||
+        !bus->read(bus->handle, WAKEUP_MMA8451_CTRL_REG2, &ctrl_reg2))
+    {
+        return false;
+    }
+
+    // The registers can only be written in standby
+    if(!bus->write(bus->handle, WAKEUP_MMA8451_CTRL_REG1,
+        ctrl_reg1 & (uint8_t)~MMA8451_CTRL_REG1_ACTIVE))
+    {
+        return false;
+    }
+
+    const bool ok =
+        bus->write(bus->handle, WAKEUP_MMA8451_TRANSIENT_CFG,
+            MMA8451_TRANSIENT_CFG_ELE | MMA8451_TRANSIENT_CFG_XYZ) &&
+        bus->write(bus->handle, WAKEUP_MMA8451_TRANSIENT_THS,
+            wakeup_mma8451_ths(threshold_mg)) &&
+        bus->write(bus->handle, WAKEUP_MMA8451_TRANSIENT_COUNT,
+            wakeup_mma8451_count(duration_ms, odr, ctrl_reg2)) &&
+        wakeup_modify(bus, WAKEUP_MMA8451_CTRL_REG4, 0,
+            MMA8451_CTRL_REG4_TRANS) &&
+        wakeup_modify(bus, WAKEUP_MMA8451_CTRL_REG5, MMA8451_CTRL_REG5_TRANS,
+            0);
+
+    // Restore the mode, even if the configuration failed
+    return bus->write(bus->handle, WAKEUP_MMA8451_CTRL_REG1, ctrl_reg1) && ok;
+}
+
+/*!
+ * \brief Enables or disables the data ready interrupt of the MMA8451
+ *
+ * While waiting for motion, the data ready interrupt is disabled, so the
+ * microcontroller is not woken up by every sample.
+ *
+ * \param[in]  bus     The register access of the sensor
+ * \param[in]  enable  True to enable the data ready interrupt
+ *
+ * \return False if a register could not be accessed
+ */
+bool wakeup_mma8451_drdy(const wakeup_bus_t *bus, const bool enable)
+{
+    uint8_t ctrl_reg1;
+    uint8_t ctrl_reg2;
+
+    if(!bus->read(bus->handle, WAKEUP_MMA8451_CTRL_REG1, &ctrl_reg1) ||
+        !bus->read(bus->handle, WAKEUP_MMA8451_CTRL_REG2, &ctrl_reg2))
+    {
+        return false;
+    }
+
+    if(!bus->write(bus->handle, WAKEUP_MMA8451_CTRL_REG1,
+        ctrl_reg1 & (uint8_t)~MMA8451_CTRL_REG1_ACTIVE))
+    {
+        return false;
+    }
+
+    const bool ok = wakeup_modify(bus, WAKEUP_MMA8451_CTRL_REG4,
+        enable ? 0 : MMA8451_CTRL_REG4_DRDY,
+        enable ? MMA8451_CTRL_REG4_DRDY : 0);
+
+    return bus->write(bus->handle, WAKEUP_MMA8451_CTRL_REG1, ctrl_reg1) && ok;
+}
+
+/*!
+ * \brief Reads and clears the transient event of the MMA8451
+ *
+ * Reading TRANSIENT_SRC clears the latched event and releases the interrupt
+ * pin.
+ *
+ * \param[in]   bus     The register access of the sensor
+ * \param[out]  motion  True if motion was detected since the last call
+ *
+ * \return False if the register could not be accessed
+ */
+bool wakeup_mma8451_source(const wakeup_bus_t *bus, bool *motion)
+{
+    uint8_t value = 0;
+    const bool ok = bus->read(bus->handle, WAKEUP_MMA8451_TRANSIENT_SRC,
+        &value);
+
+    *motion = ok && ((value & MMA8451_TRANSIENT_SRC_EA) != 0);
+
+    return ok;
+}
+
+/*!
+ * \brief Converts a threshold in mg to the WK_THS of the LSM6DSO
+ *
+ * The fine resolution of full scale / 256 is used if the threshold fits,
+ * otherwise the coarse resolution of full scale / 64. The threshold is at
+ * least one LSB.
+ *
+ * \param[in]   threshold_mg  The threshold in mg
+ * \param[in]   fs_mg         The full scale of the accelerometer in mg, for
+ *                            example 2000 for +/-2g
+ * \param[out]  fine          True if the fine resolution is used, which is
+ *                            the WAKE_THS_W bit
+ *
+ * \return The threshold in LSB, 1 to 63
+ */
+uint8_t wakeup_lsm6dso_ths(const float threshold_mg, const float fs_mg,
+    bool *fine)
+{
+    const float lsb = threshold_mg * 256.0f / fs_mg;
+
+    *fine = ((lsb + 0.5f) < 64.0f);
+
+    return (uint8_t)wakeup_round(*fine ? lsb : (lsb / 4.0f), 1, 63);
+}
+
+/*!
+ * \brief Converts a duration in ms to the WAKE_DUR of the LSM6DSO
+ *
+ * \param[in]  duration_ms  The duration in ms that the threshold must be
+ *                          exceeded
+ * \param[in]  odr          The output data rate in Hz
+ *
+ * \return The duration in samples, 0 to 3
+ */
+uint8_t wakeup_lsm6dso_dur(const float duration_ms, const float odr)
+{
+    return (uint8_t)wakeup_round(duration_ms * odr / 1000.0f, 0, 3);
+}
+
+/*!
+ * \brief Configures the wake-up detection of the LSM6DSO
+ *
+ * Motion is detected on all axes after the slope filter. The event is latched
+ * until wakeup_lsm6dso_source() is called and is routed to INT1. The
+ * registers can be written while the sensor is running.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  bus           The register access of the sensor
+ * \param[in]  threshold_mg  The threshold in mg, see wakeup_lsm6dso_ths()
+ * \param[in]  duration_ms   The duration in ms, see wakeup_lsm6dso_dur()
+ * \param[in]  odr           The output data rate in Hz while waiting for
+ *                           motion
+ * \param[in]  fs_mg         The full scale of the accelerometer in mg
+ *
+ * \return False if a register could not be accessed
+ */
+bool wakeup_lsm6dso_init(const wakeup_bus_t *bus, const float threshold_mg,
+    const float duration_ms, const float odr, const float fs_mg)
+{
+    bool fine;
+    const uint8_t ths = wakeup_lsm6dso_ths(threshold_mg, fs_mg, &fine);
+    const uint8_t dur = wakeup_lsm6dso_dur(duration_ms, odr);
+
+    return
+        wakeup_modify(bus, WAKEUP_LSM6DSO_TAP_CFG0,
+            LSM6DSO_TAP_CFG0_SLOPE_FDS, LSM6DSO_TAP_CFG0_LIR) &&
+        wakeup_modify(bus, WAKEUP_LSM6DSO_WAKE_UP_THS,
+            LSM6DSO_WAKE_UP_THS_MASK, ths) &&
+        wakeup_modify(bus, WAKEUP_LSM6DSO_WAKE_UP_DUR,
+            LSM6DSO_WAKE_UP_DUR_MASK | LSM6DSO_WAKE_THS_W,
+            (uint8_t)((dur << LSM6DSO_WAKE_UP_DUR_POS) |
+            (fine ? LSM6DSO_WAKE_THS_W : 0))) &&
+        wakeup_modify(bus, WAKEUP_LSM6DSO_MD1_CFG, 0,
+            LSM6DSO_MD1_CFG_INT1_WU) &&
+        wakeup_modify(bus, WAKEUP_LSM6DSO_TAP_CFG2, 0,
+            LSM6DSO_TAP_CFG2_INT_EN);
+}
+
+/*!
+ * \brief Reads and clears the wake-up event of the LSM6DSO
+ *
+ * Reading WAKE_UP_SRC clears the latched event and releases the interrupt
+ * pin.
+ *
+ * \param[in]   bus     The register access of the sensor
+ * \param[out]  motion  True if motion was detected since the last call
+ *
+ * \return False if the register could not be accessed
+ */
+bool wakeup_lsm6dso_source(const wakeup_bus_t *bus, bool *motion)
+{
+    uint8_t value = 0;
+    const bool ok = bus->read(bus->handle, WAKEUP_LSM6DSO_WAKE_UP_SRC, &value);
+
+    *motion = ok && ((value & LSM6DSO_WAKE_UP_SRC_WU_IA) != 0);
+
+    return ok;
+}
+
+/*!
+ * \brief Clears and sets bits of a register
+ *
+ * \param[in]  bus    The register access of the sensor
+ * \param[in]  reg    The register
+ * \param[in]  clear  The bits to clear
+ * \param[in]  set    The bits to set
+ *
+ * \return False if the register could not be accessed
+ */
+static bool wakeup_modify(const wakeup_bus_t *bus, const uint8_t reg,
+    const uint8_t clear, const uint8_t set)
+{
+    uint8_t value;
+
+    if(!bus->read(bus->handle, reg, &value))
+    {
+        return false;
+    }
+
+    value = (uint8_t)((value & ~clear) | set);
+
+    return bus->write(bus->handle, reg, value);
+}
+
+/*!
+ * \brief Rounds a non-negative value to the nearest integer within a range
+ */
+static uint32_t wakeup_round(const float value, const uint32_t min,
+    const uint32_t max)
+{
+    if(value <= (float)min)
+    {
+        return min;
+    }
+
+    const uint32_t n = (uint32_t)(value + 0.5f);
+
+    return (n > max) ? max : n;
+}
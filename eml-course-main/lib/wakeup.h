@@ -0,0 +1,112 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for the wake-up engines of accelerometers
+ * \file      wakeup.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _WAKEUP_H_
+#define _WAKEUP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// MMA8451 registers
+#define WAKEUP_MMA8451_INT_SOURCE      (0x0C)
+#define WAKEUP_MMA8451_TRANSIENT_CFG   (0x1D)
+#define WAKEUP_MMA8451_TRANSIENT_SRC   (0x1E)
+#define WAKEUP_MMA8451_TRANSIENT_THS   (0x1F)
+#define WAKEUP_MMA8451_TRANSIENT_COUNT (0x20)
+#define WAKEUP_MMA8451_CTRL_REG1       (0x2A)
+#define WAKEUP_MMA8451_CTRL_REG2       (0x2B)
+#define WAKEUP_MMA8451_CTRL_REG4       (0x2D)
+#define WAKEUP_MMA8451_CTRL_REG5       (0x2E)
+
+/// Threshold of the MMA8451 transient detection in mg per LSB
+#define WAKEUP_MMA8451_MG_PER_LSB (63.0f)
+
+/// Oversampling modes of the MMA8451, the MODS bits of CTRL_REG2
+#define WAKEUP_MMA8451_MODS_NORMAL (0x00)
+#define WAKEUP_MMA8451_MODS_LNLP   (0x01)
+#define WAKEUP_MMA8451_MODS_HR     (0x02)
+#define WAKEUP_MMA8451_MODS_LP     (0x03)
+#define WAKEUP_MMA8451_MODS_MASK   (0x03)
+
+/// LSM6DSO registers
+#define WAKEUP_LSM6DSO_INT1_CTRL   (0x0D)
+#define WAKEUP_LSM6DSO_WAKE_UP_SRC (0x1B)
+#define WAKEUP_LSM6DSO_TAP_CFG0    (0x56)
+#define WAKEUP_LSM6DSO_TAP_CFG2    (0x58)
+#define WAKEUP_LSM6DSO_WAKE_UP_THS (0x5B)
+#define WAKEUP_LSM6DSO_WAKE_UP_DUR (0x5C)
+#define WAKEUP_LSM6DSO_MD1_CFG     (0x5E)
+
+/*!
+ * \brief Type definition of the register access of a sensor
+ *
+ * The functions return false if the bus transfer failed. On the host, they
+ * can access a register map instead, so the configuration can be tested
+ * without a sensor.
+ */
+typedef struct
+{
+    bool (*write)(void *handle, const uint8_t reg, const uint8_t value);
+    bool (*read)(void *handle, const uint8_t reg, uint8_t *value);
+    void *handle;  ///< Passed to write and read, for example the I2C handle
+
+}wakeup_bus_t;
+
+// Functions are documented in the source file
+
+uint8_t wakeup_mma8451_ths(const float threshold_mg);
+float wakeup_mma8451_count_ms(const float odr, const uint8_t mods);
+uint8_t wakeup_mma8451_count(const float duration_ms, const float odr,
+    const uint8_t mods);
+bool wakeup_mma8451_init(const wakeup_bus_t *bus, const float threshold_mg,
+    const float duration_ms, const float odr);
+bool wakeup_mma8451_drdy(const wakeup_bus_t *bus, const bool enable);
+bool wakeup_mma8451_source(const wakeup_bus_t *bus, bool *motion);
+
+uint8_t wakeup_lsm6dso_ths(const float threshold_mg, const float fs_mg,
+    bool *fine);
+uint8_t wakeup_lsm6dso_dur(const float duration_ms, const float odr);
+bool wakeup_lsm6dso_init(const wakeup_bus_t *bus, const float threshold_mg,
+    const float duration_ms, const float odr, const float fs_mg);
+bool wakeup_lsm6dso_source(const wakeup_bus_t *bus, bool *motion);
+
+#endif // _WAKEUP_H_
+
+#ifdef __cplusplus
+}
+#endif
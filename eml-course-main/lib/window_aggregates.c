@@ -0,0 +1,477 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for overlapping windows with a hop
+ * \file      window_aggregates.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "window_aggregates.h"
+
+/*
+ * A window of length samples that moves hop samples at a time consists of
+ * length / hop blocks of hop samples. The aggregates of a block are computed
+ * once, while its samples arrive, and are kept until the block leaves the
+ * window. When a hop completes, the aggregates of the blocks are merged into
+ * the aggregates of the window. A window with 50% overlap thus merges 2
+ * blocks instead of processing all samples again, and a window with 75%
+ * overlap 4 blocks. No buffer of samples is needed.
+ *
+ * The sum of squared differences of a block is accumulated relative to the
+ * first sample of the block, which avoids both a division per sample and the
+ * cancellation of the naive sum of squares for data with a large offset.
+ *
+ * A window pyramid computes windows of length, 2 * length, 4 * length, ...
+ * samples from the same data stream, which all end at the last completed
+ * block of length samples. A window of scale k is the window of scale k - 1
+ * merged with the window of scale k - 1 that ended 2^(k - 1) blocks earlier,
+ * so every larger scale costs one merge per block. The windows of scale k - 1
+ * are kept in a ring of 2^(k - 1) elements, which are stored one after the
+ * other: the ring of scale k - 1 starts at element 2^(k - 1) of the history.
+ */
+
+static void merge_blocks(hopping_window_t *w);
+
+/*!
+ * \brief Resets the aggregates
+ *
+ * The minimum and the maximum are only valid if the aggregates contain at
+ * least one sample.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  a  Pointer to the aggregates
+ */
+void aggregate_reset(aggregate_t *a)
+{
+    a->n = 0;
+    a->sum = 0.0f;
+    a->m2 = 0.0f;
+    a->min = 0.0f;
+    a->max = 0.0f;
+    a->energy = 0.0f;
+}
+
+/*!
+ * \brief Merges the aggregates of another part of the data
+ *
+ * The aggregates of two parts of the data, of any number of samples, are
+ * combined with the pairwise formula of Chan et al., as if all samples were
+ * aggregated at once. The merge divides three times, so merging the blocks
+ * of a hopping window, which all have the same number of samples, is done by
+ * hopping_window_update() without dividing.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  a      Pointer to the aggregates, which are updated
+ * \param[in]     other  Pointer to the aggregates of the other part
+ */
+void aggregate_merge(aggregate_t *a, const aggregate_t *other)
+{
+    if(other->n == 0)
+    {
+        return;
+    }
+
+    if(a->n == 0)
+    {
+        *a = *other;
+        return;
+    }
+
+    const float na = (float)a->n;
+    const float nb = (float)other->n;
+    const float delta = (other->sum / nb) - (a->sum / na);
+
+    a->m2 += other->m2 + ((delta * delta * na * nb) / (na + nb));
+    a->n += other->n;
+    a->sum += other->sum;
+    a->min = (other->min < a->min) ? other->min : a->min;
+    a->max = (other->max > a->max) ? other->max : a->max;
+    a->energy += other->energy;
+}
+
+/*!
+ * \brief Returns the mean of the aggregates
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  a  Pointer to the aggregates
+ *
+ * \return The mean, like mean() in features.c
+ */
+float aggregate_mean(const aggregate_t *a)
+{
+    return a->sum / (float)a->n;
+}
+
+/*!
+ * \brief Returns the variance of the aggregates
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  a  Pointer to the aggregates
+ *
+ * \return The variance, like variance() in features.c
+ */
+float aggregate_variance(const aggregate_t *a)
+{
+    return a->m2 / (float)a->n;
+}
+
+/*!
+ * \brief Returns the minimum of the aggregates
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  a  Pointer to the aggregates
+ *
+ * \return The minimum, like min() in features.c
+ */
+float aggregate_min(const aggregate_t *a)
+{
+    return a->min;
+}
+
+/*!
+ * \brief Returns the maximum of the aggregates
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  a  Pointer to the aggregates
+ *
+ * \return The maximum, like max() in features.c
+ */
+float aggregate_max(const aggregate_t *a)
+{
+    return a->max;
+}
+
+/*!
+ * \brief Returns the energy of the aggregates
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  a  Pointer to the aggregates
+ *
+ * \return The sum of squares, like energy() in features.c
+ */
+float aggregate_energy(const aggregate_t *a)
+{
+    return a->energy;
+}
+
+/*!
+ * \brief Returns the peak-to-peak value of the aggregates
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  a  Pointer to the aggregates
+ *
+ * \return The peak-to-peak value, like peak_to_peak() in features.c
+ */
+float aggregate_peak_to_peak(const aggregate_t *a)
+{
+    return a->max - a->min;
+}
+
+/*!
+ * \brief Initializes a window that moves with a hop
+ *
+ * The first window completes after length samples, every next window hop
+ * samples later. A hop of length gives windows that do not overlap, a hop of
+ * length / 2 windows with 50% overlap.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  w       Pointer to the hopping window
+ * \param[out]  blocks  Pointer to an array of length / hop elements, which
+ *                      must remain valid
+ * \param[in]   length  The number of samples of a window, a multiple of hop
+ * \param[in]   hop     The number of samples between the start of two
+ *                      windows
+ */
+void hopping_window_init(hopping_window_t *w, aggregate_t *blocks,
+    const uint32_t length, const uint32_t hop)
+{
+    w->blocks = blocks;
+    w->n_blocks = length / hop;
+    w->hop = hop;
+    w->inv_hop = 1.0f / (float)hop;
+    w->inv_length = 1.0f / (float)length;
+
+    w->head = 0;
+    w->filled = 0;
+    w->count = 0;
+    w->shift = 0.0f;
+    w->s1 = 0.0f;
+    w->s2 = 0.0f;
+
+    for(uint32_t i=0; i<w->n_blocks; ++i)
+    {
+        aggregate_reset(&w->blocks[i]);
+    }
+
+    aggregate_reset(&w->window);
+}
+
+/*!
+ * \brief Adds a data sample to a window that moves with a hop
+ *
+ * The sample is added to the aggregates of the current hop. If the hop
+ * completes and the window contains length samples, the aggregates of the
+ * window are available from hopping_window().
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  w     Pointer to the hopping window
+ * \param[in]     data  The data sample
+ *
+ * \return True if a window is completed
+ */
+bool hopping_window_update(hopping_window_t *w, const float data)
+{
+    aggregate_t *b = &w->blocks[w->head];
+
+    // The first sample of a hop replaces the oldest block
+    if(w->count == 0)
+    {
+        w->shift = data;
+        w->s1 = 0.0f;
+        w->s2 = 0.0f;
+
+        b->min = data;
+        b->max = data;
+        b->energy = 0.0f;
+    }
+
+    const float d = data - w->shift;
+
+    w->s1 += d;
+    w->s2 += d * d;
+
+    b->min = (data < b->min) ? data : b->min;
+    b->max = (data > b->max) ? data : b->max;
+    b->energy += data * data;
+
+    if(++w->count < w->hop)
+    {
+        return false;
+    }
+
+    // The hop is completed
+    const float m2 = w->s2 - (w->s1 * w->s1 * w->inv_hop);
+
+    b->n = w->hop;
+    b->sum = w->s1 + ((float)w->hop * w->shift);
+    b->m2 = (m2 > 0.0f) ? m2 : 0.0f;
+
+    w->count = 0;
+    w->head = ((w->head + 1) == w->n_blocks) ? 0 : (w->head + 1);
+
+    if(w->filled < w->n_blocks)
+    {
+        ++w->filled;
+
+        if(w->filled < w->n_blocks)
+        {
+            return false;
+        }
+    }
+
+    merge_blocks(w);
+
+    return true;
+}
+
+/*!
+ * \brief Returns the aggregates of the last completed window
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  w  Pointer to the hopping window
+ *
+ * \return Pointer to the aggregates, which are valid after
+ *         hopping_window_update() returned true
+ */
+const aggregate_t *hopping_window(const hopping_window_t *w)
+{
+    return &w->window;
+}
+
+/*!
+ * \brief Initializes windows of several scales, which share one data stream
+ *
+ * Scale k has windows of length * 2^k samples. All scales are updated every
+ * length samples, the largest scale is complete after
+ * length * 2^(n_scales - 1) samples. For example, a length of 25 and 4
+ * scales give windows of 25, 50, 100 and 200 samples.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[out]  p         Pointer to the window pyramid
+ * \param[out]  history   Pointer to an array of
+ *                        WINDOW_PYRAMID_N_HISTORY(n_scales) elements, which
+ *                        must remain valid
+ * \param[in]   length    The number of samples of a window of the smallest
+ *                        scale
+ * \param[in]   n_scales  The number of scales, up to
+ *                        WINDOW_PYRAMID_N_SCALES_MAX
+ */
+void window_pyramid_init(window_pyramid_t *p, aggregate_t *history,
+    const uint32_t length, const uint32_t n_scales)
+{
+    p->history = history;
+    p->n_scales = n_scales;
+    p->t = 0;
+
+    // The block of the smallest scale is the first element of the history
+    hopping_window_init(&p->base, &history[0], length, length);
+
+    for(uint32_t i=1; i<WINDOW_PYRAMID_N_HISTORY(n_scales); ++i)
+    {
+        aggregate_reset(&p->history[i]);
+    }
+
+    for(uint32_t k=0; k<WINDOW_PYRAMID_N_SCALES_MAX; ++k)
+    {
+        aggregate_reset(&p->scales[k]);
+    }
+}
+
+/*!
+ * \brief Adds a data sample to windows of several scales
+ *
+ * If a block of the smallest scale completes, the windows of all scales are
+ * available from window_pyramid(). Until a scale is complete, its window
+ * contains the samples so far, which can be checked with the number of
+ * samples n of the aggregates.
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[inout]  p     Pointer to the window pyramid
+ * \param[in]     data  The data sample
+ *
+ * \return True if the windows of all scales are updated
+ */
+bool window_pyramid_update(window_pyramid_t *p, const float data)
+{
+    if(!hopping_window_update(&p->base, data))
+    {
+        return false;
+    }
+
+    p->scales[0] = *hopping_window(&p->base);
+
+    for(uint32_t k=1; k<p->n_scales; ++k)
+    {
+        // The ring of scale k - 1 holds the windows of the last 2^(k - 1)
+        // blocks, the oldest is replaced by the newest
+        const uint32_t size = (uint32_t)1 << (k - 1);
+        aggregate_t *earlier = &p->history[size + (p->t & (size - 1))];
+
+        p->scales[k] = p->scales[k - 1];
+        aggregate_merge(&p->scales[k], earlier);
+        *earlier = p->scales[k - 1];
+    }
+
+    ++p->t;
+
+    return true;
+}
+
+/*!
+ * \brief Returns the aggregates of the last window of a scale
+ *
+ * Input parameters are not checked for validity in order to maximize
+ * performance.
+ *
+ * \param[in]  p      Pointer to the window pyramid
+ * \param[in]  scale  The scale, from 0 to n_scales - 1
+ *
+ * \return Pointer to the aggregates, which are valid after
+ *         window_pyramid_update() returned true
+ */
+const aggregate_t *window_pyramid(const window_pyramid_t *p,
+    const uint32_t scale)
+{
+    return &p->scales[scale];
+}
+
+/*!
+ * \brief Merges the aggregates of all blocks into the aggregates of the
+ *        window
+ *
+ * All blocks have the same number of samples, so the mean of the window is
+ * computed first and the squared differences of the means of the blocks are
+ * added to the sum of squared differences, without dividing.
+ */
+static void merge_blocks(hopping_window_t *w)
+{
+    aggregate_t *r = &w->window;
+
+    r->n = w->n_blocks * w->hop;
+    r->sum = 0.0f;
+    r->m2 = 0.0f;
+    r->min = w->blocks[0].min;
+    r->max = w->blocks[0].max;
+    r->energy = 0.0f;
+
+    for(uint32_t i=0; i<w->n_blocks; ++i)
+    {
+        const aggregate_t *b = &w->blocks[i];
+
+        r->sum += b->sum;
+        r->min = (b->min < r->min) ? b->min : r->min;
+        r->max = (b->max > r->max) ? b->max : r->max;
+        r->energy += b->energy;
+    }
+
+    const float mean = r->sum * w->inv_length;
+    const float hop = (float)w->hop;
+
+    for(uint32_t i=0; i<w->n_blocks; ++i)
+    {
+        const float delta = (w->blocks[i].sum * w->inv_hop) - mean;
+
+        r->m2 += w->blocks[i].m2 + (hop * delta * delta);
+    }
+}
@@ -0,0 +1,130 @@
+/*! ***************************************************************************
+ *
+ * \brief     Library of functions for overlapping windows with a hop
+ * \file      window_aggregates.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _WINDOW_AGGREGATES_H_
+#define _WINDOW_AGGREGATES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*!
+ * \brief Type definition of the aggregates of a part of the data
+ */
+typedef struct
+{
+    uint32_t n;    ///< Number of samples
+    float sum;     ///< Sum
+    float m2;      ///< Sum of squared differences from the mean
+    float min;     ///< Minimum
+    float max;     ///< Maximum
+    float energy;  ///< Sum of squares
+
+}aggregate_t;
+
+/*!
+ * \brief Type definition of the state of a window that moves with a hop
+ */
+typedef struct
+{
+    // Parameters
+    aggregate_t *blocks;  ///< Aggregates of the last n_blocks hops
+    uint32_t n_blocks;    ///< Number of hops in a window
+    uint32_t hop;         ///< Number of samples in a hop
+    float inv_hop;        ///< 1.0f / hop
+    float inv_length;     ///< 1.0f / (n_blocks * hop)
+
+    // State
+    uint32_t head;        ///< Index of the block of the current hop
+    uint32_t filled;      ///< Number of completed blocks, up to n_blocks
+    uint32_t count;       ///< Number of samples in the current hop
+    float shift;         ///< First sample of the current hop
+    float s1;             ///< Sum of the current hop, minus shift
+    float s2;             ///< Sum of squares of the current hop, minus shift
+    aggregate_t window;   ///< Aggregates of the last completed window
+
+}hopping_window_t;
+
+/// Maximum number of scales of a window pyramid
+#define WINDOW_PYRAMID_N_SCALES_MAX (8)
+
+/// Number of elements of the history of a window pyramid
+#define WINDOW_PYRAMID_N_HISTORY(n_scales) ((uint32_t)1 << ((n_scales) - 1))
+
+/*!
+ * \brief Type definition of the state of windows of several scales, which
+ *        share one data stream
+ */
+typedef struct
+{
+    hopping_window_t base;  ///< Blocks of the smallest scale
+    aggregate_t *history;   ///< Block of the smallest scale, followed by the
+                            ///< last windows of all scales except the largest
+    uint32_t n_scales;      ///< Number of scales
+    uint32_t t;             ///< Number of completed blocks
+    aggregate_t scales[WINDOW_PYRAMID_N_SCALES_MAX]; ///< Aggregates of the
+                                                     ///< last window per scale
+
+}window_pyramid_t;
+
+// Functions are documented in the source file
+
+void aggregate_reset(aggregate_t *a);
+void aggregate_merge(aggregate_t *a, const aggregate_t *other);
+float aggregate_mean(const aggregate_t *a);
+float aggregate_variance(const aggregate_t *a);
+float aggregate_min(const aggregate_t *a);
+float aggregate_max(const aggregate_t *a);
+float aggregate_energy(const aggregate_t *a);
+float aggregate_peak_to_peak(const aggregate_t *a);
+
+void hopping_window_init(hopping_window_t *w, aggregate_t *blocks,
+    const uint32_t length, const uint32_t hop);
+bool hopping_window_update(hopping_window_t *w, const float data);
+const aggregate_t *hopping_window(const hopping_window_t *w);
+
+void window_pyramid_init(window_pyramid_t *p, aggregate_t *history,
+    const uint32_t length, const uint32_t n_scales);
+bool window_pyramid_update(window_pyramid_t *p, const float data);
+const aggregate_t *window_pyramid(const window_pyramid_t *p,
+    const uint32_t scale);
+
+#endif // _WINDOW_AGGREGATES_H_
+
+#ifdef __cplusplus
+}
+#endif
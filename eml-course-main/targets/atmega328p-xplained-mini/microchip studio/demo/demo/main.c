@@ -42,9 +42,34 @@
 #include "sw0.h"
 #include "usart0.h"
 
+// Uncomment to run the main loop as an event scheduler instead of polling
+// millis(). The timer interrupt posts an event every INTERVAL_MS and the
+// microcontroller sleeps in between. The utilization of the CPU is printed
+// every SCHEDULER_REPORT_MS. See lib/scheduler.c.
+//#define EVENTS
+
+#ifdef EVENTS
+#include <avr/sleep.h>
+#include "scheduler.h"
+#endif
+
+#define INTERVAL_MS (10)
+
 float angle = 0.0f;
 const float intervalAngle = (2 * 3.14159265359f / 100);
 
+#ifdef EVENTS
+
+#define SCHEDULER_REPORT_MS (10000)
+
+// Events in the order of priority
+#define EVENT_SAMPLE (0)
+#define EVENT_REPORT (1)
+
+static scheduler_t scheduler;
+
+#endif
+
 // For redirecting stdout to USART0
 int usart0_putchar(char c, FILE *stream)
 {
@@ -54,6 +79,112 @@ int usart0_putchar(char c, FILE *stream)
 
 static FILE usart0_stdout = FDEV_SETUP_STREAM(usart0_putchar, NULL, _FDEV_SETUP_WRITE);
 
+// Generates and sends a sample, ms1 is the initial timestamp
+static void sample(const uint32_t ms1)
+{
+    // Generate artificial example data
+    float acc_x_mg = 1000 * sinf(angle);
+    float acc_y_mg = 500 * sinf(angle);
+    float acc_z_mg = 100 * cosf(angle);
+
+    angle += intervalAngle;
+
+    // Set final timestamp
+    uint32_t ms2 = millis();
+
+    // Send the data
+    printf("%lu,%lu,%.1f,%.1f,%.1f\n",
+        ms1,
+        ms2,
+        (double)acc_x_mg,
+        (double)acc_y_mg,
+        (double)acc_z_mg);
+
+    // TODO Implement filter functions as required by the application.
+
+    // TODO Implement normalization functions as required by the
+    //      application.
+
+    // TODO Finish this example by designing an ML model and implement
+    //      the generated C code.
+}
+
+#ifdef EVENTS
+
+static void sample_event(void)
+{
+    // Set initial timestamp
+    sample(millis());
+}
+
+// Prints the utilization of the CPU and the statistics of the scheduler
+static void scheduler_report(void)
+{
+    const float utilization = scheduler_utilization(&scheduler);
+
+    printf("#scheduler,%lu,%.1f,%lu,%lu,%lu\n",
+        millis(),
+        (double)(100.0f * utilization),
+        scheduler.runs[EVENT_SAMPLE],
+        scheduler.sleeps,
+        scheduler.coalesced);
+}
+
+// Functions of the ATmega328P that the scheduler uses
+static void irq_disable(void)
+{
+    cli();
+}
+
+static void irq_enable(void)
+{
+    sei();
+}
+
+// Called with the interrupts disabled. Unlike WFI on a Cortex-M, a pending
+// interrupt does not wake up the AVR while the interrupts are disabled, so
+// sleep_mode() cannot be used. The instruction after sei() is executed
+// before any interrupt, so an interrupt in between the check of the
+// scheduler and sleep_cpu() wakes up the AVR.
+static void idle(void)
+{
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+}
+
+static uint32_t now_us(void)
+{
+    return (uint32_t)micros();
+}
+
+static const scheduler_port_t scheduler_port =
+{
+    irq_disable, irq_enable, idle, now_us
+};
+
+// Called from the timer interrupt every millisecond
+void millis_event(void)
+{
+    static uint16_t interval = 0;
+    static uint16_t report = 0;
+
+    if(++interval >= INTERVAL_MS)
+    {
+        interval = 0;
+        scheduler_post(&scheduler, EVENT_SAMPLE);
+    }
+
+    if(++report >= SCHEDULER_REPORT_MS)
+    {
+        report = 0;
+        scheduler_post(&scheduler, EVENT_REPORT);
+    }
+}
+
+#endif
+
 // Main application
 int main(void)
 {
@@ -70,16 +201,33 @@ int main(void)
     // Initialize the millisecond counter
     millis_init();
 
+#ifdef EVENTS
+    // The timer interrupt posts the events, so the scheduler is initialized
+    // before the interrupts are enabled. In idle sleep mode, the timer and
+    // the USART keep running.
+    scheduler_init(&scheduler, &scheduler_port);
+    scheduler_set(&scheduler, EVENT_SAMPLE, sample_event);
+    scheduler_set(&scheduler, EVENT_REPORT, scheduler_report);
+    set_sleep_mode(SLEEP_MODE_IDLE);
+#endif
+
     // Enable interrupts
     sei();
 
+    printf("Application started\n");
+
+#ifdef EVENTS
+    while(1)
+    {
+        // Runs the handlers of the posted events and sleeps until the next
+        // interrupt if there are none
+        scheduler_run(&scheduler);
+    }
+#else
     uint32_t previousmillis = 0;
     uint32_t ms1 = 0;
-    uint32_t ms2 = 0;
-    uint32_t interval = 10;
+    uint32_t interval = INTERVAL_MS;
 
-    printf("Application started\n");
-    
     while(1) 
     {
         // Set initial timestamp
@@ -90,31 +238,8 @@ int main(void)
         {
             previousmillis = ms1;
 
-            // Generate artificial example data
-            float acc_x_mg = 1000 * sinf(angle);
-            float acc_y_mg = 500 * sinf(angle);
-            float acc_z_mg = 100 * cosf(angle);
-
-            angle += intervalAngle;
-
-            // Set final timestamp
-            ms2 = millis();
-
-            // Send the data
-            printf("%lu,%lu,%.1f,%.1f,%.1f\n",
-                ms1,
-                ms2,
-                (double)acc_x_mg,
-                (double)acc_y_mg,
-                (double)acc_z_mg);
-
-            // TODO Implement filter functions as required by the application.
-
-            // TODO Implement normalization functions as required by the
-            //      application.
-
-            // TODO Finish this example by designing an ML model and implement
-            //      the generated C code.
+            sample(ms1);
         }
     }
+#endif
 }
@@ -36,11 +36,26 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
-static volatile uint32_t ms = 0;
+#include "timestamp.h"
+
+// Time from the compare match A interrupt and the counter of timer/counter 0
+static timestamp_t timestamp;
+
+static uint32_t timer0_count(void)
+{
+    return TCNT0;
+}
+
+static bool timer0_pending(void)
+{
+    return (TIFR0 & (1<<OCF0A)) != 0;
+}
 
 void millis_init(void)
 {
-    ms = 0;
+    // The counter counts up from 0 to TOP in 1 ms, so 4 us per count
+    timestamp_init(&timestamp, timer0_count, timer0_pending, 250, 1000,
+        false);
 
     // Configure Timer/counter 0 to generate an interrupt every millisecond
     //
@@ -63,19 +78,28 @@ void millis_init(void)
 // timer/counter 0 has reached its compare value
 ISR(TIMER0_COMPA_vect)
 {
-    ms++;
+    timestamp_tick(&timestamp);
+    millis_event();
+}
+
+// Called from the interrupt handler every millisecond. The application can
+// override this function, for example to post an event to a scheduler.
+__attribute__((weak)) void millis_event(void)
+{
 }
 
-inline uint32_t millis(void)
+uint32_t millis(void)
 {
-    // ms is a 32-bit variable (uint32_t). This means that multiple accesses
-    // are needed to read or write the value of ms. There is a chance that
-    // in the middle of these multiple accesses, the ms value is written due to
-    // the ISR being triggered. In order to make sure the value of ms is not
-    // updated when reading it, disable interrupts while reading the value.
-    cli();
-    uint32_t ret = ms;
-    sei();
+    // The number of ms is a 32-bit variable. This means that multiple
+    // accesses are needed to read its value. There is a chance that in the
+    // middle of these multiple accesses, the value is written due to the ISR
+    // being triggered. Instead of disabling interrupts while reading the
+    // value, the library reads it again until it has not changed.
+    return (uint32_t)timestamp_ticks(&timestamp);
+}
 
-    return ret;
+uint64_t micros(void)
+{
+    // The number of ms plus the counter, with a resolution of 4 us
+    return timestamp_us(&timestamp);
 }
@@ -36,5 +36,7 @@
 
 void millis_init(void);
 uint32_t millis(void);
+uint64_t micros(void);
+void millis_event(void);
 
 #endif /* MILLIS_H_ */
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "mma8451.h"
 #include "bsp.h"
+#include "wakeup.h"
 
 #if (CLOCK_SETUP != 1)
   #warning This driver does not work as designed
@@ -18,10 +19,26 @@ float x_out_mg = 0,
       z_out_mg = 0;
 
 bool mma8451_ready_flag = false;
+bool mma8451_motion_flag = false;
 float dt = 0;
 
+// Output data rates in Hz, selected by the DR bits of CTRL_REG1
+static const float odr_table[8] =
+{
+    800.0f, 400.0f, 200.0f, 100.0f, 50.0f, 12.5f, 6.25f, 1.5625f
+};
+
 // Local function prototypes
 void pit_init(void);
+static bool mma8451_bus_write(void *handle, const uint8_t reg,
+    const uint8_t value);
+static bool mma8451_bus_read(void *handle, const uint8_t reg, uint8_t *value);
+
+// Register access for the wake-up library
+static const wakeup_bus_t mma8451_bus =
+{
+    mma8451_bus_write, mma8451_bus_read, NULL
+};
     
 bool mma8451_init(void)
 {
@@ -164,6 +181,76 @@ bool mma8451_calibrate(void)
     return true;
 }
 
+bool mma8451_set_odr(const float odr)
+{
+    // Select the lowest ODR that is at least the requested ODR
+    uint8_t dr = 0;
+    
+    for(uint8_t i=1; i<8; i++)
+    {
+        if(odr_table[i] >= odr)
+        {
+            dr = i;
+        }
+    }
+    
+    // Standby mode, which is required to change the ODR
+    if(!(i2c0_write_byte(MMA8451_ADDRESS, CTRL_REG1, 0x00)))
+    {
+        return false;
+    } 
+    
+    // Selected ODR, Reduced noise, Active mode
+    dt = 1.0f / odr_table[dr];
+    if(!(i2c0_write_byte(MMA8451_ADDRESS, CTRL_REG1, (uint8_t)((dr<<3) | 0x05))))
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+bool mma8451_wakeup(const float threshold_mg, const float duration_ms,
+    const float odr)
+{
+    // Transient detection, routed to INT2
+    if(!wakeup_mma8451_init(&mma8451_bus, threshold_mg, duration_ms, odr))
+    {
+        return false;
+    }
+
+    // Configure the PTA15, connected to the INT2 of the MMA8451Q, for
+    // interrupts on falling edges
+    SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK;
+    PORTA->PCR[15] |= PORT_PCR_ISF_MASK | PORT_PCR_MUX(0x1)| PORT_PCR_IRQC(0xA);
+
+    // Clear an event that occurred before
+    bool motion;
+    mma8451_motion_flag = false;
+
+    return wakeup_mma8451_source(&mma8451_bus, &motion);
+}
+
+bool mma8451_drdy(const bool enable)
+{
+    if(!wakeup_mma8451_drdy(&mma8451_bus, enable))
+    {
+        return false;
+    }
+
+    // A sample that was ready before, is not processed
+    mma8451_ready_flag = false;
+
+    return true;
+}
+
+bool mma8451_motion(bool *motion)
+{
+    mma8451_motion_flag = false;
+
+    return wakeup_mma8451_source(&mma8451_bus, motion);
+}
+
 void mma8451_read(void)
 {
 	int i;
@@ -214,8 +301,54 @@ void PORTA_IRQHandler(void)
 {
     NVIC_ClearPendingIRQ(PORTA_IRQn);
     
-    // Clear the interrupt
-    PORTA->PCR[14] |= PORT_PCR_ISF_MASK;
+    // Data ready on INT1
+    if(PORTA->PCR[14] & PORT_PCR_ISF_MASK)
+    {
+        // Clear the interrupt
+        PORTA->PCR[14] |= PORT_PCR_ISF_MASK;
+
+        mma8451_ready_flag = 1;
+        mma8451_ready_event();
+    }
+
+    // Transient on INT2
+    if(PORTA->PCR[15] & PORT_PCR_ISF_MASK)
+    {
+        // Clear the interrupt
+        PORTA->PCR[15] |= PORT_PCR_ISF_MASK;
+
+        mma8451_motion_flag = 1;
+        mma8451_motion_event();
+    }
+}
+
+/*
+ * Called from the interrupt handler when data is ready. The application can
+ * override this function, for example to post an event to a scheduler.
+ */
+__WEAK void mma8451_ready_event(void)
+{
+}
+
+/*
+ * Called from the interrupt handler when motion is detected. The application
+ * can override this function.
+ */
+__WEAK void mma8451_motion_event(void)
+{
+}
+
+static bool mma8451_bus_write(void *handle, const uint8_t reg,
+    const uint8_t value)
+{
+    (void)handle;
+
+    return i2c0_write_byte(MMA8451_ADDRESS, reg, value);
+}
+
+static bool mma8451_bus_read(void *handle, const uint8_t reg, uint8_t *value)
+{
+    (void)handle;
 
-    mma8451_ready_flag = 1;	
+    return i2c0_read_byte(MMA8451_ADDRESS, reg, value);
 }
@@ -35,10 +35,18 @@ extern int16_t x_out_14_bit, y_out_14_bit, z_out_14_bit;
 extern float x_out_mg, y_out_mg, z_out_mg;
 extern float dt;
 extern bool mma8451_ready_flag;
+extern bool mma8451_motion_flag;
 
 bool mma8451_init(void);
 bool mma8451_calibrate(void);
+bool mma8451_set_odr(const float odr);
+bool mma8451_wakeup(const float threshold_mg, const float duration_ms,
+    const float odr);
+bool mma8451_drdy(const bool enable);
+bool mma8451_motion(bool *motion);
 void mma8451_read(void);
 void mma8451_rollpitch(void);
+void mma8451_ready_event(void);
+void mma8451_motion_event(void);
 
 #endif
@@ -101,6 +101,8 @@ void UART0_IRQHandler(void)
             while (1)
             {}
         }
+
+        uart0_rx_event();
     }
     if (UART0->S1 & (UART_S1_OR_MASK | UART_S1_NF_MASK | 
                      UART_S1_FE_MASK | UART_S1_PF_MASK))
@@ -112,6 +114,15 @@ void UART0_IRQHandler(void)
     }
 }
 
+/*
+ * Called from the interrupt handler when a character is received. The
+ * application can override this function, for example to post an event to a
+ * scheduler.
+ */
+__WEAK void uart0_rx_event(void)
+{
+}
+
 void uart0_send_string(char * str)
 {   
     // Enqueue string
@@ -41,5 +41,6 @@ uint32_t uart0_num_rx_chars_available(void);
 char uart0_get_char(void);
 void uart0_put_char(char c);
 void uart0_send_string(char *str);
+void uart0_rx_event(void);
 
 #endif
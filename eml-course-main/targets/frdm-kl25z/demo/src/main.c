@@ -40,12 +40,70 @@
 #include "filters.h"
 #include "normalizations.h"
 #include "temp.h"
+#include "timestamp.h"
+
+// Uncomment to benchmark the latency from sample ready to label in the BLOCK
+// and SLIDING modes. The statistics are printed every LATENCY_REPORT_MS,
+// see tools/capturing/latency_inspector.py.
+//#define LATENCY
+
+#ifdef LATENCY
+#include "latency.h"
+#endif
+
+// Uncomment to output the timestamps ms1 and ms2 in us instead of ms, for the
+// analysis of the jitter with tools/capturing/timestamp_inspector.py -u us.
+// The timestamps wrap after about 71 minutes. See lib/timestamp.c.
+//#define TIMESTAMP_US
+
+// Uncomment to sample at a low output data rate while stationary and at the
+// full output data rate while moving, and to sleep in between samples, in the
+// BLOCK and SLIDING modes. See lib/acquisition.c.
+//#define ADAPTIVE
+
+// Uncomment to let the MMA8451 detect motion in the idle mode of ADAPTIVE.
+// The data ready interrupt is disabled while idle, so the microcontroller
+// sleeps until the transient interrupt instead of reading samples at the low
+// output data rate. See lib/wakeup.c.
+//#define WAKE_ON_MOTION
+
+#if defined(WAKE_ON_MOTION) && !defined(ADAPTIVE)
+#define ADAPTIVE
+#endif
+
+#ifdef ADAPTIVE
+#include "acquisition.h"
+#endif
+
+#ifdef WAKE_ON_MOTION
+#include "wakeup.h"
+#endif
+
+// Uncomment to run the main loop as an event scheduler instead of polling.
+// The interrupt handlers post events, the handlers of the events run in the
+// order of priority and the microcontroller sleeps when no event is posted.
+// The utilization of the CPU is printed every SCHEDULER_REPORT_MS. See
+// lib/scheduler.c.
+//#define EVENTS
+
+#ifdef EVENTS
+#include "scheduler.h"
+#endif
 
 #define N_BUFFER (100)
 
 static volatile uint32_t ms = 0;
 //static volatile uint32_t prev_ms = 0;
 
+// Time in us from the SysTick interrupt and the SysTick counter
+static timestamp_t timestamp;
+
+#ifdef TIMESTAMP_US
+#define NOW() ((uint32_t)timestamp_us(&timestamp))
+#else
+#define NOW() (ms)
+#endif
+
 static uint32_t n = 0;
 static float buffer_x_out[N_BUFFER];
 static float buffer_y_out[N_BUFFER];
@@ -69,6 +127,99 @@ static float fir_x[N_FIR] = {0};
 static float fir_y[N_FIR] = {0};
 static float fir_z[N_FIR] = {0};
 
+#ifdef LATENCY
+
+#define LATENCY_REPORT_MS (10000)
+
+// Stages of the pipeline, followed by the total latency
+static const char *const latency_names[] =
+{
+    "acquisition",
+    "filtering",
+    "windowing",
+    "features",
+    "classification",
+    "output",
+    "total",
+};
+
+#define N_STAGES ((sizeof(latency_names) / sizeof(latency_names[0])) - 1)
+
+static latency_t latency;
+static uint32_t timestamps[N_STAGES + 1];
+
+// Timestamp 0 is taken when the sample is ready and timestamp i at the end
+// of stage i
+#define TIMESTAMP(i) timestamps[(i)] = (uint32_t)timestamp_us(&timestamp)
+#define LATENCY_RECORD() latency_window()
+
+#else
+
+#define TIMESTAMP(i)
+#define LATENCY_RECORD()
+
+#endif
+
+#ifdef ADAPTIVE
+
+// Output data rates in Hz, supported by the MMA8451
+#define ODR_IDLE (12.5f)
+#define ODR_ACTIVE (100.0f)
+
+// Duration of a block of the activity and the time before becoming idle
+#define ACTIVITY_BLOCK_MS (200.0f)
+#define ACTIVITY_HOLD_MS (2000.0f)
+
+// Peak-to-peak thresholds in mg of the activity, may be set by the compiler
+// The MMA8451 wakes up from the idle mode in steps of 63 mg, so the smallest
+// amplitude is 63 mg, or 126 mg peak-to-peak. With WAKE_ON_MOTION, the
+// default activity that enters the active mode matches that step, otherwise
+// activity between 60 and 126 mg would never wake up from the idle mode.
+#ifndef ACTIVITY_ENTER_MG
+#ifdef WAKE_ON_MOTION
+#define ACTIVITY_ENTER_MG (2.0f * WAKEUP_MMA8451_MG_PER_LSB)
+#else
+#define ACTIVITY_ENTER_MG (60.0f)
+#endif
+#endif
+
+#ifndef ACTIVITY_EXIT_MG
+#define ACTIVITY_EXIT_MG (30.0f)
+#endif
+
+#ifdef WAKE_ON_MOTION
+
+// Threshold in mg of the high-pass filtered acceleration that wakes up from
+// the idle mode. A peak-to-peak activity of ACTIVITY_ENTER_MG corresponds to
+// an amplitude of half that value. The threshold must be exceeded for
+// MOTION_DURATION_MS. It is rounded to a multiple of
+// WAKEUP_MMA8451_MG_PER_LSB, see wakeup_mma8451_ths().
+#ifndef MOTION_THRESHOLD_MG
+#define MOTION_THRESHOLD_MG (ACTIVITY_ENTER_MG / 2.0f)
+#endif
+
+#define MOTION_DURATION_MS (20.0f)
+
+#endif
+
+static acquisition_t acquisition;
+
+#endif
+
+#ifdef EVENTS
+
+#define SCHEDULER_REPORT_MS (10000)
+
+// Events in the order of priority
+#define EVENT_SAMPLE (0)
+#define EVENT_MOTION (1)
+#define EVENT_KEY (2)
+#define EVENT_REPORT (3)
+
+static scheduler_t scheduler;
+
+#endif
+
 // Functions for redirectiing standard output to UART0
 int stdout_putchar(int ch)
 {
@@ -86,6 +237,138 @@ int stdin_getchar(void)
     return uart0_get_char();
 }
 
+/*
+ * \brief Returns the SysTick counter, which counts down from LOAD to 0
+ */
+static uint32_t systick_count(void)
+{
+    return SysTick->VAL;
+}
+
+/*
+ * \brief Returns true if the SysTick counter wrapped and the interrupt has
+ *        not been taken yet
+ */
+static bool systick_pending(void)
+{
+    return (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+}
+
+#ifdef LATENCY
+
+/*
+ * \brief Records the timestamps of a window and prints the statistics every
+ *        LATENCY_REPORT_MS
+ *
+ * Printing takes place after the last timestamp, so it is not part of the
+ * latency of any window.
+ */
+static void latency_window(void)
+{
+    static uint32_t report_ms = 0;
+
+    latency_record(&latency, timestamps);
+
+    if((ms - report_ms) >= LATENCY_REPORT_MS)
+    {
+        report_ms = ms;
+        latency_report(&latency, latency_names);
+    }
+}
+
+#endif
+
+#ifdef ADAPTIVE
+
+/*
+ * \brief Applies a change of the mode of the acquisition controller
+ *
+ * The output data rate of the MMA8451 is changed and the window is
+ * restarted, because it must not contain samples of both rates. When the mode
+ * becomes idle, the stationary label is output once.
+ */
+static void adaptive_changed(void)
+{
+    const bool idle = (acquisition_mode(&acquisition) == ACQUISITION_IDLE);
+
+    mma8451_set_odr(acquisition_odr(&acquisition));
+    n = 0;
+
+#ifdef WAKE_ON_MOTION
+    // While idle, only the transient interrupt wakes up the microcontroller.
+    // An event that was latched while active is cleared, so the next motion
+    // generates a new interrupt.
+    mma8451_drdy(!idle);
+
+    if(idle)
+    {
+        bool motion;
+        mma8451_motion(&motion);
+    }
+#endif
+
+    printf("#acquisition,%s,%d,%d,%d\n",
+        idle ? "idle" : "active",
+        ms,
+        acquisition.samples[ACQUISITION_IDLE],
+        acquisition.samples[ACQUISITION_ACTIVE]);
+
+    if(idle)
+    {
+        rgb_green(false);
+        rgb_red(false);
+        printf("%d,%d,%s\n", ms, ms, "stationary");
+    }
+}
+
+/*
+ * \brief Updates the acquisition controller with the last sample
+ *
+ * \return True if the sample must be processed by the pipeline
+ */
+static bool adaptive_sample(void)
+{
+    const float sample[3] = {x_out_mg, y_out_mg, z_out_mg};
+
+    if(acquisition_update(&acquisition, sample))
+    {
+        adaptive_changed();
+    }
+
+    return (acquisition_mode(&acquisition) == ACQUISITION_ACTIVE);
+}
+
+#ifdef WAKE_ON_MOTION
+
+/*
+ * \brief Handles the transient interrupt of the MMA8451
+ *
+ * In the idle mode, motion makes the mode active. In the active mode, the
+ * event is left latched, so it does not interrupt again while the activity
+ * is computed from the samples.
+ */
+static void adaptive_motion(void)
+{
+    mma8451_motion_flag = false;
+
+    if(acquisition_mode(&acquisition) != ACQUISITION_IDLE)
+    {
+        return;
+    }
+
+    bool motion = false;
+    mma8451_motion(&motion);
+
+    if(motion && acquisition_set_mode(&acquisition, ACQUISITION_ACTIVE))
+    {
+        adaptive_changed();
+    }
+}
+
+#endif
+
+#endif
+
 
 typedef enum
 {
@@ -99,28 +382,33 @@ typedef enum
  * 
  * Decision tree classifier based on the following input characteristics:
  *   BLOCK_SIZE: 100
- *   BLOCK_TYPE: BLOCK
+ *   BLOCK_HOP: 100
+ * 
+ * The normalizations are folded into the thresholds. Pass these features
+ * of the data that is not normalized:
+ *   x_out_fir_rescale_variance -> x_out_fir_variance
+ *   y_out_fir_rescale_variance -> y_out_fir_variance
  * 
  * \return dtc_t
  *   0  left_right
  *   1  stationary
  *   2  up_down
  */
-dtc_t dtc(const float x_out_fir_rescale_variance, const float y_out_fir_rescale_variance)
+dtc_t dtc(const float x_out_fir_variance, const float y_out_fir_variance)
 {
     dtc_t ret;
 
-    if(x_out_fir_rescale_variance <= 0.000538f)
+    if(x_out_fir_variance <= 538.0f)
     {
          ret = stationary;
     }
-    else // x_out_fir_rescale_variance > 0.000538f
+    else // x_out_fir_variance > 538.0f
     {
-        if(y_out_fir_rescale_variance <= 0.032295f)
+        if(y_out_fir_variance <= 32295.0f)
         {
              ret = left_right;
         }
-        else // y_out_fir_rescale_variance > 0.032295f
+        else // y_out_fir_variance > 32295.0f
         {
              ret = up_down;
         }
@@ -130,12 +418,372 @@ dtc_t dtc(const float x_out_fir_rescale_variance, const float y_out_fir_rescale_
 }
 
 
+#if !defined(RAW) && !defined(BLOCK) && !defined(SLIDING)
+#define RAW
+//#define BLOCK
+//#define SLIDING
+#endif
+
+/*
+ * \brief Reads and processes a sample of the MMA8451
+ *
+ * Called when mma8451_ready_flag is set, from the main loop or as the handler
+ * of EVENT_SAMPLE.
+ */
+static void sample(void)
+{
+    uint32_t ms1 = 0;
+    uint32_t ms2 = 0;
+
+#ifdef RAW
+
+    // Handle the data as soon as new data is available
+    // mma8451 accelerometer Output Data Rate (ODR) is set to 100 Hz
+
+    // Set initial timestamp
+    ms1 = NOW();
+
+    // Clear the flag
+    mma8451_ready_flag = false;
+
+    // Reads the data in three global variables: x_out_mg, y_out_mg and
+    // z_out_mg
+    mma8451_read();
+  //float t = temp_get();
+
+    // Set final timestamp
+    ms2 = NOW();
+
+    // Send the data
+    // Send the raw data
+    printf("%d,%d,%.3f,%.3f,%.3f\n",
+        ms1,
+        ms2,
+        (double)(x_out_mg),
+        (double)(y_out_mg),
+        (double)(z_out_mg));
+
+    // TODO Implement filter function as required by the application.
+
+    // TODO Implement normalization function as required by the
+    //      application.
+
+    // TODO Finish this example by designing an ML model and implement the
+    //      generated C code.
+
+#endif
+
+#ifdef BLOCK
+
+    // Handle the data as soon as new data is available
+    // mma8451 accelerometer Output Data Rate (ODR) is set to 100 Hz
+
+    // Set initial timestamp
+    TIMESTAMP(0);
+    ms1 = NOW();
+
+    // Clear the flag
+    mma8451_ready_flag = false;
+
+    // Reads the data in three global variables: x_out_mg, y_out_mg and
+    // z_out_mg
+    mma8451_read();
+  //float t = temp_get();
+
+#ifdef ADAPTIVE
+    // While idle, only the activity is computed
+    if(!adaptive_sample())
+    {
+        return;
+    }
+#endif
+    TIMESTAMP(1);
+
+    // TODO Implement filter function as required by the application.
+
+    // Filter accelerometer data
+    x_out_mg = fir(x_out_mg, fir_coefs, fir_x, N_FIR);
+    y_out_mg = fir(y_out_mg, fir_coefs, fir_y, N_FIR);
+    z_out_mg = fir(z_out_mg, fir_coefs, fir_z, N_FIR);
+
+    // TODO Implement normalization function as required by the
+    //      application.
+
+    // The rescaling of the accelerometer data from [-1000, 1000] mg to
+    // [-1, 1] is folded into the thresholds of the decision tree, see
+    // FOLD_NORMALIZATIONS in code_generator_dtc2c.py
+    TIMESTAMP(2);
+
+    // TODO Finish this example by designing an ML model and implement
+    //      the generated C code.
+
+    // Add accelerometer data to the buffer
+    buffer_x_out[n] = x_out_mg;
+    buffer_y_out[n] = y_out_mg;
+    buffer_z_out[n] = z_out_mg;
+
+    n++;
+    TIMESTAMP(3);
+
+    // Buffer full?
+    if(n >= N_BUFFER)
+    {
+        // Reset buffer counter for next block
+        n = 0;
+
+        // Calculate features by using feature functions
+        float x_out_var = variance(buffer_x_out, N_BUFFER);
+        float y_out_var = variance(buffer_y_out, N_BUFFER);
+        TIMESTAMP(4);
+
+        // Calculate label by using the generated Decision Tree
+        // Classifier
+        dtc_t label = dtc(x_out_var, y_out_var);
+        TIMESTAMP(5);
+
+        char *label_str = "";
+
+        // Use the calculated label for further processing
+        if(label == stationary)
+        {
+             label_str = "stationary";
+             rgb_green(false);
+             rgb_red(false);
+        }
+        else if(label == up_down)
+        {
+             label_str = "up_down";
+             rgb_green(true);
+             rgb_red(false);
+        }
+        else if(label == left_right)
+        {
+             label_str = "left_right";
+             rgb_green(false);
+             rgb_red(true);
+        }
+
+        // Set final timestamp
+        ms2 = NOW();
+
+        // Print duration and label
+        printf("%d,%d,%s\n",
+            ms1,
+            ms2,
+            label_str);
+        TIMESTAMP(6);
+
+        LATENCY_RECORD();
+    }
+
+#endif
+
+#ifdef SLIDING
+
+    // Handle the data as soon as new data is available
+    // mma8451 accelerometer Output Data Rate (ODR) is set to 100 Hz
+
+    // Set initial timestamp
+    TIMESTAMP(0);
+    ms1 = NOW();
+
+    // Clear the flag
+    mma8451_ready_flag = false;
+
+    // Reads the data in three global variables: x_out_mg, y_out_mg and
+    // z_out_mg
+    mma8451_read();
+    //float t = temp_get();
+
+#ifdef ADAPTIVE
+    // While idle, only the activity is computed
+    if(!adaptive_sample())
+    {
+        return;
+    }
+#endif
+    TIMESTAMP(1);
+
+    // TODO Implement filter function as required by the application.
+
+    // Filter accelerometer data
+    x_out_mg = fir(x_out_mg, fir_coefs, fir_x, N_FIR);
+    y_out_mg = fir(y_out_mg, fir_coefs, fir_y, N_FIR);
+    z_out_mg = fir(z_out_mg, fir_coefs, fir_z, N_FIR);
+
+    // TODO Implement normalization function as required by the
+    //      application.
+
+    // The rescaling of the accelerometer data from [-1000, 1000] mg to
+    // [-1, 1] is folded into the thresholds of the decision tree, see
+    // FOLD_NORMALIZATIONS in code_generator_dtc2c.py
+    TIMESTAMP(2);
+
+    // TODO Finish this example by designing an ML model and implement
+    //      the generated C code.
+
+    // Buffer full?
+    if(n >= (N_BUFFER-1))
+    {
+        // Remove first data item in the buffer and move all others one
+        // position.
+        memmove(&buffer_x_out[0], &buffer_x_out[1], sizeof(float) * (N_BUFFER-1));
+        memmove(&buffer_y_out[0], &buffer_y_out[1], sizeof(float) * (N_BUFFER-1));
+        memmove(&buffer_z_out[0], &buffer_z_out[1], sizeof(float) * (N_BUFFER-1));
+    }
+
+    // Add accelerometer data to the buffer
+    buffer_x_out[n] = x_out_mg;
+    buffer_y_out[n] = y_out_mg;
+    buffer_z_out[n] = z_out_mg;
+
+    n++;
+    TIMESTAMP(3);
+
+    // Buffer full?
+    if(n >= N_BUFFER)
+    {
+        // Set counter at the end of the buffer
+        n = N_BUFFER-1;
+
+        // Calculate features by using feature functions
+        float x_out_var = variance(buffer_x_out, N_BUFFER);
+        float y_out_var = variance(buffer_y_out, N_BUFFER);
+        TIMESTAMP(4);
+
+        // Calculate label by using the generated Decision Tree
+        // Classifier
+        dtc_t label = dtc(x_out_var, y_out_var);
+        TIMESTAMP(5);
+
+        char *label_str = "";
+
+        // Use the calculated label for further processing
+        if(label == stationary)
+        {
+                label_str = "stationary";
+                rgb_green(false);
+                rgb_red(false);
+        }
+        else if(label == up_down)
+        {
+                label_str = "up_down";
+                rgb_green(true);
+                rgb_red(false);
+        }
+        else if(label == left_right)
+        {
+                label_str = "left_right";
+                rgb_green(false);
+                rgb_red(true);
+        }
+
+        // Set final timestamp
+        ms2 = NOW();
+
+        // Print duration and label
+        printf("%d,%d,%s\n",
+            ms1,
+            ms2,
+            label_str);
+        TIMESTAMP(6);
+
+        LATENCY_RECORD();
+    }
+
+#endif
+}
+
+/*
+ * \brief Handles the keys that the user pressed
+ */
+static void key(void)
+{
+    while(uart0_num_rx_chars_available() > 0)
+    {
+        char c = uart0_get_char();
+
+        if(c == ' ')
+        {
+            // Blink Green LED
+            rgb_green(true);
+            delay_us(1000);
+            rgb_green(false);
+        }
+    }
+}
+
+#ifdef EVENTS
+
+/*
+ * \brief Prints the utilization of the CPU and the statistics of the
+ *        scheduler every SCHEDULER_REPORT_MS
+ */
+static void scheduler_report(void)
+{
+    const float utilization = scheduler_utilization(&scheduler);
+
+    printf("#scheduler,%d,%.1f,%d,%d,%d\n",
+        ms,
+        (double)(100.0f * utilization),
+        scheduler.runs[EVENT_SAMPLE],
+        scheduler.sleeps,
+        scheduler.coalesced);
+}
+
+// Functions of the Cortex-M0+ that the scheduler uses
+static void irq_disable(void)
+{
+    __disable_irq();
+}
+
+static void irq_enable(void)
+{
+    __enable_irq();
+}
+
+static void wfi(void)
+{
+    __WFI();
+}
+
+static uint32_t now_us(void)
+{
+    return (uint32_t)timestamp_us(&timestamp);
+}
+
+static const scheduler_port_t scheduler_port =
+{
+    irq_disable, irq_enable, wfi, now_us
+};
+
+// Called from the interrupt handlers of the drivers
+void mma8451_ready_event(void)
+{
+    scheduler_post(&scheduler, EVENT_SAMPLE);
+}
+
+void mma8451_motion_event(void)
+{
+    scheduler_post(&scheduler, EVENT_MOTION);
+}
+
+void uart0_rx_event(void)
+{
+    scheduler_post(&scheduler, EVENT_KEY);
+}
+
+#endif
+
+
 int main(void)
 {
     rgb_init();
     uart0_init();
 
     // Generate SysTick interrupt every millisecond
+    timestamp_init(&timestamp, systick_count, systick_pending, 48000, 1000,
+        true);
     SysTick_Config(48000-1);
 
     // Blink Green LED
@@ -203,6 +851,24 @@ int main(void)
     printf("ODR = 100Hz\n");
     printf("+/-2g output scale\n");
 
+#ifdef WAKE_ON_MOTION
+    // Transient detection at the output data rate of the idle mode
+    if(!mma8451_wakeup(MOTION_THRESHOLD_MG, MOTION_DURATION_MS, ODR_IDLE))
+    {
+        printf("Wake-on-motion failed\n");
+    }
+
+    // Motion below the rounded threshold does not wake up from the idle mode
+    const float motion_mg = (float)wakeup_mma8451_ths(MOTION_THRESHOLD_MG) *
+        WAKEUP_MMA8451_MG_PER_LSB;
+
+    if(motion_mg > MOTION_THRESHOLD_MG)
+    {
+        printf("Warning: wake-on-motion threshold rounded up to %d mg\n",
+            (int)motion_mg);
+    }
+#endif
+
     // -------------------------------------------------------------------------
     // Internal temperature sensor initialize
     // -------------------------------------------------------------------------
@@ -218,270 +884,83 @@ int main(void)
     PORTB->PCR[0] |= PORT_PCR_MUX(1);
     PTB->PDDR |= (1<<0);
 
-    uint32_t ms1 = 0;
-    uint32_t ms2 = 0;
-
-    while(1)
-    {
-        // Check if user pressed a key
-        if(uart0_num_rx_chars_available() > 0)
-        {
-            char c = uart0_get_char();
-
-            if(c == ' ')
-            {
-                // Blink Green LED
-                rgb_green(true);
-                delay_us(1000);
-                rgb_green(false);
-            }
-        }
-
-#define RAW
-//#define BLOCK
-//#define SLIDING
-
-#ifdef RAW
+#ifdef LATENCY
+    latency_init(&latency, N_STAGES);
+#endif
 
-        // Handle the data as soon as new data is available
-        // mma8451 accelerometer Output Data Rate (ODR) is set to 100 Hz
-        if(mma8451_ready_flag)
-        {
-            // Set initial timestamp
-            ms1 = ms;
-            
-            // Clear the flag
-            mma8451_ready_flag = false;
-
-            // Reads the data in three global variables: x_out_mg, y_out_mg and
-            // z_out_mg
-            mma8451_read();
-          //float t = temp_get();
-
-            // Set final timestamp
-            ms2 = ms;
-
-            // Send the data
-            // Send the raw data
-            printf("%d,%d,%.3f,%.3f,%.3f\n",
-                ms1,
-                ms2,
-                (double)(x_out_mg),
-                (double)(y_out_mg),
-                (double)(z_out_mg));
-
-            // TODO Implement filter function as required by the application.
-
-            // TODO Implement normalization function as required by the
-            //      application.
-
-            // TODO Finish this example by designing an ML model and implement the
-            //      generated C code.
-        }
+#ifdef ADAPTIVE
+    acquisition_init(&acquisition, 3, ODR_IDLE, ODR_ACTIVE, ACTIVITY_BLOCK_MS,
+        ACTIVITY_HOLD_MS, ACTIVITY_ENTER_MG, ACTIVITY_EXIT_MG);
+#endif
 
+#ifdef EVENTS
+    // The events are posted by the interrupt handlers, so the scheduler is
+    // initialized with the interrupts disabled. A sample that became ready
+    // during the initialization is posted here.
+    __disable_irq();
+    scheduler_init(&scheduler, &scheduler_port);
+    scheduler_set(&scheduler, EVENT_SAMPLE, sample);
+#ifdef WAKE_ON_MOTION
+    scheduler_set(&scheduler, EVENT_MOTION, adaptive_motion);
 #endif
+    scheduler_set(&scheduler, EVENT_KEY, key);
+    scheduler_set(&scheduler, EVENT_REPORT, scheduler_report);
 
-#ifdef BLOCK
+    if(mma8451_ready_flag)
+    {
+        scheduler_post(&scheduler, EVENT_SAMPLE);
+    }
+    __enable_irq();
 
-        // Handle the data as soon as new data is available
-        // mma8451 accelerometer Output Data Rate (ODR) is set to 100 Hz
-        if(mma8451_ready_flag)
+    while(1)
+    {
+        // Runs the handlers of the posted events and sleeps until the next
+        // interrupt if there are none
+        scheduler_run(&scheduler);
+    }
+#else
+    while(1)
+    {
+#ifdef ADAPTIVE
+        // Sleep until the next interrupt, unless a sample is ready. An
+        // interrupt in between the check and WFI wakes up the CPU, because
+        // WFI also wakes up on an interrupt that is pending while disabled.
+        __disable_irq();
+        if(!mma8451_ready_flag && !mma8451_motion_flag)
         {
-            // Set initial timestamp
-            ms1 = ms;
-            
-            // Clear the flag
-            mma8451_ready_flag = false;
-
-            // Reads the data in three global variables: x_out_mg, y_out_mg and
-            // z_out_mg
-            mma8451_read();
-          //float t = temp_get();
-          
-            // TODO Implement filter function as required by the application.
-
-            // Filter accelerometer data
-            x_out_mg = fir(x_out_mg, fir_coefs, fir_x, N_FIR);
-            y_out_mg = fir(y_out_mg, fir_coefs, fir_y, N_FIR);
-            z_out_mg = fir(z_out_mg, fir_coefs, fir_z, N_FIR);
-            
-            // TODO Implement normalization function as required by the
-            //      application.
-
-            // Scale accelerometer data
-            const float from[2] = {-1000.0f, 1000.0f};
-            const float to[2] = {-1.0f, 1.0f};
-
-            x_out_mg = rescale(x_out_mg, from, to);
-            y_out_mg = rescale(y_out_mg, from, to);
-            z_out_mg = rescale(z_out_mg, from, to);
-            
-            // TODO Finish this example by designing an ML model and implement
-            //      the generated C code.
-
-            // Add accelerometer data to the buffer
-            buffer_x_out[n] = x_out_mg;
-            buffer_y_out[n] = y_out_mg;
-            buffer_z_out[n] = z_out_mg;
-            
-            n++;
-
-            // Buffer full?
-            if(n >= N_BUFFER)
-            {
-                // Reset buffer counter for next block
-                n = 0;
-
-                // Calculate features by using feature functions
-                float x_out_var = variance(buffer_x_out, N_BUFFER);
-                float y_out_var = variance(buffer_y_out, N_BUFFER);
-
-                // Calculate label by using the generated Decision Tree
-                // Classifier
-                dtc_t label = dtc(x_out_var, y_out_var);
-                
-                char *label_str = "";
-
-                // Use the calculated label for further processing
-                if(label == stationary)
-                {
-                     label_str = "stationary";
-                     rgb_green(false);
-                     rgb_red(false);
-                }
-                else if(label == up_down)
-                {
-                     label_str = "up_down";
-                     rgb_green(true);
-                     rgb_red(false);
-                }
-                else if(label == left_right)
-                {
-                     label_str = "left_right";
-                     rgb_green(false);
-                     rgb_red(true);
-                }
-
-                // Set final timestamp
-                ms2 = ms;
-                
-                // Print duration and label
-                printf("%d,%d,%s\n",
-                    ms1,
-                    ms2,
-                    label_str);
-            }
+            __WFI();
         }
-
+        __enable_irq();
 #endif
 
-#ifdef SLIDING
-
-    // Handle the data as soon as new data is available
-    // mma8451 accelerometer Output Data Rate (ODR) is set to 100 Hz
-    if(mma8451_ready_flag)
-    {
-        // Set initial timestamp
-        ms1 = ms;
-        
-        // Clear the flag
-        mma8451_ready_flag = false;
-
-        // Reads the data in three global variables: x_out_mg, y_out_mg and
-        // z_out_mg
-        mma8451_read();
-        //float t = temp_get();
-        
-        // TODO Implement filter function as required by the application.
-
-        // Filter accelerometer data
-        x_out_mg = fir(x_out_mg, fir_coefs, fir_x, N_FIR);
-        y_out_mg = fir(y_out_mg, fir_coefs, fir_y, N_FIR);
-        z_out_mg = fir(z_out_mg, fir_coefs, fir_z, N_FIR);
-        
-        // TODO Implement normalization function as required by the
-        //      application.
-
-        // Scale accelerometer data
-        const float from[2] = {-1000.0f, 1000.0f};
-        const float to[2] = {-1.0f, 1.0f};
-
-        x_out_mg = rescale(x_out_mg, from, to);
-        y_out_mg = rescale(y_out_mg, from, to);
-        z_out_mg = rescale(z_out_mg, from, to);
-        
-        // TODO Finish this example by designing an ML model and implement
-        //      the generated C code.
-
-        // Buffer full?
-        if(n >= (N_BUFFER-1))
+#ifdef WAKE_ON_MOTION
+        if(mma8451_motion_flag)
         {
-            // Remove first data item in the buffer and move all others one
-            // position.
-            memmove(&buffer_x_out[0], &buffer_x_out[1], sizeof(float) * (N_BUFFER-1));
-            memmove(&buffer_y_out[0], &buffer_y_out[1], sizeof(float) * (N_BUFFER-1));
-            memmove(&buffer_z_out[0], &buffer_z_out[1], sizeof(float) * (N_BUFFER-1));
+            adaptive_motion();
         }
+#endif
 
-        // Add accelerometer data to the buffer
-        buffer_x_out[n] = x_out_mg;
-        buffer_y_out[n] = y_out_mg;
-        buffer_z_out[n] = z_out_mg;
-
-        n++;
+        // Check if user pressed a key
+        key();
 
-        // Buffer full?
-        if(n >= N_BUFFER)
+        // Handle the data as soon as new data is available
+        if(mma8451_ready_flag)
         {
-            // Set counter at the end of the buffer
-            n = N_BUFFER-1;
-
-            // Calculate features by using feature functions
-            float y_out_var = variance(buffer_y_out, N_BUFFER);
-
-            // Calculate label by using the generated Decision Tree
-            // Classifier
-            dtc_t label = dtc(y_out_var);
-            
-            char *label_str = "";
-
-            // Use the calculated label for further processing
-            if(label == stationary)
-            {
-                    label_str = "stationary";
-                    rgb_green(false);
-                    rgb_red(false);
-            }
-            else if(label == up_down)
-            {
-                    label_str = "up_down";
-                    rgb_green(true);
-                    rgb_red(false);
-            }
-            else if(label == left_right)
-            {
-                    label_str = "left_right";
-                    rgb_green(false);
-                    rgb_red(true);
-            }
-
-            // Set final timestamp
-            ms2 = ms;
-            
-            // Print duration and label
-            printf("%d,%d,%s\n",
-                ms1,
-                ms2,
-                label_str);
+            sample();
         }
     }
-        
 #endif
-
-    }
 }
 
 void SysTick_Handler(void)
 {
     ms++;
+    timestamp_tick(&timestamp);
+
+#ifdef EVENTS
+    if((ms % SCHEDULER_REPORT_MS) == 0)
+    {
+        scheduler_post(&scheduler, EVENT_REPORT);
+    }
+#endif
 }
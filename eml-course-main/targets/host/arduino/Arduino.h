@@ -0,0 +1,104 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host replacement of the Arduino core header
+ * \file      Arduino.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Only the functions used by the demo applications are available. Serial is
+ * stdin and stdout and formats numbers like the Arduino Print class.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+
+#define HIGH (0x1)
+#define LOW  (0x0)
+
+#define INPUT  (0x0)
+#define OUTPUT (0x1)
+
+#define LED_BUILTIN (13)
+
+#define PI (3.1415926535897932384626433832795)
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void setup(void);
+void loop(void);
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baud);
+    int available(void);
+    int read(void);
+
+    operator bool() { return true; }
+
+    size_t print(const char *s);
+    size_t print(char c);
+    size_t print(int n);
+    size_t print(unsigned int n);
+    size_t print(long n);
+    size_t print(unsigned long n);
+    size_t print(double n, int digits = 2);
+
+    template<typename T> size_t println(T value)
+    {
+        size_t n = print(value);
+        return n + print("\r\n");
+    }
+
+    size_t println(double value, int digits = 2)
+    {
+        size_t n = print(value, digits);
+        return n + print("\r\n");
+    }
+
+    size_t println(void)
+    {
+        return print("\r\n");
+    }
+};
+
+extern HardwareSerial Serial;
+
+#endif // Arduino_h
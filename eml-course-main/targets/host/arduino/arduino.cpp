@@ -0,0 +1,221 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host implementation of the Arduino core and sensor libraries
+ * \file      arduino.cpp
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Provides main(), which calls setup() once and loop() forever like the
+ * Arduino core does. The sketch compiles and runs unchanged on the host.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <sys/ioctl.h>
+
+#include "Arduino.h"
+#include "Arduino_BMI270_BMM150.h"
+#include "Arduino_HS300x.h"
+
+/// Output data rate of the BMI270 accelerometer
+#define BMI270_ODR (100.0f)
+
+HardwareSerial Serial;
+BoschSensorClass IMU;
+HS300xClass HS300x;
+
+int main(void)
+{
+    setup();
+
+    while(1)
+    {
+        loop();
+    }
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Core
+// -----------------------------------------------------------------------------
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    (void)pin;
+    (void)val;
+}
+
+unsigned long millis(void)
+{
+    // The loop of the sketch calls this function
+    sim_poll();
+
+    return sim_millis();
+}
+
+unsigned long micros(void)
+{
+    sim_poll();
+
+    return (unsigned long)sim_micros();
+}
+
+void delay(unsigned long ms)
+{
+    sim_delay_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    sim_delay_us(us);
+}
+
+// -----------------------------------------------------------------------------
+// Serial
+// -----------------------------------------------------------------------------
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    (void)baud;
+    sim_start();
+}
+
+int HardwareSerial::available(void)
+{
+    int n = 0;
+
+    sim_poll();
+
+    return (ioctl(fileno(stdin), FIONREAD, &n) == 0) ? n : 0;
+}
+
+int HardwareSerial::read(void)
+{
+    return (available() > 0) ? getchar() : -1;
+}
+
+size_t HardwareSerial::print(const char *s)
+{
+    return (size_t)printf("%s", s);
+}
+
+size_t HardwareSerial::print(char c)
+{
+    return (size_t)printf("%c", c);
+}
+
+size_t HardwareSerial::print(int n)
+{
+    return (size_t)printf("%d", n);
+}
+
+size_t HardwareSerial::print(unsigned int n)
+{
+    return (size_t)printf("%u", n);
+}
+
+size_t HardwareSerial::print(long n)
+{
+    return (size_t)printf("%ld", n);
+}
+
+size_t HardwareSerial::print(unsigned long n)
+{
+    return (size_t)printf("%lu", n);
+}
+
+size_t HardwareSerial::print(double n, int digits)
+{
+    return (size_t)printf("%.*f", digits, n);
+}
+
+// -----------------------------------------------------------------------------
+// BMI270
+// -----------------------------------------------------------------------------
+
+int BoschSensorClass::begin(void)
+{
+    sim_sensor_start(BMI270_ODR, 3, NULL);
+
+    return 1;
+}
+
+void BoschSensorClass::end(void)
+{
+}
+
+float BoschSensorClass::accelerationSampleRate(void)
+{
+    return sim_sensor_odr();
+}
+
+int BoschSensorClass::accelerationAvailable(void)
+{
+    return sim_sensor_available() ? 1 : 0;
+}
+
+int BoschSensorClass::readAcceleration(float &x, float &y, float &z)
+{
+    float values[3];
+
+    sim_sensor_read(values);
+
+    // The simulated samples are in mg
+    x = values[0] / 1000.0f;
+    y = values[1] / 1000.0f;
+    z = values[2] / 1000.0f;
+
+    return 1;
+}
+
+// -----------------------------------------------------------------------------
+// HS300x
+// -----------------------------------------------------------------------------
+
+int HS300xClass::begin(void)
+{
+    return 1;
+}
+
+void HS300xClass::end(void)
+{
+}
+
+float HS300xClass::readTemperature(int units)
+{
+    return (units == FAHRENHEIT) ? 77.0f : 25.0f;
+}
+
+float HS300xClass::readHumidity(void)
+{
+    return 50.0f;
+}
@@ -0,0 +1,105 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host replacement of the AVR I/O header of the ATmega328P
+ * \file      io.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Only the registers and bits used by the demo application are available.
+ * The registers are plain variables, so writing them has no effect other than
+ * storing the value.
+ *
+ * avr-libc redirects stdout by assigning a stream to it. On the host, stdout
+ * is replaced by a dummy pointer, so the application keeps printing to the
+ * standard output of the process.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef _AVR_IO_H_
+#define _AVR_IO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+// avr-gcc provides sinf() and cosf() as built-in functions
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef F_CPU
+#define F_CPU (16000000UL)
+#endif
+
+extern volatile uint8_t DDRB, PORTB, PINB;
+extern volatile uint8_t TCCR0A, TCCR0B, OCR0A, TIMSK0;
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UDR0;
+extern volatile uint16_t UBRR0;
+
+// The counter and the interrupt flags of timer/counter 0 follow the simulated
+// time
+uint8_t host_tcnt0(void);
+uint8_t host_tifr0(void);
+#define TCNT0 (host_tcnt0())
+#define TIFR0 (host_tifr0())
+
+// Port B
+#define DDB5   (5)
+#define DDB7   (7)
+#define PINB7  (7)
+#define PORTB5 (5)
+
+// Timer/counter 0
+#define WGM01  (1)
+#define CS00   (0)
+#define CS01   (1)
+#define CS02   (2)
+#define OCIE0A (1)
+#define OCF0A  (1)
+
+// USART0
+#define RXEN0  (4)
+#define TXEN0  (3)
+#define RXCIE0 (7)
+#define UDRIE0 (5)
+
+// avr-libc stdio
+#define _FDEV_SETUP_READ  (0x01)
+#define _FDEV_SETUP_WRITE (0x02)
+#define _FDEV_SETUP_RW    (_FDEV_SETUP_READ | _FDEV_SETUP_WRITE)
+#define FDEV_SETUP_STREAM(p, g, f) {0}
+
+extern FILE *avr_stdout;
+
+#undef stdout
+#define stdout avr_stdout
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _AVR_IO_H_
@@ -0,0 +1,141 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host implementation of the ATmega328P peripherals
+ * \file      hal.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Together with the replacement AVR headers, main.c, millis.c and sw0.c of
+ * the Microchip Studio demo compile and run unchanged on the host, with
+ * lib/timestamp.c:
+ *
+ * - Timer/counter 0 generates the compare match A interrupt every
+ *   millisecond, as configured by millis_init(), as long as it is enabled in
+ *   TIMSK0. TCNT0 and OCF0A follow the simulated time.
+ * - USART0 is stdin and stdout. This replaces usart0.c, which depends on the
+ *   data register empty interrupt to transmit.
+ *
+ * The demo generates its own data, so it runs for SIM_DURATION seconds.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <sys/ioctl.h>
+
+#include "usart0.h"
+#include "sim.h"
+
+volatile uint8_t DDRB, PORTB, PINB;
+volatile uint8_t TCCR0A, TCCR0B, OCR0A, TIMSK0;
+volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UDR0;
+volatile uint16_t UBRR0;
+
+FILE *avr_stdout;
+
+// Local function prototypes
+static void timer0_start(void) __attribute__((constructor));
+static void timer0_isr(void);
+
+/*!
+ * \brief Starts the simulated timer/counter 0 before main() is called
+ */
+static void timer0_start(void)
+{
+    // Switch SW0 is not pressed
+    PINB = (1<<PINB7);
+
+    sim_tick_start(1000, timer0_isr);
+}
+
+/*!
+ * \brief Calls the compare match A interrupt handler if it is enabled
+ */
+static void timer0_isr(void)
+{
+    if(TIMSK0 & (1<<OCIE0A))
+    {
+        TIMER0_COMPA_vect();
+    }
+
+    // The main loop of the demo only calls millis()
+    sim_poll();
+}
+
+uint8_t host_tcnt0(void)
+{
+    // The counter counts from 0 to 249 in 1 ms, also if the interrupt has not
+    // been taken yet
+    return (uint8_t)((sim_tick_elapsed_us() % 1000) / 4);
+}
+
+uint8_t host_tifr0(void)
+{
+    // The flag is set when the counter wraps and cleared when the interrupt
+    // is taken, which can be late in the simulation
+    return (sim_tick_elapsed_us() >= 1000) ? (1<<OCF0A) : 0;
+}
+
+// -----------------------------------------------------------------------------
+// usart0
+// -----------------------------------------------------------------------------
+
+void usart0_init(void)
+{
+    UCSR0B = ((1<<RXEN0) | (1<<TXEN0) | (1<<RXCIE0));
+}
+
+char usart0_receive(void)
+{
+    const int c = getchar();
+
+    return (c == EOF) ? '\0' : (char)c;
+}
+
+void usart0_transmit(char data)
+{
+    putchar(data);
+}
+
+unsigned char usart0_nUnread(void)
+{
+    int n = 0;
+
+    if(ioctl(fileno(stdin), FIONREAD, &n) != 0)
+    {
+        n = 0;
+    }
+
+    return (n > 255) ? 255 : (unsigned char)n;
+}
+
+void usart0_transmitStr(char *str)
+{
+    while(*str)
+    {
+        usart0_transmit(*str++);
+    }
+}
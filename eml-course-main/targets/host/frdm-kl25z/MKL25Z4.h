@@ -0,0 +1,140 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host replacement of the MKL25Z4 device header
+ * \file      MKL25Z4.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Only the registers and functions used by the demo application are
+ * available. The registers are plain variables, so writing them has no
+ * effect other than storing the value.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef MKL25Z4_H
+#define MKL25Z4_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Core clock frequency in Hz
+#define DEFAULT_SYSTEM_CLOCK (48000000u)
+
+extern uint32_t SystemCoreClock;
+
+typedef struct
+{
+    volatile uint32_t PCR[32];
+
+}PORT_Type;
+
+typedef struct
+{
+    volatile uint32_t PDOR;
+    volatile uint32_t PSOR;
+    volatile uint32_t PCOR;
+    volatile uint32_t PTOR;
+    volatile uint32_t PDIR;
+    volatile uint32_t PDDR;
+
+}GPIO_Type;
+
+typedef struct
+{
+    volatile uint32_t SCGC4;
+    volatile uint32_t SCGC5;
+    volatile uint32_t SCGC6;
+
+}SIM_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+
+}SysTick_Type;
+
+typedef struct
+{
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+
+}SCB_Type;
+
+extern PORT_Type host_porta, host_portb, host_portd, host_porte;
+extern GPIO_Type host_pta, host_ptb, host_ptd, host_pte;
+extern SIM_Type host_sim;
+
+#define PORTA (&host_porta)
+#define PORTB (&host_portb)
+#define PORTD (&host_portd)
+#define PORTE (&host_porte)
+#define PTA   (&host_pta)
+#define PTB   (&host_ptb)
+#define PTD   (&host_ptd)
+#define PTE   (&host_pte)
+#define SIM   (&host_sim)
+
+// Updates the current value register of SysTick to the simulated time
+SysTick_Type *host_systick(void);
+#define SysTick (host_systick())
+
+// Updates the pending bit of SysTick to the simulated time
+SCB_Type *host_scb(void);
+#define SCB (host_scb())
+
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+#define PORT_PCR_MUX_MASK     (0x700u)
+#define PORT_PCR_MUX_SHIFT    (8u)
+#define PORT_PCR_MUX(x)       (((uint32_t)(x) << PORT_PCR_MUX_SHIFT) & PORT_PCR_MUX_MASK)
+#define PORT_PCR_ISF_MASK     (0x1000000u)
+#define PORT_PCR_IRQC(x)      (((uint32_t)(x) << 16u) & 0xF0000u)
+
+#define SIM_SCGC5_PORTA_MASK  (0x200u)
+#define SIM_SCGC5_PORTB_MASK  (0x400u)
+#define SIM_SCGC5_PORTD_MASK  (0x1000u)
+#define SIM_SCGC5_PORTE_MASK  (0x2000u)
+
+uint32_t SysTick_Config(uint32_t ticks);
+void SysTick_Handler(void);
+
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void);
+
+#define __WEAK __attribute__((weak))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MKL25Z4_H
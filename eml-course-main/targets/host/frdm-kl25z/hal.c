@@ -0,0 +1,444 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host implementation of the FRDM-KL25Z board support package
+ * \file      hal.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Replaces the drivers in ./bsp and ./temperature, so ./src/main.c compiles
+ * and runs unchanged on the host:
+ *
+ * - SysTick_Config() starts the simulated timer, which calls
+ *   SysTick_Handler() of the application. The counter and the pending bit of
+ *   SysTick follow the simulated time.
+ * - UART0 is stdin and stdout. A character on stdin calls uart0_rx_event()
+ *   when the CPU wakes up from __WFI().
+ * - The MMA8451 returns the samples of the simulated sensor in mg at an ODR of
+ *   100 Hz. The data ready interrupt sets mma8451_ready_flag and calls
+ *   mma8451_ready_event().
+ * - The wake-up functions of the MMA8451 write a register map with
+ *   lib/wakeup.c, like the driver does over I2C. The transient detection is
+ *   decoded from the register map and simulated, and sets
+ *   mma8451_motion_flag and calls mma8451_motion_event().
+ * - The RGB LED and the temperature sensor are simulated without output.
+ *
+ * The drivers are documented in the original source files.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <MKL25Z4.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+
+#include "bsp.h"
+#include "temp.h"
+#include "wakeup.h"
+#include "sim.h"
+
+/// Output data rate of the MMA8451 as configured by mma8451_init()
+#define MMA8451_ODR (100.0f)
+
+/// Cut-off frequency of the high-pass filter of the MMA8451 relative to the
+/// ODR, which is 4 Hz at 100 Hz in the normal mode
+#define MMA8451_HPF_CUTOFF (0.04f)
+
+uint32_t SystemCoreClock = DEFAULT_SYSTEM_CLOCK;
+
+PORT_Type host_porta, host_portb, host_portd, host_porte;
+GPIO_Type host_pta, host_ptb, host_ptd, host_pte;
+SIM_Type host_sim;
+
+static SysTick_Type systick;
+static SCB_Type scb;
+
+int16_t x_out_14_bit, y_out_14_bit, z_out_14_bit;
+float x_out_mg, y_out_mg, z_out_mg;
+float dt;
+bool mma8451_ready_flag;
+bool mma8451_motion_flag;
+
+/// Register map of the MMA8451
+static uint8_t mma8451_regs[0x32];
+
+/// Output data rates in Hz of the DR bits, like the driver
+static const float mma8451_odr_table[8] =
+{
+    800.0f, 400.0f, 200.0f, 100.0f, 50.0f, 12.5f, 6.25f, 1.5625f
+};
+
+// Local function prototypes
+static void mma8451_irq_handler(void);
+static void mma8451_motion_irq_handler(void);
+static bool mma8451_bus_write(void *handle, const uint8_t reg,
+    const uint8_t value);
+static bool mma8451_bus_read(void *handle, const uint8_t reg, uint8_t *value);
+
+static const wakeup_bus_t mma8451_bus =
+{
+    mma8451_bus_write, mma8451_bus_read, NULL
+};
+
+// -----------------------------------------------------------------------------
+// Core
+// -----------------------------------------------------------------------------
+
+uint32_t SysTick_Config(uint32_t ticks)
+{
+    const uint64_t period_us = ((uint64_t)(ticks + 1) * 1000000u) /
+        SystemCoreClock;
+
+    systick.LOAD = ticks;
+    systick.VAL = 0;
+    systick.CTRL = 0x7;
+
+    sim_tick_start((uint32_t)period_us, SysTick_Handler);
+
+    return 0;
+}
+
+SysTick_Type *host_systick(void)
+{
+    const uint64_t elapsed = (sim_tick_elapsed_us() * SystemCoreClock) /
+        1000000u;
+
+    // The counter reloads, also if the interrupt has not been taken yet
+    systick.VAL = (uint32_t)(systick.LOAD - (elapsed % (systick.LOAD + 1)));
+
+    return &systick;
+}
+
+SCB_Type *host_scb(void)
+{
+    const uint64_t elapsed = (sim_tick_elapsed_us() * SystemCoreClock) /
+        1000000u;
+
+    // The simulated interrupt can be late, whereas the target takes it as soon
+    // as the counter wraps. Until then, the interrupt is pending.
+    scb.ICSR = (elapsed > systick.LOAD) ? SCB_ICSR_PENDSTSET_Msk : 0;
+
+    return &scb;
+}
+
+void __disable_irq(void)
+{
+    sim_irq_disable();
+}
+
+void __enable_irq(void)
+{
+    sim_irq_enable();
+}
+
+void __WFI(void)
+{
+    int n = 0;
+
+    sim_wfi();
+
+    // stdin has no interrupt, so a received character is handled on wake-up
+    if((ioctl(fileno(stdin), FIONREAD, &n) == 0) && (n > 0))
+    {
+        uart0_rx_event();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// delay
+// -----------------------------------------------------------------------------
+
+void delay_us(uint32_t d)
+{
+    sim_delay_us(d);
+}
+
+// -----------------------------------------------------------------------------
+// rgb
+// -----------------------------------------------------------------------------
+
+void rgb_init(void)
+{
+    PTB->PDDR |= (1<<18) | (1<<19);
+    PTD->PDDR |= (1<<1);
+}
+
+void rgb_red(const bool on)
+{
+    PTB->PDOR = on ? (PTB->PDOR & ~(1u<<18)) : (PTB->PDOR | (1u<<18));
+}
+
+void rgb_green(const bool on)
+{
+    PTB->PDOR = on ? (PTB->PDOR & ~(1u<<19)) : (PTB->PDOR | (1u<<19));
+}
+
+// -----------------------------------------------------------------------------
+// uart0
+// -----------------------------------------------------------------------------
+
+void uart0_init(void)
+{
+    sim_start();
+}
+
+uint32_t uart0_num_rx_chars_available(void)
+{
+    int n = 0;
+
+    // The main loop of the application calls this function
+    sim_poll();
+
+    if(ioctl(fileno(stdin), FIONREAD, &n) != 0)
+    {
+        n = 0;
+    }
+
+    return (uint32_t)n;
+}
+
+char uart0_get_char(void)
+{
+    const int c = getchar();
+
+    return (c == EOF) ? '\0' : (char)c;
+}
+
+void uart0_put_char(char c)
+{
+    putchar(c);
+}
+
+void uart0_send_string(char *str)
+{
+    fputs(str, stdout);
+}
+
+__WEAK void uart0_rx_event(void)
+{
+}
+
+// -----------------------------------------------------------------------------
+// mma8451
+// -----------------------------------------------------------------------------
+
+bool mma8451_init(void)
+{
+    // The configuration of mma8451_calibrate(): ODR = 100 Hz, reduced noise,
+    // active mode, high resolution mode, DRDY interrupt routed to INT1
+    mma8451_regs[CTRL_REG1] = 0x1D;
+    mma8451_regs[WAKEUP_MMA8451_CTRL_REG2] = WAKEUP_MMA8451_MODS_HR;
+    mma8451_regs[CTRL_REG4] = 0x01;
+    mma8451_regs[CTRL_REG5] = 0x01;
+
+    sim_sensor_start(MMA8451_ODR, 3, mma8451_irq_handler);
+
+    return true;
+}
+
+bool mma8451_calibrate(void)
+{
+    // Wait for data, like the driver does
+    while(!mma8451_ready_flag)
+    {
+        sim_delay_us(100);
+    }
+
+    dt = 1.0f / sim_sensor_odr();
+
+    return true;
+}
+
+bool mma8451_set_odr(const float odr)
+{
+    uint8_t dr = 0;
+
+    for(uint8_t i=1; i<8; i++)
+    {
+        dr = (mma8451_odr_table[i] >= odr) ? i : dr;
+    }
+
+    dt = 1.0f / mma8451_odr_table[dr];
+    mma8451_regs[CTRL_REG1] = (uint8_t)((dr<<3) | 0x05);
+    sim_sensor_set_odr(mma8451_odr_table[dr]);
+
+    return true;
+}
+
+bool mma8451_wakeup(const float threshold_mg, const float duration_ms,
+    const float odr)
+{
+    bool motion;
+
+    if(!wakeup_mma8451_init(&mma8451_bus, threshold_mg, duration_ms, odr))
+    {
+        return false;
+    }
+
+    mma8451_motion_flag = false;
+
+    return wakeup_mma8451_source(&mma8451_bus, &motion);
+}
+
+bool mma8451_drdy(const bool enable)
+{
+    if(!wakeup_mma8451_drdy(&mma8451_bus, enable))
+    {
+        return false;
+    }
+
+    mma8451_ready_flag = false;
+
+    return true;
+}
+
+bool mma8451_motion(bool *motion)
+{
+    mma8451_motion_flag = false;
+
+    return wakeup_mma8451_source(&mma8451_bus, motion);
+}
+
+void mma8451_read(void)
+{
+    float values[3];
+
+    sim_sensor_read(values);
+
+    // Quantize like the 14-bit output at +/-2g
+    x_out_14_bit = (int16_t)(values[0] * COUNTS_PER_G / 1000.0f);
+    y_out_14_bit = (int16_t)(values[1] * COUNTS_PER_G / 1000.0f);
+    z_out_14_bit = (int16_t)(values[2] * COUNTS_PER_G / 1000.0f);
+
+    x_out_mg = ((float)x_out_14_bit / COUNTS_PER_G) * 1000;
+    y_out_mg = ((float)y_out_14_bit / COUNTS_PER_G) * 1000;
+    z_out_mg = ((float)z_out_14_bit / COUNTS_PER_G) * 1000;
+}
+
+void mma8451_rollpitch(void)
+{
+}
+
+/*!
+ * \brief Simulated data ready interrupt of the MMA8451
+ */
+static void mma8451_irq_handler(void)
+{
+    mma8451_ready_flag = 1;
+    mma8451_ready_event();
+}
+
+/*!
+ * \brief Simulated transient interrupt of the MMA8451 on INT2
+ */
+static void mma8451_motion_irq_handler(void)
+{
+    mma8451_motion_flag = 1;
+    mma8451_motion_event();
+}
+
+__WEAK void mma8451_ready_event(void)
+{
+}
+
+__WEAK void mma8451_motion_event(void)
+{
+}
+
+/*!
+ * \brief Writes a register of the register map
+ *
+ * When the sensor becomes active, the interrupts are configured from the
+ * register map, like the sensor does.
+ */
+static bool mma8451_bus_write(void *handle, const uint8_t reg,
+    const uint8_t value)
+{
+    (void)handle;
+
+    if(reg >= sizeof(mma8451_regs))
+    {
+        return false;
+    }
+
+    mma8451_regs[reg] = value;
+
+    if((reg == CTRL_REG1) && (value & 0x01))
+    {
+        const uint8_t ctrl_reg4 = mma8451_regs[CTRL_REG4];
+        const bool transient = (ctrl_reg4 & 0x20) &&
+            (mma8451_regs[WAKEUP_MMA8451_TRANSIENT_CFG] & 0x0E);
+
+        sim_sensor_ready_irq((ctrl_reg4 & 0x01) != 0);
+
+        // The simulation counts samples, the debounce counter of the sensor
+        // counts with the period of the oversampling mode
+        const float odr = mma8451_odr_table[(value >> 3) & 0x07];
+        const float count_ms = (float)mma8451_regs[
+            WAKEUP_MMA8451_TRANSIENT_COUNT] * wakeup_mma8451_count_ms(odr,
+            mma8451_regs[WAKEUP_MMA8451_CTRL_REG2]);
+        const uint32_t count = (uint32_t)((count_ms * odr / 1000.0f) + 0.5f);
+
+        // The transient threshold is 7 bits
+        sim_motion_start(transient ? ((float)(mma8451_regs[
+            WAKEUP_MMA8451_TRANSIENT_THS] & 0x7F) * WAKEUP_MMA8451_MG_PER_LSB) :
+            0.0f, count, MMA8451_HPF_CUTOFF, mma8451_motion_irq_handler);
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Reads a register of the register map
+ *
+ * Reading TRANSIENT_SRC clears the latched event.
+ */
+static bool mma8451_bus_read(void *handle, const uint8_t reg, uint8_t *value)
+{
+    (void)handle;
+
+    if(reg >= sizeof(mma8451_regs))
+    {
+        return false;
+    }
+
+    *value = (reg == WAKEUP_MMA8451_TRANSIENT_SRC) ?
+        (sim_motion_ack() ? 0x40 : 0x00) : mma8451_regs[reg];
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// temperature
+// -----------------------------------------------------------------------------
+
+void temp_init(void)
+{
+}
+
+float temp_get(void)
+{
+    return 25.0f;
+}
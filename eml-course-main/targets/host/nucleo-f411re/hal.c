@@ -0,0 +1,499 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host implementation of the NUCLEO-F411RE HAL and sensor drivers
+ * \file      hal.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Replaces the STM32 HAL, the CubeMX peripheral initialization and the
+ * STMems drivers, so ./Core/Src/main.c compiles and runs unchanged on the
+ * host:
+ *
+ * - The SysTick interrupt increments the tick returned by HAL_GetTick().
+ *   The application can override HAL_IncTick(), like with the HAL. The
+ *   counter and the pending bit of SysTick follow the simulated time.
+ * - USART2 is stdin and stdout.
+ * - The LSM6DSO returns the samples of the simulated sensor at the
+ *   configured ODR and full scale.
+ * - The LSM6DSO registers written over I2C, for example by lib/wakeup.c, are
+ *   stored in a register map. The wake-up detection is decoded from the
+ *   register map and simulated, and calls HAL_GPIO_EXTI_Callback() for INT1.
+ * - The STTS751 returns a constant temperature.
+ *
+ * The I2C functions of other devices are not used by the simulated drivers
+ * and always fail.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <sys/ioctl.h>
+
+#include "main.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "usart.h"
+#include "lsm6dso_reg.h"
+#include "stts751_reg.h"
+#include "wakeup.h"
+#include "sim.h"
+
+GPIO_TypeDef host_gpioa, host_gpiob, host_gpioc;
+
+I2C_HandleTypeDef hi2c1;
+UART_HandleTypeDef huart2;
+
+/// System clock as configured by SystemClock_Config()
+uint32_t SystemCoreClock = 100000000u;
+
+volatile uint32_t uwTick = 0;
+HAL_TickFreqTypeDef uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+
+static SysTick_Type systick;
+static SCB_Type scb;
+
+static const float lsm6dso_odr[] =
+{
+    0.0f, 12.5f, 26.0f, 52.0f, 104.0f, 208.0f, 417.0f, 833.0f, 1667.0f,
+    3333.0f, 6667.0f, 1.6f,
+};
+
+/// Configured ODR of the accelerometer
+static float lsm6dso_xl_odr = 0.0f;
+
+/// Full scale of the accelerometer in mg
+static float lsm6dso_xl_fs_mg = 2000.0f;
+
+/// Register map of the LSM6DSO
+static uint8_t lsm6dso_regs[0x80];
+
+/// Cut-off frequency relative to the ODR of the high-pass filter that
+/// approximates the slope filter of the wake-up detection
+#define LSM6DSO_SLOPE_CUTOFF (0.25f)
+
+// Local function prototypes
+static void lsm6dso_wakeup_update(void);
+static void lsm6dso_int1_handler(void);
+
+// -----------------------------------------------------------------------------
+// HAL
+// -----------------------------------------------------------------------------
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    // SysTick interrupt every millisecond
+    systick.LOAD = (SystemCoreClock / 1000u) - 1;
+    systick.VAL = 0;
+    systick.CTRL = 0x7;
+
+    sim_tick_start(1000, HAL_IncTick);
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_IncTick(void)
+{
+    uwTick += uwTickFreq;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    sim_delay_us((uint64_t)Delay * 1000);
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    (void)RCC_OscInitStruct;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct,
+    uint32_t FLatency)
+{
+    (void)RCC_ClkInitStruct;
+    (void)FLatency;
+
+    return HAL_OK;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+    uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+    GPIO_PinState PinState)
+{
+    GPIOx->ODR = (PinState == GPIO_PIN_SET) ?
+        (GPIOx->ODR | GPIO_Pin) : (GPIOx->ODR & ~(uint32_t)GPIO_Pin);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart,
+    const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)huart;
+    (void)Timeout;
+
+    fwrite(pData, 1, Size, stdout);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData,
+    uint16_t Size, uint32_t Timeout)
+{
+    int n = 0;
+
+    (void)huart;
+    (void)Timeout;
+
+    // The main loop of the application calls this function
+    sim_poll();
+
+    if((ioctl(fileno(stdin), FIONREAD, &n) != 0) || (n < Size))
+    {
+        return HAL_TIMEOUT;
+    }
+
+    return (fread(pData, 1, Size, stdin) == Size) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c,
+    uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize,
+    uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)MemAddSize;
+    (void)Timeout;
+
+    if((DevAddress != LSM6DSO_I2C_ADD_H) ||
+       ((MemAddress + Size) > sizeof(lsm6dso_regs)))
+    {
+        return HAL_ERROR;
+    }
+
+    for(uint16_t i=0; i<Size; ++i)
+    {
+        lsm6dso_regs[MemAddress + i] = pData[i];
+    }
+
+    lsm6dso_wakeup_update();
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c,
+    uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize,
+    uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)MemAddSize;
+    (void)Timeout;
+
+    if((DevAddress != LSM6DSO_I2C_ADD_H) ||
+       ((MemAddress + Size) > sizeof(lsm6dso_regs)))
+    {
+        return HAL_ERROR;
+    }
+
+    for(uint16_t i=0; i<Size; ++i)
+    {
+        // Reading WAKE_UP_SRC clears the latched event
+        pData[i] = ((MemAddress + i) == WAKEUP_LSM6DSO_WAKE_UP_SRC) ?
+            (sim_motion_ack() ? 0x08 : 0x00) : lsm6dso_regs[MemAddress + i];
+    }
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+SysTick_Type *host_systick(void)
+{
+    const uint64_t elapsed = (sim_tick_elapsed_us() * SystemCoreClock) /
+        1000000u;
+
+    // The counter reloads, also if the interrupt has not been taken yet
+    systick.VAL = (uint32_t)(systick.LOAD - (elapsed % (systick.LOAD + 1)));
+
+    return &systick;
+}
+
+SCB_Type *host_scb(void)
+{
+    const uint64_t elapsed = (sim_tick_elapsed_us() * SystemCoreClock) /
+        1000000u;
+
+    // The simulated interrupt can be late, whereas the target takes it as soon
+    // as the counter wraps. Until then, the interrupt is pending.
+    scb.ICSR = (elapsed > systick.LOAD) ? SCB_ICSR_PENDSTSET_Msk : 0;
+
+    return &scb;
+}
+
+void __disable_irq(void)
+{
+    sim_irq_disable();
+}
+
+void __enable_irq(void)
+{
+    sim_irq_enable();
+}
+
+void __WFI(void)
+{
+    sim_wfi();
+}
+
+// -----------------------------------------------------------------------------
+// CubeMX peripheral initialization
+// -----------------------------------------------------------------------------
+
+void MX_GPIO_Init(void)
+{
+}
+
+void MX_USART2_UART_Init(void)
+{
+}
+
+void MX_I2C1_Init(void)
+{
+}
+
+// -----------------------------------------------------------------------------
+// LSM6DSO
+// -----------------------------------------------------------------------------
+
+float_t lsm6dso_from_fs2_to_mg(int16_t lsb)
+{
+    return ((float_t)lsb) * 0.061f;
+}
+
+int32_t lsm6dso_device_id_get(stmdev_ctx_t *ctx, uint8_t *buff)
+{
+    (void)ctx;
+    *buff = LSM6DSO_ID;
+
+    return 0;
+}
+
+int32_t lsm6dso_reset_set(stmdev_ctx_t *ctx, uint8_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t lsm6dso_reset_get(stmdev_ctx_t *ctx, uint8_t *val)
+{
+    (void)ctx;
+    *val = 0;
+
+    return 0;
+}
+
+int32_t lsm6dso_i3c_disable_set(stmdev_ctx_t *ctx, lsm6dso_i3c_disable_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t lsm6dso_block_data_update_set(stmdev_ctx_t *ctx, uint8_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t lsm6dso_xl_data_rate_set(stmdev_ctx_t *ctx, lsm6dso_odr_xl_t val)
+{
+    (void)ctx;
+    const bool on = (lsm6dso_xl_odr > 0.0f);
+    lsm6dso_xl_odr = lsm6dso_odr[val];
+
+    if(on && (lsm6dso_xl_odr > 0.0f))
+    {
+        sim_sensor_set_odr(lsm6dso_xl_odr);
+    }
+    else if(lsm6dso_xl_odr > 0.0f)
+    {
+        // The samples are available by polling the status register
+        sim_sensor_start(lsm6dso_xl_odr, 3, NULL);
+    }
+
+    return 0;
+}
+
+int32_t lsm6dso_gy_data_rate_set(stmdev_ctx_t *ctx, lsm6dso_odr_g_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t lsm6dso_xl_full_scale_set(stmdev_ctx_t *ctx, lsm6dso_fs_xl_t val)
+{
+    const float fs_mg[] = {2000.0f, 16000.0f, 4000.0f, 8000.0f};
+
+    (void)ctx;
+    lsm6dso_xl_fs_mg = fs_mg[val];
+
+    return 0;
+}
+
+int32_t lsm6dso_gy_full_scale_set(stmdev_ctx_t *ctx, lsm6dso_fs_g_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t lsm6dso_xl_flag_data_ready_get(stmdev_ctx_t *ctx, uint8_t *val)
+{
+    (void)ctx;
+    *val = sim_sensor_available() ? 1 : 0;
+
+    return 0;
+}
+
+int32_t lsm6dso_acceleration_raw_get(stmdev_ctx_t *ctx, int16_t *val)
+{
+    float values[3];
+
+    (void)ctx;
+    sim_sensor_read(values);
+
+    // Quantize and saturate like the 16-bit output at the full scale
+    for(uint32_t i=0; i<3; ++i)
+    {
+        float lsb = values[i] * 32768.0f / lsm6dso_xl_fs_mg;
+        lsb = (lsb < -32768.0f) ? -32768.0f : lsb;
+        lsb = (lsb > 32767.0f) ? 32767.0f : lsb;
+        val[i] = (int16_t)lsb;
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Configures the simulated wake-up detection from the register map
+ *
+ * The wake-up interrupt is enabled by INTERRUPTS_ENABLE in TAP_CFG2 and
+ * routed to INT1 by INT1_WU in MD1_CFG. The threshold is WK_THS in
+ * WAKE_UP_THS, in full scale / 256 if WAKE_THS_W is set and full scale / 64
+ * otherwise, and the duration is WAKE_DUR in WAKE_UP_DUR.
+ */
+static void lsm6dso_wakeup_update(void)
+{
+    const uint8_t dur = lsm6dso_regs[WAKEUP_LSM6DSO_WAKE_UP_DUR];
+    const bool enabled =
+        (lsm6dso_regs[WAKEUP_LSM6DSO_TAP_CFG2] & 0x80) &&
+        (lsm6dso_regs[WAKEUP_LSM6DSO_MD1_CFG] & 0x20);
+
+    const float lsb_mg = lsm6dso_xl_fs_mg / ((dur & 0x10) ? 256.0f : 64.0f);
+    const float threshold_mg = (float)(lsm6dso_regs[
+        WAKEUP_LSM6DSO_WAKE_UP_THS] & 0x3F) * lsb_mg;
+
+    sim_motion_start(enabled ? threshold_mg : 0.0f, (dur >> 5) & 0x03,
+        LSM6DSO_SLOPE_CUTOFF, lsm6dso_int1_handler);
+}
+
+/*!
+ * \brief Simulated wake-up interrupt on INT1 of the LSM6DSO
+ */
+static void lsm6dso_int1_handler(void)
+{
+    HAL_GPIO_EXTI_Callback(LSM6DSM_INT1_Pin);
+}
+
+// -----------------------------------------------------------------------------
+// STTS751
+// -----------------------------------------------------------------------------
+
+float_t stts751_from_lsb_to_celsius(int16_t lsb)
+{
+    return ((float_t)lsb) / 256.0f;
+}
+
+int32_t stts751_device_id_get(stmdev_ctx_t *ctx, stts751_id_t *buff)
+{
+    (void)ctx;
+    buff->product_id = STTS751_ID_1xxxx;
+    buff->manufacturer_id = STTS751_ID_MAN;
+    buff->revision_id = STTS751_REV;
+
+    return 0;
+}
+
+int32_t stts751_temp_data_rate_set(stmdev_ctx_t *ctx, stts751_odr_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t stts751_resolution_set(stmdev_ctx_t *ctx, stts751_tres_t val)
+{
+    (void)ctx;
+    (void)val;
+
+    return 0;
+}
+
+int32_t stts751_temperature_raw_get(stmdev_ctx_t *ctx, int16_t *buff)
+{
+    (void)ctx;
+
+    // 25 degrees Celsius
+    *buff = 25 * 256;
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host replacement of the LSM6DSO driver header
+ * \file      lsm6dso_reg.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Declares the subset of the STMems standard C driver used by the demo
+ * application. The functions are implemented by the simulator in hal.c.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef LSM6DSO_REGS_H
+#define LSM6DSO_REGS_H
+
+#include <math.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MEMS_SHARED_TYPES
+#define MEMS_SHARED_TYPES
+
+typedef int32_t (*stmdev_write_ptr)(void *, uint8_t, const uint8_t *, uint16_t);
+typedef int32_t (*stmdev_read_ptr)(void *, uint8_t, uint8_t *, uint16_t);
+typedef void (*stmdev_mdelay_ptr)(uint32_t millisec);
+
+typedef struct
+{
+    stmdev_write_ptr write_reg;
+    stmdev_read_ptr read_reg;
+    stmdev_mdelay_ptr mdelay;
+    void *handle;
+
+}stmdev_ctx_t;
+
+#define PROPERTY_DISABLE (0U)
+#define PROPERTY_ENABLE  (1U)
+
+#endif // MEMS_SHARED_TYPES
+
+#define LSM6DSO_I2C_ADD_L (0xD5U)
+#define LSM6DSO_I2C_ADD_H (0xD7U)
+#define LSM6DSO_ID        (0x6CU)
+
+typedef enum
+{
+    LSM6DSO_I3C_DISABLE = 0x80,
+
+}lsm6dso_i3c_disable_t;
+
+typedef enum
+{
+    LSM6DSO_XL_ODR_OFF    = 0,
+    LSM6DSO_XL_ODR_12Hz5  = 1,
+    LSM6DSO_XL_ODR_26Hz   = 2,
+    LSM6DSO_XL_ODR_52Hz   = 3,
+    LSM6DSO_XL_ODR_104Hz  = 4,
+    LSM6DSO_XL_ODR_208Hz  = 5,
+    LSM6DSO_XL_ODR_417Hz  = 6,
+    LSM6DSO_XL_ODR_833Hz  = 7,
+    LSM6DSO_XL_ODR_1667Hz = 8,
+    LSM6DSO_XL_ODR_3333Hz = 9,
+    LSM6DSO_XL_ODR_6667Hz = 10,
+    LSM6DSO_XL_ODR_1Hz6   = 11,
+
+}lsm6dso_odr_xl_t;
+
+typedef enum
+{
+    LSM6DSO_GY_ODR_OFF    = 0,
+    LSM6DSO_GY_ODR_104Hz  = 4,
+
+}lsm6dso_odr_g_t;
+
+typedef enum
+{
+    LSM6DSO_2g  = 0,
+    LSM6DSO_16g = 1,
+    LSM6DSO_4g  = 2,
+    LSM6DSO_8g  = 3,
+
+}lsm6dso_fs_xl_t;
+
+typedef enum
+{
+    LSM6DSO_250dps  = 0,
+    LSM6DSO_125dps  = 1,
+    LSM6DSO_500dps  = 2,
+    LSM6DSO_1000dps = 4,
+    LSM6DSO_2000dps = 6,
+
+}lsm6dso_fs_g_t;
+
+float_t lsm6dso_from_fs2_to_mg(int16_t lsb);
+
+int32_t lsm6dso_device_id_get(stmdev_ctx_t *ctx, uint8_t *buff);
+int32_t lsm6dso_reset_set(stmdev_ctx_t *ctx, uint8_t val);
+int32_t lsm6dso_reset_get(stmdev_ctx_t *ctx, uint8_t *val);
+int32_t lsm6dso_i3c_disable_set(stmdev_ctx_t *ctx, lsm6dso_i3c_disable_t val);
+int32_t lsm6dso_block_data_update_set(stmdev_ctx_t *ctx, uint8_t val);
+int32_t lsm6dso_xl_data_rate_set(stmdev_ctx_t *ctx, lsm6dso_odr_xl_t val);
+int32_t lsm6dso_gy_data_rate_set(stmdev_ctx_t *ctx, lsm6dso_odr_g_t val);
+int32_t lsm6dso_xl_full_scale_set(stmdev_ctx_t *ctx, lsm6dso_fs_xl_t val);
+int32_t lsm6dso_gy_full_scale_set(stmdev_ctx_t *ctx, lsm6dso_fs_g_t val);
+int32_t lsm6dso_xl_flag_data_ready_get(stmdev_ctx_t *ctx, uint8_t *val);
+int32_t lsm6dso_acceleration_raw_get(stmdev_ctx_t *ctx, int16_t *val);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LSM6DSO_REGS_H
@@ -0,0 +1,227 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host replacement of the STM32F4xx HAL header
+ * \file      stm32f4xx_hal.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Only the types, constants and functions used by the demo application are
+ * available.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U,
+
+}HAL_StatusTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET,
+
+}GPIO_PinState;
+
+typedef enum
+{
+    EXTI0_IRQn      = 6,
+    EXTI4_IRQn      = 10,
+    EXTI9_5_IRQn    = 23,
+    USART2_IRQn     = 38,
+    EXTI15_10_IRQn  = 40,
+
+}IRQn_Type;
+
+typedef enum
+{
+    HAL_TICK_FREQ_1KHZ    = 1U,
+    HAL_TICK_FREQ_DEFAULT = HAL_TICK_FREQ_1KHZ,
+
+}HAL_TickFreqTypeDef;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+
+}SysTick_Type;
+
+typedef struct
+{
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+
+}SCB_Type;
+
+// Updates the current value register of SysTick to the simulated time
+SysTick_Type *host_systick(void);
+#define SysTick (host_systick())
+
+// Updates the pending bit of SysTick to the simulated time
+SCB_Type *host_scb(void);
+#define SCB (host_scb())
+
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+typedef struct
+{
+    volatile uint32_t ODR;
+
+}GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    struct
+    {
+        uint32_t PLLState;
+        uint32_t PLLSource;
+        uint32_t PLLM;
+        uint32_t PLLN;
+        uint32_t PLLP;
+        uint32_t PLLQ;
+    }PLL;
+
+}RCC_OscInitTypeDef;
+
+typedef struct
+{
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+
+}RCC_ClkInitTypeDef;
+
+typedef struct
+{
+    uint32_t Instance;
+
+}I2C_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t Instance;
+
+}UART_HandleTypeDef;
+
+extern GPIO_TypeDef host_gpioa, host_gpiob, host_gpioc;
+
+#define GPIOA (&host_gpioa)
+#define GPIOB (&host_gpiob)
+#define GPIOC (&host_gpioc)
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+
+#define HAL_MAX_DELAY           (0xFFFFFFFFU)
+#define I2C_MEMADD_SIZE_8BIT    (0x00000001U)
+
+#define RCC_OSCILLATORTYPE_HSE  (0x00000001U)
+#define RCC_HSE_ON              (0x00010000U)
+#define RCC_PLL_ON              (0x00000002U)
+#define RCC_PLLSOURCE_HSE       (0x00400000U)
+#define RCC_PLLP_DIV2           (0x00000002U)
+#define RCC_CLOCKTYPE_SYSCLK    (0x00000001U)
+#define RCC_CLOCKTYPE_HCLK      (0x00000002U)
+#define RCC_CLOCKTYPE_PCLK1     (0x00000004U)
+#define RCC_CLOCKTYPE_PCLK2     (0x00000008U)
+#define RCC_SYSCLKSOURCE_PLLCLK (0x00000002U)
+#define RCC_SYSCLK_DIV1         (0x00000000U)
+#define RCC_HCLK_DIV1           (0x00000000U)
+#define RCC_HCLK_DIV4           (0x00001400U)
+#define FLASH_LATENCY_3         (0x00000003U)
+#define PWR_REGULATOR_VOLTAGE_SCALE1 (0x0000C000U)
+
+#define __HAL_RCC_PWR_CLK_ENABLE()            do{}while(0)
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(x)    do{(void)(x);}while(0)
+
+extern uint32_t SystemCoreClock;
+extern volatile uint32_t uwTick;
+extern HAL_TickFreqTypeDef uwTickFreq;
+
+HAL_StatusTypeDef HAL_Init(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_IncTick(void);
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct,
+    uint32_t FLatency);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+    uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+    GPIO_PinState PinState);
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart,
+    const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData,
+    uint16_t Size, uint32_t Timeout);
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c,
+    uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize,
+    uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c,
+    uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize,
+    uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F4XX_HAL_H
@@ -0,0 +1,108 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host replacement of the STTS751 driver header
+ * \file      stts751_reg.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * Declares the subset of the STMems standard C driver used by the demo
+ * application. The functions are implemented by the simulator in hal.c.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef STTS751_REGS_H
+#define STTS751_REGS_H
+
+#include <math.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MEMS_SHARED_TYPES
+#define MEMS_SHARED_TYPES
+
+typedef int32_t (*stmdev_write_ptr)(void *, uint8_t, const uint8_t *, uint16_t);
+typedef int32_t (*stmdev_read_ptr)(void *, uint8_t, uint8_t *, uint16_t);
+typedef void (*stmdev_mdelay_ptr)(uint32_t millisec);
+
+typedef struct
+{
+    stmdev_write_ptr write_reg;
+    stmdev_read_ptr read_reg;
+    stmdev_mdelay_ptr mdelay;
+    void *handle;
+
+}stmdev_ctx_t;
+
+#define PROPERTY_DISABLE (0U)
+#define PROPERTY_ENABLE  (1U)
+
+#endif // MEMS_SHARED_TYPES
+
+#define STTS751_1xxxx_ADD_7K5 (0x91U)
+#define STTS751_ID_0xxxx      (0x00U)
+#define STTS751_ID_1xxxx      (0x01U)
+#define STTS751_ID_MAN        (0x53U)
+#define STTS751_REV           (0x01U)
+
+typedef struct
+{
+    uint8_t product_id;
+    uint8_t manufacturer_id;
+    uint8_t revision_id;
+
+}stts751_id_t;
+
+typedef enum
+{
+    STTS751_TEMP_ODR_OFF = 0x80,
+    STTS751_TEMP_ODR_1Hz = 0x04,
+
+}stts751_odr_t;
+
+typedef enum
+{
+    STTS751_9bit  = 2,
+    STTS751_10bit = 0,
+    STTS751_11bit = 1,
+    STTS751_12bit = 3,
+
+}stts751_tres_t;
+
+float_t stts751_from_lsb_to_celsius(int16_t lsb);
+
+int32_t stts751_device_id_get(stmdev_ctx_t *ctx, stts751_id_t *buff);
+int32_t stts751_temp_data_rate_set(stmdev_ctx_t *ctx, stts751_odr_t val);
+int32_t stts751_resolution_set(stmdev_ctx_t *ctx, stts751_tres_t val);
+int32_t stts751_temperature_raw_get(stmdev_ctx_t *ctx, int16_t *buff);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STTS751_REGS_H
@@ -0,0 +1,993 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host simulator of the sensors and timers of the targets
+ * \file      sim.c
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * The simulator makes it possible to run the application of a target as a
+ * Linux executable. The target specific host drivers use it to replace the
+ * hardware:
+ *
+ * - A background thread acts as the interrupt controller. It calls the timer
+ *   interrupt handler of the target, for example SysTick_Handler(), and
+ *   signals that the sensor has new data. sim_irq_disable() and
+ *   sim_irq_enable() block it, just like disabling interrupts does.
+ * - The sensor replays a CSV file from tools/data/captured or generates a
+ *   synthetic signal, at a configurable output data rate (ODR) with timing
+ *   jitter. The application can change the ODR with sim_sensor_set_odr().
+ *   The data keeps its original rate, so rows are skipped at a lower ODR.
+ * - The sensor can detect motion like the wake-up engines of accelerometers,
+ *   see sim_motion_start(). The data ready interrupt can be masked with
+ *   sim_sensor_ready_irq(), so the application only wakes up on motion.
+ * - sim_wfi() sleeps until the next interrupt, like the WFI instruction. If
+ *   the application sleeps, the number of wake-ups and the CPU time of the
+ *   application are printed in the summary. The CPU time of the host mostly
+ *   consists of the overhead of the simulator, so it is no estimate for the
+ *   target, see tools/capturing/acquisition_simulator.py for that.
+ *
+ * The simulator is configured with the following environment variables:
+ *
+ *   SIM_CSV        CSV file to replay. If not set, a synthetic signal is
+ *                  generated: 1000 * sin, 500 * sin and 100 * cos at
+ *                  SIM_FREQUENCY Hz.
+ *   SIM_COLUMNS    Comma separated CSV columns to replay, for example
+ *                  FP1,FP2,ToF. Default are the first columns that are not a
+ *                  label or a timestamp.
+ *   SIM_ODR        Output data rate in Hz. Default is the ODR of the target.
+ *   SIM_JITTER_US  Standard deviation of the jitter of the sample moments in
+ *                  us. Default 0.
+ *   SIM_SPEED      Speed of the simulated time relative to real time. Default
+ *                  1.0. Use a larger value to replay faster, but make sure
+ *                  the host keeps up.
+ *   SIM_SAMPLES    Number of synthetic samples. Default 1000.
+ *   SIM_FREQUENCY  Frequency of the synthetic signal in Hz. Default 1.0.
+ *   SIM_NOISE      Standard deviation of the noise added to the synthetic
+ *                  signal. Default 0.
+ *   SIM_SEED       Seed of the jitter and noise. Default 1.
+ *   SIM_DURATION   Simulated duration in s. Default is until all samples are
+ *                  read, or 10 s for targets without a sensor.
+ *
+ * The application exits when all samples are read or the duration has
+ * passed. If the application does not read the samples, for example while it
+ * waits for motion, it exits shortly after the data has ended. A summary is
+ * printed on stderr, so stdout only contains the output of the application.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+
+/// Maximum length of a line in a CSV file
+#define SIM_LINE_MAX (4096)
+
+/// Default duration in s of targets without a sensor
+#define SIM_DEFAULT_DURATION (10.0)
+
+/// Pi
+#define SIM_PI (3.14159265358979)
+
+/*!
+ * \brief Type definition of the state of the simulator
+ */
+typedef struct
+{
+    // Configuration
+    const char *csv;
+    const char *columns;
+    double odr;
+    double jitter_us;
+    double speed;
+    uint32_t samples;
+    double frequency;
+    double noise;
+    double duration;
+    uint64_t rng;
+
+    // Time base and interrupts
+    struct timespec start;
+    pthread_mutex_t irq;
+    bool irq_disabled;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    uint32_t interrupts;
+
+    // Sleep
+    uint32_t sleeps;
+
+    // Timer
+    uint32_t tick_period_us;
+    void (*tick_isr)(void);
+    uint64_t next_tick;
+    uint64_t last_tick;
+
+    // Sensor
+    bool sensor_on;
+    uint32_t n_channels;
+    void (*ready_cb)(void);
+    float *data;
+    uint32_t n_rows;
+    double rate;
+    double position;
+    uint32_t row;
+    bool ended;
+    uint64_t t0;
+    uint32_t k0;
+    uint64_t next_sample;
+    uint32_t produced;
+    uint32_t consumed;
+    uint32_t last;
+    uint32_t missed;
+    bool ready_masked;
+    uint64_t end_us;
+
+    // Motion detection
+    void (*motion_isr)(void);
+    float motion_threshold;
+    uint32_t motion_count;
+    double motion_cutoff;
+    bool motion_init;
+    float baseline[SIM_N_CHANNELS_MAX];
+    uint32_t debounce;
+    bool latched;
+    uint32_t motions;
+
+}sim_t;
+
+static sim_t sim;
+static pthread_once_t sim_once = PTHREAD_ONCE_INIT;
+
+// Local function prototypes
+static void sim_init(void);
+static void *sim_thread(void *arg);
+static void sim_sleep_until(const uint64_t us);
+static void sim_interrupt(void (*handler)(void));
+static void sim_finish(void);
+static double sim_env(const char *name, const double value);
+static double sim_gaussian(void);
+static uint32_t sim_load_csv(const char *filename, const uint32_t n_channels);
+static uint32_t sim_generate(const uint32_t n_channels);
+static bool sim_motion_update(void);
+
+/*!
+ * \brief Starts the simulator
+ *
+ * Reads the configuration from the environment and starts the background
+ * thread. It is safe to call this function more than once. All other
+ * functions call it, so it does not have to be called explicitly.
+ */
+void sim_start(void)
+{
+    pthread_once(&sim_once, sim_init);
+}
+
+/*!
+ * \brief Exits the application if the simulation has finished
+ *
+ * Must be called from the main thread, for example from a host driver
+ * function that the application calls in its main loop.
+ */
+void sim_poll(void)
+{
+    sim_start();
+
+    double duration = sim.duration;
+
+    if(duration <= 0.0)
+    {
+        duration = sim.sensor_on ? 0.0 : SIM_DEFAULT_DURATION;
+    }
+
+    if((duration > 0.0) && (sim_micros() >= (uint64_t)(duration * 1e6)))
+    {
+        sim_finish();
+    }
+
+    // The data has ended, but the application does not read the last sample
+    pthread_mutex_lock(&sim.lock);
+    const bool ended = sim.ended &&
+        (sim_micros() > (sim.end_us + (uint64_t)(2e6 / sim.odr) + 100000));
+    pthread_mutex_unlock(&sim.lock);
+
+    if(ended)
+    {
+        sim_finish();
+    }
+}
+
+/*!
+ * \brief Returns the simulated time since the start in us
+ */
+uint64_t sim_micros(void)
+{
+    struct timespec now;
+
+    sim_start();
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    const double ns = ((double)(now.tv_sec - sim.start.tv_sec) * 1e9) +
+        (double)(now.tv_nsec - sim.start.tv_nsec);
+
+    return (uint64_t)(ns * sim.speed / 1e3);
+}
+
+/*!
+ * \brief Returns the simulated time since the start in ms
+ */
+uint32_t sim_millis(void)
+{
+    return (uint32_t)(sim_micros() / 1000);
+}
+
+/*!
+ * \brief Waits for a simulated duration
+ *
+ * \param[in]  us  The duration in us
+ */
+void sim_delay_us(const uint64_t us)
+{
+    sim_sleep_until(sim_micros() + us);
+    sim_poll();
+}
+
+/*!
+ * \brief Disables the simulated interrupts
+ *
+ * While disabled, the background thread does not call any interrupt handler.
+ * Must be called from the main thread.
+ */
+void sim_irq_disable(void)
+{
+    sim_start();
+
+    if(!sim.irq_disabled)
+    {
+        pthread_mutex_lock(&sim.irq);
+        sim.irq_disabled = true;
+    }
+}
+
+/*!
+ * \brief Enables the simulated interrupts
+ *
+ * Must be called from the main thread.
+ */
+void sim_irq_enable(void)
+{
+    sim_start();
+
+    if(sim.irq_disabled)
+    {
+        sim.irq_disabled = false;
+        pthread_mutex_unlock(&sim.irq);
+    }
+}
+
+/*!
+ * \brief Starts a periodic timer interrupt
+ *
+ * \param[in]  period_us  The period in us of the simulated time
+ * \param[in]  isr        The interrupt handler
+ */
+void sim_tick_start(const uint32_t period_us, void (*isr)(void))
+{
+    sim_start();
+
+    pthread_mutex_lock(&sim.lock);
+    sim.tick_period_us = period_us;
+    sim.last_tick = sim_micros();
+    sim.next_tick = sim.last_tick + period_us;
+    sim.tick_isr = isr;
+    pthread_mutex_unlock(&sim.lock);
+}
+
+/*!
+ * \brief Returns the simulated time since the last timer interrupt in us
+ *
+ * Use it to simulate the counter of the timer. The timer interrupt handler
+ * and this function are atomic with respect to each other, like an interrupt
+ * handler and the main thread on a microcontroller. If the interrupts are
+ * disabled and the interrupt is pending, the result exceeds the period. Must
+ * be called from the main thread.
+ */
+uint64_t sim_tick_elapsed_us(void)
+{
+    sim_start();
+
+    const bool locked = !sim.irq_disabled;
+
+    if(locked)
+    {
+        pthread_mutex_lock(&sim.irq);
+    }
+
+    const uint64_t elapsed = sim_micros() - sim.last_tick;
+
+    if(locked)
+    {
+        pthread_mutex_unlock(&sim.irq);
+    }
+
+    return elapsed;
+}
+
+/*!
+ * \brief Starts the sensor
+ *
+ * Loads or generates the samples. The first sample is available one period
+ * after this function is called.
+ *
+ * \param[in]  odr         The default output data rate in Hz, overruled by
+ *                         SIM_ODR
+ * \param[in]  n_channels  The number of channels of a sample
+ * \param[in]  ready       Called from the background thread when a sample is
+ *                         available, like a data ready interrupt. May be
+ *                         NULL, in which case sim_sensor_available() must be
+ *                         polled.
+ */
+void sim_sensor_start(const float odr, const uint32_t n_channels,
+    void (*ready)(void))
+{
+    sim_start();
+
+    if(sim.sensor_on)
+    {
+        return;
+    }
+
+    const uint32_t n = (n_channels < SIM_N_CHANNELS_MAX) ?
+        n_channels : SIM_N_CHANNELS_MAX;
+
+    const uint32_t n_rows = (sim.csv != NULL) ?
+        sim_load_csv(sim.csv, n) : sim_generate(n);
+
+    pthread_mutex_lock(&sim.lock);
+    sim.odr = (sim.odr > 0.0) ? sim.odr : (double)odr;
+    sim.rate = sim.odr;
+    sim.n_channels = n;
+    sim.n_rows = n_rows;
+    sim.ready_cb = ready;
+    sim.t0 = sim_micros();
+    sim.next_sample = sim.t0 + (uint64_t)(1e6 / sim.odr);
+    sim.sensor_on = true;
+    pthread_mutex_unlock(&sim.lock);
+}
+
+/*!
+ * \brief Changes the output data rate of the sensor
+ *
+ * Like a sensor that is put in standby to change its configuration, the
+ * first sample at the new rate is available one new period later. The data
+ * keeps the rate at which it was started, so at a lower ODR rows are skipped
+ * and at a higher ODR rows are repeated.
+ *
+ * \param[in]  odr  The output data rate in Hz
+ */
+void sim_sensor_set_odr(const float odr)
+{
+    sim_start();
+
+    pthread_mutex_lock(&sim.lock);
+    sim.odr = (double)odr;
+    sim.t0 = sim_micros();
+    sim.k0 = sim.produced;
+    sim.next_sample = sim.t0 + (uint64_t)(1e6 / sim.odr);
+    pthread_mutex_unlock(&sim.lock);
+}
+
+/*!
+ * \brief Returns the output data rate of the sensor in Hz
+ */
+float sim_sensor_odr(void)
+{
+    sim_start();
+
+    return (float)sim.odr;
+}
+
+/*!
+ * \brief Checks if the sensor has a new sample
+ *
+ * Like the data ready bit of a status register, it is cleared by reading the
+ * sample with sim_sensor_read().
+ *
+ * \return True if a new sample is available
+ */
+bool sim_sensor_available(void)
+{
+    sim_poll();
+
+    pthread_mutex_lock(&sim.lock);
+    const bool ready = (sim.produced != sim.last);
+    pthread_mutex_unlock(&sim.lock);
+
+    return ready;
+}
+
+/*!
+ * \brief Reads the most recent sample of the sensor
+ *
+ * Like a sensor without a FIFO, samples that were not read before the next
+ * sample became available are lost. These are counted as missed. If all
+ * samples have been read, the application exits. Must be called from the main
+ * thread.
+ *
+ * \param[out]  values  The values of all channels
+ */
+void sim_sensor_read(float *values)
+{
+    sim_poll();
+
+    pthread_mutex_lock(&sim.lock);
+    const uint32_t produced = sim.produced;
+    const uint32_t index = sim.row;
+    const bool ended = sim.ended;
+    pthread_mutex_unlock(&sim.lock);
+
+    // One extra sample signals the end
+    if(ended)
+    {
+        sim_finish();
+    }
+
+    // Reading before the first sample returns the first sample, index 0
+    sim.missed += (produced > (sim.last + 1)) ? (produced - sim.last - 1) : 0;
+    sim.last = (produced > 0) ? produced : 1;
+    sim.consumed++;
+
+    memcpy(values, &sim.data[index * sim.n_channels],
+        sizeof(float) * sim.n_channels);
+}
+
+/*!
+ * \brief Enables or disables the data ready interrupt of the sensor
+ *
+ * The samples are still produced, so they can be polled with
+ * sim_sensor_available() and motion is still detected.
+ *
+ * \param[in]  enable  True to call the ready callback of sim_sensor_start()
+ */
+void sim_sensor_ready_irq(const bool enable)
+{
+    sim_start();
+
+    pthread_mutex_lock(&sim.lock);
+    sim.ready_masked = !enable;
+    pthread_mutex_unlock(&sim.lock);
+}
+
+/*!
+ * \brief Starts the motion detection of the sensor
+ *
+ * Emulates the wake-up engines of accelerometers: every sample is high-pass
+ * filtered with a first-order filter, and motion is detected if the absolute
+ * value of any channel exceeds the threshold for more than count consecutive
+ * samples. The event is latched and the handler is called as an interrupt,
+ * once until sim_motion_ack() is called. This approximates the filters of
+ * the sensors, so the moments of detection are not exact.
+ *
+ * \param[in]  threshold  The threshold in the unit of the samples, or 0 to
+ *                        stop the motion detection
+ * \param[in]  count      The number of samples that the threshold must be
+ *                        exceeded before motion is detected
+ * \param[in]  cutoff     The cut-off frequency of the high-pass filter
+ *                        relative to the ODR, for example 0.04
+ * \param[in]  isr        The interrupt handler
+ */
+void sim_motion_start(const float threshold, const uint32_t count,
+    const float cutoff, void (*isr)(void))
+{
+    sim_start();
+
+    pthread_mutex_lock(&sim.lock);
+    sim.motion_threshold = threshold;
+    sim.motion_count = count;
+    sim.motion_cutoff = (double)cutoff;
+    sim.motion_isr = (threshold > 0.0f) ? isr : NULL;
+    sim.motion_init = false;
+    sim.debounce = 0;
+    sim.latched = false;
+    pthread_mutex_unlock(&sim.lock);
+}
+
+/*!
+ * \brief Reads and clears the latched motion event
+ *
+ * \return True if motion was detected since the last call
+ */
+bool sim_motion_ack(void)
+{
+    sim_start();
+
+    pthread_mutex_lock(&sim.lock);
+    const bool latched = sim.latched;
+    sim.latched = false;
+    pthread_mutex_unlock(&sim.lock);
+
+    return latched;
+}
+
+/*!
+ * \brief Sleeps until the next interrupt, like the WFI instruction
+ *
+ * Like on a Cortex-M, an interrupt wakes the CPU even if the interrupts are
+ * disabled. So the application can check a flag with the interrupts disabled
+ * and then sleep, without missing an interrupt that occurs in between:
+ *
+ *   __disable_irq();
+ *   if(!flag)
+ *   {
+ *       __WFI();
+ *   }
+ *   __enable_irq();
+ *
+ * The time spent sleeping is not counted as active CPU time. Must be called
+ * from the main thread.
+ */
+void sim_wfi(void)
+{
+    sim_start();
+
+    const bool disabled = sim.irq_disabled;
+
+    pthread_mutex_lock(&sim.lock);
+    const uint32_t interrupts = sim.interrupts;
+    pthread_mutex_unlock(&sim.lock);
+
+    // Let the pending and the next interrupt run
+    if(disabled)
+    {
+        sim_irq_enable();
+    }
+
+    pthread_mutex_lock(&sim.lock);
+
+    // Wake up after at most 10 ms of real time, so the duration of the
+    // simulation is checked even if there are no interrupts
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    t.tv_nsec += 10000000L;
+
+    if(t.tv_nsec >= 1000000000L)
+    {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000L;
+    }
+
+    while((sim.interrupts == interrupts) &&
+          (pthread_cond_timedwait(&sim.wake, &sim.lock, &t) == 0))
+    {}
+
+    sim.sleeps++;
+    pthread_mutex_unlock(&sim.lock);
+
+    if(disabled)
+    {
+        sim_irq_disable();
+    }
+
+    sim_poll();
+}
+
+/*!
+ * \brief Reads the configuration and starts the background thread
+ */
+static void sim_init(void)
+{
+    pthread_t thread;
+
+    clock_gettime(CLOCK_MONOTONIC, &sim.start);
+
+    sim.csv = getenv("SIM_CSV");
+    sim.columns = getenv("SIM_COLUMNS");
+    sim.odr = sim_env("SIM_ODR", 0.0);
+    sim.jitter_us = sim_env("SIM_JITTER_US", 0.0);
+    sim.speed = sim_env("SIM_SPEED", 1.0);
+    sim.samples = (uint32_t)sim_env("SIM_SAMPLES", 1000.0);
+    sim.frequency = sim_env("SIM_FREQUENCY", 1.0);
+    sim.noise = sim_env("SIM_NOISE", 0.0);
+    sim.duration = sim_env("SIM_DURATION", 0.0);
+    sim.rng = (uint64_t)sim_env("SIM_SEED", 1.0);
+    sim.rng = (sim.rng == 0) ? 1 : sim.rng;
+
+    pthread_mutex_init(&sim.irq, NULL);
+    pthread_mutex_init(&sim.lock, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sim.wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_create(&thread, NULL, sim_thread, NULL);
+    pthread_detach(thread);
+}
+
+/*!
+ * \brief Background thread that simulates the interrupts
+ */
+static void *sim_thread(void *arg)
+{
+    (void)arg;
+
+    while(1)
+    {
+        uint64_t now = sim_micros();
+
+        // Wake up at least every ms to pick up a new configuration
+        uint64_t next = now + 1000;
+
+        pthread_mutex_lock(&sim.lock);
+
+        void (*isr)(void) = sim.tick_isr;
+        void (*ready_cb)(void) = sim.ready_cb;
+        const bool sensor_on = sim.sensor_on && !sim.ended;
+
+        if((isr != NULL) && (sim.next_tick < next))
+        {
+            next = sim.next_tick;
+        }
+
+        if(sensor_on && (sim.next_sample < next))
+        {
+            next = sim.next_sample;
+        }
+
+        pthread_mutex_unlock(&sim.lock);
+
+        sim_sleep_until(next);
+        now = sim_micros();
+
+        // Timer interrupt, catch up if the host was too slow
+        while((isr != NULL) && (now >= sim.next_tick))
+        {
+            pthread_mutex_lock(&sim.irq);
+            isr();
+            sim.last_tick = sim.next_tick;
+            pthread_mutex_unlock(&sim.irq);
+
+            sim.next_tick += sim.tick_period_us;
+            sim_interrupt(NULL);
+        }
+
+        // Sensor data ready
+        if(sensor_on && (now >= sim.next_sample))
+        {
+            pthread_mutex_lock(&sim.lock);
+
+            // The data keeps its original rate if the ODR has changed
+            sim.position += (sim.produced > 0) ? (sim.rate / sim.odr) : 0.0;
+            sim.produced++;
+            sim.row = (uint32_t)sim.position;
+
+            // One extra sample signals the end, so the application exits when
+            // it reads that sample
+            sim.ended = (sim.row >= sim.n_rows);
+            sim.end_us = now;
+
+            void (*motion_isr)(void) = sim_motion_update() ?
+                sim.motion_isr : NULL;
+            const bool masked = sim.ready_masked;
+
+            const double period = 1e6 / sim.odr;
+            double t = (double)sim.t0 +
+                ((double)(sim.produced - sim.k0 + 1) * period) +
+                (sim.jitter_us * sim_gaussian());
+
+            t = (t < (double)(sim.next_sample + 1)) ?
+                (double)(sim.next_sample + 1) : t;
+
+            sim.next_sample = (uint64_t)t;
+
+            pthread_mutex_unlock(&sim.lock);
+
+            if((ready_cb != NULL) && !masked)
+            {
+                sim_interrupt(ready_cb);
+            }
+
+            if(motion_isr != NULL)
+            {
+                sim_interrupt(motion_isr);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*!
+ * \brief Sleeps until a moment in simulated time
+ */
+static void sim_sleep_until(const uint64_t us)
+{
+    const double ns = (double)us * 1e3 / sim.speed;
+
+    struct timespec t = sim.start;
+    t.tv_sec += (time_t)(ns / 1e9);
+    t.tv_nsec += (long)(ns - ((double)(time_t)(ns / 1e9) * 1e9));
+
+    if(t.tv_nsec >= 1000000000L)
+    {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000L;
+    }
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) != 0)
+    {}
+}
+
+/*!
+ * \brief Calls an interrupt handler and wakes up sim_wfi()
+ *
+ * \param[in]  handler  The interrupt handler, or NULL if it has been called
+ */
+static void sim_interrupt(void (*handler)(void))
+{
+    if(handler != NULL)
+    {
+        pthread_mutex_lock(&sim.irq);
+        handler();
+        pthread_mutex_unlock(&sim.irq);
+    }
+
+    pthread_mutex_lock(&sim.lock);
+    sim.interrupts++;
+    pthread_cond_broadcast(&sim.wake);
+    pthread_mutex_unlock(&sim.lock);
+}
+
+/*!
+ * \brief Detects motion in the sample that was just produced
+ *
+ * Must be called with sim.lock locked.
+ *
+ * \return True if the motion interrupt must be called
+ */
+static bool sim_motion_update(void)
+{
+    if((sim.motion_isr == NULL) || sim.ended)
+    {
+        return false;
+    }
+
+    const float *x = &sim.data[sim.row * sim.n_channels];
+    const float alpha = (float)(1.0 - exp(-2.0 * SIM_PI * sim.motion_cutoff));
+    bool above = false;
+
+    for(uint32_t c=0; c<sim.n_channels; ++c)
+    {
+        const float hp = sim.motion_init ? (x[c] - sim.baseline[c]) : 0.0f;
+
+        sim.baseline[c] = sim.motion_init ? (sim.baseline[c] + (alpha * hp)) :
+            x[c];
+        above = above || (fabsf(hp) > sim.motion_threshold);
+    }
+
+    sim.motion_init = true;
+    sim.debounce = above ? (sim.debounce + 1) : 0;
+
+    if((sim.debounce > sim.motion_count) && !sim.latched)
+    {
+        sim.latched = true;
+        sim.motions++;
+
+        return true;
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Prints a summary and exits the application
+
+ */
+static void sim_finish(void)
+{
+    fflush(stdout);
+
+    fprintf(stderr, "sim: %u samples read at %.2f Hz, %u missed, %.3f s\n",
+        sim.consumed, sim.odr, sim.missed, (double)sim_micros() / 1e6);
+
+    if(sim.motion_isr != NULL)
+    {
+        fprintf(stderr, "sim: %u motion interrupts\n", sim.motions);
+    }
+
+    if(sim.sleeps > 0)
+    {
+        struct timespec cpu;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+
+        fprintf(stderr, "sim: %u wake-ups, %.3f s CPU time of the host\n",
+            sim.sleeps, (double)cpu.tv_sec + ((double)cpu.tv_nsec / 1e9));
+    }
+
+    exit(0);
+}
+
+/*!
+ * \brief Returns the value of a numeric environment variable
+ */
+static double sim_env(const char *name, const double value)
+{
+    const char *s = getenv(name);
+
+    return ((s != NULL) && (*s != '\0')) ? atof(s) : value;
+}
+
+/*!
+ * \brief Returns a standard normal random number
+ *
+ * Uses the xorshift64 generator and the Box-Muller transform, so the jitter
+ * and noise are reproducible for a given seed.
+ */
+static double sim_gaussian(void)
+{
+    double u[2];
+
+    for(uint32_t i=0; i<2; ++i)
+    {
+        sim.rng ^= sim.rng << 13;
+        sim.rng ^= sim.rng >> 7;
+        sim.rng ^= sim.rng << 17;
+        u[i] = ((double)(sim.rng >> 11) + 1.0) / 9007199254740993.0;
+    }
+
+    return sqrt(-2.0 * log(u[0])) * cos(2.0 * SIM_PI * u[1]);
+}
+
+/*!
+ * \brief Loads the selected columns of a CSV file
+ *
+ * \return The number of rows
+ */
+static uint32_t sim_load_csv(const char *filename, const uint32_t n_channels)
+{
+    char line[SIM_LINE_MAX];
+    int32_t index[SIM_N_CHANNELS_MAX];
+    uint32_t n_rows = 0;
+    uint32_t capacity = 1024;
+
+    FILE *f = fopen(filename, "r");
+
+    if((f == NULL) || (fgets(line, sizeof(line), f) == NULL))
+    {
+        fprintf(stderr, "sim: cannot read %s\n", filename);
+        exit(1);
+    }
+
+    for(uint32_t c=0; c<n_channels; ++c)
+    {
+        index[c] = -1;
+    }
+
+    // Map the channels on the columns of the header
+    uint32_t column = 0;
+    uint32_t selected = 0;
+
+    for(char *name = strtok(line, ",\r\n"); name != NULL;
+        name = strtok(NULL, ",\r\n"), ++column)
+    {
+        if(sim.columns != NULL)
+        {
+            // Position of the name in SIM_COLUMNS
+            const char *p = sim.columns;
+            const size_t len = strlen(name);
+
+            for(uint32_t c=0; (c < n_channels) && (p != NULL); ++c)
+            {
+                if((strncmp(p, name, len) == 0) &&
+                   ((p[len] == ',') || (p[len] == '\0')))
+                {
+                    index[c] = (int32_t)column;
+                }
+
+                p = strchr(p, ',');
+                p = (p != NULL) ? (p + 1) : NULL;
+            }
+        }
+        else if((selected < n_channels) && (strcmp(name, "label") != 0) &&
+                (strncmp(name, "timestamp", 9) != 0))
+        {
+            index[selected++] = (int32_t)column;
+        }
+    }
+
+    sim.data = malloc(sizeof(float) * capacity * n_channels);
+
+    while(fgets(line, sizeof(line), f) != NULL)
+    {
+        float values[SIM_N_CHANNELS_MAX] = {0};
+        char *s = line;
+
+        // Split on commas without skipping empty fields
+        for(int32_t col=0; s != NULL; ++col)
+        {
+            for(uint32_t c=0; c<n_channels; ++c)
+            {
+                values[c] = (index[c] == col) ? (float)atof(s) : values[c];
+            }
+
+            s = strchr(s, ',');
+            s = (s != NULL) ? (s + 1) : NULL;
+        }
+
+        if(n_rows == capacity)
+        {
+            capacity *= 2;
+            sim.data = realloc(sim.data, sizeof(float) * capacity * n_channels);
+        }
+
+        memcpy(&sim.data[n_rows * n_channels], values,
+            sizeof(float) * n_channels);
+        n_rows++;
+    }
+
+    fclose(f);
+
+    return n_rows;
+}
+
+/*!
+ * \brief Generates the synthetic signal
+ *
+ * \return The number of rows
+ */
+static uint32_t sim_generate(const uint32_t n_channels)
+{
+    const double amplitude[3] = {1000.0, 500.0, 100.0};
+    const double odr = (sim.odr > 0.0) ? sim.odr : 100.0;
+
+    sim.data = malloc(sizeof(float) * sim.samples * n_channels);
+
+    for(uint32_t i=0; i<sim.samples; ++i)
+    {
+        const double angle = 2.0 * SIM_PI * sim.frequency * (double)i / odr;
+
+        for(uint32_t c=0; c<n_channels; ++c)
+        {
+            double v = 0.0;
+
+            if(c < 3)
+            {
+                v = amplitude[c] * ((c == 2) ? cos(angle) : sin(angle));
+            }
+
+            sim.data[(i * n_channels) + c] =
+                (float)(v + (sim.noise * sim_gaussian()));
+        }
+    }
+
+    return sim.samples;
+}
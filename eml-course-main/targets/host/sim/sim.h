@@ -0,0 +1,80 @@
+/*! ***************************************************************************
+ *
+ * \brief     Host simulator of the sensors and timers of the targets
+ * \file      sim.h
+ * \author    Jeroen Veen - HAN Embedded Systems Engineering
+ * \author    Hugo Arends - HAN Embedded Systems Engineering
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _SIM_H_
+#define _SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Maximum number of sensor channels
+#define SIM_N_CHANNELS_MAX (16)
+
+// Functions are documented in the source file
+
+void sim_start(void);
+void sim_poll(void);
+
+uint64_t sim_micros(void);
+uint32_t sim_millis(void);
+void sim_delay_us(const uint64_t us);
+
+void sim_irq_disable(void);
+void sim_irq_enable(void);
+void sim_wfi(void);
+
+void sim_tick_start(const uint32_t period_us, void (*isr)(void));
+uint64_t sim_tick_elapsed_us(void);
+
+void sim_sensor_start(const float odr, const uint32_t n_channels,
+    void (*ready)(void));
+void sim_sensor_set_odr(const float odr);
+float sim_sensor_odr(void);
+bool sim_sensor_available(void);
+void sim_sensor_read(float *values);
+void sim_sensor_ready_irq(const bool enable);
+
+void sim_motion_start(const float threshold, const uint32_t count,
+    const float cutoff, void (*isr)(void));
+bool sim_motion_ack(void);
+
+#endif // _SIM_H_
+
+#ifdef __cplusplus
+}
+#endif
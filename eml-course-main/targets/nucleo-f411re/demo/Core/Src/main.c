@@ -29,8 +29,25 @@
 #include "lsm6dso_reg.h"
 #include "stts751_reg.h"
 #include "features.h"
+#include "timestamp.h"
 
 #include <stdio.h>
+
+// Uncomment to output the timestamps ms1 and ms2 in us instead of ms, for the
+// analysis of the jitter with tools/capturing/timestamp_inspector.py -u us.
+// The timestamps wrap after about 71 minutes. See lib/timestamp.c.
+//#define TIMESTAMP_US
+
+// Uncomment to let the LSM6DSO detect motion while stationary. The samples
+// are only read and sent while moving. While stationary, the ODR is lowered
+// and the microcontroller sleeps until the wake-up interrupt on INT1. See
+// lib/acquisition.c and lib/wakeup.c.
+//#define WAKE_ON_MOTION
+
+#ifdef WAKE_ON_MOTION
+#include "acquisition.h"
+#include "wakeup.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -40,17 +57,58 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#ifdef WAKE_ON_MOTION
+
+// Output data rates in Hz and the full scale in mg of the accelerometer
+#define ODR_IDLE (12.5f)
+#define ODR_ACTIVE (104.0f)
+#define FS_MG (2000.0f)
+
+// Duration of a block of the activity and the time before becoming idle
+#define ACTIVITY_BLOCK_MS (200.0f)
+#define ACTIVITY_HOLD_MS (2000.0f)
+
+// Peak-to-peak thresholds in mg of the activity, may be set by the compiler
+#ifndef ACTIVITY_ENTER_MG
+#define ACTIVITY_ENTER_MG (60.0f)
+#endif
+
+#ifndef ACTIVITY_EXIT_MG
+#define ACTIVITY_EXIT_MG (30.0f)
+#endif
+
+// Threshold in mg of the filtered acceleration that wakes up from the idle
+// mode, which must be exceeded for MOTION_DURATION_MS. A peak-to-peak
+// activity of ACTIVITY_ENTER_MG corresponds to an amplitude of half that
+// value.
+#ifndef MOTION_THRESHOLD_MG
+#define MOTION_THRESHOLD_MG (ACTIVITY_ENTER_MG / 2.0f)
+#endif
+
+#define MOTION_DURATION_MS (20.0f)
+
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
 /* USER CODE BEGIN PM */
-
+#ifdef TIMESTAMP_US
+#define NOW() ((uint32_t)timestamp_us(&timestamp))
+#else
+#define NOW() HAL_GetTick()
+#endif
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+// Time in us from the SysTick interrupt and the SysTick counter
+static timestamp_t timestamp;
 
+#ifdef WAKE_ON_MOTION
+static acquisition_t acquisition;
+static volatile bool lsm6dso_motion_flag = false;
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -65,6 +123,14 @@ static int32_t platform_write_stss751(void *handle, uint8_t reg,
                       const uint8_t *bufp, uint16_t len);
 static int32_t platform_read_stss751(void *handle, uint8_t reg,
                      uint8_t *bufp, uint16_t len);
+static uint32_t systick_count(void);
+static bool systick_pending(void);
+#ifdef WAKE_ON_MOTION
+static bool bus_write_lsm6dso(void *handle, const uint8_t reg,
+                              const uint8_t value);
+static bool bus_read_lsm6dso(void *handle, const uint8_t reg, uint8_t *value);
+static void adaptive_changed(stmdev_ctx_t *ctx, const wakeup_bus_t *bus);
+#endif
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -100,7 +166,9 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  // SysTick generates the tick of the HAL every ms at the system clock
+  timestamp_init(&timestamp, systick_count, systick_pending,
+                 SysTick->LOAD + 1, 1000, true);
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
@@ -168,6 +236,23 @@ int main(void)
   printf("ODR = 104Hz\n");
   printf("+/-2g output scale\r\n");
 
+#ifdef WAKE_ON_MOTION
+  const wakeup_bus_t bus_lsm6dso =
+  {
+    bus_write_lsm6dso, bus_read_lsm6dso, &hi2c1
+  };
+
+  // Wake-up detection at the ODR of the idle mode, routed to INT1
+  if(!wakeup_lsm6dso_init(&bus_lsm6dso, MOTION_THRESHOLD_MG,
+                          MOTION_DURATION_MS, ODR_IDLE, FS_MG))
+  {
+    printf("LSM6DSO wake-up failed\n");
+  }
+
+  acquisition_init(&acquisition, 3, ODR_IDLE, ODR_ACTIVE, ACTIVITY_BLOCK_MS,
+                   ACTIVITY_HOLD_MS, ACTIVITY_ENTER_MG, ACTIVITY_EXIT_MG);
+#endif
+
   // --------------------------------------------------------------------------
   // STTS751 initialize
   // --------------------------------------------------------------------------
@@ -220,6 +305,38 @@ int main(void)
       }
     }
 
+#ifdef WAKE_ON_MOTION
+    // ----------------------------------------------------------------------
+    // While idle, no samples are read. Sleep until the next interrupt, unless
+    // motion was detected. An interrupt in between the check and WFI wakes up
+    // the CPU, because WFI also wakes up on an interrupt that is pending
+    // while disabled.
+    if(acquisition_mode(&acquisition) == ACQUISITION_IDLE)
+    {
+      __disable_irq();
+      if(!lsm6dso_motion_flag)
+      {
+        __WFI();
+      }
+      __enable_irq();
+
+      if(lsm6dso_motion_flag)
+      {
+        bool motion = false;
+
+        lsm6dso_motion_flag = false;
+        wakeup_lsm6dso_source(&bus_lsm6dso, &motion);
+
+        if(motion && acquisition_set_mode(&acquisition, ACQUISITION_ACTIVE))
+        {
+          adaptive_changed(&dev_ctx_lsm6dso, &bus_lsm6dso);
+        }
+      }
+
+      continue;
+    }
+#endif
+
     // ----------------------------------------------------------------------
     int16_t data_raw_acceleration[3] = {0};
     float acceleration_mg[3] = {0};
@@ -231,7 +348,7 @@ int main(void)
     if(reg)
     {
       // Set initial timestamp
-      uint32_t ms1 = HAL_GetTick();
+      uint32_t ms1 = NOW();
 
       // Read acceleration field data
       lsm6dso_acceleration_raw_get(&dev_ctx_lsm6dso, data_raw_acceleration);
@@ -239,6 +356,19 @@ int main(void)
       acceleration_mg[1] = lsm6dso_from_fs2_to_mg(data_raw_acceleration[1]);
       acceleration_mg[2] = lsm6dso_from_fs2_to_mg(data_raw_acceleration[2]);
 
+#ifdef WAKE_ON_MOTION
+      // The last samples before becoming idle are not sent
+      if(acquisition_update(&acquisition, acceleration_mg))
+      {
+        adaptive_changed(&dev_ctx_lsm6dso, &bus_lsm6dso);
+      }
+
+      if(acquisition_mode(&acquisition) == ACQUISITION_IDLE)
+      {
+        continue;
+      }
+#endif
+
       // ----------------------------------------------------------------------
       //int16_t data_raw_temperature = 0;
       //
@@ -249,7 +379,7 @@ int main(void)
       // ----------------------------------------------------------------------
 
       // Set final timestamp
-      uint32_t ms2 = HAL_GetTick();
+      uint32_t ms2 = NOW();
 
       // Send the data
       printf("%d,%d,%.1f,%.1f,%.1f\n",
@@ -331,7 +461,90 @@ static void MX_NVIC_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+/*
+ * @brief  Increments the tick of the HAL and of the timestamps
+ *
+ * Overrides the weak function of the HAL, which is called by the SysTick
+ * interrupt handler.
+ *
+ */
+void HAL_IncTick(void)
+{
+  uwTick += uwTickFreq;
+  timestamp_tick(&timestamp);
+}
+
+/*
+ * @brief  Returns the SysTick counter, which counts down from LOAD to 0
+ *
+ */
+static uint32_t systick_count(void)
+{
+  return SysTick->VAL;
+}
 
+/*
+ * @brief  Returns true if the SysTick counter wrapped and the interrupt has
+ *         not been taken yet
+ *
+ */
+static bool systick_pending(void)
+{
+  return (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+}
+
+#ifdef WAKE_ON_MOTION
+
+/*
+ * @brief  Applies a change of the mode of the acquisition controller
+ *
+ * @param  ctx       the LSM6DSO driver context
+ * @param  bus       the LSM6DSO register access of the wake-up library
+ *
+ * The ODR of the accelerometer is changed. When the mode becomes idle, an
+ * event that was latched while active is cleared, so the next motion
+ * generates a new interrupt.
+ *
+ */
+static void adaptive_changed(stmdev_ctx_t *ctx, const wakeup_bus_t *bus)
+{
+  const bool idle = (acquisition_mode(&acquisition) == ACQUISITION_IDLE);
+
+  lsm6dso_xl_data_rate_set(ctx, idle ? LSM6DSO_XL_ODR_12Hz5 :
+                                       LSM6DSO_XL_ODR_104Hz);
+
+  if(idle)
+  {
+    bool motion;
+
+    lsm6dso_motion_flag = false;
+    wakeup_lsm6dso_source(bus, &motion);
+  }
+
+  printf("#acquisition,%s,%d,%d,%d\n",
+    idle ? "idle" : "active",
+    (int)HAL_GetTick(),
+    (int)acquisition.samples[ACQUISITION_IDLE],
+    (int)acquisition.samples[ACQUISITION_ACTIVE]);
+}
+
+/*
+ * @brief  EXTI line detection callback
+ *
+ * @param  GPIO_Pin  the pin of the interrupt
+ *
+ * INT1 of the LSM6DSO signals the wake-up event.
+ *
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if(GPIO_Pin == LSM6DSM_INT1_Pin)
+  {
+    lsm6dso_motion_flag = true;
+  }
+}
+
+#endif
 /* USER CODE END 4 */
 
 /**
@@ -433,3 +646,32 @@ static int32_t platform_read_lsm6dso(void *handle, uint8_t reg,
   return HAL_I2C_Mem_Read(handle, LSM6DSO_I2C_ADD_H, reg,
                           I2C_MEMADD_SIZE_8BIT, bufp, len, 1000);
 }
+
+#ifdef WAKE_ON_MOTION
+/*
+ * @brief  Write a register of the LSM6DSO for the wake-up library
+ *
+ * @param  handle    the I2C handle
+ * @param  reg       register to write
+ * @param  value     value to write
+ *
+ */
+static bool bus_write_lsm6dso(void *handle, const uint8_t reg,
+                              const uint8_t value)
+{
+  return platform_write_lsm6dso(handle, reg, &value, 1) == HAL_OK;
+}
+
+/*
+ * @brief  Read a register of the LSM6DSO for the wake-up library
+ *
+ * @param  handle    the I2C handle
+ * @param  reg       register to read
+ * @param  value     pointer to the value read
+ *
+ */
+static bool bus_read_lsm6dso(void *handle, const uint8_t reg, uint8_t *value)
+{
+  return platform_read_lsm6dso(handle, reg, value, 1) == HAL_OK;
+}
+#endif
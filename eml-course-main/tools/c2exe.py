@@ -0,0 +1,113 @@
+"""
+c2exe.py
+
+Compiles C source files to an executable for the host and runs it. This makes
+it possible to benchmark the same C code that runs on the microcontroller on a
+PC.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import config as cfg
+
+from sys import platform
+from os.path import join, exists, abspath, basename
+from os import makedirs
+from distutils.ccompiler import new_compiler
+from shutil import copyfile, rmtree
+import subprocess
+
+# Directory with the C source files that are also used on the microcontroller
+LIB_DIR_PATH = join(cfg.DATA_DIR_PATH, '..', '..', 'lib')
+
+def build(name, project_dir, sources, lib_files=[], include_files=[],
+          libraries=[], delete_temporary_files=True):
+    """
+    Builds an executable for the host.
+
+    Parameters
+    ----------
+    name : str
+        Name of the executable, without extension.
+    project_dir : str
+        Directory in which the temporary project is created. The executable
+        is written to the parent of this directory.
+    sources : dict
+        Generated source files, with the filename as key and the source code
+        as value. One of them must contain the main() function.
+    lib_files : list of str
+        Names of the files in the ./lib directory to add to the project, for
+        example ['features.h', 'features.c'].
+    include_files : list of str
+        Paths of other files that are only included by the sources, for
+        example a generated model. These are copied, but not compiled.
+    delete_temporary_files : bool
+        Set to False to examine the temporary files that are created.
+
+    Returns
+    -------
+    str
+        Path of the executable.
+    """
+    if not exists(project_dir):
+        makedirs(project_dir)
+
+    print('Creating project for building in ' + project_dir)
+
+    files = []
+
+    for filename, source in sources.items():
+        f = open(join(project_dir, filename), 'w')
+        f.write(source)
+        f.close()
+        files.append(filename)
+
+    # Copy the source files
+    for filename in lib_files:
+        copyfile(join(LIB_DIR_PATH, filename), join(project_dir, filename))
+        files.append(filename)
+
+    for path in include_files:
+        copyfile(path, join(project_dir, basename(path)))
+
+    # Compile and link the project
+    cc = new_compiler(force=1)
+
+    if platform.startswith('win'):
+        libraries = None
+        cc_args = ['/O2']
+    else:
+        # Math library
+        libraries = ["m"] + libraries
+        cc_args = ["-std=c99", "-O2"]
+
+    objects = cc.compile(
+        sources=[join(project_dir, f) for f in files if f.endswith('.c')],
+        extra_preargs=cc_args,
+        output_dir=join(project_dir, 'build'))
+
+    output_dir = abspath(join(project_dir, '..'))
+    cc.link_executable(objects, name, output_dir=output_dir,
+        libraries=libraries)
+
+    if delete_temporary_files:
+        print('Removing temporary files ' + project_dir)
+        rmtree(project_dir)
+    else:
+        print('Temporary files have been preserved in ' + project_dir)
+
+    executable = join(output_dir, cc.executable_filename(name))
+    print('Generated ' + executable)
+
+    return executable
+
+def run(executable, args=[]):
+    """
+    Runs an executable and returns everything it printed to stdout.
+    """
+    result = subprocess.run([executable] + [str(a) for a in args],
+        capture_output=True, text=True, check=True)
+    return result.stdout
@@ -0,0 +1,355 @@
+"""
+acquisition_simulator.py
+
+Simulates adaptive sampling with the acquisition controller of lib/acquisition.c
+on a replayed capture, and estimates the active CPU time of the
+microcontroller. The controller switches between a low output data rate (ODR)
+while stationary and the full ODR while moving. In the idle mode, only the
+activity is computed and the pipeline does not run.
+
+The C code of the controller is compiled for the host together with the
+captured data, so the mode changes are exactly the same as on the
+microcontroller. The captured data is assumed to be sampled at the full ODR,
+so in the idle mode rows are skipped.
+
+The active CPU time is estimated with the time of every stage of the pipeline
+on the microcontroller, see STAGE_US. Measure these with the LATENCY option of
+the demo application and latency_inspector.py. The estimate is compared with
+continuous sampling at the full ODR, both with and without sleeping in between
+samples.
+
+Use commandline parameter -p to plot the activity and the mode.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+import argparse
+import tempfile
+import unittest
+import numpy as np
+
+# TODO Set the captured data files, which are replayed one after the other,
+#      and the attributes of which the activity is computed. Use None for all
+#      attributes, at most ACQUISITION_N_CHANNELS_MAX in acquisition.h.
+INPUT_FILES = ['stationary.csv', '14524-testCPR.csv', 'stationary.csv']
+ATTRIBUTES = None
+
+# TODO Set the output data rate in Hz of the idle mode. The active mode uses
+#      the sample frequency of the captured data.
+ODR_IDLE = 12.5
+
+# TODO Set the duration in ms of a block of the activity and the time in ms
+#      that the activity must be quiet before the mode becomes idle
+BLOCK_MS = 200.0
+HOLD_MS = 2000.0
+
+# TODO Set the peak-to-peak thresholds of the activity, in the unit of the
+#      captured data
+ENTER = 300.0
+EXIT = 150.0
+
+# TODO Set the time in us of every stage of the pipeline on the
+#      microcontroller, for example the p50 values of latency_inspector.py.
+#      The default values are rough estimates for the FRDM-KL25Z at 48 MHz.
+#      Acquisition and activity run for every sample that is read, filtering
+#      and windowing for every sample of the active mode, and the other stages
+#      for every window.
+STAGE_US = {
+    'acquisition': 250.0,
+    'activity': 5.0,
+    'filtering': 60.0,
+    'windowing': 40.0,
+    'features': 400.0,
+    'classification': 5.0,
+    'output': 200.0,
+}
+
+# TODO Set the time in us of a wake-up from sleep, including the interrupt
+#      handler, and the frequency in Hz of the timer interrupts that also wake
+#      up the microcontroller, for example the SysTick of 1 kHz
+WAKE_US = 2.0
+TICK_FREQUENCY = 1000.0
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+
+#include "acquisition.h"
+
+#define N_ROWS ({n_rows})
+#define N_CHANNELS ({n_channels})
+#define RATE ({rate}f)
+
+static const float data[N_ROWS][N_CHANNELS] =
+{{
+{data}
+}};
+
+int main(void)
+{{
+    acquisition_t a;
+
+    acquisition_init(&a, N_CHANNELS, {odr_idle}f, RATE, {block_ms}f,
+        {hold_ms}f, {enter}f, {exit}f);
+
+    // The data is sampled at RATE, so rows are skipped at a lower ODR
+    double position = 0.0;
+
+    while(position < N_ROWS)
+    {{
+        const uint32_t row = (uint32_t)position;
+
+        acquisition_update(&a, data[row]);
+
+        printf("%u,%d,%f\\n", row, (int)acquisition_mode(&a), a.activity);
+
+        position += RATE / acquisition_odr(&a);
+    }}
+
+    return 0;
+}}
+'''
+
+
+def simulate(data, rate, odr_idle=ODR_IDLE, block_ms=BLOCK_MS, hold_ms=HOLD_MS,
+    enter=ENTER, exit=EXIT):
+    """
+    Runs the acquisition controller on the data
+
+    Parameters
+    ----------
+    data : numpy array
+        Samples of shape (rows, channels), sampled at rate Hz.
+    rate : float
+        Sample frequency of the data in Hz, which is the ODR of the active
+        mode.
+
+    Returns
+    -------
+    rows : numpy array
+        Index of every sample that was read.
+    active : numpy array
+        True if the sample was processed in the active mode.
+    activity : numpy array
+        Activity of the last complete block when the sample was read.
+    """
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_rows=len(data),
+            n_channels=data.shape[1],
+            rate=repr(float(rate)),
+            data=',\n'.join(['    {' + ', '.join(
+                [repr(float(v)) + 'f' for v in row]) + '}' for row in data]),
+            odr_idle=repr(float(odr_idle)),
+            block_ms=repr(float(block_ms)),
+            hold_ms=repr(float(hold_ms)),
+            enter=repr(float(enter)),
+            exit=repr(float(exit))),
+    }
+
+    project_dir = join(tempfile.mkdtemp(), 'acquisition_project')
+    executable = c2exe.build('acquisition_simulator', project_dir, sources,
+        lib_files=['acquisition.h', 'acquisition.c'])
+
+    trace = np.array([[float(x) for x in line.split(',')]
+        for line in c2exe.run(executable).splitlines()])
+
+    return trace[:, 0].astype(int), trace[:, 1] == 1, trace[:, 2]
+
+
+def windows(active, block_size, block_hop):
+    """
+    Returns the number of windows that are classified
+
+    The window restarts at every mode change, like in the demo application.
+    """
+    n = 0
+    count = 0
+
+    for a in active:
+        if not a:
+            count = 0
+            continue
+
+        count += 1
+
+        if count >= block_size:
+            n += 1
+            count -= block_hop
+
+    return n
+
+
+def cpu_time(read, processed, classified, duration, sleep=True):
+    """
+    Returns the estimated active CPU time in s
+
+    Without sleeping, the CPU is always active.
+    """
+    if not sleep:
+        return duration
+
+    us = (read * (STAGE_US['acquisition'] + STAGE_US['activity'])) + \
+        (processed * (STAGE_US['filtering'] + STAGE_US['windowing'])) + \
+        (classified * (STAGE_US['features'] + STAGE_US['classification'] +
+            STAGE_US['output'])) + \
+        (((duration * TICK_FREQUENCY) + read) * WAKE_US)
+
+    return us / 1e6
+
+
+def report(n_rows, rate, active, block_size, block_hop):
+    """Prints the samples and the CPU time of continuous and adaptive sampling"""
+    duration = n_rows / rate
+    always = np.ones(n_rows, dtype=bool)
+
+    rows = [
+        ('continuous', n_rows, n_rows, windows(always, block_size, block_hop),
+            False),
+        ('continuous + WFI', n_rows, n_rows,
+            windows(always, block_size, block_hop), True),
+        ('adaptive + WFI', len(active), int(np.sum(active)),
+            windows(active, block_size, block_hop), True),
+    ]
+
+    print()
+    print('Replayed {:.1f} s at {:.1f} Hz, windows of {} samples every {} '
+        'samples'.format(duration, rate, block_size, block_hop))
+    print()
+    print('{:<18}{:>10}{:>12}{:>10}{:>14}{:>8}'.format('acquisition', 'read',
+        'processed', 'windows', 'CPU time', 'duty'))
+
+    for name, read, processed, classified, sleep in rows:
+        t = cpu_time(read, processed, classified, duration, sleep)
+        print('{:<18}{:>10}{:>12}{:>10}{:>12.3f} s{:>7.2f}%'.format(name,
+            read, processed, classified, t, 100.0 * t / duration))
+
+
+def plot(data, rate, rows, active, activity):
+    """Plots the data, the activity and the mode"""
+    import matplotlib.pyplot as plt
+
+    t = np.arange(len(data)) / rate
+    fig, axs = plt.subplots(2, 1, sharex=True)
+
+    axs[0].plot(t, data, linewidth=0.5)
+    axs[0].set_ylabel('data')
+
+    axs[1].plot(rows / rate, activity, 'k.-', linewidth=0.5, markersize=2,
+        label='activity')
+    axs[1].axhline(ENTER, color='r', linestyle='--', label='enter')
+    axs[1].axhline(EXIT, color='g', linestyle='--', label='exit')
+    axs[1].set_ylabel('peak-to-peak')
+    axs[1].set_xlabel('time (s)')
+    axs[1].legend()
+
+    for ax in axs:
+        ax.fill_between(rows / rate, 0, 1, where=active, step='post',
+            color='orange', alpha=0.2, transform=ax.get_xaxis_transform())
+
+    axs[0].set_title('Adaptive sampling, active mode shaded')
+    plt.show()
+
+
+class TestAcquisitionSimulator(unittest.TestCase):
+    """
+    Runs the controller on a synthetic signal: quiet, moving, a short pause,
+    moving, and quiet again
+    """
+    RATE = 100.0
+
+    def signal(self):
+        rng = np.random.default_rng(1)
+        t = np.arange(int(40 * self.RATE)) / self.RATE
+        moving = ((t >= 10) & (t < 20)) | ((t >= 21) & (t < 30))
+        x = 1000.0 + rng.normal(0, 20, len(t)) + \
+            moving * 500.0 * np.sin(2 * np.pi * 2.0 * t)
+
+        return t, x.reshape(-1, 1)
+
+    def test_modes(self):
+        t, data = self.signal()
+        rows, active, activity = simulate(data, self.RATE, odr_idle=12.5,
+            block_ms=200, hold_ms=2000, enter=300, exit=150)
+
+        time = rows / self.RATE
+        changes = np.flatnonzero(np.diff(active.astype(int))) + 1
+
+        # Idle after the hold time, active during the movement including the
+        # short pause, and idle again after the hold time
+        self.assertEqual(len(changes), 3)
+        self.assertAlmostEqual(time[changes[0]], 2.0, delta=0.3)
+        self.assertAlmostEqual(time[changes[1]], 10.0, delta=0.5)
+        self.assertAlmostEqual(time[changes[2]], 32.0, delta=0.5)
+
+        # Noise within the thresholds does not make the mode toggle
+        self.assertTrue(np.all(activity[time < 9.5] < 150))
+
+        # Rows are skipped in the idle mode, at 100 / 12.5 = 8 rows per sample
+        self.assertLess(len(rows), len(data) * 0.7)
+        self.assertEqual(np.median(np.diff(rows)[~active[:-1]]), 8)
+
+    def test_cpu_time(self):
+        t, data = self.signal()
+        rows, active, activity = simulate(data, self.RATE, odr_idle=12.5,
+            block_ms=200, hold_ms=2000, enter=300, exit=150)
+
+        duration = len(data) / self.RATE
+        n = len(data)
+
+        adaptive = cpu_time(len(rows), np.sum(active),
+            windows(active, 100, 1), duration)
+        continuous = cpu_time(n, n, windows(np.ones(n, dtype=bool), 100, 1),
+            duration)
+
+        self.assertLess(adaptive, continuous * 0.7)
+        self.assertEqual(windows(np.ones(250, dtype=bool), 100, 100), 2)
+        self.assertEqual(windows(np.ones(250, dtype=bool), 100, 50), 4)
+        self.assertEqual(windows(np.ones(250, dtype=bool), 100, 1), 151)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-f', '--files', nargs='+', default=INPUT_FILES,
+        help="captured data files in " + cfg.CAPTURED_DIR_PATH)
+    parser.add_argument('-p', '--plot', action='store_true',
+        help="plot the activity and the mode")
+    parser.add_argument('-t', '--test', action='store_true',
+        help="run the unit tests")
+    args = parser.parse_args()
+
+    if args.test:
+        unittest.main(argv=sys.argv[:1])
+        return
+
+    data = []
+
+    for f in args.files:
+        bunch = CustomBunch.load_csv(join(cfg.CAPTURED_DIR_PATH, f))
+        columns = range(len(bunch.attributes)) if ATTRIBUTES is None else \
+            [bunch.attributes.index(a) for a in ATTRIBUTES]
+        data.append(np.array(bunch.data[:, list(columns)], dtype=float))
+
+    data = np.concatenate(data)
+    rate = cfg.SAMPLE_FREQUENCY
+
+    rows, active, activity = simulate(data, rate)
+    report(len(data), rate, active, int(cfg.BLOCK_SIZE), int(cfg.BLOCK_HOP))
+
+    if args.plot:
+        plot(data, rate, rows, active, activity)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,405 @@
+"""
+capture_engine.py
+
+Captures data from a serial port at a high data rate without loss. The work is
+divided over three threads, so a slow stage does not stall the serial port:
+
+- The reader reads all bytes that are waiting at once and stores them in a ring
+  buffer. It does nothing else, so the buffer of the operating system is
+  emptied as fast as possible.
+- The parser takes the bytes from the ring buffer, splits them in lines and
+  converts the values. Lines that cannot be parsed are counted and skipped.
+- The writer appends the parsed samples in chunks to a CSV file in the
+  CustomBunch format, so the file can be loaded with CustomBunch.load_csv().
+
+The microcontroller data must be formatted as follows:
+<timestamp 1>,<timestamp 2>,<attribute 1>,<attribute 2>,etc
+
+Every sample gets the host time at which its last byte was read, which is
+passed to an optional callback together with the sample. This is used by
+synchronized_recorder.py to align the clocks of several devices.
+
+The counters of the engine show whether data was lost. The ring buffer
+overruns if the parser cannot keep up, and the number of bytes that did not
+fit is counted. Progress must be printed by the caller with status(), at a
+low rate, because printing every line is slow.
+
+Run this file to test the engine with a virtual serial port (pty) that sends
+data at 1 kHz.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+from custom_bunch import CustomBunch
+import os
+import queue
+import tempfile
+import threading
+import time
+import unittest
+import serial
+
+# TODO Set the size in bytes of the ring buffer between the reader and the
+#      parser
+RING_SIZE = 1 << 20
+
+# TODO Set the number of samples that are written to the file at once
+CHUNK_SAMPLES = 1000
+
+# Timeout in s of a read from the serial port, after which the reader checks
+# if it must stop
+READ_TIMEOUT = 0.05
+
+
+class RingBuffer:
+    """
+    Thread-safe ring buffer of bytes with a single writer and a single reader
+
+    If the buffer is full, the bytes that do not fit are discarded and counted
+    as overrun. Every write is marked with the time it was made, so the reader
+    knows when each byte arrived.
+    """
+    def __init__(self, size=RING_SIZE):
+        self.buffer = bytearray(size)
+        self.size = size
+        self.head = 0
+        self.count = 0
+        self.overrun = 0
+        self.high_water = 0
+        self.closed = False
+        self.marks = []
+        self.condition = threading.Condition()
+
+    def write(self, data, t=None):
+        with self.condition:
+            n = min(len(data), self.size - self.count)
+            self.overrun += len(data) - n
+
+            # Copy in at most two parts, before and after the end of the buffer
+            tail = (self.head + self.count) % self.size
+            first = min(n, self.size - tail)
+            self.buffer[tail:tail + first] = data[:first]
+            self.buffer[:n - first] = data[first:n]
+
+            self.count += n
+            self.high_water = max(self.high_water, self.count)
+
+            if n > 0:
+                # Position after the last byte of this write and its time
+                self.marks.append((self.count, t))
+
+            self.condition.notify()
+
+    def read(self, timeout=None):
+        """
+        Returns all bytes in the buffer, waits for data if it is empty. Returns
+        an empty bytes object on a timeout or when the buffer is closed and
+        empty.
+
+        Also returns the marks of the writes as a list of tuples with the
+        position in the returned bytes after the last byte of a write and the
+        time of that write.
+        """
+        with self.condition:
+            if self.count == 0 and not self.closed:
+                self.condition.wait(timeout)
+
+            n = self.count
+            first = min(n, self.size - self.head)
+            data = bytes(self.buffer[self.head:self.head + first]) + \
+                bytes(self.buffer[:n - first])
+
+            self.head = (self.head + n) % self.size
+            self.count = 0
+
+            marks = self.marks
+            self.marks = []
+
+            return data, marks
+
+    def close(self):
+        with self.condition:
+            self.closed = True
+            self.condition.notify()
+
+
+class CaptureEngine:
+    """
+    Captures samples from an opened serial port and writes them to a file
+
+    Parameters
+    ----------
+    ser : serial.Serial
+        Opened serial port. The timeout is changed to READ_TIMEOUT.
+    attributes : list of str
+        Names of the attributes of a sample.
+    label : str
+        Label of all samples.
+    filename : str
+        CSV file that is created, or None to not save the samples.
+    n_samples : int
+        Number of samples after which the capture finishes, or None to capture
+        until stop() is called.
+    on_sample : function
+        Optional function on_sample(timestamps, data, host_time) that is
+        called by the parser thread for every sample. host_time is the value
+        of time.perf_counter() when the last byte of the sample was read.
+    """
+    def __init__(self, ser, attributes, label, filename, n_samples=None,
+        ring_size=RING_SIZE, chunk_samples=CHUNK_SAMPLES, on_sample=None):
+        self.ser = ser
+        self.attributes = attributes
+        self.label = label
+        self.filename = filename
+        self.n_samples = n_samples
+        self.chunk_samples = chunk_samples
+        self.on_sample = on_sample
+
+        self.ring = RingBuffer(ring_size)
+        self.chunks = queue.Queue()
+        self.stopping = threading.Event()
+        self.finished = threading.Event()
+
+        # Counters
+        self.bytes_read = 0
+        self.samples = 0
+        self.invalid = 0
+        self.written = 0
+        self.reader_error = None
+        self.start_time = None
+
+        self.threads = [
+            threading.Thread(target=self._reader, daemon=True),
+            threading.Thread(target=self._parser, daemon=True),
+            threading.Thread(target=self._writer, daemon=True),
+        ]
+
+    def start(self):
+        self.ser.timeout = READ_TIMEOUT
+        self.start_time = time.perf_counter()
+
+        for t in self.threads:
+            t.start()
+
+    def stop(self):
+        """Stops reading and waits until all received data is written"""
+        self.stopping.set()
+
+        for t in self.threads:
+            t.join()
+
+    def wait(self, timeout=None):
+        """Waits until n_samples are captured, returns False on a timeout"""
+        return self.finished.wait(timeout)
+
+    def overrun(self):
+        """Returns the number of bytes that were lost in the ring buffer"""
+        return self.ring.overrun
+
+    def status(self):
+        """Returns a one-line summary of the counters"""
+        elapsed = max(time.perf_counter() - self.start_time, 1e-9)
+
+        return ("[{:>8}] {:7.1f} samples/s | {:6.1f} kB/s | invalid: {} | " \
+            "overrun: {} B | ring: {:3.0f}% max | written: {}").format(
+            self.samples, self.samples / elapsed,
+            self.bytes_read / elapsed / 1000.0, self.invalid,
+            self.ring.overrun, 100.0 * self.ring.high_water / self.ring.size,
+            self.written)
+
+    def _reader(self):
+        try:
+            while not self.stopping.is_set() and not self.finished.is_set():
+                data = self.ser.read(max(1, self.ser.in_waiting))
+
+                if len(data) > 0:
+                    self.bytes_read += len(data)
+                    self.ring.write(data, time.perf_counter())
+
+        except (OSError, serial.SerialException) as e:
+            # For example, the device was disconnected
+            self.reader_error = e
+
+        self.ring.close()
+
+    def _parser(self):
+        # Discard the first line, because capturing might be started in the
+        # middle of the transmission of a string
+        synchronized = False
+        partial = b''
+        chunk = []
+
+        while True:
+            data, marks = self.ring.read(READ_TIMEOUT)
+
+            if len(data) == 0:
+                if self.ring.closed:
+                    break
+                continue
+
+            lines = (partial + data).split(b'\n')
+
+            # Position of the end of the current line in data and the index of
+            # the first write that contains it
+            end = -len(partial)
+            mark = 0
+            partial = lines.pop()
+
+            for line in lines:
+                end += len(line) + 1
+
+                while marks[mark][0] < end:
+                    mark += 1
+
+                if not synchronized:
+                    synchronized = True
+                    continue
+
+                if self.finished.is_set():
+                    break
+
+                sample = self._parse(line)
+
+                if sample is None:
+                    self.invalid += 1
+                    continue
+
+                chunk.append(sample)
+                self.samples += 1
+
+                if self.on_sample is not None:
+                    self.on_sample(sample[0], sample[1], marks[mark][1])
+
+                if len(chunk) >= self.chunk_samples:
+                    self.chunks.put(chunk)
+                    chunk = []
+
+                if self.n_samples is not None and \
+                    self.samples >= self.n_samples:
+                    self.finished.set()
+
+        if len(chunk) > 0:
+            self.chunks.put(chunk)
+
+        self.chunks.put(None)
+        self.finished.set()
+
+    def _parse(self, line):
+        csv = line.rstrip(b'\r').split(b',')
+
+        if len(csv) < 2 + len(self.attributes):
+            return None
+
+        try:
+            timestamps = [int(d) for d in csv[:2]]
+            data = [float(d) for d in csv[2:2 + len(self.attributes)]]
+        except ValueError:
+            return None
+
+        return timestamps, data
+
+    def _writer(self):
+        if self.filename is None:
+            while self.chunks.get() is not None:
+                pass
+            return
+
+        with open(self.filename, 'w', newline='\n') as f:
+            f.write(','.join(['label', 'timestamp1', 'timestamp2'] +
+                list(self.attributes)) + '\n')
+
+            while True:
+                chunk = self.chunks.get()
+
+                if chunk is None:
+                    break
+
+                f.write(''.join('{},{},{},{}\n'.format(self.label, ts[0],
+                    ts[1], ','.join(repr(d) for d in data))
+                    for ts, data in chunk))
+                f.flush()
+
+                self.written += len(chunk)
+
+
+class TestCaptureEngine(unittest.TestCase):
+    """
+    Captures a 1 kHz stream from a simulated device on a pty
+    """
+    ODR = 1000
+    DURATION = 3.0
+    ATTRIBUTES = ['FP1','FP2','FP3','FP4','FP5','FP6','FP7','FP8','ToF']
+
+    def device(self, master):
+        # Send the samples in bursts every 10 ms, like a USB serial converter
+        n = int(self.ODR * self.DURATION)
+        t0 = time.perf_counter()
+        i = 0
+
+        while i < n:
+            burst = []
+
+            while i < n and i < (time.perf_counter() - t0) * self.ODR:
+                values = ','.join('{:.1f}'.format(260.0 + ((i + c) % 50))
+                    for c in range(len(self.ATTRIBUTES)))
+                burst.append('{},{},{}\n'.format(i, i + 1, values))
+                i += 1
+
+            data = ''.join(burst).encode('ascii')
+
+            while len(data) > 0:
+                data = data[os.write(master, data):]
+
+            time.sleep(0.01)
+
+    def test_pty_1khz(self):
+        if not hasattr(os, 'openpty'):
+            raise unittest.SkipTest('No pty available')
+
+        import tty
+        master, slave = os.openpty()
+        tty.setraw(slave)
+
+        ser = serial.Serial(os.ttyname(slave), 115200)
+        filename = join(tempfile.mkdtemp(), 'capture.csv')
+
+        # The first line is discarded
+        n = int(self.ODR * self.DURATION) - 1
+        engine = CaptureEngine(ser, self.ATTRIBUTES, 'test', filename, n)
+        engine.start()
+
+        device = threading.Thread(target=self.device, args=(master,))
+        device.start()
+
+        # Slow down the main thread, like a console would
+        while not engine.wait(0.5):
+            print(engine.status())
+
+        device.join()
+        engine.stop()
+        print(engine.status())
+        ser.close()
+        os.close(master)
+
+        self.assertEqual(engine.samples, n)
+        self.assertEqual(engine.invalid, 0)
+        self.assertEqual(engine.overrun(), 0)
+
+        bunch = CustomBunch.load_csv(filename)
+        self.assertEqual(len(bunch.data), n)
+        self.assertEqual(bunch.attributes, self.ATTRIBUTES)
+
+        # No sample is missing or out of order
+        self.assertTrue(all(bunch.timestamps[1:, 0] -
+            bunch.timestamps[:-1, 0] == 1))
+
+
+if __name__ == "__main__":
+    unittest.main()
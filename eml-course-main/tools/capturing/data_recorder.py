@@ -11,6 +11,11 @@ This script assumes that the microcontroller data is formatted as follows:
 IMPORTANT. The attributes are application depended and must be set manually in
 this file!. Refer to the list called 'attributes'.
 
+The data is captured by the CaptureEngine, which reads the serial port in a
+background thread and writes the samples to the file in chunks, so no data is
+lost at high data rates. The progress is printed every PROGRESS_INTERVAL
+seconds.
+
 Authors:    Jeroen Veen
             Hugo Arends
 Date:       October 2023
@@ -23,10 +28,10 @@ sys.path.append(join(dirname(realpath(__file__)), '..'))
 
 import config as cfg
 from custom_bunch import CustomBunch
+from capture_engine import CaptureEngine
 import comport_tools as cpt
 from os.path import join
 import argparse
-from numpy import array
 import serial
 
 # TODO Set the label for the recording here. Alternatively, use the command
@@ -41,6 +46,9 @@ ATTRIBUTE_NAMES = ['FP1','FP2','FP3','FP4','FP5','FP6','FP7','FP8','ToF']
 # TODO Set number of samples (or press CTRL+C to abort)
 N_SAMPLES = 10000
 
+# TODO Set the interval in seconds between two progress updates
+PROGRESS_INTERVAL = 0.5
+
 def main():
     print("Press CTRL+C to quit")
 
@@ -65,62 +73,45 @@ def main():
 
     print("Opened %s @ %sbps" % (ser.port, ser.baudrate))
 
-    cnt = 0
-    labels = []
-    timestamps = []
-    data = []
-
     # Reset serial
     ser.reset_output_buffer()
     ser.reset_input_buffer()
 
-    # Discard the first line, because logging might be started in the middle of
-    # the transmission of a string
-    ser.readline()
-
-    while cnt < N_SAMPLES:
-        try:
-            # Read a line
-            line = ser.readline()
-
-            if(len(line) == 0):
-                print("Data timeout")
-            else:
-                # Decode the line and split the comma seperated values
-                line = line.rstrip().decode("ascii")
-                csv = line.split(',')
-                
-                # Parse data required by custom bunch
-                timestamps.append([int(d) for d in csv[:2]])
-                data.append([float(d) for d in csv[2:2+len(ATTRIBUTE_NAMES)]])
-                labels.append(args.label)
-
-                # Print the data and a counter, so the number of samples is
-                # visible
-                cnt += 1
-                print(("[{:>8}] " + args.label + ',' + line).format(cnt))
-                
-        except KeyboardInterrupt:
-            print("Stop app")
-            break
-        
-        except Exception as e:
-            print("Abort app: %s" % e)
-            break
+    name = args.label
+    filename = join(cfg.CAPTURED_DIR_PATH, name+'.csv')
+
+    engine = CaptureEngine(ser, ATTRIBUTE_NAMES, args.label, filename,
+        N_SAMPLES)
+    engine.start()
+
+    try:
+        # Print the progress, so the number of samples is visible
+        while not engine.wait(PROGRESS_INTERVAL):
+            print(engine.status(), end='\r')
+
+    except KeyboardInterrupt:
+        print("\nStop app")
+
+    engine.stop()
+    print(engine.status())
+
+    if engine.reader_error is not None:
+        print("Abort app: %s" % engine.reader_error)
+
+    if engine.overrun() > 0:
+        print("WARNING: %d bytes were lost" % engine.overrun())
 
     ser.flush()
     ser.close()
     print("Closed %s" % ser.port)
 
-    # Create bunch from the recorded data
-    name = args.label
-    bunch = CustomBunch(data, timestamps=timestamps, attributes=ATTRIBUTE_NAMES,
-        labels=labels, name=name)
+    if engine.samples == 0:
+        print("No data captured")
+        return
+
+    # Load the bunch from the recorded data
+    bunch = CustomBunch.load_csv(filename)
     print(bunch.print_summary())
-    
-    # Save the bunch
-    filename = join(cfg.CAPTURED_DIR_PATH, name+'.csv')
-    bunch.save_csv(filename)
 
     print('Files written:')
     print(filename)
@@ -0,0 +1,436 @@
+"""
+event_scheduler.py
+
+Tests the event scheduler of lib/scheduler.c on the host and measures the
+utilization of the CPU that it reports.
+
+The C code of the library is compiled for the host with a port that uses
+POSIX threads. A second thread is the interrupt: it posts an event every
+period and signals a condition variable. Disabling the interrupts locks the
+mutex of the condition variable, and the sleep function waits on the
+condition variable, so an event that is posted after the scheduler checked
+for events wakes it up, like WFI on a Cortex-M.
+
+The handler of the event runs for a given time. The utilization that the
+scheduler measures with the time sleeping and the time not sleeping, is
+compared to the fraction of the period that the handler runs. If the handler
+takes longer than the period, events are coalesced, but none are lost.
+
+This script prints the utilization for a range of durations of the handler.
+Use commandline parameter -t to run the unit tests.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import c2exe
+import argparse
+import tempfile
+import unittest
+
+# TODO Set the period in us of the simulated interrupt
+PERIOD_US = 2000
+
+# TODO Set the duration in ms of a measurement
+DURATION_MS = 1000
+
+# TODO Set the durations in us of the handler to report
+COSTS_US = [0, 100, 250, 500, 1000, 1500]
+
+MAIN_FILE_STR = \
+'''
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "scheduler.h"
+
+/*
+ * Host port of the scheduler. Usage:
+ *
+ *   main run <period_us> <cost_us> <duration_ms>
+ *   main order
+ *
+ * run posts event 0 every period from the interrupt thread, and the handler
+ * runs for cost_us. order posts events without the interrupt thread and
+ * prints the order in which the handlers run.
+ */
+
+static pthread_mutex_t irq = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+static scheduler_t s;
+
+static volatile int stopping = 0;
+static uint32_t period_us;
+static uint32_t cost_us;
+static uint32_t posted;
+
+// Event to post when the interrupts are disabled, in the order mode
+static int post_on_disable = -1;
+static uint32_t blocked;
+
+static uint64_t now64(void)
+{{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return ((uint64_t)t.tv_sec * 1000000u) + ((uint64_t)t.tv_nsec / 1000u);
+}}
+
+static uint32_t now(void)
+{{
+    return (uint32_t)now64();
+}}
+
+static void disable(void)
+{{
+    pthread_mutex_lock(&irq);
+
+    // An interrupt that occurred just before the interrupts were disabled
+    if(post_on_disable >= 0)
+    {{
+        scheduler_post(&s, (uint32_t)post_on_disable);
+        post_on_disable = -1;
+    }}
+}}
+
+static void enable(void)
+{{
+    pthread_mutex_unlock(&irq);
+}}
+
+static void sleep_irq(void)
+{{
+    if(stopping)
+    {{
+        blocked++;
+        return;
+    }}
+
+    pthread_cond_wait(&wake, &irq);
+}}
+
+static const scheduler_port_t port =
+{{
+    disable, enable, sleep_irq, now
+}};
+
+static void *interrupt(void *arg)
+{{
+    (void)arg;
+
+    uint64_t next = now64() + period_us;
+
+    while(!stopping)
+    {{
+        while(now64() < next)
+        {{
+            struct timespec t = {{0, 50000}};
+            nanosleep(&t, NULL);
+        }}
+
+        next += period_us;
+
+        pthread_mutex_lock(&irq);
+        scheduler_post(&s, 0);
+        posted++;
+        pthread_cond_signal(&wake);
+        pthread_mutex_unlock(&irq);
+    }}
+
+    return NULL;
+}}
+
+static void work(void)
+{{
+    const uint64_t end = now64() + cost_us;
+
+    while(now64() < end)
+    {{}}
+}}
+
+static void run(const uint32_t duration_ms)
+{{
+    pthread_t thread;
+
+    scheduler_init(&s, &port);
+    scheduler_set(&s, 0, work);
+
+    pthread_create(&thread, NULL, interrupt, NULL);
+
+    // Skip the start-up
+    const uint64_t start = now64();
+    while(now64() < (start + 100000))
+    {{
+        scheduler_run(&s);
+    }}
+
+    scheduler_utilization(&s);
+
+    const uint64_t end = now64() + ((uint64_t)duration_ms * 1000u);
+    while(now64() < end)
+    {{
+        scheduler_run(&s);
+    }}
+
+    const float utilization = scheduler_utilization(&s);
+
+    // Handle the remaining events without sleeping
+    stopping = 1;
+    pthread_join(thread, NULL);
+
+    while(scheduler_pending(&s))
+    {{
+        scheduler_run(&s);
+    }}
+
+    printf("result,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%f\\n",
+        posted, s.runs[0], s.coalesced, s.sleeps, (double)utilization);
+}}
+
+static void handler(uint32_t event)
+{{
+    printf("handler,%" PRIu32 "\\n", event);
+
+    // A handler of a low priority event posts a high priority event
+    if(event == 5)
+    {{
+        scheduler_post(&s, 1);
+    }}
+}}
+
+static void handler1(void) {{ handler(1); }}
+static void handler2(void) {{ handler(2); }}
+static void handler3(void) {{ handler(3); }}
+static void handler5(void) {{ handler(5); }}
+static void handler6(void) {{ handler(6); }}
+
+static void order(void)
+{{
+    stopping = 1;
+
+    scheduler_init(&s, &port);
+    scheduler_set(&s, 1, handler1);
+    scheduler_set(&s, 2, handler2);
+    scheduler_set(&s, 3, handler3);
+    scheduler_set(&s, 5, handler5);
+    scheduler_set(&s, 6, handler6);
+
+    scheduler_post(&s, 6);
+    scheduler_post(&s, 3);
+    scheduler_post(&s, 5);
+    scheduler_post(&s, 2);
+    scheduler_post(&s, 2);
+    scheduler_post(&s, 4);
+
+    scheduler_run(&s);
+    printf("sleeps,%" PRIu32 ",%" PRIu32 "\\n", s.sleeps, s.coalesced);
+
+    // The interrupt occurs after the handlers ran, but before the scheduler
+    // checks for events with the interrupts disabled
+    post_on_disable = 3;
+    blocked = 0;
+    scheduler_run(&s);
+    printf("blocked,%" PRIu32 ",%d\\n", blocked, scheduler_pending(&s));
+
+    scheduler_run(&s);
+    printf("blocked,%" PRIu32 ",%d\\n", blocked, scheduler_pending(&s));
+}}
+
+int main(int argc, char *argv[])
+{{
+    if((argc >= 5) && (strcmp(argv[1], "run") == 0))
+    {{
+        period_us = (uint32_t)strtoul(argv[2], NULL, 0);
+        cost_us = (uint32_t)strtoul(argv[3], NULL, 0);
+        run((uint32_t)strtoul(argv[4], NULL, 0));
+    }}
+    else if((argc >= 2) && (strcmp(argv[1], "order") == 0))
+    {{
+        order();
+    }}
+    else
+    {{
+        return 1;
+    }}
+
+    return 0;
+}}
+'''
+
+_executable = None
+
+
+def executable():
+    """Builds the host port with the library once"""
+    global _executable
+
+    if _executable is None:
+        project_dir = join(tempfile.mkdtemp(), 'scheduler_project')
+        _executable = c2exe.build('event_scheduler', project_dir,
+            {'main.c': MAIN_FILE_STR.format()},
+            lib_files=['scheduler.h', 'scheduler.c'], libraries=['pthread'])
+
+    return _executable
+
+
+def measure(cost_us, period_us=PERIOD_US, duration_ms=DURATION_MS):
+    """
+    Runs the scheduler with an event every period
+
+    Parameters
+    ----------
+    cost_us : int
+        Duration in us of the handler of the event.
+    period_us : int
+        Period in us of the interrupt that posts the event.
+    duration_ms : int
+        Duration in ms of the measurement of the utilization.
+
+    Returns
+    -------
+    dict
+        posted, runs, coalesced and sleeps are counted over the whole run,
+        utilization is the fraction of the measurement not sleeping.
+    """
+    output = c2exe.run(executable(), ['run', period_us, cost_us,
+        duration_ms])
+
+    for line in output.splitlines():
+        fields = line.split(',')
+
+        if fields[0] == 'result':
+            return {
+                'posted': int(fields[1]),
+                'runs': int(fields[2]),
+                'coalesced': int(fields[3]),
+                'sleeps': int(fields[4]),
+                'utilization': float(fields[5]),
+            }
+
+    raise RuntimeError('No result: ' + output)
+
+
+def order():
+    """
+    Returns the order in which the handlers ran and the results of a post
+    just before the scheduler goes to sleep
+    """
+    output = c2exe.run(executable(), ['order'])
+
+    handlers = []
+    results = {}
+
+    for line in output.splitlines():
+        fields = line.split(',')
+
+        if fields[0] == 'handler':
+            handlers.append(int(fields[1]))
+        else:
+            results.setdefault(fields[0], []).append(
+                tuple(int(f) for f in fields[1:]))
+
+    return handlers, results
+
+
+def report(period_us=PERIOD_US, duration_ms=DURATION_MS):
+    """Prints the measured utilization for a range of handler durations"""
+    print()
+    print('{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}'.format('cost(us)',
+        'expected', 'measured', 'posted', 'sleeps', 'coalesced'))
+
+    for cost_us in COSTS_US:
+        r = measure(cost_us, period_us, duration_ms)
+
+        print('{:>10}{:>9.1f}%{:>9.1f}%{:>10}{:>10}{:>10}'.format(cost_us,
+            100.0 * min(cost_us / period_us, 1.0),
+            100.0 * r['utilization'], r['posted'], r['sleeps'],
+            r['coalesced']))
+
+    print()
+    print('Event every {} us, utilization over {} ms'.format(period_us,
+        duration_ms))
+
+
+class TestEventScheduler(unittest.TestCase):
+    """Tests lib/scheduler.c with a host port"""
+
+    def test_priority(self):
+        handlers, _ = order()
+
+        # Event 4 has no handler and is discarded. The handler of event 5
+        # posts event 1, which runs before event 6. Event 3 is posted again
+        # before the scheduler sleeps.
+        self.assertEqual(handlers, [2, 3, 5, 1, 6, 3])
+
+    def test_coalesced(self):
+        _, results = order()
+
+        # Event 2 was posted twice before its handler ran
+        self.assertEqual(results['sleeps'][0], (1, 1))
+
+    def test_post_before_sleep(self):
+        _, results = order()
+
+        # The event that was posted when the interrupts were disabled keeps
+        # the scheduler awake, and is handled by the next run
+        self.assertEqual(results['blocked'][0], (0, 1))
+        self.assertEqual(results['blocked'][1], (1, 0))
+
+    def test_no_lost_events(self):
+        for cost_us in [0, 500, 3000]:
+            r = measure(cost_us, duration_ms=300)
+            self.assertGreater(r['posted'], 0)
+            self.assertEqual(r['runs'] + r['coalesced'], r['posted'])
+
+    def test_sleeps(self):
+        r = measure(100, duration_ms=300)
+
+        # The scheduler sleeps in between almost all events. The host can
+        # delay the main thread, so a few events are coalesced.
+        self.assertGreater(r['sleeps'], r['posted'] // 2)
+        self.assertLess(r['coalesced'], r['posted'] // 10)
+
+    def test_utilization(self):
+        idle = measure(0, duration_ms=300)
+        self.assertLess(idle['utilization'], 0.1)
+
+        half = measure(PERIOD_US // 2, duration_ms=300)
+        self.assertAlmostEqual(half['utilization'], 0.5, delta=0.15)
+
+        # A handler that takes longer than the period never sleeps
+        busy = measure(2 * PERIOD_US, duration_ms=300)
+        self.assertGreater(busy['utilization'], 0.9)
+        self.assertGreater(busy['coalesced'], 0)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-p', '--period', type=int, default=PERIOD_US,
+        help="period in us of the events")
+    parser.add_argument('-d', '--duration', type=int, default=DURATION_MS,
+        help="duration in ms of a measurement")
+    parser.add_argument('-t', '--test', action='store_true',
+        help="run the unit tests")
+    args = parser.parse_args()
+
+    if args.test:
+        unittest.main(argv=sys.argv[:1])
+        return
+
+    report(args.period, args.duration)
+
+
+if __name__ == "__main__":
+    main()
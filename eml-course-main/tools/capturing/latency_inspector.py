@@ -0,0 +1,246 @@
+"""
+latency_inspector.py
+
+Shows the latency statistics of the pipeline of a demo application, from the
+moment a sample is ready until the label is output. The application must be
+compiled with LATENCY defined, see lib/latency.c. It periodically prints the
+statistics of every stage as follows:
+
+#latency,<stage>,<count>,<p50>,<p99>,<max>
+#histogram,<stage>,<lower>:<count>,<lower>:<count>,etc
+
+All values are in us. Other lines, such as the labels, are ignored. The
+statistics are read from the serial port, or with the commandline parameter -f
+from a file or from stdin, for example the output of a host build:
+
+make DEMO_FLAGS="-DSLIDING -DLATENCY"
+./build/frdm-kl25z | python3 latency_inspector.py -f -
+
+The histogram uses 4 bins per power of two, so the percentiles are the upper
+bound of a bin and have a resolution of 25%.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import config as cfg
+import comport_tools as cpt
+import serial
+import argparse
+import numpy as np
+
+# TODO Set the name of the stage of the total latency, which is the last stage
+#      of a report
+TOTAL_STAGE = 'total'
+
+# TODO Set the maximum width of the histogram bars in characters
+BAR_WIDTH = 50
+
+# Number of bits of the mantissa of the histogram bins, see lib/latency.c
+SUB_BITS = 2
+SUB_BINS = 1 << SUB_BITS
+
+
+def latency_bin(us):
+    """Returns the histogram bin of a latency in us, like lib/latency.c"""
+    if us < SUB_BINS:
+        return us
+
+    e = int(us).bit_length() - 1
+    m = (us >> (e - SUB_BITS)) & (SUB_BINS - 1)
+
+    return ((e - SUB_BITS + 1) * SUB_BINS) + m
+
+
+def latency_bin_lower(b):
+    """Returns the smallest latency in us that is counted in a bin"""
+    if b < SUB_BINS:
+        return b
+
+    e = (b // SUB_BINS) + SUB_BITS - 1
+    m = b % SUB_BINS
+
+    return (SUB_BINS + m) << (e - SUB_BITS)
+
+
+def percentile(histogram, p, maximum):
+    """Returns a percentile of a histogram like lib/latency.c
+
+    histogram is a list of (lower, count) tuples in ascending order.
+    """
+    counts = np.array([c for _, c in histogram])
+
+    if counts.sum() == 0:
+        return 0
+
+    rank = p * counts.sum() / 100.0
+    b = np.argmax(np.cumsum(counts) >= max(rank, 1))
+    upper = latency_bin_lower(latency_bin(histogram[b][0]) + 1) - 1
+
+    return min(upper, maximum)
+
+
+def parse(line, report):
+    """Adds a #latency or #histogram line to the report
+
+    Returns True if the line completes a report.
+    """
+    fields = line.split(',')
+
+    if fields[0] == '#latency' and len(fields) == 6:
+        count, p50, p99, maximum = [int(x) for x in fields[2:]]
+        report.setdefault(fields[1], {}).update(count=count, p50=p50,
+            p99=p99, max=maximum)
+
+    elif fields[0] == '#histogram' and len(fields) >= 2:
+        histogram = [tuple(int(x) for x in f.split(':')) for f in fields[2:]]
+        report.setdefault(fields[1], {})['histogram'] = histogram
+
+        return fields[1] == TOTAL_STAGE
+
+    return False
+
+
+def show(report, cnt):
+    """Prints a table of the percentiles and a histogram of the total latency"""
+    print()
+    print("Report {:d}".format(cnt))
+    print("{:<16}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}".format('stage',
+        'count', 'p50', 'p99', 'max', 'p50 hist', 'p99 hist'))
+
+    for name, stage in report.items():
+        if 'max' not in stage or 'histogram' not in stage:
+            continue
+
+        print("{:<16}{:>8}{:>8}us{:>8}us{:>8}us{:>8}us{:>8}us".format(
+            name, stage['count'], stage['p50'], stage['p99'], stage['max'],
+            percentile(stage['histogram'], 50, stage['max']),
+            percentile(stage['histogram'], 99, stage['max'])))
+
+    histogram = report.get(TOTAL_STAGE, {}).get('histogram', [])
+
+    if len(histogram) == 0:
+        return
+
+    print()
+    print("Histogram of the {} latency".format(TOTAL_STAGE))
+
+    peak = max(c for _, c in histogram)
+
+    for lower, count in histogram:
+        upper = latency_bin_lower(latency_bin(lower) + 1) - 1
+        bar = '#' * max(1, round(BAR_WIDTH * count / peak))
+        print("{:>8}-{:<8}us {:>8} {}".format(lower, upper, count, bar))
+
+
+def plot(report):
+    """Plots the histogram of the total latency"""
+    import matplotlib.pyplot as plt
+
+    histogram = report.get(TOTAL_STAGE, {}).get('histogram', [])
+
+    if len(histogram) == 0:
+        return
+
+    lower = np.array([l for l, _ in histogram])
+    upper = np.array([latency_bin_lower(latency_bin(l) + 1) for l in lower])
+    count = np.array([c for _, c in histogram])
+
+    plt.bar(lower, count, width=upper - lower, align='edge', edgecolor='k')
+    plt.xscale('symlog')
+    plt.xlabel('latency (us)')
+    plt.ylabel('windows')
+    plt.title('{} latency'.format(TOTAL_STAGE))
+    plt.show()
+
+
+def read_lines(args):
+    """Yields the lines from the serial port or the file"""
+    if args.file is not None:
+        f = sys.stdin if args.file == '-' else open(args.file)
+
+        for line in f:
+            yield line.rstrip()
+
+        if f is not sys.stdin:
+            f.close()
+
+        return
+
+    # Open COM port
+    ser = serial.Serial()
+    ser.port = cfg.COMPORT
+    ser.baudrate = cfg.BAUDRATE
+    ser.timeout = 3
+
+    try:
+        ser.open()
+    except:
+        print("Could not open %s @ %sbps" % (ser.port, ser.baudrate))
+        print("Available COM ports: " + str(cpt.available_comports()))
+        exit()
+
+    print("Opened %s @ %sbps" % (ser.port, ser.baudrate))
+
+    # Reset serial
+    ser.reset_output_buffer()
+    ser.reset_input_buffer()
+
+    # Discard the first line, because logging might be started in the middle of
+    # the transmission of a string
+    ser.readline()
+
+    try:
+        while True:
+            line = ser.readline()
+
+            if(len(line) == 0):
+                print("Data timeout")
+            else:
+                yield line.rstrip().decode("ascii", errors="replace")
+
+    finally:
+        ser.flush()
+        ser.close()
+        print("Closed %s" % ser.port)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-f', '--file', default=None,
+        help="read from a file, or from stdin if '-', instead of the COM port")
+    parser.add_argument('-p', '--plot', action='store_true',
+        help="plot the histogram of the last report")
+    args = parser.parse_args()
+
+    print("Press CTRL+C to quit")
+
+    report = {}
+    last = {}
+    cnt = 0
+
+    try:
+        for line in read_lines(args):
+            if parse(line, report):
+                cnt += 1
+                show(report, cnt)
+                last = report
+                report = {}
+
+    except KeyboardInterrupt:
+        print("Stop app")
+
+    if cnt == 0:
+        print("No latency statistics received, was LATENCY defined?")
+    elif args.plot:
+        plot(last)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,415 @@
+"""
+live_plotter.py
+
+Plots the data from a serial port live, for example to watch the forces on a
+CPR pad during a session. The plot is updated at a fixed frame rate, whatever
+the sample rate is:
+
+- A CaptureEngine reads the serial port in a background thread and stores the
+  samples in a SampleRing, so the plot never blocks the serial port.
+- Every frame, the last WINDOW seconds are decimated to the minimum and the
+  maximum of every pixel column, so the number of plotted points does not
+  depend on the sample rate and no peak is hidden.
+- Only the lines are redrawn on a copy of the static background of the axes
+  (blitting). The background is only redrawn when the y-axis must grow. The
+  readout above the axes is redrawn every READOUT_INTERVAL seconds, because
+  drawing text takes more time than drawing the lines.
+
+The readout shows the time needed to update a frame, the frame rate, and the
+lag: the time between the reception of the newest sample and the moment it is
+shown.
+
+This script assumes that the microcontroller data is formatted as follows:
+<timestamp 1>,<timestamp 2>,<attribute 1>,<attribute 2>,etc
+
+With the commandline parameter -f, a captured CSV file is replayed at the rate
+at which it was recorded instead. Run this file with -t to test the decimation
+and the frame time without a display.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+from capture_engine import CaptureEngine
+import comport_tools as cpt
+import argparse
+import threading
+import time
+import unittest
+import numpy as np
+import serial
+
+# TODO Set the attribute names from the microcontroller data here
+ATTRIBUTE_NAMES = ['FP1','FP2','FP3','FP4','FP5','FP6','FP7','FP8','ToF']
+
+# TODO Set the number of seconds that is shown
+WINDOW = 10.0
+
+# TODO Set the number of frames per second
+FPS = 25
+
+# TODO Set the interval in seconds between two updates of the readout
+READOUT_INTERVAL = 0.5
+
+# TODO Set the number of samples that is kept. Must be enough for WINDOW
+#      seconds at the highest sample rate.
+RING_SAMPLES = 1 << 16
+
+
+class SampleRing:
+    """
+    Thread-safe ring buffer of the last samples, with their device timestamp
+    in ms and the host time at which they were received
+    """
+    def __init__(self, n_attributes, size=RING_SAMPLES):
+        self.size = size
+        self.data = np.zeros((size, n_attributes))
+        self.device_ms = np.zeros(size)
+        self.host_s = np.zeros(size)
+        self.count = 0
+        self.lock = threading.Lock()
+
+    def append(self, timestamps, data, host_time):
+        with self.lock:
+            i = self.count % self.size
+            self.data[i] = data
+            self.device_ms[i] = timestamps[0]
+            self.host_s[i] = host_time
+            self.count += 1
+
+    def last(self, window):
+        """
+        Returns copies of the device times in s relative to the newest sample,
+        the data of the last window seconds, and the host time at which the
+        newest sample was received
+        """
+        with self.lock:
+            n = min(self.count, self.size)
+
+            if n == 0:
+                return np.zeros(0), np.zeros((0, self.data.shape[1])), None
+
+            # Oldest first
+            index = (np.arange(self.count - n, self.count)) % self.size
+            t = self.device_ms[index]
+            newest = index[-1]
+            received = self.host_s[newest]
+            x = (t - t[-1]) / 1000.0
+            first = np.searchsorted(x, -window)
+
+            return x[first:], self.data[index[first:]], received
+
+
+def decimate(x, y, x_min, x_max, columns):
+    """
+    Reduces the samples to the minimum and maximum of every pixel column
+
+    x must be ascending. Returns x and y with at most 2 points per column, the
+    minimum and the maximum of that column in the order they occur. If there
+    are less than 2 samples per column, the samples are returned unchanged.
+    """
+    if len(x) <= 2 * columns:
+        return x, y
+
+    column = np.clip(((x - x_min) * columns / (x_max - x_min)).astype(int),
+        0, columns - 1)
+
+    # First sample of every non-empty column
+    starts = np.flatnonzero(np.diff(column, prepend=-1))
+
+    lo = np.minimum.reduceat(y, starts)
+    hi = np.maximum.reduceat(y, starts)
+
+    # Index of the first minimum and maximum of every column, per channel
+    segment = np.cumsum(np.diff(column, prepend=-1) != 0) - 1
+    index = np.arange(len(y)).reshape((-1,) + (1,) * (y.ndim - 1))
+    first_lo = np.minimum.reduceat(np.where(y == lo[segment], index, len(y)),
+        starts)
+    first_hi = np.minimum.reduceat(np.where(y == hi[segment], index, len(y)),
+        starts)
+    lo_first = first_lo <= first_hi
+
+    xs = np.repeat(x_min + (column[starts] + 0.5) * (x_max - x_min) / columns,
+        2)
+    ys = np.empty((2 * len(starts),) + y.shape[1:])
+    ys[0::2] = np.where(lo_first, lo, hi)
+    ys[1::2] = np.where(lo_first, hi, lo)
+
+    return xs, ys
+
+
+class LivePlotter:
+    """
+    Plots the last window seconds of a SampleRing with blitting
+    """
+    def __init__(self, ring, attributes, window=WINDOW, ylim=None, title=''):
+        import matplotlib.pyplot as plt
+
+        self.ring = ring
+        self.window = window
+        self.auto_ylim = ylim is None
+
+        self.fig, self.ax = plt.subplots()
+        self.ax.set_xlim(-window, 0)
+        self.ax.set_ylim(*(ylim if ylim is not None else (-1.0, 1.0)))
+        self.ax.set_xlabel('time (s)')
+
+        # Animated artists are not drawn in the background
+        self.lines = [self.ax.plot([], [], label=a, animated=True)[0]
+            for a in attributes]
+        self.readout = self.fig.text(0.01, 0.99, title, animated=True,
+            va='top')
+        self.ax.legend(loc='upper right')
+
+        self.background = None
+        self.readout_background = None
+        self.readout_time = 0.0
+        self.fig.canvas.mpl_connect('draw_event', self.on_draw)
+
+        self.frames = 0
+        self.frame_time = 0.0
+        self.frame_period = 1.0 / FPS
+        self.lag = 0.0
+        self.previous = None
+
+    def on_draw(self, event):
+        # The figure was redrawn, for example after a resize
+        canvas = self.fig.canvas
+        self.background = canvas.copy_from_bbox(self.ax.bbox)
+        self.readout_background = canvas.copy_from_bbox(self.readout_bbox())
+
+        for artist in self.lines + [self.readout]:
+            self.fig.draw_artist(artist)
+
+    def readout_bbox(self):
+        """Returns the area above the axes"""
+        from matplotlib.transforms import Bbox
+
+        return Bbox([[self.fig.bbox.x0, self.ax.bbox.y1 + 1],
+            [self.fig.bbox.x1, self.fig.bbox.y1]])
+
+    def update(self):
+        """Draws a frame and returns the time needed in s"""
+        start = time.perf_counter()
+        canvas = self.fig.canvas
+
+        if self.background is None:
+            canvas.draw()
+
+        x, y, received = self.ring.last(self.window)
+
+        if len(x) > 0:
+            columns = max(int(self.ax.bbox.width), 1)
+            xs, ys = decimate(x, y, -self.window, 0.0, columns)
+
+            for i, line in enumerate(self.lines):
+                line.set_data(xs, ys[:, i])
+
+            if self.auto_ylim and self.grow_ylim(ys):
+                # The background with the axis must be redrawn
+                canvas.draw()
+
+            self.lag = time.perf_counter() - received
+
+        if self.previous is not None:
+            # Smooth the readout
+            self.frame_period += 0.1 * ((start - self.previous) -
+                self.frame_period)
+        self.previous = start
+
+        canvas.restore_region(self.background)
+
+        for line in self.lines:
+            self.ax.draw_artist(line)
+
+        canvas.blit(self.ax.bbox)
+
+        if start - self.readout_time >= READOUT_INTERVAL:
+            self.readout_time = start
+            self.readout.set_text("frame: {:5.1f} ms | {:4.1f} fps | " \
+                "lag: {:6.1f} ms".format(self.frame_time * 1000.0,
+                1.0 / self.frame_period, self.lag * 1000.0))
+
+            canvas.restore_region(self.readout_background)
+            self.fig.draw_artist(self.readout)
+            canvas.blit(self.readout_bbox())
+
+        canvas.flush_events()
+
+        self.frames += 1
+        self.frame_time = time.perf_counter() - start
+
+        return self.frame_time
+
+    def grow_ylim(self, y):
+        """Grows the y-axis to fit the data, returns True if it changed"""
+        lo, hi = self.ax.get_ylim()
+        y_min, y_max = np.min(y), np.max(y)
+
+        if y_min >= lo and y_max <= hi:
+            return False
+
+        margin = 0.1 * max(y_max - y_min, 1e-9)
+        self.ax.set_ylim(min(lo, y_min - margin), max(hi, y_max + margin))
+
+        return True
+
+    def run(self):
+        import matplotlib.pyplot as plt
+
+        timer = self.fig.canvas.new_timer(interval=int(1000 / FPS))
+        timer.add_callback(self.update)
+        timer.start()
+        plt.show()
+
+
+def replay(filename, ring, stop):
+    """Feeds the samples of a captured CSV file to the ring at their rate"""
+    bunch = CustomBunch.load_csv(filename)
+    t0 = time.perf_counter()
+    ms0 = bunch.timestamps[0, 0]
+
+    for timestamps, data in zip(bunch.timestamps, bunch.data):
+        delay = (timestamps[0] - ms0) / 1000.0 - (time.perf_counter() - t0)
+
+        if delay > 0:
+            time.sleep(delay)
+
+        if stop.is_set():
+            break
+
+        ring.append(timestamps, data, time.perf_counter())
+
+
+def main():
+    # Parse command line arguments
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-p', '--port', default=cfg.COMPORT,
+        help="serial port")
+    parser.add_argument('-f', '--file', default=None,
+        help="replay a captured CSV file instead of the serial port")
+    parser.add_argument('-y', '--ylim', type=float, nargs=2, default=None,
+        help="fixed limits of the y-axis")
+    parser.add_argument('-t', '--test', action='store_true',
+        help="run the tests without a display")
+    args = parser.parse_args()
+
+    if args.test:
+        unittest.main(argv=sys.argv[:1])
+
+    stop = threading.Event()
+
+    if args.file is not None:
+        filename = args.file if args.file.endswith('.csv') else \
+            join(cfg.CAPTURED_DIR_PATH, args.file + '.csv')
+        attributes = CustomBunch.load_csv(filename).attributes
+        ring = SampleRing(len(attributes))
+        source = threading.Thread(target=replay, args=(filename, ring, stop),
+            daemon=True)
+        source.start()
+        title = filename
+    else:
+        # Open COM port
+        ser = serial.Serial()
+        ser.port = args.port
+        ser.baudrate = cfg.BAUDRATE
+
+        try:
+            ser.open()
+        except:
+            print("Could not open %s @ %sbps" % (ser.port, ser.baudrate))
+            print("Available COM ports: " + str(cpt.available_comports()))
+            exit()
+
+        print("Opened %s @ %sbps" % (ser.port, ser.baudrate))
+
+        # Reset serial
+        ser.reset_output_buffer()
+        ser.reset_input_buffer()
+
+        attributes = ATTRIBUTE_NAMES
+        ring = SampleRing(len(attributes))
+        engine = CaptureEngine(ser, attributes, '', None,
+            on_sample=ring.append)
+        engine.start()
+        title = ser.port
+
+    plotter = LivePlotter(ring, attributes, ylim=args.ylim, title=title)
+    plotter.run()
+
+    stop.set()
+
+    if args.file is None:
+        engine.stop()
+        print(engine.status())
+        ser.close()
+        print("Closed %s" % ser.port)
+
+
+class TestLivePlotter(unittest.TestCase):
+    """
+    Tests the decimation and the frame time with 9 channels at 100 Hz
+    """
+    def test_decimate(self):
+        rng = np.random.default_rng(0)
+        x = np.sort(rng.uniform(-10.0, 0.0, 100000))
+        y = rng.normal(size=(len(x), 3))
+        y[12345, 1] = 100.0
+
+        xs, ys = decimate(x, y, -10.0, 0.0, 500)
+
+        self.assertLessEqual(len(xs), 2 * 500)
+        np.testing.assert_allclose(ys.max(axis=0), y.max(axis=0))
+        np.testing.assert_allclose(ys.min(axis=0), y.min(axis=0))
+
+        # The minimum and the maximum keep the order in which they occur
+        x = -10.0 + (np.arange(4000) + 0.5) * 10.0 / 4000
+        y = np.stack([np.tile([0.0, 1.0, 3.0, 2.0], 1000),
+            np.tile([3.0, 1.0, 0.0, 2.0], 1000)], axis=1)
+
+        xs, ys = decimate(x, y, -10.0, 0.0, 500)
+        np.testing.assert_allclose(ys[0:4, 0], [0.0, 3.0, 0.0, 3.0])
+        np.testing.assert_allclose(ys[0:4, 1], [3.0, 0.0, 3.0, 0.0])
+
+        # Few samples are not decimated
+        x = np.sort(rng.uniform(-10.0, 0.0, 100000))
+        y = rng.normal(size=(len(x), 3))
+        xs, ys = decimate(x[:100], y[:100], -10.0, 0.0, 500)
+        self.assertEqual(len(xs), 100)
+
+    def test_frame_time(self):
+        import matplotlib
+        matplotlib.use('Agg')
+
+        ring = SampleRing(len(ATTRIBUTE_NAMES))
+        plotter = LivePlotter(ring, ATTRIBUTE_NAMES)
+
+        # One minute of data at 100 Hz
+        t = np.arange(6000) * 10
+        for i, ms in enumerate(t):
+            ring.append((ms, ms), 1000.0 * np.sin(ms / 1000.0 +
+                np.arange(len(ATTRIBUTE_NAMES))), time.perf_counter())
+
+        # The first frames draw the background
+        plotter.update()
+        plotter.update()
+
+        frame_times = [plotter.update() for _ in range(50)]
+        print("Frame time: {:.1f} ms median, {:.1f} ms max".format(
+            1000.0 * np.median(frame_times), 1000.0 * np.max(frame_times)))
+
+        self.assertLess(np.median(frame_times), 1.0 / FPS)
+        self.assertEqual(plotter.lines[0].get_xdata().shape[0],
+            2 * int(plotter.ax.bbox.width))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,410 @@
+"""
+synchronized_recorder.py
+
+Records data from several serial ports at once and saves the data in one file
+as a CustomBunch. Can be used when a project needs several boards, for example
+one at the wrist and one at the ankle. The commandline parameter -p sets the
+ports, -n the names of the devices and -l the label. The file is saved with
+name '<label>.csv'. The data of every device is also saved unaligned with name
+'<label>_<name>.csv'.
+
+This script assumes that the microcontroller data is formatted as follows:
+<timestamp 1>,<timestamp 2>,<attribute 1>,<attribute 2>,etc
+
+The clocks of the devices are not synchronized, they have a different offset
+and run slightly too fast or too slow. Every device is captured by a
+CaptureEngine, which records the host time at which every sample was received.
+A ClockEstimator estimates the relation between timestamp 1 of a device and
+the host time:
+
+    host time = offset + slope * device time
+
+The slope differs from 1 by the drift of the device clock, which is reported
+in ppm.
+
+The delay of the serial connection is always positive and mostly random, so
+the sample with the smallest delay in every ESTIMATOR_WINDOW seconds is used
+for a least squares fit of the line. After the capture, the samples of all
+devices are mapped to the host time and resampled with linear interpolation to
+a common timebase at cfg.SAMPLE_FREQUENCY, or the rate set with -r. The
+attributes in the merged file are named '<name>_<attribute>'.
+
+IMPORTANT. The attributes are application depended and must be set manually in
+this file!. Refer to the list called 'attributes'.
+
+Run this file with -t to test the alignment with virtual serial ports (pty) fed
+by simulated devices with skewed clocks.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+from capture_engine import CaptureEngine
+import comport_tools as cpt
+import argparse
+import math
+import os
+import tempfile
+import threading
+import time
+import unittest
+import numpy as np
+import serial
+
+# TODO Set the label for the recording here. Alternatively, use the command
+#      line -l option
+LABEL_NAME = 'synchronized'
+
+# TODO Set the attribute names from the microcontroller data here. All devices
+#      must send the same attributes.
+ATTRIBUTE_NAMES = ['x','y','z']
+
+# TODO Set number of samples per device (or press CTRL+C to abort)
+N_SAMPLES = 10000
+
+# TODO Set the length in seconds of the device time in which the sample with
+#      the smallest delay is selected for the clock estimation
+ESTIMATOR_WINDOW = 0.5
+
+# TODO Set the interval in seconds between two progress updates
+PROGRESS_INTERVAL = 0.5
+
+
+class ClockEstimator:
+    """
+    Estimates the offset and drift of a device clock from the host time at
+    which its samples are received
+
+    The estimate is updated in O(1) per sample, so it is available during the
+    capture.
+    """
+    def __init__(self, window=ESTIMATOR_WINDOW):
+        self.window = window
+        self.window_start = None
+        self.best = None
+
+        # Running means and co-moments of the selected points, relative to the
+        # first point to prevent a loss of precision
+        self.origin = None
+        self.n = 0
+        self.mean_x = 0.0
+        self.mean_y = 0.0
+        self.m2_x = 0.0
+        self.c_xy = 0.0
+
+    def update(self, device_ms, host_s):
+        """Adds a sample with its device time in ms and host time in s"""
+        x = device_ms / 1000.0
+
+        if self.origin is None:
+            self.origin = (x, host_s)
+
+        x -= self.origin[0]
+        y = host_s - self.origin[1]
+
+        if self.window_start is None:
+            self.window_start = x
+        elif x - self.window_start >= self.window:
+            self._add(*self.best)
+            self.window_start = x
+            self.best = None
+
+        # The sample with the smallest delay has the smallest y - x
+        if self.best is None or (y - x) < (self.best[1] - self.best[0]):
+            self.best = (x, y)
+
+    def finish(self):
+        """Adds the selected point of the last window"""
+        if self.best is not None:
+            self._add(*self.best)
+            self.best = None
+            self.window_start = None
+
+    def _add(self, x, y):
+        self.n += 1
+        dx = x - self.mean_x
+        self.mean_x += dx / self.n
+        self.mean_y += (y - self.mean_y) / self.n
+        self.m2_x += dx * (x - self.mean_x)
+        self.c_xy += dx * (y - self.mean_y)
+
+    def slope(self):
+        return self.c_xy / self.m2_x if self.m2_x > 0 else 1.0
+
+    def drift_ppm(self):
+        """
+        Returns how much the device clock runs too fast in parts per million
+        """
+        return (1.0 / self.slope() - 1.0) * 1e6
+
+    def host_time(self, device_ms):
+        """Returns the host time in s of device times in ms"""
+        if self.origin is None:
+            return np.asarray(device_ms) / 1000.0
+
+        x = np.asarray(device_ms) / 1000.0 - self.origin[0]
+        return self.origin[1] + self.mean_y + self.slope() * (x - self.mean_x)
+
+
+class Device:
+    """
+    Samples and clock estimate of one device
+    """
+    def __init__(self, name):
+        self.name = name
+        self.device_ms = []
+        self.data = []
+        self.estimator = ClockEstimator()
+
+    def on_sample(self, timestamps, data, host_time):
+        self.device_ms.append(timestamps[0])
+        self.data.append(data)
+        self.estimator.update(timestamps[0], host_time)
+
+    def status(self):
+        return "{}: drift {:+7.0f} ppm".format(self.name,
+            self.estimator.drift_ppm())
+
+
+def align(devices, attributes, label, rate, name=""):
+    """
+    Resamples the data of all devices to a common timebase and returns it as
+    one CustomBunch
+
+    The timebase covers the period in which all devices have data. Timestamp 1
+    and 2 are both the time in ms since the start of the timebase.
+    """
+    host = []
+
+    for d in devices:
+        d.estimator.finish()
+        host.append(d.estimator.host_time(np.array(d.device_ms)))
+
+    start = max(h[0] for h in host)
+    stop = min(h[-1] for h in host)
+    t = np.arange(start, stop, 1.0 / rate)
+
+    data = np.column_stack([np.interp(t, h, np.array(d.data)[:, i])
+        for d, h in zip(devices, host) for i in range(len(attributes))])
+
+    ms = np.round((t - start) * 1000.0).astype(int)
+    timestamps = np.column_stack([ms, ms])
+
+    return CustomBunch(data, timestamps=timestamps,
+        attributes=['{}_{}'.format(d.name, a) for d in devices
+            for a in attributes],
+        labels=[label] * len(t), name=name)
+
+
+def main():
+    # Parse command line arguments
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-p', '--ports', nargs='+', default=[cfg.COMPORT],
+        help="serial ports of the devices")
+    parser.add_argument('-n', '--names', nargs='+', default=None,
+        help="names of the devices, default dev1, dev2, etc")
+    parser.add_argument('-l', '--label', default=LABEL_NAME,
+        help="label for the captured data")
+    parser.add_argument('-r', '--rate', type=float,
+        default=cfg.SAMPLE_FREQUENCY, help="sample rate in Hz of the output")
+    parser.add_argument('-t', '--test', action='store_true',
+        help="run the tests with simulated devices")
+    args = parser.parse_args()
+
+    if args.test:
+        unittest.main(argv=sys.argv[:1])
+
+    print("Press CTRL+C to quit")
+
+    names = args.names
+    if names is None:
+        names = ['dev{}'.format(i + 1) for i in range(len(args.ports))]
+
+    ports = []
+    devices = []
+    engines = []
+
+    for port, name in zip(args.ports, names):
+        # Open COM port
+        ser = serial.Serial()
+        ser.port = port
+        ser.baudrate = cfg.BAUDRATE
+
+        try:
+            ser.open()
+        except:
+            print("Could not open %s @ %sbps" % (ser.port, ser.baudrate))
+            print("Available COM ports: " + str(cpt.available_comports()))
+            exit()
+
+        print("Opened %s @ %sbps" % (ser.port, ser.baudrate))
+
+        # Reset serial
+        ser.reset_output_buffer()
+        ser.reset_input_buffer()
+
+        device = Device(name)
+        filename = join(cfg.CAPTURED_DIR_PATH,
+            '{}_{}.csv'.format(args.label, name))
+
+        ports.append(ser)
+        devices.append(device)
+        engines.append(CaptureEngine(ser, ATTRIBUTE_NAMES, args.label,
+            filename, N_SAMPLES, on_sample=device.on_sample))
+
+    for engine in engines:
+        engine.start()
+
+    try:
+        # Print the progress, so the number of samples is visible
+        while not all(engine.wait(PROGRESS_INTERVAL / len(engines))
+            for engine in engines):
+            print(' | '.join(d.status() + ', {} samples'.format(e.samples)
+                for d, e in zip(devices, engines)), end='\r')
+
+    except KeyboardInterrupt:
+        print("\nStop app")
+
+    for engine, ser in zip(engines, ports):
+        engine.stop()
+        print(ser.port + ' ' + engine.status())
+
+        if engine.overrun() > 0:
+            print("WARNING: %d bytes were lost" % engine.overrun())
+
+        ser.flush()
+        ser.close()
+        print("Closed %s" % ser.port)
+
+    if any(len(d.data) < 2 for d in devices):
+        print("Not enough data captured")
+        return
+
+    for d in devices:
+        print(d.status())
+
+    # Create bunch from the aligned data
+    bunch = align(devices, ATTRIBUTE_NAMES, args.label, args.rate,
+        args.label)
+    print(bunch.print_summary())
+
+    # Save the bunch
+    filename = join(cfg.CAPTURED_DIR_PATH, args.label+'.csv')
+    bunch.save_csv(filename)
+
+    print('Files written:')
+    print(filename)
+
+
+class TestSynchronizedCapture(unittest.TestCase):
+    """
+    Captures from simulated devices with skewed clocks on ptys
+
+    All devices sample the same sine wave, so after alignment the channels of
+    the devices must be equal.
+    """
+    ODR = 100.0
+    DURATION = 6.0
+    FREQUENCY = 1.0
+    AMPLITUDE = 1000.0
+
+    # Offset in ms and drift in ppm of the simulated device clocks
+    CLOCKS = [(123456, 5000.0), (7, -3000.0), (40000, 0.0)]
+
+    def device(self, master, offset, drift, t0):
+        # Send the samples that are due every 5 ms, with a random extra delay
+        # like a USB serial converter
+        rng = np.random.default_rng(offset)
+        k = 0
+
+        while True:
+            host = time.perf_counter() - t0
+            device_ms = offset + (1.0 + drift * 1e-6) * host * 1000.0
+            lines = []
+
+            while offset + k * 1000.0 / self.ODR <= device_ms:
+                sample_ms = offset + k * 1000.0 / self.ODR
+                true_s = (sample_ms - offset) / (1.0 + drift * 1e-6) / 1000.0
+                value = self.AMPLITUDE * math.sin(2 * math.pi *
+                    self.FREQUENCY * true_s)
+                lines.append('{},{},{:.2f},{:.2f},0.00\n'.format(
+                    int(sample_ms), int(sample_ms) + 1, value, -value))
+                k += 1
+
+            if host > self.DURATION:
+                break
+
+            data = ''.join(lines).encode('ascii')
+
+            while len(data) > 0:
+                data = data[os.write(master, data):]
+
+            time.sleep(0.005 + rng.exponential(0.002))
+
+    def test_skewed_clocks(self):
+        if not hasattr(os, 'openpty'):
+            raise unittest.SkipTest('No pty available')
+
+        import tty
+        directory = tempfile.mkdtemp()
+        t0 = time.perf_counter() + 0.2
+        masters = []
+        ports = []
+        devices = []
+        engines = []
+        threads = []
+
+        for i, (offset, drift) in enumerate(self.CLOCKS):
+            master, slave = os.openpty()
+            tty.setraw(slave)
+            masters.append(master)
+            ports.append(serial.Serial(os.ttyname(slave), 115200))
+            devices.append(Device('dev{}'.format(i + 1)))
+            engines.append(CaptureEngine(ports[-1], ATTRIBUTE_NAMES, 'test',
+                join(directory, 'dev{}.csv'.format(i + 1)),
+                on_sample=devices[-1].on_sample))
+            threads.append(threading.Thread(target=self.device,
+                args=(master, offset, drift, t0)))
+
+        for e in engines:
+            e.start()
+
+        for t in threads:
+            t.start()
+
+        for t in threads:
+            t.join()
+
+        time.sleep(0.2)
+
+        for e, p, m in zip(engines, ports, masters):
+            e.stop()
+            p.close()
+            os.close(m)
+
+        bunch = align(devices, ATTRIBUTE_NAMES, 'test', 50.0)
+
+        for d, (offset, drift) in zip(devices, self.CLOCKS):
+            print(d.status() + " (simulated {:+.0f} ppm)".format(drift))
+            self.assertAlmostEqual(d.estimator.drift_ppm(), drift, delta=500)
+
+        self.assertGreater(len(bunch.data), 4.0 * 50.0)
+
+        # The aligned channels differ less than a few ms of the sine wave
+        x = bunch.data[:, 0::len(ATTRIBUTE_NAMES)]
+        rms = np.sqrt(np.mean((x - x[:, :1]) ** 2, axis=0))
+        limit = self.AMPLITUDE * 2 * math.pi * self.FREQUENCY * 0.004
+        print("RMS difference to dev1: {}, limit {:.1f}".format(rms, limit))
+        self.assertTrue(np.all(rms < limit))
+
+
+if __name__ == "__main__":
+    main()
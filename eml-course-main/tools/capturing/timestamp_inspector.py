@@ -1,15 +1,38 @@
 """
 timestamp_inspector.py
 
-Logs data from a serial port to the terminal. Can be used at the beginning of a
-project to test datacommunication between a Python script and the
-microcontroller.
+Analyzes the timestamps of the data received from a serial port while it is
+captured. Can be used to check that the microcontroller samples at the expected
+output data rate (ODR), that no samples are lost and that the serial
+connection is fast enough.
+
+This script assumes that the microcontroller data is formatted as follows:
+<timestamp 1>,<timestamp 2>,<attribute 1>,<attribute 2>,etc
+
+Timestamp 1 is the moment a sample is taken and timestamp 2 the moment its
+processing is finished, both in ms. With the commandline parameter -u us, the
+timestamps are in us, as output by the demo applications with TIMESTAMP_US,
+and the distribution of the period has bins of 0.1 ms to show the jitter. The
+following is reported:
+
+- The distribution of the period between samples and its jitter.
+- Gaps, where one or more samples were dropped, and duplicate timestamps.
+  If the data contains a sequence number, set its attribute with the
+  commandline parameter -s to count dropped and duplicate samples exactly.
+- The effective ODR versus the nominal ODR.
+- The utilization of the serial connection and the headroom that is left.
+- The processing time timestamp 2 - timestamp 1.
+
+All statistics are updated in O(1) per line. The data is read from the serial
+port, or with the commandline parameter -f from a file or from stdin. A
+captured CSV file, with a header containing timestamp1, can also be replayed.
+The serial port can also be a virtual port, such as a pty.
 
 Authors:    Jeroen Veen
             Hugo Arends
-Date:       October 2023
+Date:       October 2026
 
-Copyright:  2023 HAN University of Applied Sciences. All Rights Reserved.
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
 """
 import sys
 from os.path import join, dirname, realpath
@@ -18,15 +41,277 @@ sys.path.append(join(dirname(realpath(__file__)), '..'))
 import config as cfg
 import comport_tools as cpt
 import serial
+import argparse
+import math
 import numpy as np
 
-def main():
-    print("Press CTRL+C to quit")
+# TODO Set the number of samples of the rolling statistics
+N_SAMPLES = 1000
+
+# TODO Set the period, as a multiple of the nominal period, above which the
+#      interval between two samples is reported as a gap
+GAP_FACTOR = 1.5
+
+# TODO Set the largest period in ms in the distribution. Longer periods are
+#      counted in the last bin.
+MAX_PERIOD_MS = 250
+
+# TODO Set the number of bits per character of the serial connection, which is
+#      10 for 8 data bits, no parity and 1 stop bit
+BITS_PER_CHAR = 10
+
+# Number of lines between two updates of the status line
+REFRESH_LINES = 25
+
+
+class RunningStatistics:
+    """
+    Mean, variance, minimum and maximum of all values with Welford's algorithm
+    """
+    def __init__(self):
+        self.n = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+        self.min = math.inf
+        self.max = -math.inf
+
+    def update(self, x):
+        self.n += 1
+        delta = x - self.mean
+        self.mean += delta / self.n
+        self.m2 += delta * (x - self.mean)
+        self.min = min(self.min, x)
+        self.max = max(self.max, x)
+
+    def std(self):
+        return math.sqrt(self.m2 / (self.n - 1)) if self.n > 1 else 0.0
+
+
+class RollingStatistics:
+    """
+    Mean and standard deviation of the last n values
+
+    The values are stored in a ring buffer and the sums are updated with the
+    value that is added and the value that is removed.
+    """
+    def __init__(self, n):
+        self.buffer = np.zeros(n)
+        self.index = 0
+        self.n = 0
+        self.sum = 0.0
+        self.sum2 = 0.0
+
+    def update(self, x):
+        if self.n == len(self.buffer):
+            old = self.buffer[self.index]
+            self.sum -= old
+            self.sum2 -= old * old
+        else:
+            self.n += 1
+
+        self.buffer[self.index] = x
+        self.index = (self.index + 1) % len(self.buffer)
+        self.sum += x
+        self.sum2 += x * x
+
+        # Prevent the accumulation of rounding errors
+        if self.index == 0:
+            self.sum = float(np.sum(self.buffer[:self.n]))
+            self.sum2 = float(np.sum(self.buffer[:self.n] ** 2))
+
+    def mean(self):
+        return self.sum / self.n if self.n > 0 else 0.0
+
+    def std(self):
+        if self.n < 2:
+            return 0.0
+
+        var = (self.sum2 - self.sum * self.sum / self.n) / (self.n - 1)
+        return math.sqrt(max(var, 0.0))
+
+
+class TimestampAnalyzer:
+    """
+    Streaming analysis of the timestamps of the received samples
+    """
+    def __init__(self, odr, baudrate, n_samples=N_SAMPLES, resolution=1.0):
+        self.odr = odr
+        self.period = 1000.0 / odr
+        self.baudrate = baudrate
+
+        self.lines = 0
+        self.invalid = 0
+        self.gaps = 0
+        self.dropped = 0
+        self.duplicates = 0
+        self.resets = 0
+        self.largest_gap = 0
+
+        # Histogram of the period with bins of resolution ms
+        self.resolution = resolution
+        self.histogram = np.zeros(int(round(MAX_PERIOD_MS / resolution)) + 1,
+            dtype=np.int64)
+
+        self.period_all = RunningStatistics()
+        self.period_rolling = RollingStatistics(n_samples)
+        self.processing = RunningStatistics()
+        self.chars_rolling = RollingStatistics(n_samples)
+
+        self.first_timestamp = None
+        self.prev_timestamp = None
+        self.prev_sequence = None
+
+    def update(self, timestamp1, timestamp2, n_chars, sequence=None):
+        """
+        Adds a sample with its timestamps in ms and the number of characters of
+        its line, including the line ending
+        """
+        self.lines += 1
+        self.chars_rolling.update(n_chars)
+        self.processing.update(timestamp2 - timestamp1)
+
+        if sequence is not None and self.prev_sequence is not None:
+            step = sequence - self.prev_sequence
+
+            if step == 0:
+                self.duplicates += 1
+            elif step > 1:
+                self.dropped += step - 1
+            elif step < 0:
+                self.resets += 1
+
+        if sequence is not None:
+            self.prev_sequence = sequence
+
+        if self.prev_timestamp is None:
+            self.first_timestamp = timestamp1
+            self.prev_timestamp = timestamp1
+            return
+
+        interval = timestamp1 - self.prev_timestamp
+
+        if interval < 0:
+            # The microcontroller was reset or the timestamp wrapped
+            self.resets += 1
+            self.first_timestamp = timestamp1
+            self.prev_timestamp = timestamp1
+            return
+
+        self.prev_timestamp = timestamp1
+
+        if interval == 0 and sequence is None:
+            self.duplicates += 1
+            return
+
+        if interval > GAP_FACTOR * self.period:
+            self.gaps += 1
+            self.largest_gap = max(self.largest_gap, interval)
+
+            if sequence is None:
+                self.dropped += max(round(interval / self.period) - 1, 0)
+
+        self.histogram[min(int(round(interval / self.resolution)),
+            len(self.histogram) - 1)] += 1
+        self.period_all.update(interval)
+        self.period_rolling.update(interval)
+
+    def effective_odr(self):
+        """Returns the ODR in Hz of the last samples"""
+        mean = self.period_rolling.mean()
+        return 1000.0 / mean if mean > 0 else 0.0
+
+    def utilization(self):
+        """
+        Returns the fraction of the serial bandwidth that is needed to send the
+        samples at the nominal ODR
+        """
+        bits_per_s = self.chars_rolling.mean() * BITS_PER_CHAR * self.odr
+        return bits_per_s / self.baudrate
+
+    def percentile(self, p):
+        """Returns a percentile of the period in ms from the histogram"""
+        total = np.sum(self.histogram)
+
+        if total == 0:
+            return 0
+
+        rank = max(p * total / 100.0, 1)
+        return np.argmax(np.cumsum(self.histogram) >= rank) * self.resolution
+
+    def status(self):
+        """Returns a one-line summary"""
+        return ("[{:>8}] ODR: {:6.1f}Hz | period: {:5.1f}+/-{:4.1f}ms | " \
+            "gaps: {:>4} | dropped: {:>5} | duplicates: {:>4} | " \
+            "serial: {:3.0f}%").format(self.lines, self.effective_odr(),
+            self.period_rolling.mean(), self.period_rolling.std(), self.gaps,
+            self.dropped, self.duplicates, 100.0 * self.utilization())
+
+    def report(self):
+        """Prints the summary of all samples"""
+        print()
+        print("Lines:            {:>10}".format(self.lines))
+        print("Invalid lines:    {:>10}".format(self.invalid))
+
+        if self.period_all.n == 0:
+            return
+
+        print("Nominal ODR:      {:>10.2f} Hz".format(self.odr))
+        print("Effective ODR:    {:>10.2f} Hz (last {} samples)".format(
+            self.effective_odr(), self.period_rolling.n))
+        print("Average ODR:      {:>10.2f} Hz".format(
+            1000.0 / self.period_all.mean))
+        print("Period:           {:>10.2f} ms, std {:.2f} ms, " \
+            "min {:g} ms, max {:g} ms".format(self.period_all.mean,
+            self.period_all.std(), self.period_all.min, self.period_all.max))
+        print("Period p1/p50/p99:{:>7g} / {:g} / {:g} ms".format(
+            self.percentile(1), self.percentile(50), self.percentile(99)))
+        print("Gaps:             {:>10} (largest {:g} ms)".format(self.gaps,
+            self.largest_gap))
+        print("Dropped samples:  {:>10} ({:.2f}%{})".format(self.dropped,
+            100.0 * self.dropped / (self.lines + self.dropped),
+            "" if self.prev_sequence is not None else ", estimated"))
+        print("Duplicates:       {:>10}".format(self.duplicates))
+        print("Resets:           {:>10}".format(self.resets))
+        print("Processing time:  {:>10.2f} ms, max {:g} ms".format(
+            self.processing.mean, self.processing.max))
+        print("Serial:           {:>10.1f} chars per line, {:.0f}% of {} bps" \
+            ", headroom {:.0f}%".format(self.chars_rolling.mean(),
+            100.0 * self.utilization(), self.baudrate,
+            100.0 * (1.0 - self.utilization())))
+
+        if self.utilization() > 1.0:
+            print("WARNING: the serial connection is too slow for the " \
+                "nominal ODR, samples will be lost")
+
+        print()
+        print("Distribution of the period")
+
+        peak = np.max(self.histogram)
+
+        for i in np.nonzero(self.histogram)[0]:
+            count = self.histogram[i]
+            label = ">=" if i == len(self.histogram) - 1 else "  "
+            print("{}{:>6g} ms {:>8} {}".format(label, i * self.resolution,
+                count, '#' * max(1, int(round(50 * count / peak)))))
+
+
+def read_lines(args):
+    """Yields the lines from the serial port or the file"""
+    if args.file is not None:
+        f = sys.stdin if args.file == '-' else open(args.file)
+
+        for line in f:
+            yield line.rstrip('\r\n'), len(line)
+
+        if f is not sys.stdin:
+            f.close()
+
+        return
 
     # Open COM port
     ser = serial.Serial()
-    ser.port = cfg.COMPORT
-    ser.baudrate = cfg.BAUDRATE
+    ser.port = args.port
+    ser.baudrate = args.baudrate
     ser.timeout = 3
 
     try:
@@ -46,46 +331,83 @@ def main():
     # the transmission of a string
     ser.readline()
 
-    N_SAMPLES = 1000
-    samples = []
-    cnt = 0
-
-    while True:
-        try:
-            # Read a line
+    try:
+        while True:
             line = ser.readline()
 
             if(len(line) == 0):
                 print("Data timeout")
             else:
-               # Decode the line and split the comma seperated values
-                line = line.rstrip().decode("ascii")
-                timestamp1, timestamp2, *data = line.split(',')
-                
-                samples.append(int(timestamp2) - int(timestamp1))
-
-                if len(samples) > N_SAMPLES:
-                    samples.pop(0)
-
-                avg_ms = np.average(samples)
-
-                cnt += 1
-
-                print("[{:>8}] average: {:5.1f}ms | min: {:5.1f}ms | " \
-                    "max: {:5.1f}ms".format(cnt,avg_ms,np.min(samples),
-                    np.max(samples)),end ='\r')
-                
-        except KeyboardInterrupt:
-            print("Stop app")
-            break
-        
-        except Exception as e:
-            print("Abort app: %s" % e)
-            break
-
-    ser.flush()
-    ser.close()
-    print("Closed %s" % ser.port)
+                yield line.rstrip().decode("ascii", errors="replace"), len(line)
+
+    finally:
+        ser.flush()
+        ser.close()
+        print("Closed %s" % ser.port)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-p', '--port', default=cfg.COMPORT,
+        help="serial port, also a virtual port such as /dev/pts/3")
+    parser.add_argument('-b', '--baudrate', type=int, default=cfg.BAUDRATE)
+    parser.add_argument('-f', '--file', default=None,
+        help="read from a file, or from stdin if '-', instead of the port")
+    parser.add_argument('-o', '--odr', type=float,
+        default=cfg.SAMPLE_FREQUENCY, help="nominal ODR in Hz")
+    parser.add_argument('-s', '--sequence', type=int, default=None,
+        help="attribute number, starting at 1, of a sequence number")
+    parser.add_argument('-u', '--unit', choices=['ms', 'us'], default='ms',
+        help="unit of the timestamps")
+    args = parser.parse_args()
+
+    print("Press CTRL+C to quit")
+
+    # Timestamps in us are converted to ms
+    scale = 1000.0 if args.unit == 'us' else 1.0
+    analyzer = TimestampAnalyzer(args.odr, args.baudrate,
+        resolution=0.1 if args.unit == 'us' else 1.0)
+
+    # Column of timestamp 1, changed by the header of a captured CSV file
+    column = 0
+
+    try:
+        for line, n_chars in read_lines(args):
+            fields = line.split(',')
+
+            if 'timestamp1' in fields:
+                column = fields.index('timestamp1')
+                continue
+
+            try:
+                timestamp1 = float(fields[column]) / scale
+                timestamp2 = float(fields[column + 1]) / scale
+                sequence = None
+
+                if args.sequence is not None:
+                    sequence = int(float(fields[column + 1 + args.sequence]))
+
+            except (ValueError, IndexError):
+                analyzer.invalid += 1
+                continue
+
+            # The label of a captured CSV file is not sent by the
+            # microcontroller
+            if column > 0:
+                n_chars -= len(','.join(fields[:column])) + 1
+
+            analyzer.update(timestamp1, timestamp2, n_chars, sequence)
+
+            if analyzer.lines % REFRESH_LINES == 0:
+                print(analyzer.status(), end='\r')
+
+    except KeyboardInterrupt:
+        print("Stop app")
+
+    except Exception as e:
+        print("Abort app: %s" % e)
+
+    analyzer.report()
 
 
 if __name__ == "__main__":
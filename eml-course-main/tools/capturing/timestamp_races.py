@@ -0,0 +1,367 @@
+"""
+timestamp_races.py
+
+Tests the timestamps in us of lib/timestamp.c for races with the tick
+interrupt.
+
+The time in us is the number of ticks, counted by the tick interrupt, plus
+the counter of the timer. The counter wraps and the interrupt increments the
+number of ticks at about the same moment, so a timestamp that is taken around
+the wrap can combine the old number of ticks with the new counter, and be a
+tick too early. Such races are rare on a microcontroller and therefore hard
+to test on one.
+
+The C code of the library is compiled for the host together with a simulated
+timer. Every read of the counter and of the pending flag advances the
+simulated time, and the interrupt handler can run at each of these points.
+Around the wrap, every combination of the moment the read starts and the
+moment the interrupt is taken is checked:
+
+- The timestamp is between the time at the start and at the end of the read.
+- The next timestamp is not less than the timestamp.
+
+The interrupt is taken as soon as it is pending, delayed by a higher priority
+interrupt, or not at all during the read because the interrupts are
+disabled. This script prints the results for the timers of the targets. Use
+commandline parameter -t to run the unit tests.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import c2exe
+import argparse
+import tempfile
+import unittest
+
+# TODO Set the number of counts that a read of the counter or of the pending
+#      flag takes, which is the time between two points at which the interrupt
+#      can be taken
+STEP = 3
+
+# Timers of the targets: name, counts per tick, tick in us, counts down
+TARGETS = [
+    ('FRDM-KL25Z SysTick', 48000, 1000, True),
+    ('NUCLEO-F411RE SysTick', 100000, 1000, True),
+    ('ATmega328P Timer0', 250, 1000, False),
+]
+
+MAIN_FILE_STR = \
+'''
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timestamp.h"
+
+/*
+ * Simulated timer. Usage:
+ *
+ *   main <period> <tick_us> <down> <ticks> <step> <pending> <interrupts>
+ *
+ * ticks is the 64-bit number of ticks at the first wrap. The interrupts are
+ * enabled, delayed or disabled.
+ */
+
+/// Maximum number of points during a read at which the interrupt is taken
+#define N_POINTS (16)
+
+static timestamp_t t;
+static uint64_t base;
+static uint64_t now;
+static uint64_t taken;
+static uint32_t step;
+static int point;
+static int isr_point;
+
+/*
+ * Takes the tick interrupt if it is pending and the interrupts are enabled
+ */
+static void interrupt(void)
+{{
+    if((isr_point >= 0) && (point++ >= isr_point) &&
+        ((now / t.period) > taken))
+    {{
+        taken++;
+        timestamp_tick(&t);
+    }}
+}}
+
+static uint32_t count(void)
+{{
+    interrupt();
+    now += step;
+
+    const uint32_t c = (uint32_t)(now % t.period);
+
+    interrupt();
+
+    return t.down ? (t.period - 1 - c) : c;
+}}
+
+static bool pending(void)
+{{
+    interrupt();
+    now += step;
+
+    const bool p = (now / t.period) > taken;
+
+    interrupt();
+
+    return p;
+}}
+
+/*
+ * Returns the simulated time in us
+ */
+static uint64_t us(void)
+{{
+    return ((base + (now / t.period)) * t.tick_us) +
+        (((now % t.period) * t.tick_us) / t.period);
+}}
+
+int main(int argc, char *argv[])
+{{
+    if(argc < 8)
+    {{
+        return 1;
+    }}
+
+    const uint32_t period = (uint32_t)strtoul(argv[1], NULL, 0);
+    const uint32_t tick_us = (uint32_t)strtoul(argv[2], NULL, 0);
+    const bool down = atoi(argv[3]) != 0;
+    const uint64_t ticks = strtoull(argv[4], NULL, 0);
+    const bool use_pending = atoi(argv[6]) != 0;
+    const char *interrupts = argv[7];
+
+    step = (uint32_t)strtoul(argv[5], NULL, 0);
+
+    // The ticks at the start of the simulated time, so the wrap at period is
+    // the wrap to the given number of ticks
+    base = ticks - 1;
+
+    const int first = (strcmp(interrupts, "disabled") == 0) ? -1 : 0;
+    const int last = (strcmp(interrupts, "delayed") == 0) ? N_POINTS : first;
+    const uint32_t window = (N_POINTS + 4) * step;
+
+    uint32_t checks = 0;
+    uint32_t errors = 0;
+
+    for(uint32_t phase=period-window; phase<=period+window; ++phase)
+    {{
+        // The interrupt of a wrap just before the read may not be taken yet
+        for(int late=0; late<2; ++late)
+        {{
+            for(int k=first; k<=last; ++k)
+            {{
+                timestamp_init(&t, count, use_pending ? pending : NULL,
+                    period, tick_us, down);
+
+                now = phase;
+                taken = now / period;
+                taken -= (late && (taken > 0)) ? 1 : 0;
+
+                const uint64_t n = base + taken;
+                t.ticks = (uint32_t)n;
+                t.epoch = (uint32_t)(n >> 32);
+
+                point = 0;
+                isr_point = k;
+
+                const uint64_t start = us();
+                const uint64_t t1 = timestamp_us(&t);
+                const uint64_t end = us();
+
+                // The interrupts are enabled after the read
+                isr_point = 0;
+                point = 0;
+                interrupt();
+
+                const uint64_t t2 = timestamp_us(&t);
+
+                checks++;
+
+                if((t1 < start) || (t1 > end) || (t2 < t1))
+                {{
+                    if(errors++ < 10)
+                    {{
+                        printf("error,%" PRIu32 ",%d,%d,%" PRIu64 ",%" PRIu64
+                            ",%" PRIu64 ",%" PRIu64 "\\n", phase, late, k,
+                            start, t1, end, t2);
+                    }}
+                }}
+            }}
+        }}
+    }}
+
+    printf("result,%" PRIu32 ",%" PRIu32 "\\n", checks, errors);
+
+    return 0;
+}}
+'''
+
+_executable = None
+
+
+def executable():
+    """Builds the simulated timer with the library once"""
+    global _executable
+
+    if _executable is None:
+        project_dir = join(tempfile.mkdtemp(), 'timestamp_project')
+        _executable = c2exe.build('timestamp_races', project_dir,
+            {'main.c': MAIN_FILE_STR.format()},
+            lib_files=['timestamp.h', 'timestamp.c'])
+
+    return _executable
+
+
+def check(period, tick_us, down, ticks=1, step=STEP, pending=True,
+    interrupts='delayed'):
+    """
+    Checks the timestamps around a wrap of the counter
+
+    Parameters
+    ----------
+    period : int
+        Number of counts per tick.
+    tick_us : int
+        Duration of a tick in us.
+    down : bool
+        The counter counts down.
+    ticks : int
+        Number of ticks, up to 64 bits, after the wrap.
+    step : int
+        Number of counts that a read of the counter or the pending flag takes.
+    pending : bool
+        Let the library read the pending flag.
+    interrupts : str
+        'enabled' to take the interrupt as soon as it is pending, 'delayed' to
+        take it at any point during the read, or 'disabled' to take it after
+        the read.
+
+    Returns
+    -------
+    checks : int
+        Number of combinations that were checked.
+    errors : list
+        Tuples (phase, late, point, start, t1, end, t2) of the first failed
+        combinations, with the time in us at the start and the end of the
+        read, the timestamp and the next timestamp.
+    n_errors : int
+        Number of failed combinations.
+    """
+    output = c2exe.run(executable(), [period, tick_us, int(down), ticks,
+        step, int(pending), interrupts])
+
+    errors = []
+    checks = n_errors = 0
+
+    for line in output.splitlines():
+        fields = line.split(',')
+
+        if fields[0] == 'result':
+            checks, n_errors = int(fields[1]), int(fields[2])
+        elif fields[0] == 'error':
+            errors.append(tuple(int(f) for f in fields[1:]))
+
+    return checks, errors, n_errors
+
+
+def report(step=STEP):
+    """Prints the results for the timers of the targets"""
+    print()
+    print('{:<24}{:>10}{:>12}{:>10}{:>10}{:>10}'.format('timer', 'counts',
+        'us/count', 'enabled', 'delayed', 'disabled'))
+
+    for name, period, tick_us, down in TARGETS:
+        results = []
+
+        for interrupts in ['enabled', 'delayed', 'disabled']:
+            checks, _, n_errors = check(period, tick_us, down, step=step,
+                interrupts=interrupts)
+            results.append('{}/{}'.format(n_errors, checks))
+
+        print('{:<24}{:>10}{:>12.3f}{:>10}{:>10}{:>10}'.format(name, period,
+            tick_us / period, *results))
+
+    print()
+    print('Failed combinations per check of the interrupts')
+
+
+class TestTimestampRaces(unittest.TestCase):
+    """Tests lib/timestamp.c with a simulated timer"""
+
+    def test_down_counter(self):
+        for interrupts in ['enabled', 'delayed', 'disabled']:
+            checks, errors, _ = check(48000, 1000, True,
+                interrupts=interrupts)
+            self.assertGreater(checks, 0)
+            self.assertEqual(errors, [], interrupts)
+
+    def test_up_counter(self):
+        for interrupts in ['enabled', 'delayed', 'disabled']:
+            checks, errors, _ = check(250, 1000, False, step=1,
+                interrupts=interrupts)
+            self.assertGreater(checks, 0)
+            self.assertEqual(errors, [], interrupts)
+
+    def test_slow_read(self):
+        # A read that takes a large part of a tick
+        checks, errors, _ = check(250, 1000, False, step=10)
+        self.assertEqual(errors, [])
+
+    def test_epoch(self):
+        # The 32-bit number of ticks wraps to 0 at the wrap of the counter
+        checks, errors, _ = check(48000, 1000, True, ticks=1 << 32)
+        self.assertEqual(errors, [])
+
+        checks, errors, _ = check(48000, 1000, True, ticks=(1 << 32) + 1,
+            interrupts='disabled')
+        self.assertEqual(errors, [])
+
+        checks, errors, _ = check(250, 1000, False, ticks=5 << 32)
+        self.assertEqual(errors, [])
+
+    def test_without_pending_flag(self):
+        # Without the pending flag, the timestamps are correct as long as the
+        # interrupt is taken immediately
+        checks, errors, _ = check(48000, 1000, True, pending=False,
+            interrupts='enabled')
+        self.assertEqual(errors, [])
+
+        # With the interrupts disabled, the timestamp after the wrap is a
+        # tick too early and the time goes back
+        checks, errors, n_errors = check(48000, 1000, True, pending=False,
+            interrupts='disabled')
+        self.assertGreater(n_errors, 0)
+
+        phase, late, point, start, t1, end, t2 = errors[0]
+        self.assertLess(t1, start)
+        self.assertAlmostEqual(start - t1, 1000, delta=10)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-s', '--step', type=int, default=STEP,
+        help="number of counts that a read of the counter takes")
+    parser.add_argument('-t', '--test', action='store_true',
+        help="run the unit tests")
+    args = parser.parse_args()
+
+    if args.test:
+        unittest.main(argv=sys.argv[:1])
+        return
+
+    report(args.step)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,465 @@
+"""
+wakeup_registers.py
+
+Shows and tests the register configuration of the wake-up engines of the
+MMA8451 and the LSM6DSO by lib/wakeup.c.
+
+The thresholds of the wake-up engines are set in mg, like the thresholds of
+the activity in lib/acquisition.c, but the registers have a coarse
+resolution. This script prints the register values and the effective
+threshold and duration for the settings below, so the quantization can be
+taken into account when choosing the thresholds.
+
+The C code of the library is compiled for the host together with a register
+map, which logs every register access. The unit tests check the register
+values and the order of the accesses, for example that the MMA8451 is in
+standby while it is configured. Use commandline parameter -t to run the unit
+tests.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import c2exe
+import argparse
+import tempfile
+import unittest
+
+# TODO Set the threshold in mg and the duration in ms of the wake-up, for
+#      example half the ACTIVITY_ENTER_MG of the demo applications, and the
+#      output data rate in Hz while waiting for motion
+THRESHOLD_MG = 30.0
+DURATION_MS = 20.0
+ODR = 12.5
+
+# TODO Set the oversampling mode of the MMA8451, the MODS bits of CTRL_REG2.
+#      The driver uses the high resolution mode.
+MODS = 2
+
+# TODO Set the full scale in mg of the LSM6DSO
+FS_MG = 2000.0
+
+# Registers
+MMA8451_TRANSIENT_CFG = 0x1D
+MMA8451_TRANSIENT_SRC = 0x1E
+MMA8451_TRANSIENT_THS = 0x1F
+MMA8451_TRANSIENT_COUNT = 0x20
+MMA8451_CTRL_REG1 = 0x2A
+MMA8451_CTRL_REG2 = 0x2B
+MMA8451_MODS_HR = 0x02
+MMA8451_CTRL_REG4 = 0x2D
+MMA8451_CTRL_REG5 = 0x2E
+
+LSM6DSO_WAKE_UP_SRC = 0x1B
+LSM6DSO_TAP_CFG0 = 0x56
+LSM6DSO_TAP_CFG2 = 0x58
+LSM6DSO_WAKE_UP_THS = 0x5B
+LSM6DSO_WAKE_UP_DUR = 0x5C
+LSM6DSO_MD1_CFG = 0x5E
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wakeup.h"
+
+/*
+ * Register map that logs every access. Usage:
+ *
+ *   main <fail> <reg>=<value>,... <command> <parameters>
+ *
+ * The access with index fail fails, use -1 to let all accesses succeed.
+ */
+static uint8_t regs[256];
+static int fail = -1;
+static int accesses = 0;
+
+static bool mock_write(void *handle, const uint8_t reg, const uint8_t value)
+{{
+    (void)handle;
+
+    if(accesses++ == fail)
+    {{
+        printf("F,%u,%u\\n", reg, value);
+        return false;
+    }}
+
+    regs[reg] = value;
+    printf("W,%u,%u\\n", reg, value);
+
+    return true;
+}}
+
+static bool mock_read(void *handle, const uint8_t reg, uint8_t *value)
+{{
+    (void)handle;
+
+    if(accesses++ == fail)
+    {{
+        printf("F,%u,0\\n", reg);
+        return false;
+    }}
+
+    *value = regs[reg];
+    printf("R,%u,%u\\n", reg, *value);
+
+    return true;
+}}
+
+int main(int argc, char *argv[])
+{{
+    const wakeup_bus_t bus = {{mock_write, mock_read, NULL}};
+
+    fail = atoi(argv[1]);
+
+    for(char *s = strtok(argv[2], ","); s != NULL; s = strtok(NULL, ","))
+    {{
+        unsigned int reg, value;
+
+        if(sscanf(s, "%u=%u", &reg, &value) == 2)
+        {{
+            regs[reg] = (uint8_t)value;
+        }}
+    }}
+
+    const char *command = argv[3];
+    float p[4] = {{0}};
+
+    for(int i=4; (i<argc) && (i<8); ++i)
+    {{
+        p[i-4] = (float)atof(argv[i]);
+    }}
+
+    bool ok = false;
+    bool flag = false;
+    unsigned int value = 0;
+
+    if(strcmp(command, "mma8451_init") == 0)
+    {{
+        ok = wakeup_mma8451_init(&bus, p[0], p[1], p[2]);
+    }}
+    else if(strcmp(command, "mma8451_drdy") == 0)
+    {{
+        ok = wakeup_mma8451_drdy(&bus, p[0] != 0.0f);
+    }}
+    else if(strcmp(command, "mma8451_source") == 0)
+    {{
+        ok = wakeup_mma8451_source(&bus, &flag);
+    }}
+    else if(strcmp(command, "mma8451_ths") == 0)
+    {{
+        value = wakeup_mma8451_ths(p[0]);
+        ok = true;
+    }}
+    else if(strcmp(command, "mma8451_count_ms") == 0)
+    {{
+        // In us, to return an integer
+        value = (unsigned int)((1000.0f * wakeup_mma8451_count_ms(p[0],
+            (uint8_t)p[1])) + 0.5f);
+        ok = true;
+    }}
+    else if(strcmp(command, "mma8451_count") == 0)
+    {{
+        value = wakeup_mma8451_count(p[0], p[1], (uint8_t)p[2]);
+        ok = true;
+    }}
+    else if(strcmp(command, "lsm6dso_init") == 0)
+    {{
+        ok = wakeup_lsm6dso_init(&bus, p[0], p[1], p[2], p[3]);
+    }}
+    else if(strcmp(command, "lsm6dso_source") == 0)
+    {{
+        ok = wakeup_lsm6dso_source(&bus, &flag);
+    }}
+    else if(strcmp(command, "lsm6dso_ths") == 0)
+    {{
+        value = wakeup_lsm6dso_ths(p[0], p[1], &flag);
+        ok = true;
+    }}
+    else if(strcmp(command, "lsm6dso_dur") == 0)
+    {{
+        value = wakeup_lsm6dso_dur(p[0], p[1]);
+        ok = true;
+    }}
+
+    printf("result,%d,%d,%u\\n", (int)ok, (int)flag, value);
+
+    return 0;
+}}
+'''
+
+_executable = None
+
+
+def executable():
+    """Builds the register map with the library once"""
+    global _executable
+
+    if _executable is None:
+        project_dir = join(tempfile.mkdtemp(), 'wakeup_project')
+        _executable = c2exe.build('wakeup_registers', project_dir,
+            {'main.c': MAIN_FILE_STR.format()},
+            lib_files=['wakeup.h', 'wakeup.c'])
+
+    return _executable
+
+
+def call(command, *parameters, regs={}, fail=-1):
+    """
+    Calls a function of the library on the register map
+
+    Parameters
+    ----------
+    command : str
+        Name of the function without the wakeup_ prefix.
+    parameters : float
+        Parameters of the function after the bus.
+    regs : dict
+        Initial values of the registers, the others are 0.
+    fail : int
+        Index of the register access that fails, or -1.
+
+    Returns
+    -------
+    result : tuple
+        Return value, the boolean output parameter and the value returned by
+        the conversion functions.
+    accesses : list
+        Tuples (access, register, value), where access is 'R', 'W' or 'F'
+        for a failed access.
+    regs : dict
+        Final values of the registers.
+    """
+    presets = ','.join('{}={}'.format(r, v) for r, v in regs.items()) or '-'
+    output = c2exe.run(executable(), [fail, presets, command] +
+        list(parameters))
+
+    accesses = []
+    final = dict(regs)
+    result = None
+
+    for line in output.splitlines():
+        fields = line.split(',')
+
+        if fields[0] == 'result':
+            result = (fields[1] == '1', fields[2] == '1', int(fields[3]))
+        else:
+            accesses.append((fields[0], int(fields[1]), int(fields[2])))
+
+            if fields[0] == 'W':
+                final[int(fields[1])] = int(fields[2])
+
+    return result, accesses, final
+
+
+def report(threshold_mg=THRESHOLD_MG, duration_ms=DURATION_MS, odr=ODR,
+    fs_mg=FS_MG, mods=MODS):
+    """Prints the register values and the effective threshold and duration"""
+    ths = call('mma8451_ths', threshold_mg)[0][2]
+    count = call('mma8451_count', duration_ms, odr, mods)[0][2]
+    count_ms = call('mma8451_count_ms', odr, mods)[0][2] / 1000.0
+
+    print()
+    print('Requested: {:.1f} mg for {:.1f} ms at {:.2f} Hz'.format(
+        threshold_mg, duration_ms, odr))
+    print()
+    print('{:<10}{:<22}{:>14}{:>14}'.format('sensor', 'registers',
+        'threshold', 'duration'))
+    print('{:<10}{:<22}{:>11.1f} mg{:>11.1f} ms'.format('MMA8451',
+        'THS={} COUNT={}'.format(ths, count), ths * 63.0, count * count_ms))
+
+    (_, fine, ths), _, _ = call('lsm6dso_ths', threshold_mg, fs_mg)
+    dur = call('lsm6dso_dur', duration_ms, odr)[0][2]
+    lsb = fs_mg / (256.0 if fine else 64.0)
+
+    print('{:<10}{:<22}{:>11.1f} mg{:>11.1f} ms'.format('LSM6DSO',
+        'THS={} W={} DUR={}'.format(ths, int(fine), dur), ths * lsb,
+        dur * 1000.0 / odr))
+
+
+class TestWakeupRegisters(unittest.TestCase):
+    """Tests lib/wakeup.c on a register map"""
+
+    # MMA8451 active at 100 Hz in the high resolution mode with DRDY on INT1,
+    # like the driver
+    MMA8451 = {MMA8451_CTRL_REG1: 0x1D, MMA8451_CTRL_REG2: 0x02,
+        MMA8451_CTRL_REG4: 0x01, MMA8451_CTRL_REG5: 0x01}
+
+    def test_mma8451_quantization(self):
+        self.assertEqual(call('mma8451_ths', 30.0)[0][2], 1)
+        self.assertEqual(call('mma8451_ths', 0.0)[0][2], 1)
+        self.assertEqual(call('mma8451_ths', 150.0)[0][2], 2)
+        self.assertEqual(call('mma8451_ths', 10000.0)[0][2], 127)
+
+        # Period of the debounce counter in us per oversampling mode, see
+        # table 43 of the datasheet
+        for odr, periods in [(800.0, [1250, 1250, 1250, 1250]),
+                             (100.0, [10000, 10000, 2500, 10000]),
+                             (12.5, [20000, 80000, 2500, 80000]),
+                             (1.5625, [20000, 80000, 2500, 640000])]:
+            for mods, period in enumerate(periods):
+                self.assertEqual(call('mma8451_count_ms', odr, mods)[0][2],
+                    period)
+
+        # The high resolution mode of the driver counts every 2.5 ms
+        hr = MMA8451_MODS_HR
+        self.assertEqual(call('mma8451_count', 100.0, 100.0, hr)[0][2], 40)
+        self.assertEqual(call('mma8451_count', 160.0, 1.5625, hr)[0][2], 64)
+        self.assertEqual(call('mma8451_count', 20.0, 12.5, hr)[0][2], 8)
+        self.assertEqual(call('mma8451_count', 1e5, 100.0, hr)[0][2], 255)
+
+        # The normal mode counts at most every 20 ms
+        self.assertEqual(call('mma8451_count', 160.0, 1.5625, 0)[0][2], 8)
+
+    def test_mma8451_init(self):
+        result, accesses, regs = call('mma8451_init', 150.0, 160.0, 12.5,
+            regs=self.MMA8451)
+
+        self.assertTrue(result[0])
+        self.assertEqual(regs[MMA8451_TRANSIENT_CFG], 0x1E)
+        self.assertEqual(regs[MMA8451_TRANSIENT_THS], 2)
+        self.assertEqual(regs[MMA8451_TRANSIENT_COUNT], 64)
+
+        # Transient interrupt enabled and routed to INT2, DRDY unchanged
+        self.assertEqual(regs[MMA8451_CTRL_REG4], 0x21)
+        self.assertEqual(regs[MMA8451_CTRL_REG5], 0x01)
+        self.assertEqual(regs[MMA8451_CTRL_REG1], 0x1D)
+
+        self.assert_standby(accesses)
+
+    def test_mma8451_drdy(self):
+        regs = dict(self.MMA8451)
+        regs[MMA8451_CTRL_REG4] = 0x21
+
+        result, accesses, regs = call('mma8451_drdy', 0, regs=regs)
+        self.assertTrue(result[0])
+        self.assertEqual(regs[MMA8451_CTRL_REG4], 0x20)
+        self.assert_standby(accesses)
+
+        result, accesses, regs = call('mma8451_drdy', 1, regs=regs)
+        self.assertEqual(regs[MMA8451_CTRL_REG4], 0x21)
+        self.assertEqual(regs[MMA8451_CTRL_REG1], 0x1D)
+
+    def test_mma8451_failure(self):
+        # The mode is restored if the configuration fails
+        result, accesses, regs = call('mma8451_init', 150.0, 160.0, 12.5,
+            regs=self.MMA8451, fail=3)
+
+        self.assertFalse(result[0])
+        self.assertEqual(accesses[-1], ('W', MMA8451_CTRL_REG1, 0x1D))
+        self.assertNotIn(MMA8451_CTRL_REG4,
+            [r for a, r, v in accesses if a == 'W'])
+
+        # Nothing is written if the modes cannot be read
+        for fail in [0, 1]:
+            result, accesses, regs = call('mma8451_init', 150.0, 160.0, 12.5,
+                regs=self.MMA8451, fail=fail)
+
+            self.assertFalse(result[0])
+            self.assertEqual(len(accesses), fail + 1)
+            self.assertNotIn('W', [a for a, r, v in accesses])
+
+    def test_mma8451_source(self):
+        self.assertEqual(call('mma8451_source',
+            regs={MMA8451_TRANSIENT_SRC: 0x44})[0], (True, True, 0))
+        self.assertEqual(call('mma8451_source',
+            regs={MMA8451_TRANSIENT_SRC: 0x04})[0], (True, False, 0))
+        self.assertEqual(call('mma8451_source',
+            regs={MMA8451_TRANSIENT_SRC: 0x44}, fail=0)[0], (False, False, 0))
+
+    def test_lsm6dso_quantization(self):
+        # Full scale / 256 if the threshold fits, full scale / 64 otherwise
+        (_, fine, ths), _, _ = call('lsm6dso_ths', 30.0, 2000.0)
+        self.assertEqual((fine, ths), (True, 4))
+
+        (_, fine, ths), _, _ = call('lsm6dso_ths', 600.0, 2000.0)
+        self.assertEqual((fine, ths), (False, 19))
+
+        (_, fine, ths), _, _ = call('lsm6dso_ths', 1e5, 2000.0)
+        self.assertEqual((fine, ths), (False, 63))
+
+        self.assertEqual(call('lsm6dso_dur', 20.0, 104.0)[0][2], 2)
+        self.assertEqual(call('lsm6dso_dur', 20.0, 12.5)[0][2], 0)
+        self.assertEqual(call('lsm6dso_dur', 1000.0, 104.0)[0][2], 3)
+
+    def test_lsm6dso_init(self):
+        # Other bits of the registers are preserved
+        presets = {LSM6DSO_TAP_CFG0: 0x50, LSM6DSO_WAKE_UP_THS: 0xC0,
+            LSM6DSO_WAKE_UP_DUR: 0x8F, LSM6DSO_MD1_CFG: 0x01}
+
+        result, accesses, regs = call('lsm6dso_init', 30.0, 20.0, 104.0,
+            2000.0, regs=presets)
+
+        self.assertTrue(result[0])
+        self.assertEqual(regs[LSM6DSO_TAP_CFG0], 0x41)
+        self.assertEqual(regs[LSM6DSO_WAKE_UP_THS], 0xC4)
+        self.assertEqual(regs[LSM6DSO_WAKE_UP_DUR], 0x8F | 0x40 | 0x10)
+        self.assertEqual(regs[LSM6DSO_MD1_CFG], 0x21)
+        self.assertEqual(regs[LSM6DSO_TAP_CFG2], 0x80)
+
+        # The interrupts are enabled last, when the configuration is complete
+        self.assertEqual(accesses[-1], ('W', LSM6DSO_TAP_CFG2, 0x80))
+
+        # Nothing is enabled if an access fails
+        result, accesses, regs = call('lsm6dso_init', 30.0, 20.0, 104.0,
+            2000.0, fail=1)
+
+        self.assertFalse(result[0])
+        self.assertEqual(len(accesses), 2)
+
+    def test_lsm6dso_source(self):
+        self.assertEqual(call('lsm6dso_source',
+            regs={LSM6DSO_WAKE_UP_SRC: 0x0F})[0], (True, True, 0))
+        self.assertEqual(call('lsm6dso_source',
+            regs={LSM6DSO_WAKE_UP_SRC: 0x07})[0], (True, False, 0))
+
+    def assert_standby(self, accesses):
+        """
+        Asserts that the MMA8451 registers are only written in standby and
+        that CTRL_REG1 is restored at the end
+        """
+        active = True
+
+        for access, reg, value in accesses:
+            if access != 'W':
+                continue
+
+            if reg == MMA8451_CTRL_REG1:
+                active = (value & 0x01) != 0
+            else:
+                self.assertFalse(active, 'register 0x{:02X} written while '
+                    'active'.format(reg))
+
+        self.assertEqual(accesses[-1][:2], ('W', MMA8451_CTRL_REG1))
+        self.assertTrue(active)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-m', '--threshold', type=float, default=THRESHOLD_MG,
+        help="threshold in mg")
+    parser.add_argument('-d', '--duration', type=float, default=DURATION_MS,
+        help="duration in ms")
+    parser.add_argument('-o', '--odr', type=float, default=ODR,
+        help="output data rate in Hz while waiting for motion")
+    parser.add_argument('-t', '--test', action='store_true',
+        help="run the unit tests")
+    args = parser.parse_args()
+
+    if args.test:
+        unittest.main(argv=sys.argv[:1])
+        return
+
+    report(args.threshold, args.duration, args.odr)
+
+
+if __name__ == "__main__":
+    main()
@@ -18,10 +18,35 @@ from os import makedirs
 COMPORT = 'COM3'
 BAUDRATE = 115200
 
-# TODO Set feature calculation parameters
-#      Valid BLOCK_TYPE values are: BLOCK or SLIDING
+# TODO Set feature calculation parameters. A window of BLOCK_SIZE samples
+#      starts every BLOCK_HOP samples. BLOCK_HOP = BLOCK_SIZE gives blocks that
+#      do not overlap, BLOCK_SIZE // 2 windows with 50% overlap, BLOCK_SIZE // 4
+#      75% overlap and 1 a window that slides one sample at a time. On the
+#      microcontroller, BLOCK_SIZE must be a multiple of BLOCK_HOP, see
+#      ./lib/window_aggregates.c.
 BLOCK_SIZE = 100
-BLOCK_TYPE = 'BLOCK'
+BLOCK_HOP = 100
+
+# TODO Set the number of scales of the multi-resolution features. Scale k has
+#      windows of BLOCK_SIZE * 2**k samples, which all end at the same sample.
+#      For example, BLOCK_SIZE = 25 and BLOCK_SCALES = 4 give the features of
+#      the last 25, 50, 100 and 200 samples. The features of scale k > 0 are
+#      named after their window, for example ToF_variance_w200. On the
+#      microcontroller, BLOCK_HOP must be equal to BLOCK_SIZE and BLOCK_SCALES
+#      at most 8, see window_pyramid_init() in ./lib/window_aggregates.c.
+BLOCK_SCALES = 1
+
+# TODO Set the sample frequency in Hz of the captured data and the frequency
+#      band in Hz of the band_energy feature. For example, walking is typically
+#      1 - 2 Hz and jogging 2.5 - 4 Hz.
+SAMPLE_FREQUENCY = 68.9
+BAND_ENERGY = [1.0, 2.0]
+
+# TODO Set the forgetting factor of the running mean and the hysteresis in
+#      standard deviations of the repetitive motion features, such as
+#      peak_count and cadence.
+MOTION_ALPHA = 0.02
+MOTION_HYSTERESIS = 0.5
 
 
 # Directory paths. The data directory is located relative to this file
@@ -0,0 +1,212 @@
+"""
+build_knn.py
+
+Nearest prototype (k-NN) classifier
+
+The training data of the decision tree classifier is clustered into a small
+number of prototypes per class with k-means. New data is classified by the
+majority label of the k nearest prototypes. With one prototype per class this
+is a nearest centroid classifier. The number of prototypes per class is a knob
+to trade accuracy for latency and memory on the microcontroller.
+
+Run build_dtc.py first, because the train and test bunches of the decision
+tree classifier are used.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+from custom_bunch import CustomBunch
+import config as cfg
+from os.path import join
+from joblib import dump
+import numpy as np
+from sklearn.cluster import KMeans
+from sklearn.neighbors import KNeighborsClassifier
+from sklearn.metrics import confusion_matrix
+from sklearn.metrics import classification_report
+
+# TODO Set the number of prototypes per class. One prototype per class results
+#      in a nearest centroid classifier. More prototypes usually increase the
+#      accuracy, but also the latency and the size of the table.
+N_PROTOTYPES = 4
+
+# TODO Set the number of nearest prototypes that vote for the label. Must not
+#      exceed KNN_K_MAX in ./lib/classifiers.h.
+K_NEIGHBOURS = 1
+
+# Values of N_PROTOTYPES for which the test accuracy is reported
+N_PROTOTYPES_SWEEP = [1, 2, 4, 8, 16]
+
+# Must be equal to KNN_N_FEATURES_MAX, KNN_N_CLASSES_MAX and KNN_K_MAX in
+# ./lib/classifiers.h
+KNN_N_FEATURES_MAX = 32
+KNN_N_CLASSES_MAX = 32
+KNN_K_MAX = 8
+
+def check_limits(n_features, n_classes, k_neighbours):
+    """
+    Asserts that the knn() and knn_q7() functions support the model.
+    """
+    assert n_features <= KNN_N_FEATURES_MAX, 'The number of features ({}) ' \
+        'must not exceed KNN_N_FEATURES_MAX ({})'.format(n_features,
+        KNN_N_FEATURES_MAX)
+    assert n_classes <= KNN_N_CLASSES_MAX, 'The number of classes ({}) ' \
+        'must not exceed KNN_N_CLASSES_MAX ({})'.format(n_classes,
+        KNN_N_CLASSES_MAX)
+    assert 1 <= k_neighbours <= KNN_K_MAX, 'k ({}) must be in the range ' \
+        '1 .. KNN_K_MAX ({})'.format(k_neighbours, KNN_K_MAX)
+
+def fit(train_bunch, n_prototypes, k_neighbours, random_state=0):
+    """
+    Clusters the training data of each class into prototypes.
+
+    Features are standardized first, because distances are meaningless when
+    the features have a different range.
+
+    Returns
+    -------
+    dict
+        The prototype model with the keys attributes, classes, offset, scale,
+        prototypes (standardized), labels (index in classes), k and range
+        (largest absolute standardized training value).
+    """
+    x = np.array(train_bunch.data, dtype=float)
+    y = np.array(train_bunch.labels)
+
+    offset = x.mean(axis=0)
+    std = x.std(axis=0)
+    scale = 1.0 / np.where(std > 0, std, 1.0)
+    xs = (x - offset) * scale
+
+    classes = sorted(list(np.unique(y)))
+    check_limits(x.shape[1], len(classes), k_neighbours)
+
+    prototypes = []
+    labels = []
+
+    for i, c in enumerate(classes):
+        xc = xs[y == c]
+        # A class cannot have more prototypes than samples
+        n = min(n_prototypes, len(xc))
+        kmeans = KMeans(n_clusters=n, n_init=10, random_state=random_state)
+        kmeans.fit(xc)
+        prototypes.extend(kmeans.cluster_centers_)
+        labels.extend([i] * n)
+
+    return {
+        'attributes': list(train_bunch.attributes),
+        'classes': classes,
+        'offset': offset,
+        'scale': scale,
+        'prototypes': np.array(prototypes),
+        'labels': np.array(labels),
+        'k': k_neighbours,
+        'range': np.abs(xs).max(),
+    }
+
+def predict(model, data):
+    """
+    Predicts the labels of the data with a prototype model.
+    """
+    knn = KNeighborsClassifier(n_neighbors=min(model['k'], len(model['labels'])))
+    knn.fit(model['prototypes'], model['labels'])
+    xs = (np.array(data, dtype=float) - model['offset']) * model['scale']
+    return [model['classes'][i] for i in knn.predict(xs)]
+
+def accuracy(model, bunch):
+    """
+    Returns the fraction of correctly predicted labels.
+    """
+    pred = predict(model, bunch.data)
+    return np.mean([p == l for p, l in zip(pred, bunch.labels)])
+
+def main():
+
+    filename_train_bunch = join(cfg.MODEL_DIR_PATH,"dtc_train_bunch.csv")
+    filename_test_bunch = join(cfg.MODEL_DIR_PATH,"dtc_test_bunch.csv")
+
+    train_bunch = CustomBunch.load_csv(filename_train_bunch)
+    test_bunch = CustomBunch.load_csv(filename_test_bunch)
+
+    model = fit(train_bunch, N_PROTOTYPES, K_NEIGHBOURS)
+
+    train_pred = predict(model, train_bunch.data)
+    test_pred = predict(model, test_bunch.data)
+    test_accuracy = accuracy(model, test_bunch)
+
+    # Accuracy for several number of prototypes
+    sweep = [(n, accuracy(fit(train_bunch, n, K_NEIGHBOURS), test_bunch))
+             for n in N_PROTOTYPES_SWEEP]
+
+    # Print info
+    if __name__ == "__main__":
+        print(f'Prototypes: {len(model["labels"])} ({N_PROTOTYPES} per class), '
+              f'k = {K_NEIGHBOURS}\n')
+
+        print('Training report:\n')
+        print(classification_report(train_bunch.labels, train_pred,
+            zero_division=0))
+
+        print('\nTest report:\n')
+        print(classification_report(test_bunch.labels, test_pred,
+            zero_division=0))
+
+        print(f'Test accuracy score: {test_accuracy:.4f}\n')
+
+        print('Confusion matrix:\n')
+        print(confusion_matrix(test_bunch.labels, test_pred))
+        print()
+
+        print('Test accuracy per number of prototypes per class:\n')
+        for n, a in sweep:
+            print(f'{n:>4}: {a:.4f}')
+        print()
+
+    # Create output files
+    filename_dump = join(cfg.MODEL_DIR_PATH,"knn_model.gz")
+    filename_txt = join(cfg.MODEL_DIR_PATH,"knn_model.txt")
+
+    # Save the model
+    dump(model, filename_dump)
+
+    # Save model results in plain text
+    textfile = open(filename_txt, 'w')
+    textfile.write(f'Prototypes: {len(model["labels"])} ({N_PROTOTYPES} per '
+                   f'class), k = {K_NEIGHBOURS}')
+    textfile.write('\n\n')
+    textfile.write('Training report: ')
+    textfile.write('\n'.ljust(80, '-') + '\n')
+    textfile.write(str(classification_report(train_bunch.labels, train_pred,
+        zero_division=0)))
+    textfile.write('\n')
+    textfile.write('Test report: ')
+    textfile.write('\n'.ljust(80, '-') + '\n')
+    textfile.write(str(classification_report(test_bunch.labels, test_pred,
+        zero_division=0)))
+    textfile.write('\n')
+    textfile.write(f'Test accuracy score: {test_accuracy:.4f}\n')
+    textfile.write('\n')
+    textfile.write('Confusion matrix: ')
+    textfile.write('\n'.ljust(80, '-') + '\n')
+    textfile.write(str(confusion_matrix(test_bunch.labels, test_pred)))
+    textfile.write('\n\n')
+    textfile.write('Test accuracy per number of prototypes per class: ')
+    textfile.write('\n'.ljust(80, '-') + '\n')
+    for n, a in sweep:
+        textfile.write(f'{n:>4}: {a:.4f}\n')
+    textfile.close()
+
+    print('Files written:')
+    print(filename_dump)
+    print(filename_txt)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,309 @@
+"""
+anytime_dtc.py
+
+Evaluates anytime classification with decision tree classifiers, which emit
+a label before the window is complete if the data is obvious.
+
+Without anytime classification, a label is emitted when the window of
+BLOCK_SIZE samples is complete. With anytime classification, the features of
+the first samples of the window, the prefix, are computed at every checkpoint
+and classified by a decision tree that is trained on the features of prefixes
+of that length. If the confidence of the prediction, the purity of the leaf
+(see CONFIDENCE in code_generator_dtc2c.py), is at least the threshold, the
+label is emitted and the rest of the window is skipped. The last checkpoint is
+the complete window, which always emits a label.
+
+The windows of the input files of feature_calculator.py, with the feature
+functions of feature_calculator.py, are split in training and test windows
+once, so all trees are trained and tested on the same windows. For every
+threshold, the test windows are replayed to report the mean latency from the
+first sample of the window to the label and the accuracy, compared with the
+tree of the complete window.
+
+The generated classifiers are compiled for the host together with the
+features of the test windows, to check that they emit the same labels at the
+same checkpoints as scikit-learn, and are saved in
+dtc_anytime/dtc_anytime_model.c.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+sys.path.append(join(dirname(realpath(__file__)), '..', 'preprocessing',
+    'feature_selection'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+import code_generator_dtc2c as generator
+from benchmark_knn_dtc import model_arguments
+import feature_calculator as fc
+from glob import glob
+import numpy as np
+from os.path import join, exists
+from os import makedirs
+from sklearn.model_selection import train_test_split
+from sklearn.tree import DecisionTreeClassifier
+
+# TODO Set the number of samples of the prefixes at which a window is
+#      classified. The last checkpoint must be the complete window.
+CHECKPOINTS = [cfg.BLOCK_SIZE * k // 5 for k in range(1, 6)]
+
+# TODO Set the thresholds of the confidence to compare, and the threshold of
+#      the generated classifiers
+THRESHOLDS = [0.8, 0.9, 0.95, 0.99, 1.0]
+THRESHOLD = 0.95
+
+# TODO Set the minimum number of training samples in a leaf. The leaves of a
+#      tree that is grown until all leaves are pure all have a confidence of
+#      1.0, so the confidence only separates obvious from ambiguous windows if
+#      a leaf holds several training samples.
+MIN_SAMPLES_LEAF = 5
+
+# Fraction of the windows that is used for testing, and the seed of the split
+TEST_SIZE = 0.25
+RANDOM_STATE = 0
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+
+#define N_CHECKPOINTS ({n_checkpoints})
+#define N_TEST ({n_test})
+#define N_FEATURES ({n_features})
+
+// Features of the prefixes of the test windows
+static const float test_x[N_CHECKPOINTS][N_TEST][N_FEATURES] =
+{{
+{test_x}
+}};
+
+{declarations}
+
+static int (*const predict[N_CHECKPOINTS])(const float *, float *) =
+{{
+{predictions}
+}};
+
+int main(void)
+{{
+    for(uint32_t i=0; i<N_TEST; ++i)
+    {{
+        for(uint32_t k=0; k<N_CHECKPOINTS; ++k)
+        {{
+            float confidence;
+            const int label = predict[k](test_x[k][i], &confidence);
+
+            if((confidence >= DTC_ANYTIME_THRESHOLD) ||
+                (k == (N_CHECKPOINTS - 1)))
+            {{
+                printf("%d,%u\\n", label, (unsigned int)k);
+                break;
+            }}
+        }}
+    }}
+
+    return 0;
+}}
+'''
+
+WRAPPER_FILE_STR = \
+'''
+int predict_{n}(const float *x, float *confidence)
+{{
+    return (int)dtc_{n}({args});
+}}
+'''
+
+HEADER_STR = \
+'''/*
+ * Anytime decision tree classifiers, generated by anytime_dtc.py. At every
+ * checkpoint of n samples, call dtc_<n>() with the features of the first n
+ * samples of the window: {checkpoints}. If the confidence is at least
+ * DTC_ANYTIME_THRESHOLD, emit the label and skip the rest of the window. The
+ * last checkpoint is the complete window, which always emits a label.
+ */
+#define DTC_ANYTIME_THRESHOLD ({threshold}f)
+
+'''
+
+def prefix_features():
+    """
+    Returns the attributes, the features of every prefix of every window and
+    the labels of the windows.
+    """
+    filenames = sorted(glob(join(fc.INPUT_DIR_PATH, '*.csv')))
+    assert len(filenames) != 0, 'No CSV files'
+
+    attributes = None
+    x = [[] for _ in CHECKPOINTS]
+    labels = []
+
+    for filename in filenames:
+        bunch = CustomBunch.load_csv(filename)
+        assert len(bunch.unique_labels) == 1, \
+            'Expected a bunch with a unique label'
+
+        names = []
+        columns = [[] for _ in CHECKPOINTS]
+
+        for attr in bunch.attributes:
+            windows = fc.windows(bunch.data[:, bunch.attributes.index(attr)])
+
+            for f in fc.FEATURE_FUNCTIONS:
+                names.append(attr + '_' + f.__name__)
+
+                for k, n in enumerate(CHECKPOINTS):
+                    columns[k].append([f(w[0:n]) for w in windows])
+
+        assert attributes is None or attributes == names, \
+            'Expected the same attributes in all files'
+        attributes = names
+
+        for k in range(len(CHECKPOINTS)):
+            x[k] += list(np.array(columns[k]).T)
+        labels += [bunch.labels[0]] * len(columns[0][0])
+
+    return attributes, [np.array(xk) for xk in x], np.array(labels)
+
+def replay(probabilities, classes, threshold):
+    """
+    Returns the label and the index of the checkpoint at which every window
+    emits its label.
+    """
+    labels = []
+    exits = []
+
+    for i in range(len(probabilities[0])):
+        for k, p in enumerate(probabilities):
+            if (np.max(p[i]) >= threshold) or (k == len(probabilities) - 1):
+                labels.append(classes[np.argmax(p[i])])
+                exits.append(k)
+                break
+
+    return np.array(labels), np.array(exits)
+
+def main():
+
+    assert int(cfg.BLOCK_SCALES) == 1, 'Anytime classification of prefixes ' \
+        'requires a single scale'
+    assert CHECKPOINTS[-1] == int(cfg.BLOCK_SIZE), 'The last checkpoint ' \
+        'must be the complete window'
+
+    attributes, x, y = prefix_features()
+
+    # Split the windows once, so every tree uses the same windows
+    train, test = train_test_split(np.arange(len(y)), test_size=TEST_SIZE,
+        stratify=y, random_state=RANDOM_STATE)
+
+    dtcs = []
+    for xk in x:
+        dtc = DecisionTreeClassifier(min_samples_leaf=MIN_SAMPLES_LEAF,
+            random_state=RANDOM_STATE)
+        dtc.fit(xk[train], y[train])
+        dtcs.append(dtc)
+
+    probabilities = [dtc.predict_proba(xk[test]) for dtc, xk in zip(dtcs, x)]
+    classes = dtcs[0].classes_
+
+    # The tree of the complete window always waits for the last checkpoint
+    ms = 1000.0 / cfg.SAMPLE_FREQUENCY
+    full = np.mean(classes[np.argmax(probabilities[-1], axis=1)] == y[test])
+
+    print()
+    print('Windows: {} training, {} test'.format(len(train), len(test)))
+    print('Checkpoints: {} samples'.format(CHECKPOINTS))
+    print('Accuracy per checkpoint, without early exit: {}'.format(
+        ' '.join(['{:.4f}'.format(np.mean(classes[np.argmax(p, axis=1)] ==
+        y[test])) for p in probabilities])))
+    print()
+    print('{:<12}{:>10}{:>14}{:>10}{:>10}{:>10}  {}'.format('threshold',
+        'samples', 'latency ms', 'saved', 'accuracy', 'delta',
+        'exits per checkpoint'))
+    print('{:<12}{:>10.1f}{:>14.1f}{:>9.1f}%{:>10.4f}{:>10.4f}'.format(
+        'complete', CHECKPOINTS[-1], CHECKPOINTS[-1] * ms, 0.0, full, 0.0))
+
+    for threshold in THRESHOLDS:
+        labels, exits = replay(probabilities, classes, threshold)
+        samples = np.mean(np.array(CHECKPOINTS)[exits])
+        accuracy = np.mean(labels == y[test])
+        print('{:<12}{:>10.1f}{:>14.1f}{:>9.1f}%{:>10.4f}{:>+10.4f}  {}'.format(
+            threshold, samples, samples * ms,
+            100.0 * (1.0 - samples / CHECKPOINTS[-1]), accuracy,
+            accuracy - full, ' '.join([str(np.sum(exits == k)) for k in
+            range(len(CHECKPOINTS))])))
+
+    # Generate the classifier of every checkpoint with its own function name,
+    # the enumerated type of the labels only once
+    bunch = CustomBunch(x[-1][train], timestamps=None, attributes=attributes,
+        labels=y[train])
+
+    model = HEADER_STR.format(checkpoints=', '.join([str(n) for n in
+        CHECKPOINTS]), threshold=generator.float_str(THRESHOLD))
+    sources = {}
+
+    for k, (n, dtc) in enumerate(zip(CHECKPOINTS, dtcs)):
+        source = generator.generate(dtc, bunch, counts=None, lazy=False,
+            verbose=False, fold=False, confidence=True)
+        source = source.replace('dtc_t dtc(', 'dtc_t dtc_{}('.format(n))
+
+        model += source if k == 0 else \
+            '\n' + source[source.index('/*\n * \\brief Decision tree'):]
+
+        sources['dtc_{}.c'.format(n)] = source + WRAPPER_FILE_STR.format(n=n,
+            args=model_arguments(source, 'dtc_t dtc_{}'.format(n),
+            attributes) + ', confidence')
+
+    labels, exits = replay(probabilities, classes, THRESHOLD)
+
+    sources['main.c'] = HEADER_STR.format(checkpoints='', threshold=
+        generator.float_str(THRESHOLD)) + MAIN_FILE_STR.format(
+        n_checkpoints=len(CHECKPOINTS),
+        n_test=len(test),
+        n_features=len(attributes),
+        test_x=',\n'.join(['    {\n' + ',\n'.join(['        {' + ', '.join(
+            [repr(float(v)) + 'f' for v in row]) + '}' for row in xk[test]]) +
+            '\n    }' for xk in x]),
+        declarations='\n'.join(['int predict_{}(const float *x, float '
+            '*confidence);'.format(n) for n in CHECKPOINTS]),
+        predictions=',\n'.join(['    predict_{}'.format(n) for n in
+            CHECKPOINTS]))
+
+    executable = c2exe.build('anytime_dtc',
+        join(cfg.MODEL_EMBEDDING_DIR_PATH, 'anytime_project'), sources)
+
+    output = [line.split(',') for line in c2exe.run(executable).splitlines()]
+    c_labels = np.array([classes[int(label)] for label, _ in output])
+    c_exits = np.array([int(k) for _, k in output])
+
+    print()
+    print('Generated classifiers, threshold {}:'.format(THRESHOLD))
+    print('  labels that differ from scikit-learn       {}'.format(
+        np.sum(c_labels != labels)))
+    print('  checkpoints that differ from scikit-learn  {}'.format(
+        np.sum(c_exits != exits)))
+
+    # Save the source in a file
+    code_filepath = join(cfg.MODEL_EMBEDDING_DIR_PATH, 'dtc_anytime')
+    code_filename = join(code_filepath, 'dtc_anytime_model.c')
+
+    if not exists(code_filepath):
+        makedirs(code_filepath)
+
+    codefile = open(code_filename, 'w')
+    codefile.write(model)
+    codefile.close()
+
+    print()
+    print('File written:')
+    print(code_filename)
+
+
+if __name__ == "__main__":
+    main()
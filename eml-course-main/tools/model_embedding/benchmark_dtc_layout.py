@@ -0,0 +1,189 @@
+"""
+benchmark_dtc_layout.py
+
+Compares the layouts of the branches of the generated decision tree
+classifier, see LAYOUT in code_generator_dtc2c.py.
+
+The hot and flat layouts order the children of each node by the number of
+training samples that reach them, or by a replayed capture if
+PROFILE_FILENAME is set. The test samples are then used to count the compares
+and taken branches per prediction of each layout. All layouts execute the
+same compares, but the hot path of the hot and flat layouts does not take a
+branch. On a Cortex-M0+ with a 3-stage pipeline, a taken branch refills the
+pipeline.
+
+The generated C files are also compiled for the host together with the test
+data, to check that all layouts return the same labels and to measure the
+latency. The host predicts branches, so use the latency to compare the
+layouts relative to each other. The number of taken branches is what counts
+on the microcontroller.
+
+Run build_dtc.py first.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+import code_generator_dtc2c as generator
+from benchmark_knn_dtc import model_arguments
+import joblib
+from os.path import join
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#define N_TEST ({n_test})
+#define N_FEATURES ({n_features})
+
+static const float test_x[N_TEST][N_FEATURES] =
+{{
+{test_x}
+}};
+
+static const int test_y[N_TEST] =
+{{
+{test_y}
+}};
+
+{declarations}
+
+static void benchmark(const char *name, int (*predict)(const float *))
+{{
+    volatile int sink = 0;
+    uint32_t correct = 0;
+    uint32_t differ = 0;
+
+    for(uint32_t i=0; i<N_TEST; ++i)
+    {{
+        const int label = predict(test_x[i]);
+
+        correct += (label == test_y[i]) ? 1 : 0;
+        differ += (label != predict_default(test_x[i])) ? 1 : 0;
+    }}
+
+    // Repeat the predictions until the measurement takes long enough
+    uint32_t repeat = 1;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            for(uint32_t i=0; i<N_TEST; ++i)
+            {{
+                sink += predict(test_x[i]);
+            }}
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    printf("%s,%f,%u,%f\\n", name, (double)correct / N_TEST,
+        (unsigned int)differ, 1e9 * duration / ((double)repeat * N_TEST));
+}}
+
+int main(void)
+{{
+{benchmarks}
+
+    return 0;
+}}
+'''
+
+WRAPPER_FILE_STR = \
+'''
+int predict_{layout}(const float *x)
+{{
+    return (int)dtc_{layout}({args});
+}}
+'''
+
+def main():
+
+    filename_train_bunch = join(cfg.MODEL_DIR_PATH,"dtc_train_bunch.csv")
+    filename_test_bunch = join(cfg.MODEL_DIR_PATH,"dtc_test_bunch.csv")
+    filename_dtc = join(cfg.MODEL_DIR_PATH,"dtc_model.gz")
+
+    dtc = joblib.load(filename_dtc)
+    train_bunch = CustomBunch.load_csv(filename_train_bunch)
+    test_bunch = CustomBunch.load_csv(filename_test_bunch)
+    attributes = train_bunch.attributes
+
+    # The layout follows the profile, the test samples are counted
+    profile = None
+    if generator.PROFILE_FILENAME is not None:
+        profile = CustomBunch.load_csv(generator.PROFILE_FILENAME)
+
+    counts = generator.node_counts(dtc, attributes, profile)
+    test_counts = generator.node_counts(dtc, attributes, test_bunch)
+
+    # Generate each layout with its own function name
+    sources = {}
+    statistics = {}
+
+    for layout in generator.LAYOUTS:
+        source = generator.generate(dtc, train_bunch, layout, counts,
+            lazy=False, verbose=False)
+        source = source.replace('dtc_t dtc(', 'dtc_t dtc_{}('.format(layout))
+
+        sources['dtc_{}.c'.format(layout)] = source + WRAPPER_FILE_STR.format(
+            layout=layout, args=model_arguments(source,
+            'dtc_t dtc_' + layout, test_bunch.attributes))
+
+        statistics[layout] = generator.branch_statistics(dtc.tree_,
+            test_counts, generator.first_children(dtc.tree_, counts, layout))
+
+    sources['main.c'] = MAIN_FILE_STR.format(
+        n_test=len(test_bunch.data),
+        n_features=len(test_bunch.attributes),
+        test_x=',\n'.join(['    {' + ', '.join(
+            [repr(float(v)) + 'f' for v in x]) + '}'
+            for x in test_bunch.data]),
+        test_y=',\n'.join(['    ' + str(list(dtc.classes_).index(l)) for l in
+            test_bunch.labels]),
+        declarations='\n'.join(['int predict_{}(const float *x);'.format(l)
+            for l in generator.LAYOUTS]),
+        benchmarks='\n'.join(['    benchmark("{0}", predict_{0});'.format(l)
+            for l in generator.LAYOUTS]),
+        min_duration=MIN_DURATION)
+
+    executable = c2exe.build('benchmark_dtc_layout',
+        join(cfg.MODEL_EMBEDDING_DIR_PATH, 'benchmark_layout_project'),
+        sources)
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Test samples: {len(test_bunch.data)}')
+    print('Profile: {}\n'.format(generator.PROFILE_FILENAME
+        if profile is not None else 'training samples'))
+    print('{:<10}{:>10}{:>10}{:>10}{:>10}{:>16}'.format('layout', 'compares',
+        'taken', 'accuracy', 'differ', 'ns/prediction'))
+    for line in output.splitlines():
+        layout, accuracy, differ, ns = line.split(',')
+        compares, taken = statistics[layout]
+        print('{:<10}{:>10.2f}{:>10.2f}{:>10.4f}{:>10}{:>16.1f}'.format(layout,
+            compares, taken, float(accuracy), int(differ), float(ns)))
+
+
+if __name__ == "__main__":
+    main()
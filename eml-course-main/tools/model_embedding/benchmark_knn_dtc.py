@@ -0,0 +1,170 @@
+"""
+benchmark_knn_dtc.py
+
+Compares the latency and accuracy of the generated nearest prototype (k-NN)
+classifier with the generated decision tree classifier.
+
+Both generated C files are compiled for the host together with the test data of
+the decision tree classifier. The latency is measured on the host, so use it to
+compare the classifiers relative to each other. Absolute values on the
+microcontroller are much larger.
+
+Run build_dtc.py, code_generator_dtc2c.py, build_knn.py and
+code_generator_knn2c.py first.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+import joblib
+from os.path import join
+import re
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#define N_TEST ({n_test})
+#define N_FEATURES ({n_features})
+
+static const float test_x[N_TEST][N_FEATURES] =
+{{
+{test_x}
+}};
+
+static const int test_y[N_TEST] =
+{{
+{test_y}
+}};
+
+int dtc_predict(const float *x);
+int knn_predict(const float *x);
+
+static void benchmark(const char *name, int (*predict)(const float *))
+{{
+    volatile int sink = 0;
+    uint32_t correct = 0;
+
+    for(uint32_t i=0; i<N_TEST; ++i)
+    {{
+        correct += (predict(test_x[i]) == test_y[i]) ? 1 : 0;
+    }}
+
+    // Repeat the predictions until the measurement takes long enough
+    uint32_t repeat = 1;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            for(uint32_t i=0; i<N_TEST; ++i)
+            {{
+                sink += predict(test_x[i]);
+            }}
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    printf("%s,%f,%f\\n", name, (double)correct / N_TEST,
+        1e9 * duration / ((double)repeat * N_TEST));
+}}
+
+int main(void)
+{{
+    benchmark("dtc", dtc_predict);
+    benchmark("knn", knn_predict);
+
+    return 0;
+}}
+'''
+
+WRAPPER_FILE_STR = \
+'''
+#include "{model}"
+
+int {name}_predict(const float *x)
+{{
+    return (int){function}({args});
+}}
+'''
+
+def model_arguments(source, function, attributes):
+    """
+    Returns the arguments for calling a generated model function with a
+    feature vector x, by looking up the parameter names in the attributes.
+    Output parameters, such as confidence, are left out.
+    """
+    signature = re.search(function + r'\((.*?)\)', source).group(1)
+    names = [p.split()[-1] for p in signature.split(',') if '*' not in p]
+    return ', '.join(['x[{}]'.format(attributes.index(n)) for n in names])
+
+def main():
+
+    filename_test_bunch = join(cfg.MODEL_DIR_PATH,"dtc_test_bunch.csv")
+    filename_dtc = join(cfg.MODEL_EMBEDDING_DIR_PATH, 'dtc', 'dtc_model.c')
+    filename_knn = join(cfg.MODEL_EMBEDDING_DIR_PATH, 'knn', 'knn_model.c')
+
+    test_bunch = CustomBunch.load_csv(filename_test_bunch)
+    attributes = test_bunch.attributes
+
+    # Both generated enumerated types follow the sorted training labels
+    classes = joblib.load(join(cfg.MODEL_DIR_PATH,"knn_model.gz"))['classes']
+
+    dtc_source = open(filename_dtc, 'r').read()
+    knn_source = open(filename_knn, 'r').read()
+
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_test=len(test_bunch.data),
+            n_features=len(attributes),
+            test_x=',\n'.join(['    {' + ', '.join(
+                [repr(float(v)) + 'f' for v in x]) + '}'
+                for x in test_bunch.data]),
+            test_y=',\n'.join(['    ' + str(classes.index(l)) for l in
+                test_bunch.labels]),
+            min_duration=MIN_DURATION),
+        'dtc_wrapper.c': WRAPPER_FILE_STR.format(
+            model='dtc_model.c', name='dtc', function='dtc',
+            args=model_arguments(dtc_source, 'dtc_t dtc', attributes)),
+        'knn_wrapper.c': WRAPPER_FILE_STR.format(
+            model='knn_model.c', name='knn', function='knn_classify',
+            args=model_arguments(knn_source, 'knn_t knn_classify', attributes)),
+    }
+
+    executable = c2exe.build('benchmark_knn_dtc',
+        join(cfg.MODEL_EMBEDDING_DIR_PATH, 'benchmark_project'), sources,
+        lib_files=['classifiers.h', 'classifiers.c'],
+        include_files=[filename_dtc, filename_knn])
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Test samples: {len(test_bunch.data)}\n')
+    print('{:<12}{:>12}{:>16}'.format('classifier', 'accuracy', 'ns/prediction'))
+    for line in output.splitlines():
+        name, accuracy, ns = line.split(',')
+        print('{:<12}{:>12.4f}{:>16.1f}'.format(name, float(accuracy), float(ns)))
+
+
+if __name__ == "__main__":
+    main()
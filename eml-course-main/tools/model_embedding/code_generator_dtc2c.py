@@ -12,6 +12,8 @@ Copyright:  2023 HAN University of Applied Sciences. All Rights Reserved.
 import sys
 from os.path import join, dirname, realpath
 sys.path.append(join(dirname(realpath(__file__)), '..'))
+sys.path.append(join(dirname(realpath(__file__)), '..', 'preprocessing',
+    'normalization_selection'))
 
 import config as cfg
 from custom_bunch import CustomBunch
@@ -21,34 +23,410 @@ from os.path import join, exists
 from os import makedirs
 from sklearn.tree import _tree
 from sklearn.tree import DecisionTreeClassifier
+import re
+import normalization_calculator as nc
+
+# TODO Set to True to also generate dtc_lazy(), which computes each feature
+#      only when a node of the tree needs it. See ./lib/feature_cache.c.
+LAZY = False
+
+# TODO Set the layout of the branches of each node in the generated tree:
+#      'default'  the left child (<=) in the if and the right child (>) in the
+#                 else
+#      'hot'      the child that most samples reach in the if, with a hint
+#                 for the compiler, so the hot path is laid out depth-first
+#                 and reached without taken branches
+#      'flat'     as 'hot', but the cold child returns early and the hot
+#                 child follows as straight-line compares without nesting
+LAYOUT = 'hot'
+
+# TODO Set to the filename of a bunch of features, for example of a replayed
+#      capture, to count the samples that reach each node. Set to None to use
+#      the training samples of the tree.
+PROFILE_FILENAME = None
+
+# TODO Set to True to fold the affine normalizations of the preprocessing,
+#      see NORMALIZATION_FUNCTIONS in normalization_calculator.py, into the
+#      thresholds of the tree. A feature of normalized data, for example
+#      x_out_fir_rescale_variance, is then replaced by the same feature of the
+#      data that is not normalized, x_out_fir_variance, so the firmware can
+#      skip the normalization. Check the predictions with parity_dtc_fold.py.
+FOLD_NORMALIZATIONS = False
+
+# TODO Set to True to also return the confidence of each prediction, which is
+#      the purity of the leaf: the fraction of the training samples in the
+#      leaf that have the predicted label. Anytime classification emits a
+#      label before the window is complete if the confidence is high enough,
+#      see anytime_dtc.py.
+CONFIDENCE = False
+
+LAYOUTS = ['default', 'hot', 'flat']
+
+# The scale and offset of a feature of the data y = a * x + b, given the
+# scale a and offset b of the normalization. None if the feature cannot be
+# folded. A negative scale would reverse the comparison, so it is not folded.
+FOLDS = {
+    'min': lambda a, b: (a, b) if a > 0 else None,
+    'max': lambda a, b: (a, b) if a > 0 else None,
+    'mean': lambda a, b: (a, b) if a > 0 else None,
+    'variance': lambda a, b: (a * a, 0.0) if a != 0 else None,
+    'energy': lambda a, b: (a * a, 0.0) if a != 0 and b == 0 else None,
+    'peak_to_peak': lambda a, b: (abs(a), 0.0) if a != 0 else None,
+    'median': lambda a, b: (a, b) if a > 0 else None,
+    'percentile_25': lambda a, b: (a, b) if a > 0 else None,
+    'percentile_75': lambda a, b: (a, b) if a > 0 else None,
+    'iqr': lambda a, b: (abs(a), 0.0) if a != 0 else None,
+    'rms': lambda a, b: (abs(a), 0.0) if a != 0 and b == 0 else None,
+    'crest_factor': lambda a, b: (1.0, 0.0) if a != 0 and b == 0 else None,
+    'skewness': lambda a, b: (1.0, 0.0) if a > 0 else None,
+    'kurtosis': lambda a, b: (1.0, 0.0) if a != 0 else None,
+}
+
+# Emitted in a file with the hot or flat layout. Compilers that do not know
+# __builtin_expect() get the condition without a hint.
+EXPECT_STR = \
+    '#ifndef DTC_LIKELY\n' \
+    '#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)\n' \
+    '#define DTC_LIKELY(x)   __builtin_expect(!!(x), 1)\n' \
+    '#define DTC_UNLIKELY(x) __builtin_expect(!!(x), 0)\n' \
+    '#else\n' \
+    '#define DTC_LIKELY(x)   (x)\n' \
+    '#define DTC_UNLIKELY(x) (x)\n' \
+    '#endif\n' \
+    '#endif\n\n'
 
 export_str = ""
 
-def main():
-
-    filename_train_bunch = join(cfg.MODEL_DIR_PATH,"dtc_train_bunch.csv")
-    filename_dtc = join(cfg.MODEL_DIR_PATH,"dtc_model.gz")
+def c_identifier(label):
+    """
+    Converts a label to a valid C identifier, so it can be used in an
+    enumerated type. Invalid characters are replaced by an underscore and a
+    leading digit is prefixed with an underscore. Valid identifiers are returned
+    unchanged.
+    """
+    identifier = re.sub(r'[^0-9a-zA-Z_]', '_', str(label))
+    if identifier[0].isdigit():
+        identifier = '_' + identifier
+    return identifier
+
+def float_str(value):
+    """
+    Returns a value with the precision of a float, formatted so that an f can
+    be appended for a float constant in C.
+    """
+    s = '{:.9g}'.format(value)
+    if '.' not in s and 'e' not in s:
+        s += '.0'
+    return s
+
+def float32_threshold(threshold):
+    """
+    Returns the largest float that is not greater than the threshold.
+    scikit-learn compares float features with double thresholds, so a float
+    constant that is rounded up could move features to the other branch.
+    """
+    t = np.float32(threshold)
+    if t > threshold:
+        t = np.nextafter(t, np.float32(-np.inf))
+    return float(t)
+
+def affine_normalizations():
+    """
+    Returns the affine normalizations in normalization_calculator.py.
+
+    Returns
+    -------
+    dict
+        The scale a and offset b of normalization y = a * x + b, by the name
+        of the normalization function. Normalizations that are not affine,
+        such as clip, or that adapt to the data, such as online_zscore, are
+        not returned.
+    """
+    affine = {}
+
+    for f, arg in zip(nc.NORMALIZATION_FUNCTIONS, nc.ARGS):
+        if f.__name__ == 'rescale':
+            from_, to_ = arg
+            scale = (to_[1] - to_[0]) / (from_[1] - from_[0])
+            affine[f.__name__] = (scale, to_[0] - (from_[0] * scale))
+
+    return affine
+
+def fold_normalization(attribute, affine):
+    """
+    Returns how a feature of normalized data follows from the same feature of
+    the data that is not normalized.
+
+    The attribute names of the preprocessing combine the names of the
+    functions, so a feature of normalized data ends with the name of the
+    normalization and the name of the feature, for example
+    x_out_fir_rescale_variance. The features of a larger scale end with the
+    size of their window, for example x_out_fir_rescale_variance_w200. A
+    normalization followed by a filter is not folded, because the filter
+    starts with its state at zero.
+
+    Parameters
+    ----------
+    attribute : str
+        The name of the attribute.
+    affine : dict
+        The affine normalizations, see affine_normalizations().
+
+    Returns
+    -------
+    tuple or None
+        The name of the feature without the normalization and the scale and
+        offset of the feature: feature(y) = scale * feature(x) + offset. None
+        if the feature cannot be folded.
+    """
+    scale = re.search(r'_w[0-9]+$', attribute)
+    scale = '' if scale is None else scale.group(0)
+    name = attribute[:len(attribute) - len(scale)]
+
+    for normalization, (a, b) in affine.items():
+        for feature, fold in FOLDS.items():
+            suffix = '_' + normalization + '_' + feature
+
+            if name.endswith(suffix):
+                folded = fold(a, b)
+
+                if folded is None:
+                    return None
+
+                return (name[:-len(suffix)] + '_' + feature + scale,) + \
+                    folded
+
+    return None
+
+def expected_features(tree_):
+    """
+    Returns the expected number of features that are computed per window when
+    the features are computed on demand.
+
+    A window that ends in a leaf computes the distinct features on the path
+    from the root to that leaf. The number is averaged over the leaves,
+    weighted by the number of training samples of each class in the leaves.
+
+    Parameters
+    ----------
+    tree_ : sklearn.tree._tree.Tree
+        The tree of the decision tree classifier.
+
+    Returns
+    -------
+    expected : float
+        Expected number of features per window, weighted by the training class
+        frequencies.
+    per_class : numpy.ndarray
+        Expected number of features per window of each class.
+    n_features : int
+        Number of distinct features in the tree, which are all computed when
+        the features are computed in advance.
+    """
+    counts = []
+
+    def recurse(node, used):
+        if tree_.feature[node] == _tree.TREE_UNDEFINED:
+            # The values are counts or fractions, depending on the version of
+            # scikit-learn
+            value = tree_.value[node][0]
+            counts.append((len(used), value / value.sum() *
+                tree_.weighted_n_node_samples[node]))
+        else:
+            used = used | {tree_.feature[node]}
+            recurse(tree_.children_left[node], used)
+            recurse(tree_.children_right[node], used)
+
+    recurse(0, frozenset())
+
+    n = np.array([c[0] for c in counts], dtype=float)
+    samples = np.array([c[1] for c in counts])
+
+    per_class = (n @ samples) / samples.sum(axis=0)
+    expected = (n @ samples.sum(axis=1)) / samples.sum()
+    n_features = len(set(f for f in tree_.feature if f != _tree.TREE_UNDEFINED))
+
+    return expected, per_class, n_features
+
+def node_counts(dtc, attributes, bunch=None):
+    """
+    Returns the number of samples that reach each node of the tree.
+
+    Parameters
+    ----------
+    dtc : sklearn.tree.DecisionTreeClassifier
+        The decision tree classifier.
+    attributes : list
+        The attributes of the training bunch, in the order of the features of
+        the tree.
+    bunch : CustomBunch or None
+        Samples to replay through the tree, for example the features of a
+        capture. The attributes are looked up by name. If None, the number of
+        training samples of each node is returned.
+
+    Returns
+    -------
+    numpy.ndarray
+        Number of samples per node.
+    """
+    if bunch is None:
+        return np.array(dtc.tree_.n_node_samples, dtype=float)
+
+    data = np.array(bunch.data, dtype=np.float32)
+    data = data[:, [bunch.attributes.index(a) for a in attributes]]
+
+    return np.asarray(dtc.decision_path(data).sum(axis=0), dtype=float).ravel()
+
+def first_children(tree_, counts, layout):
+    """
+    Returns the child of each node that is emitted first, in the if.
+
+    With the default layout that is always the left child. With the hot and
+    flat layouts it is the child that most samples reach, the left child if
+    both are reached equally often.
+
+    Parameters
+    ----------
+    tree_ : sklearn.tree._tree.Tree
+        The tree of the decision tree classifier.
+    counts : numpy.ndarray
+        Number of samples per node, see node_counts().
+    layout : str
+        One of LAYOUTS.
+
+    Returns
+    -------
+    numpy.ndarray
+        The first child of each node, -1 for the leaves.
+    """
+    left = tree_.children_left
+    right = tree_.children_right
+
+    if layout == 'default':
+        return np.array(left)
+
+    return np.where(counts[right] > counts[left], right, left)
+
+def branch_statistics(tree_, counts, first):
+    """
+    Returns the average number of compares and taken branches per prediction.
+
+    Every node on the path to a leaf is one compare. A compare that continues
+    in the second child, the else or the early return, is a taken branch. On
+    a Cortex-M0+ a taken branch refills the pipeline, so it costs one or two
+    cycles more than a branch that is not taken.
+
+    Parameters
+    ----------
+    tree_ : sklearn.tree._tree.Tree
+        The tree of the decision tree classifier.
+    counts : numpy.ndarray
+        Number of samples per node, see node_counts().
+    first : numpy.ndarray
+        The first child of each node, see first_children().
+
+    Returns
+    -------
+    compares : float
+        Average number of compares per prediction.
+    taken : float
+        Average number of taken branches per prediction.
+    """
+    internal = np.flatnonzero(tree_.children_left != _tree.TREE_LEAF)
+    left = tree_.children_left[internal]
+    right = tree_.children_right[internal]
+    second = np.where(first[internal] == left, right, left)
+
+    compares = counts[internal].sum() / counts[0]
+    taken = counts[second].sum() / counts[0]
+
+    return compares, taken
+
+def generate(dtc, bunch, layout=LAYOUT, counts=None, lazy=LAZY, verbose=True,
+    fold=FOLD_NORMALIZATIONS, confidence=CONFIDENCE):
+    """
+    Returns the C code of a decision tree classifier.
+
+    Parameters
+    ----------
+    dtc : sklearn.tree.DecisionTreeClassifier
+        The decision tree classifier.
+    bunch : CustomBunch
+        The training bunch, for the names of the attributes.
+    layout : str
+        The layout of the branches, one of LAYOUTS.
+    counts : numpy.ndarray or None
+        Number of samples per node for the hot and flat layouts, see
+        node_counts(). If None, the training samples are used.
+    lazy : bool
+        Also generate dtc_lazy().
+    verbose : bool
+        Print the expected number of features and branches.
+    fold : bool
+        Fold the affine normalizations into the thresholds.
+    confidence : bool
+        Also return the purity of the leaf in the output parameter
+        confidence.
+
+    Returns
+    -------
+    str
+        The C code.
+    """
+    assert layout in LAYOUTS, 'layout should be one of ' + str(LAYOUTS)
 
-    dtc = joblib.load(filename_dtc)
-    bunch = CustomBunch.load_csv(filename_train_bunch)
-    
     # Adapted from the original tree export_text function
     # https://github.com/scikit-learn/scikit-learn/blob/main/sklearn/tree/_export.py
 
     tree_ = dtc.tree_
     spacing = 4
-    decimals = 6
     max_depth = 10
     show_weights = False
 
     feature_names_ = [bunch.attributes[i] if i != _tree.TREE_UNDEFINED else
         None for i in tree_.feature]
+    thresholds_ = [float_str(float32_threshold(t)) for t in tree_.threshold]
+
+    # Replace the features of normalized data by the features of the data
+    # that is not normalized, with the thresholds scaled accordingly
+    folded = {}
+
+    if fold:
+        affine = affine_normalizations()
+
+        for node, name in enumerate(feature_names_):
+            f = fold_normalization(name, affine) if name is not None else None
+
+            if f is not None:
+                folded[name] = f[0]
+                feature_names_[node] = f[0]
+                thresholds_[node] = float_str((tree_.threshold[node] - f[2]) /
+                    f[1])
+
+    # The attribute index of each feature, for the order of the features
+    attribute_index = {}
+    for i, name in zip(tree_.feature, feature_names_):
+        if name is not None:
+            attribute_index[name] = i
 
     right_child_fmt = "{}if({} <= {}f)\n"
     left_child_fmt = "{}else // {} > {}f\n"
     truncation_fmt = "{} {}\n"
     value_fmt = "{}{}{}\n"
 
+    # Conditions of the hot and flat layouts
+    condition_fmt = {True: "{} <= {}", False: "{} > {}"}
+    hint_fmt = {'hot': "{}if(DTC_LIKELY({}f))\n",
+        'flat': "{}if(DTC_UNLIKELY({}f))\n"}
+    no_hint_fmt = "{}if({}f)\n"
+    else_fmt = "{}else // {}f\n"
+    continue_fmt = "{}// {}f\n"
+
+    if counts is None:
+        counts = node_counts(dtc, bunch.attributes)
+
+    first = first_children(tree_, counts, layout)
+
     global export_str
 
     export_str = ""
@@ -80,16 +458,26 @@ def main():
         val = ""
         is_classification = isinstance(dtc, DecisionTreeClassifier)
         if show_weights or not is_classification:
-            val = ["{1:.{0}f}, ".format(decimals, v) for v in value]
+            val = [float_str(v) + ", " for v in value]
             val = "[" + "".join(val)[:-2] + "]"
         if is_classification:
+            if confidence:
+                export_str += value_fmt.format(indent, "",
+                    " *confidence = " + float_str(np.max(value) /
+                    np.sum(value)) + "f;")
             # val += " ret = " + str(np.argmax(value)) + "; // " + str(class_name)
-            val += " ret = " + str(class_name) + ";"
+            if layout == 'flat':
+                val += " return " + c_identifier(class_name) + ";"
+            else:
+                val += " ret = " + c_identifier(class_name) + ";"
         export_str += value_fmt.format(indent, "", val)
 
-    def print_tree_recurse(node, depth):
+    def print_tree_recurse(node, depth, condition_names=feature_names_,
+        level=None):
         global export_str
-        indent = (" " * spacing) * depth
+        # The flat layout indents the hot child at the level of its parent
+        level = depth if level is None else level
+        indent = (" " * spacing) * level
 
         value = None
         if tree_.n_outputs == 1:
@@ -102,18 +490,54 @@ def main():
             class_name = dtc.classes_[class_name]
 
         if depth <= max_depth + 1:
-            if tree_.feature[node] != _tree.TREE_UNDEFINED:
+            if tree_.feature[node] != _tree.TREE_UNDEFINED and \
+                layout != 'default':
                 name = feature_names_[node]
-                threshold = tree_.threshold[node]
-                threshold = "{1:.{0}f}".format(decimals, threshold)
-                export_str += (right_child_fmt.format(indent, name, threshold))
+                threshold = thresholds_[node]
+
+                hot = first[node]
+                cold = tree_.children_left[node] + \
+                    tree_.children_right[node] - hot
+                is_left = (hot == tree_.children_left[node])
+
+                # The hot layout tests for the hot child, the flat layout for
+                # the cold child. Without a difference, there is no hint.
+                tested = (is_left == (layout == 'hot'))
+                fmt = hint_fmt[layout] if counts[hot] > counts[cold] else \
+                    no_hint_fmt
+                export_str += fmt.format(indent, condition_fmt[tested].format(
+                    condition_names[node], threshold))
                 export_str += '{}{{\n'.format(indent)
-                print_tree_recurse(tree_.children_left[node], depth + 1)
+
+                if layout == 'hot':
+                    print_tree_recurse(hot, depth + 1, condition_names)
+                    export_str += '{}}}\n'.format(indent)
+                    export_str += else_fmt.format(indent,
+                        condition_fmt[not is_left].format(name, threshold))
+                    export_str += '{}{{\n'.format(indent)
+                    print_tree_recurse(cold, depth + 1, condition_names)
+                    export_str += '{}}}\n'.format(indent)
+                else:
+                    print_tree_recurse(cold, depth + 1, condition_names,
+                        level + 1)
+                    export_str += '{}}}\n\n'.format(indent)
+                    export_str += continue_fmt.format(indent,
+                        condition_fmt[is_left].format(name, threshold))
+                    print_tree_recurse(hot, depth + 1, condition_names, level)
+            elif tree_.feature[node] != _tree.TREE_UNDEFINED:
+                name = feature_names_[node]
+                threshold = thresholds_[node]
+                export_str += (right_child_fmt.format(indent,
+                    condition_names[node], threshold))
+                export_str += '{}{{\n'.format(indent)
+                print_tree_recurse(tree_.children_left[node], depth + 1,
+                    condition_names)
                 export_str += '{}}}\n'.format(indent)
 
                 export_str += (left_child_fmt.format(indent, name, threshold))
                 export_str += '{}{{\n'.format(indent)
-                print_tree_recurse(tree_.children_right[node], depth + 1)
+                print_tree_recurse(tree_.children_right[node], depth + 1,
+                    condition_names)
                 export_str += '{}}}\n'.format(indent)
             else:  # leaf
                 _add_leaf(value, class_name, indent)
@@ -135,7 +559,7 @@ def main():
         'typedef enum\n' \
         '{\n'
     for x, label in enumerate(dtc.classes_):
-        typedef_str += '{}{} = {},\n'.format(" " * spacing, label, x)
+        typedef_str += '{}{} = {},\n'.format(" " * spacing, c_identifier(label), x)
     typedef_str += \
         '}dtc_t;\n\n'
 
@@ -146,8 +570,28 @@ def main():
         ' * \n' \
         ' * Decision tree classifier based on the following input characteristics:\n' \
         ' *   BLOCK_SIZE: ' + str(cfg.BLOCK_SIZE) + '\n' \
-        ' *   BLOCK_TYPE: ' + str(cfg.BLOCK_TYPE) + '\n' \
-        ' * \n' \
+        ' *   BLOCK_HOP: ' + str(cfg.BLOCK_HOP) + '\n' \
+        ' *   BLOCK_SCALES: ' + str(cfg.BLOCK_SCALES) + '\n' \
+        ' * \n'
+    if layout != 'default':
+        comment_str += \
+            ' * The branch that most samples reach is emitted first in each node\n' \
+            ' * (layout: ' + layout + '), so the hot path takes the fewest branches.\n' \
+            ' * \n'
+    if folded:
+        comment_str += \
+            ' * The normalizations are folded into the thresholds. Pass these features\n' \
+            ' * of the data that is not normalized:\n'
+        for name in sorted(folded, key=bunch.attributes.index):
+            comment_str += ' *   ' + name + ' -> ' + folded[name] + '\n'
+        comment_str += \
+            ' * \n'
+    if confidence:
+        comment_str += \
+            ' * \\param[out]  confidence  Fraction of the training samples in the leaf\n' \
+            ' *                          with the returned label\n' \
+            ' * \n'
+    comment_str += \
         ' * \\return dtc_t\n'
     for x, label in enumerate(dtc.classes_):
         comment_str += ' *   ' + str(x) + '  ' + label + '\n'
@@ -156,30 +600,147 @@ def main():
                
     # Create an argument for each feature
     args = ', '.join(['const float ' + str(f) for f in [i for i in set(feature_names_) if i is not None]])
+    if confidence:
+        args += (', ' if args else '') + 'float *confidence'
 
     # Create the function start
     function_open_str = \
         'dtc_t dtc(' +  args + ')\n' \
         '{\n'
-    function_open_str += \
-        '{}dtc_t ret;\n\n'.format(" " * spacing)
+    # The flat layout returns from each leaf
+    ret_str = '{}dtc_t ret;\n\n'.format(" " * spacing)
+    return_str = '\n{}return ret;\n}}\n'.format(" " * spacing)
+
+    if layout == 'flat':
+        ret_str = ''
+        return_str = '}\n'
+
+    function_open_str += ret_str
 
     # Create the function body
     function_body_str = print_tree_recurse(0, 1)
 
     # Create the function end
-    function_close_str = \
-        '\n{}return ret;\n}}\n'.format(" " * spacing)
-
-    # Show all parts
-    if __name__ == "__main__":
-        print(typedef_str[:-1])
-        print(comment_str[:-1])
-        print(function_open_str[:-1])
-        print(function_body_str[:-1])
-        print(function_close_str[:-1])
-
-    # Save all parts in a file
+    function_close_str = return_str
+
+    # Report the number of features computed per window on demand
+    expected, per_class, n_features = expected_features(tree_)
+
+    width = max([len(str(label)) for label in dtc.classes_] + [3]) + 2
+
+    if verbose:
+        print('Features in the tree: {} of {}'.format(n_features,
+            len(bunch.attributes)))
+        print('Expected number of features computed per window on demand:')
+        print('  {:<{}}{:>8.2f}'.format('all', width, expected))
+        for label, e in zip(dtc.classes_, per_class):
+            print('  {:<{}}{:>8.2f}'.format(str(label), width, e))
+
+        # Report the branches per prediction of the profile
+        print('Branches per prediction:')
+        print('  {:<{}}{:>10}{:>10}'.format('layout', width, 'compares',
+            'taken'))
+        for name in sorted({'default', layout}, key=LAYOUTS.index):
+            compares, taken = branch_statistics(tree_, counts,
+                first_children(tree_, counts, name))
+            print('  {:<{}}{:>10.2f}{:>10.2f}'.format(name, width, compares,
+                taken))
+
+        if fold:
+            print('Normalizations folded into the thresholds: {} of {}'.format(
+                len(folded), n_features))
+            for name in sorted(folded, key=bunch.attributes.index):
+                print('  {} -> {}'.format(name, folded[name]))
+
+    include_str = ''
+    lazy_str = ''
+
+    if layout != 'default':
+        include_str = EXPECT_STR
+
+    if lazy:
+        include_str = '#include "feature_cache.h"\n\n' + include_str
+
+        # Create an enumerated type of the features, in the order of the
+        # attributes
+        lazy_features = sorted(attribute_index, key=attribute_index.get)
+        lazy_ids = {a: 'DTC_' + c_identifier(a).upper() for a in
+            lazy_features}
+
+        lazy_str = \
+            '\n// Features of dtc_lazy(), in the order of the feature cache\n' \
+            'typedef enum\n' \
+            '{\n'
+        for x, a in enumerate(lazy_features):
+            lazy_str += '{}{} = {},\n'.format(" " * spacing, lazy_ids[a], x)
+        lazy_str += '{}DTC_N_FEATURES = {},\n'.format(" " * spacing,
+            len(lazy_features))
+        lazy_str += \
+            '}dtc_feature_t;\n\n'
+
+        # Create function documentation
+        lazy_str += \
+            '/*\n' \
+            ' * \\brief Decision tree classifier with features computed on demand\n' \
+            ' * \n' \
+            ' * Identical to dtc(), but each feature is requested from the feature cache\n' \
+            ' * when a node needs it, see lib/feature_cache.c. Expected number of\n' \
+            ' * features computed per window of the ' + str(n_features) + ' features in the tree,\n' \
+            ' * weighted by the training class frequencies:\n' \
+            ' *   {:<{}}{:.2f}\n'.format('all', width, expected)
+        for label, e in zip(dtc.classes_, per_class):
+            lazy_str += ' *   {:<{}}{:.2f}\n'.format(str(label), width, e)
+        lazy_str += \
+            ' * \n' \
+            ' * \\param[inout]  features  Feature cache of the window\n'
+        if confidence:
+            lazy_str += \
+                ' * \\param[out]    confidence  Fraction of the training samples in the\n' \
+                ' *                            leaf with the returned label\n'
+        lazy_str += \
+            ' * \n' \
+            ' * \\return dtc_t\n' \
+            ' */\n'
+
+        lazy_str += \
+            'dtc_t dtc_lazy(feature_cache_t *features' + \
+            (', float *confidence' if confidence else '') + ')\n' \
+            '{\n'
+        lazy_str += ret_str
+
+        # Create the function body, which requests the features
+        condition_names = ['feature_cache_get(features, {})'.format(
+            lazy_ids[n]) if n is not None else None for n in feature_names_]
+        export_str = ""
+        lazy_str += print_tree_recurse(0, 1, condition_names)
+
+        lazy_str += return_str
+
+    return include_str + typedef_str + comment_str + function_open_str + \
+        function_body_str + function_close_str + lazy_str
+
+def main():
+
+    filename_train_bunch = join(cfg.MODEL_DIR_PATH,"dtc_train_bunch.csv")
+    filename_dtc = join(cfg.MODEL_DIR_PATH,"dtc_model.gz")
+
+    dtc = joblib.load(filename_dtc)
+    bunch = CustomBunch.load_csv(filename_train_bunch)
+
+    # Count the samples per node of a replayed capture, or of the training
+    # samples
+    profile = None
+    if PROFILE_FILENAME is not None:
+        profile = CustomBunch.load_csv(PROFILE_FILENAME)
+
+    counts = node_counts(dtc, bunch.attributes, profile)
+
+    source = generate(dtc, bunch, LAYOUT, counts)
+
+    # Show the source
+    print(source[:-1])
+
+    # Save the source in a file
     code_filepath = join(cfg.MODEL_EMBEDDING_DIR_PATH, 'dtc')
     code_filename = join(code_filepath, 'dtc_model.c')
 
@@ -187,11 +748,7 @@ def main():
         makedirs(code_filepath)
 
     codefile = open(code_filename, 'w')
-    codefile.write(typedef_str)
-    codefile.write(comment_str)
-    codefile.write(function_open_str)
-    codefile.write(function_body_str)
-    codefile.write(function_close_str)
+    codefile.write(source)
     codefile.close()
 
     print('File written:')
@@ -0,0 +1,187 @@
+"""
+code_generator_knn2c.py
+
+Generate C code from a nearest prototype (k-NN) model
+
+The prototypes are emitted as a packed constant table that is searched by the
+knn() or knn_q7() functions in ./lib/classifiers.c.
+
+Authors:    Hugo Arends
+            Jeroen Veen
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+sys.path.append(join(dirname(realpath(__file__)), '..', 'model_building'))
+
+import config as cfg
+from build_knn import check_limits
+from code_generator_dtc2c import c_identifier
+import joblib
+import numpy as np
+from os.path import join, exists
+from os import makedirs
+
+# TODO Set to True to store the prototypes as int8 instead of float. This
+#      reduces the table size by a factor four and avoids floating point
+#      arithmetic in the distance computations.
+QUANTIZE = False
+
+def main():
+
+    filename_knn = join(cfg.MODEL_DIR_PATH,"knn_model.gz")
+    model = joblib.load(filename_knn)
+
+    spacing = 4
+    decimals = 6
+
+    attributes = model['attributes']
+    classes = model['classes']
+    prototypes = model['prototypes']
+    labels = model['labels']
+    offset = model['offset']
+    scale = model['scale']
+
+    n_prototypes, n_features = prototypes.shape
+    check_limits(n_features, len(classes), model['k'])
+
+    if QUANTIZE:
+        # Map the largest absolute standardized training value to 127
+        q = 127.0 / model['range']
+        prototypes = np.clip(np.round(prototypes * q), -128, 127).astype(int)
+        scale = scale * q
+        prototype_type = 'int8_t'
+        model_type = 'knn_q7_model_t'
+        function = 'knn_q7'
+        fmt = lambda v: '{:>4d}'.format(v)
+    else:
+        prototype_type = 'float'
+        model_type = 'knn_model_t'
+        function = 'knn'
+        fmt = lambda v: '{1:.{0}f}f'.format(decimals, v)
+
+    indent = " " * spacing
+
+    # Build source file
+
+    include_str = \
+        '#include "classifiers.h"\n\n'
+
+    # Create enumerated type of all labels
+    typedef_str = \
+        'typedef enum\n' \
+        '{\n'
+    for x, label in enumerate(classes):
+        typedef_str += '{}{} = {},\n'.format(indent, c_identifier(label), x)
+    typedef_str += \
+        '}knn_t;\n\n'
+
+    # Create the packed tables
+    table_str = \
+        '#define KNN_N_PROTOTYPES ({})\n'.format(n_prototypes) + \
+        '#define KNN_N_FEATURES ({})\n'.format(n_features) + \
+        '#define KNN_N_CLASSES ({})\n'.format(len(classes)) + \
+        '#define KNN_K ({})\n\n'.format(model['k']) + \
+        '#if (KNN_N_FEATURES > KNN_N_FEATURES_MAX) || ' \
+        '(KNN_N_CLASSES > KNN_N_CLASSES_MAX) || (KNN_K > KNN_K_MAX)\n' \
+        '#error "The model exceeds the limits of the k-NN functions in ' \
+        'classifiers.h"\n' \
+        '#endif\n\n'
+
+    table_str += 'static const float knn_offset[KNN_N_FEATURES] =\n{\n'
+    for a, v in zip(attributes, offset):
+        table_str += '{}{}, // {}\n'.format(indent,
+            '{1:.{0}f}f'.format(decimals, v), a)
+    table_str += '};\n\n'
+
+    table_str += 'static const float knn_scale[KNN_N_FEATURES] =\n{\n'
+    for a, v in zip(attributes, scale):
+        table_str += '{}{}, // {}\n'.format(indent,
+            '{1:.{0}f}f'.format(decimals, v), a)
+    table_str += '};\n\n'
+
+    table_str += 'static const {} knn_prototypes[KNN_N_PROTOTYPES * ' \
+        'KNN_N_FEATURES] =\n{{\n'.format(prototype_type)
+    for p, l in zip(prototypes, labels):
+        table_str += '{}{}, // {}\n'.format(indent,
+            ', '.join([fmt(v) for v in p]), classes[l])
+    table_str += '};\n\n'
+
+    table_str += 'static const uint8_t knn_labels[KNN_N_PROTOTYPES] =\n{\n'
+    for l in labels:
+        table_str += '{}{},\n'.format(indent, c_identifier(classes[l]))
+    table_str += '};\n\n'
+
+    table_str += \
+        'static const {} knn_model =\n'.format(model_type) + \
+        '{\n' + \
+        '{}knn_prototypes,\n'.format(indent) + \
+        '{}knn_labels,\n'.format(indent) + \
+        '{}knn_offset,\n'.format(indent) + \
+        '{}knn_scale,\n'.format(indent) + \
+        '{}KNN_N_PROTOTYPES,\n'.format(indent) + \
+        '{}KNN_N_FEATURES,\n'.format(indent) + \
+        '};\n\n'
+
+    # Create function documentation
+    comment_str = \
+        '/*\n' \
+        ' * \\brief Nearest prototype classifier\n' \
+        ' * \n' \
+        ' * Nearest prototype classifier based on the following input characteristics:\n' \
+        ' *   BLOCK_SIZE: ' + str(cfg.BLOCK_SIZE) + '\n' \
+        ' *   BLOCK_HOP: ' + str(cfg.BLOCK_HOP) + '\n' \
+        ' *   BLOCK_SCALES: ' + str(cfg.BLOCK_SCALES) + '\n' \
+        ' *   PROTOTYPES: ' + str(n_prototypes) + '\n' \
+        ' *   K:          ' + str(model['k']) + '\n' \
+        ' * \n' \
+        ' * \\return knn_t\n'
+    for x, label in enumerate(classes):
+        comment_str += ' *   ' + str(x) + '  ' + label + '\n'
+    comment_str += \
+        ' */\n'
+
+    # Create an argument for each feature, in the order of the table columns
+    args = ', '.join(['const float ' + str(a) for a in attributes])
+
+    function_str = \
+        'knn_t knn_classify(' + args + ')\n' \
+        '{\n' + \
+        '{}const float x[KNN_N_FEATURES] = {{{}}};\n\n'.format(indent,
+            ', '.join(attributes)) + \
+        '{}return (knn_t){}(x, &knn_model, KNN_K);\n'.format(indent,
+            function) + \
+        '}\n'
+
+    # Show all parts
+    if __name__ == "__main__":
+        print(include_str[:-1])
+        print(typedef_str[:-1])
+        print(table_str[:-1])
+        print(comment_str[:-1])
+        print(function_str[:-1])
+
+    # Save all parts in a file
+    code_filepath = join(cfg.MODEL_EMBEDDING_DIR_PATH, 'knn')
+    code_filename = join(code_filepath, 'knn_model.c')
+
+    if not exists(code_filepath):
+        makedirs(code_filepath)
+
+    codefile = open(code_filename, 'w')
+    codefile.write(include_str)
+    codefile.write(typedef_str)
+    codefile.write(table_str)
+    codefile.write(comment_str)
+    codefile.write(function_str)
+    codefile.close()
+
+    print('File written:')
+    print(code_filename)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,220 @@
+"""
+parity_dtc_fold.py
+
+Checks that folding the normalizations into the thresholds of the generated
+decision tree classifier does not change its predictions, see
+FOLD_NORMALIZATIONS in code_generator_dtc2c.py.
+
+The windows of the preprocessing are computed again from the input files of
+normalization_calculator.py, once with and once without the normalization,
+with the normalization and feature functions that are also used on the
+microcontroller. The generated classifier with the features of normalized
+data and the generated classifier with the normalizations folded into the
+thresholds are compiled for the host, and their labels are compared for every
+window. Both are also compared with the predictions of scikit-learn.
+
+Run build_dtc.py first.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..'))
+sys.path.append(join(dirname(realpath(__file__)), '..', 'preprocessing',
+    'feature_selection'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+import code_generator_dtc2c as generator
+from benchmark_knn_dtc import model_arguments
+from copy import deepcopy
+import feature_functions as ff
+from feature_calculator import windows, scale_suffix
+from glob import glob
+import joblib
+import normalization_calculator as nc
+import numpy as np
+from os.path import join
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+
+#define N_WINDOWS ({n_windows})
+#define N_FEATURES ({n_features})
+
+// Features of the normalized data and of the data that is not normalized
+static const float normalized_x[N_WINDOWS][N_FEATURES] =
+{{
+{normalized_x}
+}};
+
+static const float folded_x[N_WINDOWS][N_FEATURES] =
+{{
+{folded_x}
+}};
+
+static const int reference_y[N_WINDOWS] =
+{{
+{reference_y}
+}};
+
+int predict_normalized(const float *x);
+int predict_folded(const float *x);
+
+int main(void)
+{{
+    uint32_t differ = 0;
+    uint32_t normalized_reference = 0;
+    uint32_t folded_reference = 0;
+
+    for(uint32_t i=0; i<N_WINDOWS; ++i)
+    {{
+        const int normalized = predict_normalized(normalized_x[i]);
+        const int folded = predict_folded(folded_x[i]);
+
+        differ += (normalized != folded) ? 1 : 0;
+        normalized_reference += (normalized != reference_y[i]) ? 1 : 0;
+        folded_reference += (folded != reference_y[i]) ? 1 : 0;
+    }}
+
+    printf("%u,%u,%u\\n", (unsigned int)differ,
+        (unsigned int)normalized_reference, (unsigned int)folded_reference);
+
+    return 0;
+}}
+'''
+
+WRAPPER_FILE_STR = \
+'''
+int predict_{name}(const float *x)
+{{
+    return (int)dtc_{name}({args});
+}}
+'''
+
+def main():
+
+    filename_train_bunch = join(cfg.MODEL_DIR_PATH,"dtc_train_bunch.csv")
+    filename_dtc = join(cfg.MODEL_DIR_PATH,"dtc_model.gz")
+
+    dtc = joblib.load(filename_dtc)
+    train_bunch = CustomBunch.load_csv(filename_train_bunch)
+
+    # The features in the tree, and how each is computed from the input of
+    # the normalization
+    attributes = [train_bunch.attributes[i] for i in
+        sorted(set(f for f in dtc.tree_.feature if f >= 0))]
+
+    affine = generator.affine_normalizations()
+    normalizations = {f.__name__: (f, arg) for f, arg in
+        zip(nc.NORMALIZATION_FUNCTIONS, nc.ARGS)}
+
+    stages = []
+    for a in attributes:
+        stage = [(a[:-len(n + f + scale_suffix(k)) - 2], n, f, k) for n in
+            normalizations for f in generator.FOLDS for k in
+            range(int(cfg.BLOCK_SCALES)) if a.endswith('_' + n + '_' + f +
+            scale_suffix(k))]
+        assert len(stage) == 1, a + ' is not a feature of normalized data ' \
+            'that can be computed again, see FOLDS in code_generator_dtc2c.py'
+        stages += stage
+
+    folded = [generator.fold_normalization(a, affine) for a in attributes]
+    folded_attributes = [a if f is None else f[0] for a, f in
+        zip(attributes, folded)]
+
+    # Compute the features of every window, with and without the
+    # normalization
+    normalized_x = []
+    folded_x = []
+
+    for filename in sorted(glob(join(nc.INPUT_DIR_PATH, '*.csv'))):
+        bunch = CustomBunch.load_csv(filename)
+
+        normalized_columns = []
+        folded_columns = []
+
+        for (attr, n, f, k), fold in zip(stages, folded):
+            d = bunch.data[:, bunch.attributes.index(attr)]
+
+            # Every attribute starts with its own copy of the arguments,
+            # because stateful functions keep their state in them
+            function, arg = normalizations[n]
+            arg = deepcopy(arg)
+            y = np.array([function(val, arg[0], arg[1]) for val in d])
+
+            feature = getattr(ff, f)
+            normalized_columns.append([feature(w) for w in windows(y, k)])
+            folded_columns.append(normalized_columns[-1] if fold is None else
+                [feature(w) for w in windows(d, k)])
+
+        normalized_x += list(np.array(normalized_columns).T)
+        folded_x += list(np.array(folded_columns).T)
+
+    assert len(normalized_x) > 0, 'No windows'
+
+    # The reference predictions of scikit-learn. The other features are not
+    # used by the tree.
+    x = np.zeros((len(normalized_x), len(train_bunch.attributes)))
+    for k, a in enumerate(attributes):
+        x[:, train_bunch.attributes.index(a)] = [row[k] for row in
+            normalized_x]
+    reference_y = [list(dtc.classes_).index(l) for l in dtc.predict(x)]
+
+    # Generate both classifiers with their own function name
+    sources = {}
+
+    for name, fold, names in [('normalized', False, attributes),
+        ('folded', True, folded_attributes)]:
+        source = generator.generate(dtc, train_bunch, lazy=False,
+            verbose=False, fold=fold)
+        source = source.replace('dtc_t dtc(', 'dtc_t dtc_{}('.format(name))
+
+        sources['dtc_{}.c'.format(name)] = source + WRAPPER_FILE_STR.format(
+            name=name, args=model_arguments(source, 'dtc_t dtc_' + name,
+            names))
+
+    def rows(data):
+        return ',\n'.join(['    {' + ', '.join([repr(float(v)) + 'f' for v
+            in row]) + '}' for row in data])
+
+    sources['main.c'] = MAIN_FILE_STR.format(
+        n_windows=len(normalized_x),
+        n_features=len(attributes),
+        normalized_x=rows(normalized_x),
+        folded_x=rows(folded_x),
+        reference_y=',\n'.join(['    ' + str(y) for y in reference_y]))
+
+    executable = c2exe.build('parity_dtc_fold',
+        join(cfg.MODEL_EMBEDDING_DIR_PATH, 'parity_project'), sources)
+
+    differ, normalized_reference, folded_reference = \
+        c2exe.run(executable).split(',')
+
+    print()
+    print('Windows: {}'.format(len(normalized_x)))
+    print('Features folded: {} of {}'.format(
+        sum(f is not None for f in folded), len(attributes)))
+    for a, f in zip(attributes, folded):
+        if f is not None:
+            print('  {} = {} * {} {} {}'.format(a,
+                generator.float_str(f[1]), f[0], '-' if f[2] < 0 else '+',
+                generator.float_str(abs(f[2]))))
+    print()
+    print('{:<28}{:>8}'.format('labels', 'differ'))
+    print('{:<28}{:>8}'.format('folded vs normalized', int(differ)))
+    print('{:<28}{:>8}'.format('normalized vs scikit-learn',
+        int(normalized_reference)))
+    print('{:<28}{:>8}'.format('folded vs scikit-learn',
+        int(folded_reference)))
+
+
+if __name__ == "__main__":
+    main()
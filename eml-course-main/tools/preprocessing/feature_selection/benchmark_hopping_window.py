@@ -0,0 +1,207 @@
+"""
+benchmark_hopping_window.py
+
+Compares the latency of the features of overlapping windows, computed from
+all samples of every window and by merging the aggregates of the hops of
+window_aggregates.c.
+
+A window of WINDOW_SIZE samples starts every hop samples of a captured data
+file. The minimum, maximum, mean, variance and energy of every window are
+computed with the functions in features.c, which process all samples of the
+window again, and with a hopping window, which aggregates every sample once
+and merges WINDOW_SIZE / hop blocks per window. Both must give the same
+results. The C code is compiled for the host, so use the latency to compare
+the implementations relative to each other. Absolute values on the
+microcontroller are much larger.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..', '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+from os.path import join
+
+# TODO Set the captured data file, the channel, the window size and the hops.
+#      The window size must be a multiple of every hop.
+INPUT_FILE = join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv')
+CHANNEL = 'ToF'
+WINDOW_SIZE = 100
+HOPS = [100, 50, 25, 10, 5]
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "features.h"
+#include "window_aggregates.h"
+
+#define N_SAMPLES ({n_samples})
+#define N_HOPS ({n_hops})
+#define N_WINDOW ({n_window})
+
+static float data[N_SAMPLES] =
+{{
+{data}
+}};
+
+static const uint32_t hops[N_HOPS] = {{{hops}}};
+
+// The minimum, maximum, mean, variance and energy of every window
+static float results[2][N_SAMPLES][5];
+
+static aggregate_t blocks[N_WINDOW];
+
+static uint32_t recompute(const uint32_t hop)
+{{
+    uint32_t n = 0;
+
+    for(uint32_t i=N_WINDOW; i<=N_SAMPLES; i+=hop)
+    {{
+        float *window = &data[i - N_WINDOW];
+
+        results[0][n][0] = min(window, N_WINDOW);
+        results[0][n][1] = max(window, N_WINDOW);
+        results[0][n][2] = mean(window, N_WINDOW);
+        results[0][n][3] = variance(window, N_WINDOW);
+        results[0][n][4] = energy(window, N_WINDOW);
+        ++n;
+    }}
+
+    return n;
+}}
+
+static uint32_t hopping(const uint32_t hop)
+{{
+    hopping_window_t w;
+    uint32_t n = 0;
+
+    hopping_window_init(&w, blocks, N_WINDOW, hop);
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        if(hopping_window_update(&w, data[i]))
+        {{
+            const aggregate_t *a = hopping_window(&w);
+
+            results[1][n][0] = aggregate_min(a);
+            results[1][n][1] = aggregate_max(a);
+            results[1][n][2] = aggregate_mean(a);
+            results[1][n][3] = aggregate_variance(a);
+            results[1][n][4] = aggregate_energy(a);
+            ++n;
+        }}
+    }}
+
+    return n;
+}}
+
+static double benchmark(uint32_t (*features)(const uint32_t),
+    const uint32_t hop, uint32_t *n)
+{{
+    // Repeat the data until the measurement takes long enough
+    uint32_t repeat = 1;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            *n = features(hop);
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    return 1e9 * duration / ((double)repeat * N_SAMPLES);
+}}
+
+int main(void)
+{{
+    for(uint32_t k=0; k<N_HOPS; ++k)
+    {{
+        uint32_t n_recompute;
+        uint32_t n_hopping;
+
+        const double ns_recompute = benchmark(recompute, hops[k], &n_recompute);
+        const double ns_hopping = benchmark(hopping, hops[k], &n_hopping);
+
+        // Largest difference relative to the feature of the recomputed
+        // window
+        float differ = (n_recompute == n_hopping) ? 0.0f : INFINITY;
+
+        for(uint32_t i=0; i<n_recompute; ++i)
+        {{
+            for(uint32_t j=0; j<5; ++j)
+            {{
+                const float r = results[0][i][j];
+                const float d = fabsf(r - results[1][i][j]);
+
+                differ = fmaxf(differ, (r != 0.0f) ? d / fabsf(r) : d);
+            }}
+        }}
+
+        printf("%u,%u,%f,%f,%f\\n", (unsigned int)hops[k],
+            (unsigned int)n_recompute, ns_recompute, ns_hopping,
+            (double)differ);
+    }}
+
+    return 0;
+}}
+'''
+
+def main():
+
+    bunch = CustomBunch.load_csv(INPUT_FILE)
+    data = bunch.data[:, bunch.attributes.index(CHANNEL)]
+
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_samples=len(data),
+            n_hops=len(HOPS),
+            n_window=WINDOW_SIZE,
+            data=',\n'.join(['    ' + repr(float(v)) + 'f' for v in data]),
+            hops=', '.join(str(h) for h in HOPS),
+            min_duration=MIN_DURATION),
+    }
+
+    executable = c2exe.build('benchmark_hopping_window',
+        join(cfg.PREPROCESSING_FEATURES_DIR_PATH, 'benchmark_project'), sources,
+        lib_files=['features.h', 'features.c', 'window_aggregates.h',
+            'window_aggregates.c'])
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Samples: {len(data)} of {CHANNEL}, windows of {WINDOW_SIZE} '
+          f'samples, min, max, mean, variance and energy\n')
+    print('{:<6}{:>10}{:>10}{:>22}{:>20}{:>10}{:>12}'.format('hop', 'overlap',
+        'windows', 'recompute ns/sample', 'hopping ns/sample', 'speedup',
+        'rel differ'))
+    for line in output.splitlines():
+        hop, n, ns_recompute, ns_hopping, differ = line.split(',')
+        print('{:<6}{:>9.0f}%{:>10}{:>22.1f}{:>20.1f}{:>10.1f}{:>12.3g}'.format(
+            int(hop), 100.0 * (1.0 - int(hop) / WINDOW_SIZE), int(n),
+            float(ns_recompute), float(ns_hopping),
+            float(ns_recompute) / float(ns_hopping), float(differ)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,212 @@
+"""
+benchmark_multichannel.py
+
+Compares the latency of the multi-channel features for the structure of arrays
+(SoA) and array of structures (AoS) layouts, and for computing every feature
+in a separate pass.
+
+The C code is compiled for the host together with the windows of a captured
+data file. The latency is measured on the host, so use it to compare the
+layouts relative to each other. Absolute values on the microcontroller are
+much larger.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..', '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+import numpy as np
+from os.path import join
+
+# TODO Set the captured data file and the number of channels, starting at the
+#      first attribute. Must not exceed MC_N_CHANNELS_MAX in features.h.
+INPUT_FILE = join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv')
+N_CHANNELS = 9
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "features.h"
+
+#define N_WINDOWS ({n_windows})
+#define N_CHANNELS ({n_channels})
+#define N ({n})
+
+// Array of structures: all channels of a sample are adjacent
+static const float aos[N_WINDOWS][N * N_CHANNELS] =
+{{
+{aos}
+}};
+
+// Structure of arrays: a separate array per channel
+static float soa[N_WINDOWS][N_CHANNELS][N];
+
+static multichannel_t result;
+static volatile float sink;
+
+static void separate(const uint32_t w)
+{{
+    float *data[N_CHANNELS];
+
+    for(uint32_t c=0; c<N_CHANNELS; ++c)
+    {{
+        data[c] = soa[w][c];
+        result.mean[c] = mean(data[c], N);
+        result.variance[c] = variance(data[c], N);
+    }}
+
+    // A pass per channel pair
+    uint32_t p = 0;
+
+    for(uint32_t a=0; a<N_CHANNELS; ++a)
+    {{
+        for(uint32_t b=a+1; b<N_CHANNELS; ++b)
+        {{
+            float sum = 0.0f;
+
+            for(uint32_t i=0; i<N; ++i)
+            {{
+                sum += (data[a][i] - result.mean[a]) * (data[b][i] - result.mean[b]);
+            }}
+
+            result.covariance[p++] = sum / N;
+        }}
+    }}
+
+    // A pass for the vector magnitude and the signal magnitude area
+    float magnitude = 0.0f;
+    float sma = 0.0f;
+
+    for(uint32_t i=0; i<N; ++i)
+    {{
+        float sq = 0.0f;
+
+        for(uint32_t c=0; c<N_CHANNELS; ++c)
+        {{
+            sq += data[c][i] * data[c][i];
+            sma += fabsf(data[c][i]);
+        }}
+
+        magnitude += sqrtf(sq);
+    }}
+
+    result.magnitude = magnitude / N;
+    result.sma = sma / N;
+}}
+
+static void one_pass_soa(const uint32_t w)
+{{
+    const float *data[N_CHANNELS];
+
+    for(uint32_t c=0; c<N_CHANNELS; ++c)
+    {{
+        data[c] = soa[w][c];
+    }}
+
+    multichannel_soa(&result, data, N_CHANNELS, N);
+}}
+
+static void one_pass_aos(const uint32_t w)
+{{
+    multichannel_aos(&result, aos[w], N_CHANNELS, N);
+}}
+
+static void benchmark(const char *name, void (*features)(const uint32_t))
+{{
+    // Repeat the windows until the measurement takes long enough
+    uint32_t repeat = 1;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            for(uint32_t w=0; w<N_WINDOWS; ++w)
+            {{
+                features(w);
+                sink += result.covariance[0];
+            }}
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    printf("%s,%f\\n", name, 1e9 * duration / ((double)repeat * N_WINDOWS));
+}}
+
+int main(void)
+{{
+    for(uint32_t w=0; w<N_WINDOWS; ++w)
+    {{
+        for(uint32_t i=0; i<N; ++i)
+        {{
+            for(uint32_t c=0; c<N_CHANNELS; ++c)
+            {{
+                soa[w][c][i] = aos[w][(i * N_CHANNELS) + c];
+            }}
+        }}
+    }}
+
+    benchmark("separate", separate);
+    benchmark("soa", one_pass_soa);
+    benchmark("aos", one_pass_aos);
+
+    return 0;
+}}
+'''
+
+def main():
+
+    bunch = CustomBunch.load_csv(INPUT_FILE)
+    n = int(cfg.BLOCK_SIZE)
+
+    data = np.array(bunch.data[:, 0:N_CHANNELS], dtype=float)
+    n_windows = len(data) // n
+    windows = np.reshape(data[0:n_windows * n], (n_windows, n * N_CHANNELS))
+
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_windows=n_windows,
+            n_channels=N_CHANNELS,
+            n=n,
+            aos=',\n'.join(['    {' + ', '.join(
+                [repr(float(v)) + 'f' for v in w]) + '}' for w in windows]),
+            min_duration=MIN_DURATION),
+    }
+
+    executable = c2exe.build('benchmark_multichannel',
+        join(cfg.PREPROCESSING_FEATURES_DIR_PATH, 'benchmark_project'), sources,
+        lib_files=['features.h', 'features.c'])
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Windows: {n_windows}, channels: {N_CHANNELS}, '
+          f'samples per window: {n}\n')
+    print('{:<12}{:>12}'.format('layout', 'ns/window'))
+    for line in output.splitlines():
+        name, ns = line.split(',')
+        print('{:<12}{:>12.1f}'.format(name, float(ns)))
+
+
+if __name__ == "__main__":
+    main()
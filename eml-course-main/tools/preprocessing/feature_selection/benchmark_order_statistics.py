@@ -0,0 +1,215 @@
+"""
+benchmark_order_statistics.py
+
+Compares the latency of the median and the quartiles of a sliding window,
+computed by sorting every window and by updating the sliding percentiles of
+order_statistics.c.
+
+After every sample of a captured data file, the median, first quartile and
+third quartile of the last n samples are computed. Sorting a window costs
+O(n log n) per sample, a sliding percentile O(log n). Both must give the same
+results. The C code is compiled for the host, so use the latency to compare
+the implementations relative to each other. Absolute values on the
+microcontroller are much larger.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..', '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+from os.path import join
+
+# TODO Set the captured data file, the channel and the window sizes
+INPUT_FILE = join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv')
+CHANNEL = 'ToF'
+WINDOW_SIZES = [25, 50, 100, 200]
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "order_statistics.h"
+
+#define N_SAMPLES ({n_samples})
+#define N_SIZES ({n_sizes})
+#define N_MAX ({n_max})
+
+static const float data[N_SAMPLES] =
+{{
+{data}
+}};
+
+static const uint32_t sizes[N_SIZES] = {{{sizes}}};
+
+// The median, first quartile and third quartile after every sample
+static float results[2][N_SAMPLES][3];
+
+static float ring[N_MAX];
+static float sorted[N_MAX];
+
+static float x[3][N_MAX];
+static uint16_t heap[3][N_MAX];
+static uint16_t index_[3][N_MAX];
+
+static int compare(const void *a, const void *b)
+{{
+    const float fa = *(const float *)a;
+    const float fb = *(const float *)b;
+
+    return (fa > fb) - (fa < fb);
+}}
+
+// Percentile of sorted data, like sliding_percentile()
+static float percentile(const float *s, const uint32_t n, const float p)
+{{
+    const float rank = p * (float)(n - 1) / 100.0f;
+    const uint32_t k = (uint32_t)rank;
+    const float fraction = rank - (float)k;
+
+    if((k >= (n - 1)) || (fraction == 0.0f))
+    {{
+        return s[k < n ? k : n - 1];
+    }}
+
+    return s[k] + (fraction * (s[k + 1] - s[k]));
+}}
+
+static void sort(const uint32_t n)
+{{
+    uint32_t head = 0;
+
+    memset(ring, 0, sizeof(ring));
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        ring[head] = data[i];
+        head = ((head + 1) == n) ? 0 : (head + 1);
+
+        memcpy(sorted, ring, n * sizeof(float));
+        qsort(sorted, n, sizeof(float), compare);
+
+        results[0][i][0] = percentile(sorted, n, 50.0f);
+        results[0][i][1] = percentile(sorted, n, 25.0f);
+        results[0][i][2] = percentile(sorted, n, 75.0f);
+    }}
+}}
+
+static void sliding(const uint32_t n)
+{{
+    static const float p[3] = {{50.0f, 25.0f, 75.0f}};
+    sliding_percentile_t s[3];
+
+    for(uint32_t j=0; j<3; ++j)
+    {{
+        sliding_percentile_init(&s[j], x[j], heap[j], index_[j], n, p[j]);
+    }}
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        for(uint32_t j=0; j<3; ++j)
+        {{
+            sliding_percentile_update(&s[j], data[i]);
+            results[1][i][j] = sliding_percentile(&s[j]);
+        }}
+    }}
+}}
+
+static double benchmark(void (*percentiles)(const uint32_t), const uint32_t n)
+{{
+    // Repeat the data until the measurement takes long enough
+    uint32_t repeat = 1;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            percentiles(n);
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    return 1e9 * duration / ((double)repeat * N_SAMPLES);
+}}
+
+int main(void)
+{{
+    for(uint32_t k=0; k<N_SIZES; ++k)
+    {{
+        const double ns_sort = benchmark(sort, sizes[k]);
+        const double ns_sliding = benchmark(sliding, sizes[k]);
+
+        float differ = 0.0f;
+
+        for(uint32_t i=0; i<N_SAMPLES; ++i)
+        {{
+            for(uint32_t j=0; j<3; ++j)
+            {{
+                differ = fmaxf(differ, fabsf(results[0][i][j] - results[1][i][j]));
+            }}
+        }}
+
+        printf("%u,%f,%f,%f\\n", (unsigned int)sizes[k], ns_sort, ns_sliding,
+            (double)differ);
+    }}
+
+    return 0;
+}}
+'''
+
+def main():
+
+    bunch = CustomBunch.load_csv(INPUT_FILE)
+    data = bunch.data[:, bunch.attributes.index(CHANNEL)]
+
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_samples=len(data),
+            n_sizes=len(WINDOW_SIZES),
+            n_max=max(WINDOW_SIZES),
+            data=',\n'.join(['    ' + repr(float(v)) + 'f' for v in data]),
+            sizes=', '.join(str(n) for n in WINDOW_SIZES),
+            min_duration=MIN_DURATION),
+    }
+
+    executable = c2exe.build('benchmark_order_statistics',
+        join(cfg.PREPROCESSING_FEATURES_DIR_PATH, 'benchmark_project'), sources,
+        lib_files=['order_statistics.h', 'order_statistics.c'])
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Samples: {len(data)} of {CHANNEL}, median and quartiles after '
+          f'every sample\n')
+    print('{:<8}{:>18}{:>20}{:>10}{:>10}'.format('window', 'sort ns/sample',
+        'sliding ns/sample', 'speedup', 'differ'))
+    for line in output.splitlines():
+        n, ns_sort, ns_sliding, differ = line.split(',')
+        print('{:<8}{:>18.1f}{:>20.1f}{:>10.1f}{:>10.3g}'.format(int(n),
+            float(ns_sort), float(ns_sliding),
+            float(ns_sort) / float(ns_sliding), float(differ)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,270 @@
+"""
+benchmark_window_pyramid.py
+
+Compares the latency of the features of windows of several scales, which end
+at the same sample, computed from all samples of every window, with a
+hopping window per scale and with the window pyramid of window_aggregates.c.
+
+Every HOP samples of a captured data file, the minimum, maximum, mean,
+variance and energy of the last HOP * 2^k samples are computed for every
+scale k. The functions in features.c process all samples of every window
+again. A hopping window per scale aggregates every sample once per scale and
+merges 2^k blocks. The window pyramid aggregates every sample once and merges
+once per scale. All must give the same results. The C code is compiled for
+the host, so use the latency to compare the implementations relative to each
+other. Absolute values on the microcontroller are much larger.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..', '..'))
+
+import config as cfg
+from custom_bunch import CustomBunch
+import c2exe
+from os.path import join
+
+# TODO Set the captured data file, the channel, the window size of the
+#      smallest scale and the numbers of scales
+INPUT_FILE = join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv')
+CHANNEL = 'ToF'
+HOP = 25
+N_SCALES = [1, 2, 3, 4]
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "features.h"
+#include "window_aggregates.h"
+
+#define N_SAMPLES ({n_samples})
+#define HOP ({hop})
+#define N_SIZES ({n_sizes})
+#define N_SCALES_MAX ({n_scales_max})
+#define N_WINDOWS_MAX (N_SAMPLES / HOP)
+
+static float data[N_SAMPLES] =
+{{
+{data}
+}};
+
+static const uint32_t n_scales[N_SIZES] = {{{n_scales}}};
+
+// The minimum, maximum, mean, variance and energy of every window per scale
+static float results[3][N_WINDOWS_MAX][N_SCALES_MAX][5];
+
+static aggregate_t blocks[N_SCALES_MAX][(uint32_t)1 << (N_SCALES_MAX - 1)];
+static aggregate_t history[WINDOW_PYRAMID_N_HISTORY(N_SCALES_MAX)];
+
+static void store(float *r, const aggregate_t *a)
+{{
+    r[0] = aggregate_min(a);
+    r[1] = aggregate_max(a);
+    r[2] = aggregate_mean(a);
+    r[3] = aggregate_variance(a);
+    r[4] = aggregate_energy(a);
+}}
+
+// Windows end when the largest scale is complete
+static uint32_t recompute(const uint32_t s)
+{{
+    uint32_t n = 0;
+
+    for(uint32_t i=(HOP << (s - 1)); i<=N_SAMPLES; i+=HOP)
+    {{
+        for(uint32_t k=0; k<s; ++k)
+        {{
+            const uint32_t length = HOP << k;
+            float *window = &data[i - length];
+
+            results[0][n][k][0] = min(window, length);
+            results[0][n][k][1] = max(window, length);
+            results[0][n][k][2] = mean(window, length);
+            results[0][n][k][3] = variance(window, length);
+            results[0][n][k][4] = energy(window, length);
+        }}
+
+        ++n;
+    }}
+
+    return n;
+}}
+
+static uint32_t hopping(const uint32_t s)
+{{
+    hopping_window_t w[N_SCALES_MAX];
+    uint32_t n = 0;
+
+    for(uint32_t k=0; k<s; ++k)
+    {{
+        hopping_window_init(&w[k], blocks[k], HOP << k, HOP);
+    }}
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        bool complete = false;
+
+        for(uint32_t k=0; k<s; ++k)
+        {{
+            complete = hopping_window_update(&w[k], data[i]);
+        }}
+
+        // The largest scale is the last to complete
+        if(complete)
+        {{
+            for(uint32_t k=0; k<s; ++k)
+            {{
+                store(results[1][n][k], hopping_window(&w[k]));
+            }}
+
+            ++n;
+        }}
+    }}
+
+    return n;
+}}
+
+static uint32_t pyramid(const uint32_t s)
+{{
+    window_pyramid_t p;
+    uint32_t n = 0;
+
+    window_pyramid_init(&p, history, HOP, s);
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        if(window_pyramid_update(&p, data[i]) &&
+            (window_pyramid(&p, s - 1)->n == (HOP << (s - 1))))
+        {{
+            for(uint32_t k=0; k<s; ++k)
+            {{
+                store(results[2][n][k], window_pyramid(&p, k));
+            }}
+
+            ++n;
+        }}
+    }}
+
+    return n;
+}}
+
+static double benchmark(uint32_t (*features)(const uint32_t),
+    const uint32_t s, uint32_t *n)
+{{
+    // Repeat the data until the measurement takes long enough
+    uint32_t repeat = 1;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            *n = features(s);
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    return 1e9 * duration / ((double)repeat * N_SAMPLES);
+}}
+
+// Largest difference relative to the feature of the recomputed window
+static float differ(const uint32_t a, const uint32_t n, const uint32_t s)
+{{
+    float d = 0.0f;
+
+    for(uint32_t i=0; i<n; ++i)
+    {{
+        for(uint32_t k=0; k<s; ++k)
+        {{
+            for(uint32_t j=0; j<5; ++j)
+            {{
+                const float r = results[0][i][k][j];
+                const float e = fabsf(r - results[a][i][k][j]);
+
+                d = fmaxf(d, (r != 0.0f) ? e / fabsf(r) : e);
+            }}
+        }}
+    }}
+
+    return d;
+}}
+
+int main(void)
+{{
+    for(uint32_t m=0; m<N_SIZES; ++m)
+    {{
+        const uint32_t s = n_scales[m];
+        uint32_t n[3];
+
+        const double ns_recompute = benchmark(recompute, s, &n[0]);
+        const double ns_hopping = benchmark(hopping, s, &n[1]);
+        const double ns_pyramid = benchmark(pyramid, s, &n[2]);
+
+        const float d = ((n[0] == n[1]) && (n[0] == n[2])) ?
+            fmaxf(differ(1, n[0], s), differ(2, n[0], s)) : INFINITY;
+
+        printf("%u,%u,%f,%f,%f,%f\\n", (unsigned int)s, (unsigned int)n[0],
+            ns_recompute, ns_hopping, ns_pyramid, (double)d);
+    }}
+
+    return 0;
+}}
+'''
+
+def main():
+
+    bunch = CustomBunch.load_csv(INPUT_FILE)
+    data = bunch.data[:, bunch.attributes.index(CHANNEL)]
+
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_samples=len(data),
+            hop=HOP,
+            n_sizes=len(N_SCALES),
+            n_scales_max=max(N_SCALES),
+            data=',\n'.join(['    ' + repr(float(v)) + 'f' for v in data]),
+            n_scales=', '.join(str(s) for s in N_SCALES),
+            min_duration=MIN_DURATION),
+    }
+
+    executable = c2exe.build('benchmark_window_pyramid',
+        join(cfg.PREPROCESSING_FEATURES_DIR_PATH, 'benchmark_project'), sources,
+        lib_files=['features.h', 'features.c', 'window_aggregates.h',
+            'window_aggregates.c'])
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Samples: {len(data)} of {CHANNEL}, windows every {HOP} samples, '
+          f'min, max, mean, variance and energy per scale\n')
+    print('{:<20}{:>10}{:>12}{:>12}{:>12}{:>12}'.format('scales', 'windows',
+        'recompute', 'hopping', 'pyramid', 'rel differ'))
+    print('{:<20}{:>10}{:>12}{:>12}{:>12}'.format('', '', 'ns/sample',
+        'ns/sample', 'ns/sample'))
+    for line in output.splitlines():
+        s, n, ns_recompute, ns_hopping, ns_pyramid, d = line.split(',')
+        scales = '/'.join(str(HOP << k) for k in range(int(s)))
+        print('{:<20}{:>10}{:>12.1f}{:>12.1f}{:>12.1f}{:>12.3g}'.format(scales,
+            int(n), float(ns_recompute), float(ns_hopping), float(ns_pyramid),
+            float(d)))
+
+
+if __name__ == "__main__":
+    main()
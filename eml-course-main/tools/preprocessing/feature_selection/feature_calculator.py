@@ -26,21 +26,69 @@ import feature_functions as ff
 FEATURE_FUNCTIONS = [ff.variance]
 # FEATURE_FUNCTIONS = [ff.raw,ff.min,ff.max,ff.mean,ff.variance,ff.energy,ff.peak_to_peak]
 # FEATURE_FUNCTIONS = [np.mean,np.var,np.median,np.ptp,np.std]
+# Spectral features, the window of the largest scale must not exceed
+# FFT_N_MAX in fft.h (see SPECTRAL_FEATURE_FUNCTIONS)
+# FEATURE_FUNCTIONS = [ff.variance,ff.band_energy,ff.dominant_frequency,ff.spectral_centroid]
+# Repetitive motion features, such as the CPR compression rate
+# FEATURE_FUNCTIONS = [ff.zero_crossing_rate,ff.peak_count,ff.peak_interval_mean,ff.peak_interval_std,ff.cadence]
+# Shape features, computed from the central moments in a single pass
+# FEATURE_FUNCTIONS = [ff.mean,ff.variance,ff.rms,ff.crest_factor,ff.skewness,ff.kurtosis]
+# Robust features, for channels with spikes such as the ToF sensor
+# FEATURE_FUNCTIONS = [ff.median,ff.percentile_25,ff.percentile_75,ff.iqr]
 
 # TODO Set input directory path for feature calculation
 #INPUT_DIR_PATH = cfg.CAPTURED_DIR_PATH
 #INPUT_DIR_PATH = cfg.PREPROCESSING_FILTERS_DIR_PATH
 INPUT_DIR_PATH = cfg.PREPROCESSING_NORMALIZATIONS_DIR_PATH
 
+# Feature functions that compute the power spectrum of the window
+SPECTRAL_FEATURE_FUNCTIONS = [ff.band_energy, ff.dominant_frequency,
+    ff.spectral_centroid]
+
+def check_window_size():
+    """
+    Asserts that the window of the largest scale fits the power spectrum if
+    spectral features are calculated.
+    """
+    n_max = int(cfg.BLOCK_SIZE) << (int(cfg.BLOCK_SCALES) - 1)
+
+    if any(f in SPECTRAL_FEATURE_FUNCTIONS for f in FEATURE_FUNCTIONS):
+        assert n_max <= ff.FFT_N_MAX, 'Spectral features require windows ' \
+            'of at most FFT_N_MAX ({}) samples, the largest scale has {} ' \
+            'samples'.format(ff.FFT_N_MAX, n_max)
+
+def windows(d, scale=0):
+    """
+    Returns the windows of a scale of the data. Scale k has windows of
+    BLOCK_SIZE * 2**k samples. The windows of all scales end every BLOCK_HOP
+    samples, from the first sample at which the largest scale is complete.
+    Samples after the last window are discarded.
+    """
+    n = int(cfg.BLOCK_SIZE) << scale
+    n_max = int(cfg.BLOCK_SIZE) << (int(cfg.BLOCK_SCALES) - 1)
+    hop = int(cfg.BLOCK_HOP)
+
+    return [d[i-n:i] for i in range(n_max, len(d) + 1, hop)]
+
+def scale_suffix(scale):
+    """
+    Returns the suffix of the attribute names of the features of a scale, for
+    example _w200. The features of scale 0 have no suffix.
+    """
+    return '' if scale == 0 else '_w' + str(int(cfg.BLOCK_SIZE) << scale)
+
 def main():
 
     print('BLOCK_SIZE: '+str(cfg.BLOCK_SIZE))
-    print('BLOCK_TYPE: '+str(cfg.BLOCK_TYPE))
+    print('BLOCK_HOP: '+str(cfg.BLOCK_HOP))
+    print('BLOCK_SCALES: '+str(cfg.BLOCK_SCALES))
 
     if __name__ == "__main__":
         print('FEATURE_FUNCTIONS: ' +
             str([f.__name__ for f in FEATURE_FUNCTIONS]))
 
+    check_window_size()
+
     # Get paths of all captured data files
     filenames = glob(join(INPUT_DIR_PATH, '*.csv'))
 
@@ -67,49 +115,20 @@ def main():
             # Get a slice containing this attributes data
             d = bunch.data[:, bunch.attributes.index(attr)]
 
-            # BLOCK type?
-            if cfg.BLOCK_TYPE == 'BLOCK':
-                # Make the length of the data a multiple of the BLOCK_SIZE
-                d = d[0:(len(d) - (len(d) % int(cfg.BLOCK_SIZE)))]
-                # Reshape the data to blocks of size BLOCK_SIZE
-                d = np.reshape(d, (-1, int(cfg.BLOCK_SIZE)))
-
-                # Loop all feature functions
-                for f in FEATURE_FUNCTIONS:
-                    r = []
-                    # Loop all blocks
-                    for block in d:
-                        # Append the calculated feature of this block to the
-                        # result
-                        r.append(f(block))        
-                    # Append the result to the data
-                    data.append(r)
-                    # Combine this attribute and feature name to a new
-                    # attribute
-                    attributes.append(attr+'_'+f.__name__)
-        
-            # Sliding type?
-            if cfg.BLOCK_TYPE == 'SLIDING':
-                # Loop all feature functions
-                for f in FEATURE_FUNCTIONS:
-                    # Copy the original data
-                    tmp = d
+            # Loop all feature functions and all scales
+            for f in FEATURE_FUNCTIONS:
+                for k in range(int(cfg.BLOCK_SCALES)):
                     r = []
-                    # Loop the data while its length is greater or equal to the
-                    # BLOCK_SIZE
-                    while(len(tmp) >= int(cfg.BLOCK_SIZE)):
-                        # Get BLOCK_SIZE elements from the start of data
-                        block = tmp[0:int(cfg.BLOCK_SIZE)]
-                        # Append the calculated feature of this block to the
-                        # result
-                        r.append(f(block))      
-                        # Remove the first element from the data  
-                        tmp = np.delete(tmp,0)
+                    # Loop all windows of this scale
+                    for block in windows(d, k):
+                        # Append the calculated feature of this window to
+                        # the result
+                        r.append(f(block))
                     # Append the result to the data
                     data.append(r)
-                    # Combine this attribute and function name to a new
-                    # attribute
-                    attributes.append(attr+'_'+f.__name__)
+                    # Combine this attribute, feature name and scale to a
+                    # new attribute
+                    attributes.append(attr+'_'+f.__name__+scale_suffix(k))
 
         # Swap the data axes
         data = np.swapaxes(data,0,1)
@@ -17,8 +17,115 @@ import config as cfg
 import ctypes
 from os.path import join, isfile
 import feature_functions_c2dll
+import numpy as np
+import unittest
 
-FEATURES_DLL = join(cfg.PREPROCESSING_FEATURES_DIR_PATH, 'features.dll')
+FEATURES_DLL = feature_functions_c2dll.library_filename()
+
+# Must be equal to FFT_N_MAX in fft.h
+FFT_N_MAX = 256
+
+class Motion(ctypes.Structure):
+    """
+    State of the repetitive motion features, see motion_t in features.h
+    """
+    _fields_ = [('alpha', ctypes.c_float),
+                ('hysteresis', ctypes.c_float),
+                ('mean', ctypes.c_float),
+                ('variance', ctypes.c_float),
+                ('above', ctypes.c_bool),
+                ('started', ctypes.c_bool),
+                ('t', ctypes.c_uint32),
+                ('last_peak', ctypes.c_uint32),
+                ('has_peak', ctypes.c_bool),
+                ('candidate', ctypes.c_float),
+                ('candidate_t', ctypes.c_uint32),
+                ('n', ctypes.c_uint32),
+                ('crossings', ctypes.c_uint32),
+                ('peaks', ctypes.c_uint32),
+                ('intervals', ctypes.c_uint32),
+                ('interval_mean', ctypes.c_float),
+                ('interval_m2', ctypes.c_float)]
+
+class Moments(ctypes.Structure):
+    """
+    Central moments of a window, see moments_t in features.h
+    """
+    _fields_ = [('n', ctypes.c_uint32),
+                ('mean', ctypes.c_float),
+                ('m2', ctypes.c_float),
+                ('m3', ctypes.c_float),
+                ('m4', ctypes.c_float),
+                ('peak', ctypes.c_float)]
+
+# Must be equal to MC_N_CHANNELS_MAX in features.h
+MC_N_CHANNELS_MAX = 9
+MC_N_PAIRS_MAX = (MC_N_CHANNELS_MAX * (MC_N_CHANNELS_MAX - 1)) // 2
+
+class Multichannel(ctypes.Structure):
+    """
+    Multi-channel features, see multichannel_t in features.h
+    """
+    _fields_ = [('n_channels', ctypes.c_uint32),
+                ('mean', ctypes.c_float * MC_N_CHANNELS_MAX),
+                ('variance', ctypes.c_float * MC_N_CHANNELS_MAX),
+                ('covariance', ctypes.c_float * MC_N_PAIRS_MAX),
+                ('magnitude', ctypes.c_float),
+                ('sma', ctypes.c_float)]
+
+class SlidingPercentile(ctypes.Structure):
+    """
+    Percentile of a sliding window, see sliding_percentile_t in
+    order_statistics.h
+    """
+    _fields_ = [('x', ctypes.POINTER(ctypes.c_float)),
+                ('heap', ctypes.POINTER(ctypes.c_uint16)),
+                ('index', ctypes.POINTER(ctypes.c_uint16)),
+                ('n', ctypes.c_uint32),
+                ('k', ctypes.c_uint32),
+                ('fraction', ctypes.c_float),
+                ('head', ctypes.c_uint32)]
+
+class Aggregate(ctypes.Structure):
+    """
+    Aggregates of a part of the data, see aggregate_t in window_aggregates.h
+    """
+    _fields_ = [('n', ctypes.c_uint32),
+                ('sum', ctypes.c_float),
+                ('m2', ctypes.c_float),
+                ('min', ctypes.c_float),
+                ('max', ctypes.c_float),
+                ('energy', ctypes.c_float)]
+
+class HoppingWindow(ctypes.Structure):
+    """
+    Window that moves with a hop, see hopping_window_t in window_aggregates.h
+    """
+    _fields_ = [('blocks', ctypes.POINTER(Aggregate)),
+                ('n_blocks', ctypes.c_uint32),
+                ('hop', ctypes.c_uint32),
+                ('inv_hop', ctypes.c_float),
+                ('inv_length', ctypes.c_float),
+                ('head', ctypes.c_uint32),
+                ('filled', ctypes.c_uint32),
+                ('count', ctypes.c_uint32),
+                ('shift', ctypes.c_float),
+                ('s1', ctypes.c_float),
+                ('s2', ctypes.c_float),
+                ('window', Aggregate)]
+
+# Must be equal to WINDOW_PYRAMID_N_SCALES_MAX in window_aggregates.h
+WINDOW_PYRAMID_N_SCALES_MAX = 8
+
+class WindowPyramid(ctypes.Structure):
+    """
+    Windows of several scales, see window_pyramid_t in window_aggregates.h
+    """
+    _fields_ = [('base', HoppingWindow),
+                ('history', ctypes.POINTER(Aggregate)),
+                ('n_scales', ctypes.c_uint32),
+                ('t', ctypes.c_uint32),
+                ('scales', Aggregate * WINDOW_PYRAMID_N_SCALES_MAX)]
 
 def check_features_dll():
     """
@@ -105,6 +212,441 @@ def peak_to_peak(data):
     x = (ctypes.c_float * n)(*data)
     return c_lib.peak_to_peak(ctypes.byref(x), n)
 
+def rfft(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the spectrum in the packed format of rfft().
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    n = len(data)
+    x = (ctypes.c_float * n)(*data)
+    c_lib.rfft(ctypes.byref(x), n)
+    return list(x)
+
+def rfft_q15(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    The data must be integers in the Q15 range. Returns the spectrum, scaled
+    by 1/n, in the packed format of rfft_q15().
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    n = len(data)
+    x = (ctypes.c_int16 * n)(*[int(v) for v in data])
+    c_lib.rfft_q15(ctypes.byref(x), n)
+    return list(x)
+
+def power_spectrum(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the power spectrum and the size of the transform.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.power_spectrum.restype = ctypes.c_uint32
+    n = len(data)
+    assert 2 <= n <= FFT_N_MAX, \
+        'The number of samples must be in the range 2 .. FFT_N_MAX'
+    x = (ctypes.c_float * n)(*data)
+    power = (ctypes.c_float * (FFT_N_MAX // 2 + 1))()
+    m = c_lib.power_spectrum(ctypes.byref(x), n, ctypes.byref(power))
+    return list(power)[0:m // 2 + 1], m
+
+def band_energy(data, f_low=cfg.BAND_ENERGY[0], f_high=cfg.BAND_ENERGY[1],
+                fs=cfg.SAMPLE_FREQUENCY):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.band_energy.restype = ctypes.c_float
+    power, m = power_spectrum(data)
+    p = (ctypes.c_float * len(power))(*power)
+    return c_lib.band_energy(ctypes.byref(p), m, (ctypes.c_float)(fs),
+        (ctypes.c_float)(f_low), (ctypes.c_float)(f_high))
+
+def dominant_frequency(data, fs=cfg.SAMPLE_FREQUENCY):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.dominant_frequency.restype = ctypes.c_float
+    power, m = power_spectrum(data)
+    p = (ctypes.c_float * len(power))(*power)
+    return c_lib.dominant_frequency(ctypes.byref(p), m, (ctypes.c_float)(fs))
+
+def spectral_centroid(data, fs=cfg.SAMPLE_FREQUENCY):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.spectral_centroid.restype = ctypes.c_float
+    power, m = power_spectrum(data)
+    p = (ctypes.c_float * len(power))(*power)
+    return c_lib.spectral_centroid(ctypes.byref(p), m, (ctypes.c_float)(fs))
+
+def goertzel(data, f, fs=cfg.SAMPLE_FREQUENCY):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.goertzel_coefficient.restype = ctypes.c_float
+    c_lib.goertzel.restype = ctypes.c_float
+    coeff = c_lib.goertzel_coefficient((ctypes.c_float)(f), (ctypes.c_float)(fs))
+    n = len(data)
+    x = (ctypes.c_float * n)(*data)
+    return c_lib.goertzel(ctypes.byref(x), n, (ctypes.c_float)(coeff))
+
+def motion_init(alpha=cfg.MOTION_ALPHA, hysteresis=cfg.MOTION_HYSTERESIS):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the initialized Motion structure.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    m = Motion()
+    c_lib.motion_init(ctypes.byref(m), (ctypes.c_float)(alpha),
+        (ctypes.c_float)(hysteresis))
+    return m
+
+def motion_reset(m):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.motion_reset(ctypes.byref(m))
+
+def motion_update(m, data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns True if a peak was detected.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.motion_update.restype = ctypes.c_bool
+    return c_lib.motion_update(ctypes.byref(m), (ctypes.c_float)(data))
+
+def motion(data):
+    """
+    Returns the Motion structure after updating it with all data in a block.
+
+    On the microcontroller the running mean and variance are kept across
+    windows. Here every block is processed separately, so the running
+    statistics are primed with the statistics of the block instead.
+    """
+    m = motion_init()
+    m.mean = np.mean(data)
+    m.variance = np.var(data)
+    m.started = True
+
+    for val in data:
+        motion_update(m, val)
+    return m
+
+def zero_crossing_rate(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.zero_crossing_rate.restype = ctypes.c_float
+    return c_lib.zero_crossing_rate(ctypes.byref(motion(data)))
+
+def peak_count(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.peak_count.restype = ctypes.c_uint32
+    return c_lib.peak_count(ctypes.byref(motion(data)))
+
+def peak_interval_mean(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.peak_interval_mean.restype = ctypes.c_float
+    return c_lib.peak_interval_mean(ctypes.byref(motion(data)))
+
+def peak_interval_std(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.peak_interval_std.restype = ctypes.c_float
+    return c_lib.peak_interval_std(ctypes.byref(motion(data)))
+
+def cadence(data, fs=cfg.SAMPLE_FREQUENCY):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.cadence.restype = ctypes.c_float
+    return c_lib.cadence(ctypes.byref(motion(data)), (ctypes.c_float)(fs))
+
+def moments(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the Moments structure of a block.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    n = len(data)
+    x = (ctypes.c_float * n)(*data)
+    m = Moments()
+    c_lib.moments(ctypes.byref(m), ctypes.byref(x), n)
+    return m
+
+def moments_merge(m, other):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Merges the Moments structure other into m.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.moments_merge(ctypes.byref(m), ctypes.byref(other))
+
+def rms(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.rms.restype = ctypes.c_float
+    return c_lib.rms(ctypes.byref(moments(data)))
+
+def crest_factor(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.crest_factor.restype = ctypes.c_float
+    return c_lib.crest_factor(ctypes.byref(moments(data)))
+
+def skewness(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.skewness.restype = ctypes.c_float
+    return c_lib.skewness(ctypes.byref(moments(data)))
+
+def kurtosis(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.kurtosis.restype = ctypes.c_float
+    return c_lib.kurtosis(ctypes.byref(moments(data)))
+
+def multichannel(data):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    The data is an array with a row per sample and a column per channel, which
+    is the array of structures layout. Returns the Multichannel structure.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    n, n_channels = np.shape(data)
+    x = (ctypes.c_float * (n * n_channels))(*np.ravel(data))
+    r = Multichannel()
+    c_lib.multichannel_aos(ctypes.byref(r), ctypes.byref(x), n_channels, n)
+    return r
+
+def channel_correlation(r, a, b):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.channel_correlation.restype = ctypes.c_float
+    return c_lib.channel_correlation(ctypes.byref(r), a, b)
+
+def channel_covariance(r, a, b):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.channel_covariance.restype = ctypes.c_float
+    return c_lib.channel_covariance(ctypes.byref(r), a, b)
+
+def percentile(data, p):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns percentile p of a block, with the sliding percentile of a window
+    of the size of the block.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    n = len(data)
+    x = (ctypes.c_float * n)()
+    heap = (ctypes.c_uint16 * n)()
+    index = (ctypes.c_uint16 * n)()
+    s = SlidingPercentile()
+    c_lib.sliding_percentile_init(ctypes.byref(s), x, heap, index, n,
+        (ctypes.c_float)(p))
+
+    for val in data:
+        c_lib.sliding_percentile_update(ctypes.byref(s), (ctypes.c_float)(val))
+
+    c_lib.sliding_percentile.restype = ctypes.c_float
+    return c_lib.sliding_percentile(ctypes.byref(s))
+
+def median(data):
+    """
+    Returns the median of a block, see percentile()
+    """
+    return percentile(data, 50.0)
+
+def percentile_25(data):
+    """
+    Returns the first quartile of a block, see percentile()
+    """
+    return percentile(data, 25.0)
+
+def percentile_75(data):
+    """
+    Returns the third quartile of a block, see percentile()
+    """
+    return percentile(data, 75.0)
+
+def iqr(data):
+    """
+    Returns the interquartile range of a block, see percentile()
+    """
+    return percentile(data, 75.0) - percentile(data, 25.0)
+
+def hopping_windows(data, length=cfg.BLOCK_SIZE, hop=cfg.BLOCK_HOP):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the Aggregate structures of all windows of length samples that
+    start every hop samples. The length must be a multiple of the hop.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    assert length % hop == 0, 'The length must be a multiple of the hop'
+
+    blocks = (Aggregate * (length // hop))()
+    w = HoppingWindow()
+    c_lib.hopping_window_init(ctypes.byref(w), blocks, length, hop)
+
+    r = []
+    for val in data:
+        if c_lib.hopping_window_update(ctypes.byref(w), (ctypes.c_float)(val)):
+            r.append(Aggregate.from_buffer_copy(w.window))
+    return r
+
+def window_pyramid(data, length=cfg.BLOCK_SIZE, n_scales=cfg.BLOCK_SCALES):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns a list of the Aggregate structures of all scales for every block
+    of length samples, starting when the largest scale is complete. Scale k
+    has windows of length * 2**k samples.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    history = (Aggregate * (1 << (n_scales - 1)))()
+    p = WindowPyramid()
+    c_lib.window_pyramid_init(ctypes.byref(p), history, length, n_scales)
+
+    r = []
+    for val in data:
+        if c_lib.window_pyramid_update(ctypes.byref(p), (ctypes.c_float)(val)):
+            if p.scales[n_scales - 1].n == (length << (n_scales - 1)):
+                r.append([Aggregate.from_buffer_copy(p.scales[k])
+                    for k in range(n_scales)])
+    return r
+
+def aggregate_merge(a, other):
+    """
+    Python wrapper for the feature calculation functions that are also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Merges the Aggregate structure other into a.
+    """
+    check_features_dll()
+    c_lib = ctypes.CDLL(FEATURES_DLL)
+
+    c_lib.aggregate_merge(ctypes.byref(a), ctypes.byref(other))
+
 def raw(data, n=None):
     """
     Returns the first raw sample in the array
@@ -113,3 +655,418 @@ def raw(data, n=None):
     return the same raw input data.
     """
     return data[0] if (len(data) > 0) else None
+
+
+class TestSpectralFeatures(unittest.TestCase):
+    """
+    Compares the spectral functions with numpy. Run with:
+
+        python feature_functions.py
+    """
+
+    def setUp(self):
+        self.rng = np.random.default_rng(0)
+
+    def test_rfft(self):
+        for n in [4, 8, 32, FFT_N_MAX]:
+            x = self.rng.standard_normal(n)
+            X = np.fft.rfft(x)
+            r = np.array(rfft(x))
+            np.testing.assert_allclose(r[0], X[0].real, atol=1e-4)
+            np.testing.assert_allclose(r[1], X[n//2].real, atol=1e-4)
+            np.testing.assert_allclose(r[2::2], X[1:n//2].real, atol=1e-4)
+            np.testing.assert_allclose(r[3::2], X[1:n//2].imag, atol=1e-4)
+
+    def test_rfft_q15(self):
+        n = 128
+        x = np.round(8000 * self.rng.standard_normal(n)).clip(-32768, 32767)
+        X = np.fft.rfft(x) / n
+        r = np.array(rfft_q15(x))
+        atol = 0.01 * np.abs(X).max()
+        np.testing.assert_allclose(r[2::2], X[1:n//2].real, atol=atol)
+        np.testing.assert_allclose(r[3::2], X[1:n//2].imag, atol=atol)
+
+    def test_spectral_features(self):
+        # 1.5 Hz sine with 100 samples at 50 Hz, zero-padded to 128
+        fs = 50.0
+        t = np.arange(100) / fs
+        x = 10.0 + np.sin(2 * np.pi * 1.5 * t)
+
+        power, m = power_spectrum(x)
+        self.assertEqual(m, 128)
+        self.assertEqual(len(power), 65)
+        self.assertAlmostEqual(power[0], 0.0, places=2)
+
+        f = dominant_frequency(x, fs)
+        self.assertLessEqual(abs(f - 1.5), fs / m)
+
+        inside = band_energy(x, 1.0, 2.0, fs)
+        outside = band_energy(x, 2.5, 4.0, fs)
+        self.assertGreater(inside, 10 * outside)
+        self.assertAlmostEqual(band_energy(x, 0.0, fs, fs), sum(power),
+            delta=1e-3 * sum(power))
+
+        self.assertLess(spectral_centroid(x, fs),
+            spectral_centroid(x + np.sin(2 * np.pi * 20.0 * t), fs))
+
+    def test_too_many_samples(self):
+        # The C code has no room for more than FFT_N_MAX samples
+        power, m = power_spectrum(self.rng.standard_normal(FFT_N_MAX))
+        self.assertEqual(m, FFT_N_MAX)
+        with self.assertRaises(AssertionError):
+            power_spectrum(self.rng.standard_normal(FFT_N_MAX + 1))
+        with self.assertRaises(AssertionError):
+            dominant_frequency(self.rng.standard_normal(400))
+
+    def test_goertzel(self):
+        n = 100
+        fs = 50.0
+        x = self.rng.standard_normal(n)
+        X = np.fft.fft(x)
+        for k in [1, 3, 10]:
+            self.assertAlmostEqual(goertzel(x, k * fs / n, fs), abs(X[k])**2,
+                delta=1e-3 * abs(X[k])**2)
+
+
+class TestMotionFeatures(unittest.TestCase):
+    """
+    Tests the repetitive motion features. Run with:
+
+        python feature_functions.py
+    """
+
+    def test_sine(self):
+        # 110 compressions per minute at 66.7 Hz with some noise
+        fs = 66.7
+        f = 110.0 / 60.0
+        t = np.arange(400) / fs
+        rng = np.random.default_rng(0)
+        x = 500.0 + 100.0 * np.sin(2 * np.pi * f * t) + \
+            5.0 * rng.standard_normal(len(t))
+
+        m = motion(x)
+        expected = len(t) * f / fs
+
+        self.assertLessEqual(abs(m.peaks - expected), 1)
+        self.assertAlmostEqual(zero_crossing_rate(x), 2 * f / fs, delta=0.01)
+        self.assertAlmostEqual(cadence(x, fs), 110.0, delta=5.0)
+        self.assertLess(peak_interval_std(x), 2.0)
+
+    def test_streaming(self):
+        # Window statistics are cleared, running statistics are kept
+        x = np.tile([0.0, 1.0, 2.0, 1.0, 0.0, -1.0, -2.0, -1.0], 20)
+        m = motion_init(0.05, 0.5)
+        for val in x:
+            motion_update(m, val)
+        peaks = m.peaks
+
+        motion_reset(m)
+        self.assertEqual(m.peaks, 0)
+        self.assertEqual(m.n, 0)
+
+        for val in x:
+            motion_update(m, val)
+        self.assertAlmostEqual(m.peaks, peaks, delta=1)
+        self.assertAlmostEqual(m.interval_mean, 8.0, places=3)
+
+    def test_captured_cpr(self):
+        from glob import glob
+        from custom_bunch import CustomBunch
+
+        filenames = glob(join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv'))
+        if len(filenames) == 0:
+            raise unittest.SkipTest('No captured CPR data')
+
+        bunch = CustomBunch.load_csv(filenames[0])
+        x = bunch.data[:, bunch.attributes.index('ToF')]
+
+        # The distance sensor shows a compression about every 35 samples
+        self.assertAlmostEqual(cadence(x, 68.9), 118.0, delta=15.0)
+
+
+class TestMultichannelFeatures(unittest.TestCase):
+    """
+    Compares the multi-channel features with numpy. Run with:
+
+        python feature_functions.py
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        from glob import glob
+        from custom_bunch import CustomBunch
+
+        filenames = glob(join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv'))
+        if len(filenames) == 0:
+            raise unittest.SkipTest('No captured CPR data')
+
+        # FP1..FP8 and ToF
+        bunch = CustomBunch.load_csv(filenames[0])
+        cls.data = np.array(bunch.data[0:cfg.BLOCK_SIZE, 0:MC_N_CHANNELS_MAX],
+                            dtype=np.float32)
+
+    def test_aos(self):
+        x = self.data.astype(np.float64)
+        r = multichannel(self.data)
+        n_channels = x.shape[1]
+
+        np.testing.assert_allclose(r.mean[0:n_channels], x.mean(axis=0),
+            rtol=1e-5)
+        np.testing.assert_allclose(r.variance[0:n_channels], x.var(axis=0),
+            rtol=1e-3, atol=1e-3)
+
+        cov = np.cov(x, rowvar=False, bias=True)
+        corr = np.corrcoef(x, rowvar=False)
+        for a in range(n_channels):
+            for b in range(n_channels):
+                self.assertAlmostEqual(channel_covariance(r, a, b), cov[a, b],
+                    delta=1e-3 * np.sqrt(cov[a, a] * cov[b, b]) + 1e-3)
+                if cov[a, a] > 0 and cov[b, b] > 0:
+                    self.assertAlmostEqual(channel_correlation(r, a, b),
+                        corr[a, b], delta=1e-3)
+
+        self.assertAlmostEqual(r.magnitude,
+            np.mean(np.sqrt(np.sum(x**2, axis=1))), delta=1e-3 * r.magnitude)
+        self.assertAlmostEqual(r.sma, np.mean(np.sum(np.abs(x), axis=1)),
+            delta=1e-3 * r.sma)
+
+    def test_soa(self):
+        check_features_dll()
+        c_lib = ctypes.CDLL(FEATURES_DLL)
+
+        n, n_channels = self.data.shape
+        channels = [(ctypes.c_float * n)(*self.data[:, c])
+                    for c in range(n_channels)]
+        pointers = (ctypes.POINTER(ctypes.c_float) * n_channels)(
+            *[ctypes.cast(c, ctypes.POINTER(ctypes.c_float)) for c in channels])
+        r = Multichannel()
+        c_lib.multichannel_soa(ctypes.byref(r), pointers, n_channels, n)
+
+        # Both layouts perform identical arithmetic
+        aos = multichannel(self.data)
+        self.assertEqual(list(r.mean), list(aos.mean))
+        self.assertEqual(list(r.covariance), list(aos.covariance))
+        self.assertEqual(r.sma, aos.sma)
+
+
+class TestMoments(unittest.TestCase):
+    """
+    Compares the moment features with numpy and scipy. Run with:
+
+        python feature_functions.py
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        # Skewed data with a large offset, like a distance sensor
+        rng = np.random.default_rng(0)
+        cls.data = (500.0 + rng.gamma(2.0, 10.0, 200)).astype(np.float32)
+
+    def test_moments(self):
+        from scipy import stats
+
+        x = self.data.astype(np.float64)
+        self.assertAlmostEqual(rms(self.data), np.sqrt(np.mean(x**2)),
+            delta=1e-5 * np.sqrt(np.mean(x**2)))
+        self.assertAlmostEqual(crest_factor(self.data),
+            np.max(np.abs(x)) / np.sqrt(np.mean(x**2)), delta=1e-5)
+        self.assertAlmostEqual(skewness(self.data), stats.skew(x),
+            delta=1e-3)
+        self.assertAlmostEqual(kurtosis(self.data), stats.kurtosis(x),
+            delta=1e-2)
+
+    def test_sine(self):
+        x = np.sin(2 * np.pi * np.arange(1000) / 40.0)
+        self.assertAlmostEqual(crest_factor(x), np.sqrt(2.0), delta=1e-3)
+        self.assertAlmostEqual(skewness(x), 0.0, delta=1e-3)
+        self.assertAlmostEqual(kurtosis(x), -1.5, delta=1e-3)
+
+    def test_merge(self):
+        # Merging the moments of sub-blocks equals the moments of the block
+        whole = moments(self.data)
+        merged = moments(self.data[0:0])
+        for i in range(0, len(self.data), 25):
+            moments_merge(merged, moments(self.data[i:i+25]))
+
+        self.assertEqual(merged.n, whole.n)
+        self.assertEqual(merged.peak, whole.peak)
+        self.assertAlmostEqual(merged.mean, whole.mean, delta=1e-3)
+        for a, b in [(merged.m2, whole.m2), (merged.m3, whole.m3),
+            (merged.m4, whole.m4)]:
+            self.assertAlmostEqual(a, b, delta=1e-3 * abs(b))
+
+    def test_constant(self):
+        x = np.full(10, 3.0)
+        self.assertEqual(skewness(x), 0.0)
+        self.assertEqual(kurtosis(x), 0.0)
+        self.assertAlmostEqual(crest_factor(x), 1.0, places=6)
+
+
+class TestOrderStatistics(unittest.TestCase):
+    """
+    Compares the sliding percentiles with numpy. Run with:
+
+        python feature_functions.py
+    """
+
+    def test_percentile(self):
+        rng = np.random.default_rng(0)
+        for n in [1, 2, 7, 100]:
+            x = rng.standard_normal(n).astype(np.float32)
+            for p in [0.0, 10.0, 25.0, 50.0, 75.0, 100.0]:
+                self.assertAlmostEqual(percentile(x, p), np.percentile(x, p),
+                    delta=1e-5)
+
+    def test_ties(self):
+        x = np.array([3.0, 1.0, 3.0, 3.0, 1.0, 2.0, 3.0, 1.0])
+        self.assertEqual(median(x), np.median(x))
+        self.assertEqual(iqr(x), np.percentile(x, 75) - np.percentile(x, 25))
+
+    def test_sliding(self):
+        check_features_dll()
+        c_lib = ctypes.CDLL(FEATURES_DLL)
+        c_lib.sliding_percentile.restype = ctypes.c_float
+
+        # Every window of a stream with spikes, including the zeros that the
+        # window starts with
+        n = 25
+        rng = np.random.default_rng(1)
+        x = rng.integers(0, 50, 500).astype(np.float32)
+        x[::37] = 1000.0
+        padded = np.concatenate([np.zeros(n - 1, dtype=np.float32), x])
+
+        for p in [25.0, 50.0, 90.0]:
+            buffers = [(ctypes.c_float * n)(), (ctypes.c_uint16 * n)(),
+                (ctypes.c_uint16 * n)()]
+            s = SlidingPercentile()
+            c_lib.sliding_percentile_init(ctypes.byref(s), *buffers, n,
+                (ctypes.c_float)(p))
+
+            for i, val in enumerate(x):
+                c_lib.sliding_percentile_update(ctypes.byref(s),
+                    (ctypes.c_float)(val))
+                self.assertAlmostEqual(c_lib.sliding_percentile(
+                    ctypes.byref(s)), np.percentile(padded[i:i+n], p),
+                    delta=1e-3)
+
+    def test_captured_tof(self):
+        from glob import glob
+        from custom_bunch import CustomBunch
+
+        filenames = glob(join(cfg.CAPTURED_DIR_PATH, '14524-testCPR.csv'))
+        if len(filenames) == 0:
+            raise unittest.SkipTest('No captured CPR data')
+
+        bunch = CustomBunch.load_csv(filenames[0])
+        x = bunch.data[0:cfg.BLOCK_SIZE, bunch.attributes.index('ToF')]
+
+        self.assertAlmostEqual(median(x), np.median(x), delta=1e-3)
+        self.assertAlmostEqual(iqr(x), np.percentile(x, 75) -
+            np.percentile(x, 25), delta=1e-3)
+
+
+class TestHoppingWindow(unittest.TestCase):
+    """
+    Compares the aggregates of overlapping windows with numpy. Run with:
+
+        python feature_functions.py
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        # A movement with a large offset, like a distance sensor
+        rng = np.random.default_rng(0)
+        t = np.arange(1000)
+        cls.data = (800.0 + 40.0 * np.sin(2 * np.pi * t / 70.0) +
+            5.0 * rng.standard_normal(len(t))).astype(np.float32)
+
+    def test_windows(self):
+        length = 100
+        for hop in [100, 50, 25, 10, 1]:
+            windows = hopping_windows(self.data, length, hop)
+            starts = range(0, len(self.data) - length + 1, hop)
+            self.assertEqual(len(windows), len(starts))
+
+            for a, i in zip(windows, starts):
+                x = self.data[i:i+length].astype(np.float64)
+                self.assertEqual(a.n, length)
+                self.assertEqual(a.min, np.min(x))
+                self.assertEqual(a.max, np.max(x))
+                self.assertAlmostEqual(a.sum / a.n, np.mean(x), delta=1e-3)
+                self.assertAlmostEqual(a.m2 / a.n, np.var(x),
+                    delta=1e-3 * np.var(x))
+                self.assertAlmostEqual(a.energy, np.sum(x**2),
+                    delta=1e-5 * np.sum(x**2))
+
+    def test_features(self):
+        # The getters return the same features as features.c
+        check_features_dll()
+        c_lib = ctypes.CDLL(FEATURES_DLL)
+
+        a = hopping_windows(self.data[0:100], 100, 20)[0]
+        x = self.data[0:100]
+        for f in [min, max, mean, variance, energy, peak_to_peak]:
+            getter = getattr(c_lib, 'aggregate_' + f.__name__)
+            getter.restype = ctypes.c_float
+            self.assertAlmostEqual(getter(ctypes.byref(a)), f(x),
+                delta=1e-4 * abs(f(x)))
+
+    def test_merge(self):
+        # Merging windows of different length equals the longer window
+        whole = hopping_windows(self.data[0:300], 300, 300)[0]
+        merged = hopping_windows(self.data[0:100], 100, 100)[0]
+        aggregate_merge(merged, hopping_windows(self.data[100:300], 200, 50)[0])
+
+        self.assertEqual(merged.n, whole.n)
+        self.assertEqual(merged.min, whole.min)
+        self.assertEqual(merged.max, whole.max)
+        for a, b in [(merged.sum, whole.sum), (merged.m2, whole.m2),
+            (merged.energy, whole.energy)]:
+            self.assertAlmostEqual(a, b, delta=1e-4 * abs(b))
+
+
+class TestWindowPyramid(unittest.TestCase):
+    """
+    Compares the windows of several scales with numpy. Run with:
+
+        python feature_functions.py
+    """
+
+    def test_scales(self):
+        rng = np.random.default_rng(0)
+        x = (800.0 + 40.0 * np.sin(2 * np.pi * np.arange(1000) / 70.0) +
+            5.0 * rng.standard_normal(1000)).astype(np.float32)
+
+        length = 25
+        for n_scales in [1, 2, 4]:
+            rows = window_pyramid(x, length, n_scales)
+            n_max = length << (n_scales - 1)
+            ends = range(n_max, len(x) + 1, length)
+            self.assertEqual(len(rows), len(ends))
+
+            for row, end in zip(rows, ends):
+                for k, a in enumerate(row):
+                    w = x[end - (length << k):end].astype(np.float64)
+                    self.assertEqual(a.n, len(w))
+                    self.assertEqual(a.min, np.min(w))
+                    self.assertEqual(a.max, np.max(w))
+                    self.assertAlmostEqual(a.sum / a.n, np.mean(w), delta=1e-3)
+                    self.assertAlmostEqual(a.m2 / a.n, np.var(w),
+                        delta=1e-3 * np.var(w))
+                    self.assertAlmostEqual(a.energy, np.sum(w**2),
+                        delta=1e-5 * np.sum(w**2))
+
+    def test_largest_scale(self):
+        # The largest scale equals a hopping window with the same hop
+        x = np.random.default_rng(1).standard_normal(800).astype(np.float32)
+        rows = window_pyramid(x, 25, 4)
+        windows = hopping_windows(x, 200, 25)
+        self.assertEqual(len(rows), len(windows))
+        for row, a in zip(rows, windows):
+            self.assertEqual(row[3].n, a.n)
+            self.assertAlmostEqual(row[3].sum, a.sum, delta=1e-4)
+            self.assertAlmostEqual(row[3].m2, a.m2, delta=1e-4 * a.m2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -21,8 +21,22 @@ from os import makedirs
 from distutils.ccompiler import new_compiler
 from shutil import copyfile, rmtree
 
-# TODO The list of feature functions that are implemented in features.c.
-FUNCTIONS_IN_C_FILE = ['min','max','mean','variance','energy','peak_to_peak']
+# TODO The list of feature functions that are implemented in features.c,
+#      fft.c, order_statistics.c and window_aggregates.c.
+FUNCTIONS_IN_C_FILE = ['min','max','mean','variance','energy','peak_to_peak',
+    'band_energy','dominant_frequency','spectral_centroid',
+    'rfft','rfft_q15','power_spectrum','goertzel_coefficient','goertzel',
+    'motion_init','motion_reset','motion_update','zero_crossing_rate',
+    'peak_count','peak_interval_mean','peak_interval_std','cadence',
+    'moments_reset','moments_update','moments_merge','moments','rms',
+    'crest_factor','skewness','kurtosis',
+    'multichannel_soa','multichannel_aos','channel_covariance',
+    'channel_correlation','sliding_percentile_init',
+    'sliding_percentile_update','sliding_percentile','aggregate_reset',
+    'aggregate_merge','aggregate_mean','aggregate_variance','aggregate_min',
+    'aggregate_max','aggregate_energy','aggregate_peak_to_peak',
+    'hopping_window_init','hopping_window_update','hopping_window',
+    'window_pyramid_init','window_pyramid_update','window_pyramid']
 
 # Set to False if you would like to examine the temporary files that are
 # created.
@@ -38,6 +52,15 @@ int main(void)
 }
 '''
 
+def library_filename():
+    """
+    Returns the path of the dll, which has a platform dependent name, for
+    example features.dll on Windows and libfeatures.so on Linux.
+    """
+    return new_compiler().library_filename(
+        'features', lib_type='shared',
+        output_dir=cfg.PREPROCESSING_FEATURES_DIR_PATH)
+
 def main():
 
     PROJECT_DIR = join(cfg.PREPROCESSING_FEATURES_DIR_PATH, 'c2dll_project')
@@ -58,13 +81,23 @@ def main():
         join(PROJECT_DIR,'features.h'))
     copyfile(join(FEATURES_SOURCE_DIR_PATH,'features.c'),
         join(PROJECT_DIR,'features.c'))
+    copyfile(join(FEATURES_SOURCE_DIR_PATH,'fft.h'), 
+        join(PROJECT_DIR,'fft.h'))
+    copyfile(join(FEATURES_SOURCE_DIR_PATH,'fft.c'),
+        join(PROJECT_DIR,'fft.c'))
+    copyfile(join(FEATURES_SOURCE_DIR_PATH,'order_statistics.h'), 
+        join(PROJECT_DIR,'order_statistics.h'))
+    copyfile(join(FEATURES_SOURCE_DIR_PATH,'order_statistics.c'),
+        join(PROJECT_DIR,'order_statistics.c'))
+    copyfile(join(FEATURES_SOURCE_DIR_PATH,'window_aggregates.h'), 
+        join(PROJECT_DIR,'window_aggregates.h'))
+    copyfile(join(FEATURES_SOURCE_DIR_PATH,'window_aggregates.c'),
+        join(PROJECT_DIR,'window_aggregates.c'))
 
     # Compile and link the project
     cc = new_compiler(force=1)
 
-    output_libname = cc.library_filename(
-        'features', lib_type='shared', 
-        output_dir=cfg.PREPROCESSING_FEATURES_DIR_PATH)
+    output_libname = library_filename()
 
     if platform.startswith('win'):
         libraries = None
@@ -75,7 +108,9 @@ def main():
         cc_args = ["-std=c99"]
 
     objects = cc.compile(
-        sources=[join(PROJECT_DIR,'main.c'),join(PROJECT_DIR,'features.c')],
+        sources=[join(PROJECT_DIR,'main.c'),join(PROJECT_DIR,'features.c'),
+            join(PROJECT_DIR,'fft.c'),join(PROJECT_DIR,'order_statistics.c'),
+            join(PROJECT_DIR,'window_aggregates.c')],
         extra_preargs=cc_args,
         output_dir=join(PROJECT_DIR,'build'))
 
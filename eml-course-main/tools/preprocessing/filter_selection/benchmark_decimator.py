@@ -0,0 +1,230 @@
+"""
+benchmark_decimator.py
+
+Compares the latency of decimating with fir(), which filters every input
+sample and discards the outputs that are not kept, and with the polyphase
+decimators fir_decimate() and fir_decimate_q15(), which only compute the
+outputs that are kept.
+
+The input is a synthetic accelerometer channel sampled at SAMPLE_FREQUENCY.
+For every decimation factor a low pass filter is designed with a cutoff
+frequency below half the output sample frequency. The C code is compiled for
+the host, so use the latency to compare the implementations relative to each
+other. The number of multiplications per input sample is what counts on the
+microcontroller.
+
+Authors:    Jeroen Veen
+            Hugo Arends
+Date:       October 2026
+
+Copyright:  2026 HAN University of Applied Sciences. All Rights Reserved.
+"""
+import sys
+from os.path import join, dirname, realpath
+sys.path.append(join(dirname(realpath(__file__)), '..', '..'))
+
+import config as cfg
+import c2exe
+import filter_functions as ff
+import numpy as np
+from os.path import join
+from scipy import signal
+
+# TODO Set the sample frequency of the sensor in Hz, the decimation factors
+#      and the number of coefficients of the FIR filters
+SAMPLE_FREQUENCY = 833
+FACTORS = [2, 4, 8]
+N_COEFS = 32
+
+# Number of input samples
+N_SAMPLES = 4096
+
+# Minimum duration of a latency measurement in seconds
+MIN_DURATION = 0.2
+
+MAIN_FILE_STR = \
+'''
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "filters.h"
+
+#define N_SAMPLES ({n_samples})
+#define N_COEFS ({n_coefs})
+#define N_FACTORS ({n_factors})
+
+static const float data[N_SAMPLES] =
+{{
+{data}
+}};
+
+static const uint32_t factors[N_FACTORS] = {{{factors}}};
+
+static const float coefs[N_FACTORS][N_COEFS] =
+{{
+{coefs}
+}};
+
+static const int16_t data_q15[N_SAMPLES] =
+{{
+{data_q15}
+}};
+
+static const int16_t coefs_q15[N_FACTORS][N_COEFS] =
+{{
+{coefs_q15}
+}};
+
+static float x[N_COEFS];
+static float state[N_COEFS];
+static int32_t state_q15[N_COEFS];
+
+static volatile float sink;
+
+// Returns the number of outputs
+static uint32_t decimate_fir(const uint32_t f)
+{{
+    uint32_t n = 0;
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        const float y = fir(data[i], coefs[f], x, N_COEFS);
+
+        if((i % factors[f]) == 0)
+        {{
+            sink += y;
+            ++n;
+        }}
+    }}
+
+    return n;
+}}
+
+static uint32_t decimate_polyphase(const uint32_t f)
+{{
+    fir_decimator_t d;
+    uint32_t n = 0;
+    float y;
+
+    fir_decimator_init(&d, coefs[f], state, N_COEFS, factors[f]);
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        if(fir_decimate(&d, data[i], &y))
+        {{
+            sink += y;
+            ++n;
+        }}
+    }}
+
+    return n;
+}}
+
+static uint32_t decimate_polyphase_q15(const uint32_t f)
+{{
+    fir_decimator_q15_t d;
+    uint32_t n = 0;
+    int16_t y;
+
+    fir_decimator_q15_init(&d, coefs_q15[f], state_q15, N_COEFS, factors[f]);
+
+    for(uint32_t i=0; i<N_SAMPLES; ++i)
+    {{
+        if(fir_decimate_q15(&d, data_q15[i], &y))
+        {{
+            sink += y;
+            ++n;
+        }}
+    }}
+
+    return n;
+}}
+
+static void benchmark(const char *name, uint32_t (*decimate)(const uint32_t),
+    const uint32_t f)
+{{
+    // Repeat the data until the measurement takes long enough
+    uint32_t repeat = 1;
+    uint32_t n = 0;
+    double duration = 0.0;
+
+    while(duration < {min_duration})
+    {{
+        repeat *= 2;
+
+        clock_t start = clock();
+
+        for(uint32_t r=0; r<repeat; ++r)
+        {{
+            n = decimate(f);
+        }}
+
+        duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }}
+
+    printf("%s,%u,%u,%f\\n", name, (unsigned int)factors[f], (unsigned int)n,
+        1e9 * duration / ((double)repeat * N_SAMPLES));
+}}
+
+int main(void)
+{{
+    for(uint32_t f=0; f<N_FACTORS; ++f)
+    {{
+        benchmark("fir", decimate_fir, f);
+        benchmark("polyphase", decimate_polyphase, f);
+        benchmark("polyphase_q15", decimate_polyphase_q15, f);
+    }}
+
+    return 0;
+}}
+'''
+
+def main():
+
+    # A slow movement with noise, within [-1, 1) for the Q15 format
+    rng = np.random.default_rng(0)
+    t = np.arange(N_SAMPLES) / SAMPLE_FREQUENCY
+    data = (0.4 * np.sin(2 * np.pi * 2.0 * t) +
+        0.1 * rng.standard_normal(N_SAMPLES)).astype(np.float32)
+
+    # Cutoff frequency at 80% of the output Nyquist frequency
+    coefs = [signal.firwin(numtaps=N_COEFS,
+        cutoff=0.8 * SAMPLE_FREQUENCY / (2 * factor), fs=SAMPLE_FREQUENCY)
+        for factor in FACTORS]
+
+    sources = {
+        'main.c': MAIN_FILE_STR.format(
+            n_samples=N_SAMPLES,
+            n_coefs=N_COEFS,
+            n_factors=len(FACTORS),
+            data=',\n'.join(['    ' + repr(float(v)) + 'f' for v in data]),
+            factors=', '.join(str(f) for f in FACTORS),
+            coefs=',\n'.join(['    {' + ', '.join(
+                [repr(float(v)) + 'f' for v in c]) + '}' for c in coefs]),
+            data_q15=',\n'.join(['    ' + str(v) for v in ff.to_q15(data)]),
+            coefs_q15=',\n'.join(['    {' + ', '.join(
+                [str(v) for v in ff.to_q15(c)]) + '}' for c in coefs]),
+            min_duration=MIN_DURATION),
+    }
+
+    executable = c2exe.build('benchmark_decimator',
+        join(cfg.PREPROCESSING_FILTERS_DIR_PATH, 'benchmark_project'), sources,
+        lib_files=['filters.h', 'filters.c'])
+
+    output = c2exe.run(executable)
+
+    print()
+    print(f'Samples: {N_SAMPLES} at {SAMPLE_FREQUENCY} Hz, '
+          f'coefficients: {N_COEFS}\n')
+    print('{:<16}{:>8}{:>10}{:>12}{:>12}'.format('decimator', 'factor',
+        'outputs', 'MACs/input', 'ns/input'))
+    for line in output.splitlines():
+        name, factor, n, ns = line.split(',')
+        macs = N_COEFS if name == 'fir' else N_COEFS / int(factor)
+        print('{:<16}{:>8}{:>10}{:>12.1f}{:>12.2f}'.format(name, int(factor),
+            int(n), macs, float(ns)))
+
+
+if __name__ == "__main__":
+    main()
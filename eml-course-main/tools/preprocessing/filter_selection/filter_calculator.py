@@ -25,6 +25,8 @@ import filter_functions as ff
 # TODO Set filter functions here
 FILTER_FUNCTIONS = [ff.fir]
 #FILTER_FUNCTIONS = [ff.fir, ff.raw]
+#FILTER_FUNCTIONS = [ff.moving_average, ff.dc_blocker]
+#FILTER_FUNCTIONS = [ff.median_filter]
 
 # TODO Set filter specific arguments
 #      The number of arguments must be equal to the number of arguments in
@@ -34,12 +36,30 @@ ARGS = [
     [0.02017993, 0.06489484, 0.16638971, 0.24853553, 
      0.24853553, 0.16638971, 0.06489484, 0.02017993],
 ]
+#ARGS = [
+#    # Moving average of 32 samples
+#    [32],
+#    # DC blocker f_s=100Hz, f_cutoff=0.3Hz, alpha=1-2*pi*f_cutoff/f_s
+#    [0.98115],
+#]
+#ARGS = [
+#    # Median of 5 samples, removes spikes of up to 2 samples
+#    [5],
+#]
+
+# TODO Set the decimation factor, for example 8 to decimate data captured at
+#      833 Hz to 104 Hz. The FIR filters then run as the polyphase decimator
+#      fir_decimate() of the microcontroller, so their coefficients must be
+#      designed for the captured sample frequency, see fir_coefs_calculator.py.
+DECIMATION_FACTOR = 1
 
 # TODO Set input file path for calculation normalizations
 INPUT_DIR_PATH = cfg.CAPTURED_DIR_PATH
 
 
 assert len(FILTER_FUNCTIONS) == len(ARGS), 'Number of FILTER_FUNCTIONS and ARGS must be equal'
+assert DECIMATION_FACTOR == 1 or all(f == ff.fir for f in FILTER_FUNCTIONS), \
+    'Only FIR filters can be decimated'
 
 def main():
 
@@ -76,11 +96,16 @@ def main():
             # Loop all filter functions
             for f, arg in zip(FILTER_FUNCTIONS, ARGS): 
                 r = []
-                # Create a list of floats that can be passed by reference, so
-                # the intermediate values are properly stored.
-                filter_x = (ctypes.c_float * len(arg))(0) if len(arg) > 0 else []
-                for val in d:
-                    r.append(f(val, arg, filter_x))      
+                if DECIMATION_FACTOR > 1:
+                    # Only every DECIMATION_FACTOR-th output is computed
+                    r = ff.decimate(d, arg, DECIMATION_FACTOR)
+                else:
+                    # Create a list of floats that can be passed by reference,
+                    # so the intermediate values are properly stored. The
+                    # other filters store their state in an empty list.
+                    filter_x = (ctypes.c_float * len(arg))(0) if f == ff.fir else []
+                    for val in d:
+                        r.append(f(val, arg, filter_x))      
                 # Append the result to the data
                 data.append(r)
                 # Combine this attribute and function name to a new
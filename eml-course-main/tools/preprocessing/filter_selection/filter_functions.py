@@ -17,8 +17,129 @@ import config as cfg
 import ctypes
 from os.path import join, isfile
 import filter_functions_c2dll
+import unittest
 
-FILTERS_DLL = join(cfg.PREPROCESSING_FILTERS_DIR_PATH, 'filters.dll')
+FILTERS_DLL = filter_functions_c2dll.library_filename()
+
+class FirDecimator(ctypes.Structure):
+    """
+    Polyphase FIR decimator, see fir_decimator_t in filters.h
+    """
+    _fields_ = [('coefs', ctypes.POINTER(ctypes.c_float)),
+                ('state', ctypes.POINTER(ctypes.c_float)),
+                ('n', ctypes.c_uint32),
+                ('factor', ctypes.c_uint32),
+                ('n_state', ctypes.c_uint32),
+                ('phase', ctypes.c_uint32),
+                ('next', ctypes.c_uint32)]
+
+class FirDecimatorQ15(ctypes.Structure):
+    """
+    Polyphase FIR decimator in Q15 format, see fir_decimator_q15_t in
+    filters.h
+    """
+    _fields_ = [('coefs', ctypes.POINTER(ctypes.c_int16)),
+                ('state', ctypes.POINTER(ctypes.c_int32)),
+                ('n', ctypes.c_uint32),
+                ('factor', ctypes.c_uint32),
+                ('n_state', ctypes.c_uint32),
+                ('phase', ctypes.c_uint32),
+                ('next', ctypes.c_uint32)]
+
+class FirInterpolator(ctypes.Structure):
+    """
+    Polyphase FIR interpolator, see fir_interpolator_t in filters.h
+    """
+    _fields_ = [('coefs', ctypes.POINTER(ctypes.c_float)),
+                ('state', ctypes.POINTER(ctypes.c_float)),
+                ('n', ctypes.c_uint32),
+                ('factor', ctypes.c_uint32),
+                ('n_state', ctypes.c_uint32),
+                ('head', ctypes.c_uint32)]
+
+class FirInterpolatorQ15(ctypes.Structure):
+    """
+    Polyphase FIR interpolator in Q15 format, see fir_interpolator_q15_t in
+    filters.h
+    """
+    _fields_ = [('coefs', ctypes.POINTER(ctypes.c_int16)),
+                ('state', ctypes.POINTER(ctypes.c_int16)),
+                ('n', ctypes.c_uint32),
+                ('factor', ctypes.c_uint32),
+                ('n_state', ctypes.c_uint32),
+                ('head', ctypes.c_uint32)]
+
+class MovingAverage(ctypes.Structure):
+    """
+    Moving average filter, see moving_average_t in filters.h
+    """
+    _fields_ = [('x', ctypes.POINTER(ctypes.c_float)),
+                ('sum', ctypes.c_float),
+                ('partial', ctypes.c_float),
+                ('scale', ctypes.c_float),
+                ('n', ctypes.c_uint32),
+                ('head', ctypes.c_uint32)]
+
+class MovingAverageQ15(ctypes.Structure):
+    """
+    Moving average filter in Q15 format, see moving_average_q15_t in
+    filters.h
+    """
+    _fields_ = [('x', ctypes.POINTER(ctypes.c_int16)),
+                ('sum', ctypes.c_int32),
+                ('n', ctypes.c_uint32),
+                ('shift', ctypes.c_uint32),
+                ('head', ctypes.c_uint32)]
+
+class Cic(ctypes.Structure):
+    """
+    CIC decimator, see cic_t in filters.h
+    """
+    _fields_ = [('stages', ctypes.POINTER(MovingAverage)),
+                ('order', ctypes.c_uint32),
+                ('factor', ctypes.c_uint32),
+                ('phase', ctypes.c_uint32)]
+
+class CicQ15(ctypes.Structure):
+    """
+    CIC decimator in Q15 format, see cic_q15_t in filters.h
+    """
+    _fields_ = [('integrators', ctypes.POINTER(ctypes.c_uint32)),
+                ('combs', ctypes.POINTER(ctypes.c_uint32)),
+                ('order', ctypes.c_uint32),
+                ('factor', ctypes.c_uint32),
+                ('shift', ctypes.c_uint32),
+                ('phase', ctypes.c_uint32)]
+
+class DcBlocker(ctypes.Structure):
+    """
+    DC blocker, see dc_blocker_t in filters.h
+    """
+    _fields_ = [('alpha', ctypes.c_float),
+                ('x', ctypes.c_float),
+                ('y', ctypes.c_float)]
+
+class DcBlockerQ15(ctypes.Structure):
+    """
+    DC blocker in Q15 format, see dc_blocker_q15_t in filters.h
+    """
+    _fields_ = [('alpha', ctypes.c_int16),
+                ('x', ctypes.c_int16),
+                ('y', ctypes.c_int16),
+                ('fraction', ctypes.c_int32)]
+
+class SlidingPercentile(ctypes.Structure):
+    """
+    Percentile of a sliding window, see sliding_percentile_t in
+    order_statistics.h
+    """
+    _fields_ = [('x', ctypes.POINTER(ctypes.c_float)),
+                ('heap', ctypes.POINTER(ctypes.c_uint16)),
+                ('index', ctypes.POINTER(ctypes.c_uint16)),
+                ('n', ctypes.c_uint32),
+                ('k', ctypes.c_uint32),
+                ('fraction', ctypes.c_float),
+                ('head', ctypes.c_uint32)]
 
 def check_filters_dll():
     """
@@ -47,3 +168,461 @@ def raw(data, coefs, x):
     Mainly used for comparing the filtered data to the raw data.
     """
     return data
+
+def n_state(n, factor):
+    """
+    Returns the number of elements of the state of a polyphase decimator or
+    interpolator, see FIR_POLYPHASE_N_STATE in filters.h
+    """
+    return (n + factor - 1) // factor
+
+def to_q15(values):
+    """
+    Converts floats in the range [-1, 1) to Q15 format, with saturation
+    """
+    return [int(min(32767, max(-32768, round(v * 32768)))) for v in values]
+
+def decimate(data, coefs, factor):
+    """
+    Python wrapper for the polyphase FIR decimator that is also used on the
+    microcontroller. Refer to the C-source files for documentation.
+
+    Returns one output for every factor samples of data, starting with the
+    output of the first sample. The state starts at zero for every call, like
+    the filter of a channel after a reset of the microcontroller.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    c_lib.fir_decimate.restype = ctypes.c_bool
+    n = len(coefs)
+    c = (ctypes.c_float * n)(*coefs)
+    state = (ctypes.c_float * n_state(n, factor))()
+    d = FirDecimator()
+    c_lib.fir_decimator_init(ctypes.byref(d), c, state, n, factor)
+
+    y = ctypes.c_float()
+    r = []
+    for val in data:
+        if c_lib.fir_decimate(ctypes.byref(d), ctypes.c_float(val),
+            ctypes.byref(y)):
+            r.append(y.value)
+    return r
+
+def decimate_q15(data, coefs, factor):
+    """
+    Python wrapper for the polyphase FIR decimator in Q15 format that is also
+    used on the microcontroller, see decimate(). The data and coefficients
+    are integers in Q15 format, see to_q15().
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    c_lib.fir_decimate_q15.restype = ctypes.c_bool
+    n = len(coefs)
+    c = (ctypes.c_int16 * n)(*coefs)
+    state = (ctypes.c_int32 * n_state(n, factor))()
+    d = FirDecimatorQ15()
+    c_lib.fir_decimator_q15_init(ctypes.byref(d), c, state, n, factor)
+
+    y = ctypes.c_int16()
+    r = []
+    for val in data:
+        if c_lib.fir_decimate_q15(ctypes.byref(d), ctypes.c_int16(val),
+            ctypes.byref(y)):
+            r.append(y.value)
+    return r
+
+def interpolate(data, coefs, factor):
+    """
+    Python wrapper for the polyphase FIR interpolator that is also used on
+    the microcontroller. Refer to the C-source files for documentation.
+
+    Returns factor outputs for every sample of data. The coefficients must
+    have a gain of factor.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    n = len(coefs)
+    c = (ctypes.c_float * n)(*coefs)
+    state = (ctypes.c_float * n_state(n, factor))()
+    f = FirInterpolator()
+    c_lib.fir_interpolator_init(ctypes.byref(f), c, state, n, factor)
+
+    y = (ctypes.c_float * factor)()
+    r = []
+    for val in data:
+        c_lib.fir_interpolate(ctypes.byref(f), ctypes.c_float(val), y)
+        r += list(y)
+    return r
+
+def interpolate_q15(data, coefs, factor):
+    """
+    Python wrapper for the polyphase FIR interpolator in Q15 format that is
+    also used on the microcontroller, see interpolate(). The data and
+    coefficients are integers in Q15 format, see to_q15().
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    n = len(coefs)
+    c = (ctypes.c_int16 * n)(*coefs)
+    state = (ctypes.c_int16 * n_state(n, factor))()
+    f = FirInterpolatorQ15()
+    c_lib.fir_interpolator_q15_init(ctypes.byref(f), c, state, n, factor)
+
+    y = (ctypes.c_int16 * factor)()
+    r = []
+    for val in data:
+        c_lib.fir_interpolate_q15(ctypes.byref(f), ctypes.c_int16(val), y)
+        r += list(y)
+    return r
+
+def moving_average(data, arg, state):
+    """
+    Python wrapper for the moving average filter that is also used on the
+    microcontroller. Refer to the C-source files for documentation.
+
+    arg is [n]. The filter is stored in state, which must be an empty list
+    for the first sample of a channel.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    if len(state) == 0:
+        m = MovingAverage()
+        x = (ctypes.c_float * arg[0])()
+        c_lib.moving_average_init(ctypes.byref(m), x, arg[0])
+        state += [m, x]
+
+    c_lib.moving_average.restype = ctypes.c_float
+    return c_lib.moving_average(ctypes.byref(state[0]), ctypes.c_float(data))
+
+def moving_average_q15(data, arg, state):
+    """
+    Python wrapper for the moving average filter in Q15 format that is also
+    used on the microcontroller, see moving_average(). The data is an integer
+    in Q15 format and n must be a power of two.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    if len(state) == 0:
+        m = MovingAverageQ15()
+        x = (ctypes.c_int16 * arg[0])()
+        c_lib.moving_average_q15_init(ctypes.byref(m), x, arg[0])
+        state += [m, x]
+
+    c_lib.moving_average_q15.restype = ctypes.c_int16
+    return c_lib.moving_average_q15(ctypes.byref(state[0]),
+        ctypes.c_int16(data))
+
+def cic(data, order, factor):
+    """
+    Python wrapper for the CIC decimator that is also used on the
+    microcontroller. Refer to the C-source files for documentation.
+
+    Returns one output for every factor samples of data, starting with the
+    output of the first sample.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    c_lib.cic_decimate.restype = ctypes.c_bool
+    stages = (MovingAverage * order)()
+    x = (ctypes.c_float * (order * factor))()
+    c = Cic()
+    c_lib.cic_init(ctypes.byref(c), stages, x, order, factor)
+
+    y = ctypes.c_float()
+    r = []
+    for val in data:
+        if c_lib.cic_decimate(ctypes.byref(c), ctypes.c_float(val),
+            ctypes.byref(y)):
+            r.append(y.value)
+    return r
+
+def cic_q15(data, order, factor):
+    """
+    Python wrapper for the CIC decimator in Q15 format that is also used on
+    the microcontroller, see cic(). The data are integers in Q15 format and
+    factor must be a power of two.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    c_lib.cic_decimate_q15.restype = ctypes.c_bool
+    integrators = (ctypes.c_uint32 * order)()
+    combs = (ctypes.c_uint32 * order)()
+    c = CicQ15()
+    c_lib.cic_q15_init(ctypes.byref(c), integrators, combs, order, factor)
+
+    y = ctypes.c_int16()
+    r = []
+    for val in data:
+        if c_lib.cic_decimate_q15(ctypes.byref(c), ctypes.c_int16(val),
+            ctypes.byref(y)):
+            r.append(y.value)
+    return r
+
+def dc_blocker(data, arg, state):
+    """
+    Python wrapper for the DC blocker that is also used on the
+    microcontroller. Refer to the C-source files for documentation.
+
+    arg is [alpha]. The filter is stored in state, which must be an empty list
+    for the first sample of a channel.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    if len(state) == 0:
+        b = DcBlocker()
+        c_lib.dc_blocker_init(ctypes.byref(b), ctypes.c_float(arg[0]))
+        state.append(b)
+
+    c_lib.dc_blocker.restype = ctypes.c_float
+    return c_lib.dc_blocker(ctypes.byref(state[0]), ctypes.c_float(data))
+
+def dc_blocker_q15(data, arg, state):
+    """
+    Python wrapper for the DC blocker in Q15 format that is also used on the
+    microcontroller, see dc_blocker(). The data and alpha are integers in Q15
+    format.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    if len(state) == 0:
+        b = DcBlockerQ15()
+        c_lib.dc_blocker_q15_init(ctypes.byref(b), ctypes.c_int16(arg[0]))
+        state.append(b)
+
+    c_lib.dc_blocker_q15.restype = ctypes.c_int16
+    return c_lib.dc_blocker_q15(ctypes.byref(state[0]), ctypes.c_int16(data))
+
+def median_filter(data, arg, state):
+    """
+    Python wrapper for the median filter that is also used on the
+    microcontroller. Refer to the C-source files for documentation.
+
+    arg is [n]. The filter is stored in state, which must be an empty list
+    for the first sample of a channel.
+    """
+    check_filters_dll()
+    c_lib = ctypes.CDLL(FILTERS_DLL)
+
+    if len(state) == 0:
+        s = SlidingPercentile()
+        buffers = [(ctypes.c_float * arg[0])(), (ctypes.c_uint16 * arg[0])(),
+            (ctypes.c_uint16 * arg[0])()]
+        c_lib.median_filter_init(ctypes.byref(s), *buffers, arg[0])
+        state += [s] + buffers
+
+    c_lib.median_filter.restype = ctypes.c_float
+    return c_lib.median_filter(ctypes.byref(state[0]), ctypes.c_float(data))
+
+
+class TestPolyphase(unittest.TestCase):
+    """
+    Tests the polyphase decimator and interpolator against fir(). Run with:
+
+        python filter_functions.py
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        import numpy as np
+        from scipy import signal
+
+        # An accelerometer channel sampled at 833 Hz, decimated to 104 Hz
+        rng = np.random.default_rng(0)
+        t = np.arange(400) / 833.0
+        cls.data = (0.4 * np.sin(2 * np.pi * 3.0 * t) +
+            0.1 * rng.standard_normal(len(t))).astype(np.float32)
+        cls.coefs = signal.firwin(numtaps=31, cutoff=40, fs=833).astype(
+            np.float32)
+
+    def fir_all(self, data, coefs):
+        x = (ctypes.c_float * len(coefs))(0)
+        return [fir(val, coefs, x) for val in data]
+
+    @staticmethod
+    def fir_q15(data, coefs):
+        # Integer reference with the rounding and saturation of filters.c
+        x = [0] * len(coefs)
+        r = []
+        for val in data:
+            x = [val] + x[:-1]
+            acc = sum(c * v for c, v in zip(coefs, x))
+            r.append(min(32767, max(-32768, (acc + (1 << 14)) >> 15)))
+        return r
+
+    def test_decimate(self):
+        # Identical to every factor-th output of fir()
+        y = self.fir_all(self.data, self.coefs)
+        for factor in [1, 2, 3, 8]:
+            self.assertEqual(decimate(self.data, self.coefs, factor),
+                y[::factor])
+
+    def test_interpolate(self):
+        import numpy as np
+
+        # Identical to fir() of the data with zeros inserted
+        for factor in [1, 2, 4]:
+            coefs = list(self.coefs * factor)
+            stuffed = np.zeros(len(self.data) * factor, dtype=np.float32)
+            stuffed[::factor] = self.data
+            np.testing.assert_allclose(
+                interpolate(self.data, coefs, factor),
+                self.fir_all(stuffed, coefs), rtol=1e-5, atol=1e-6)
+
+    def test_decimate_q15(self):
+        import numpy as np
+
+        data = to_q15(self.data)
+        coefs = to_q15(self.coefs)
+        y = self.fir_q15(data, coefs)
+        for factor in [1, 4, 8]:
+            r = decimate_q15(data, coefs, factor)
+            self.assertEqual(r, y[::factor])
+
+            # Within a few LSB of the float decimator
+            f = np.array(decimate(self.data, self.coefs, factor)) * 32768
+            self.assertLess(np.max(np.abs(np.array(r) - f)), 4.0)
+
+    def test_interpolate_q15(self):
+        data = to_q15(self.data)
+        for factor in [2, 4]:
+            coefs = to_q15(self.coefs * factor)
+            stuffed = [0] * (len(data) * factor)
+            stuffed[::factor] = data
+            self.assertEqual(interpolate_q15(data, coefs, factor),
+                self.fir_q15(stuffed, coefs))
+
+    def test_saturation(self):
+        # A full scale step with a gain above one saturates
+        coefs = to_q15([0.9, 0.9])
+        self.assertEqual(decimate_q15([32767] * 4, coefs, 2)[-1], 32767)
+        self.assertEqual(decimate_q15([-32768] * 4, coefs, 2)[-1], -32768)
+
+
+class TestConstantCost(unittest.TestCase):
+    """
+    Tests the moving average, CIC decimator, DC blocker and median filter
+    against their definitions. Run with:
+
+        python filter_functions.py
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        import numpy as np
+
+        # Gravity on an accelerometer channel, with movement and noise
+        rng = np.random.default_rng(1)
+        t = np.arange(1000) / 833.0
+        cls.data = (0.5 + 0.3 * np.sin(2 * np.pi * 2.0 * t) +
+            0.05 * rng.standard_normal(len(t))).astype(np.float32)
+
+    def test_moving_average(self):
+        import numpy as np
+
+        for n in [1, 5, 32]:
+            state = []
+            r = [moving_average(val, [n], state) for val in self.data]
+            y = np.convolve(self.data.astype(np.float64), np.ones(n) / n)
+            np.testing.assert_allclose(r, y[:len(r)], atol=1e-5)
+
+    def test_moving_average_drift(self):
+        import numpy as np
+
+        # A large offset does not leave rounding errors in the running sum,
+        # the error is that of summing 32 floats once
+        d = (self.data + 1000.0).astype(np.float32)
+        state = []
+        for val in np.tile(d, 10):
+            r = moving_average(val, [32], state)
+        self.assertAlmostEqual(r, np.mean(d[-32:], dtype=np.float64),
+            delta=1e-3)
+
+    def test_moving_average_q15(self):
+        data = to_q15(self.data)
+        for n in [1, 4, 32]:
+            state = []
+            r = [moving_average_q15(val, [n], state) for val in data]
+            padded = [0] * (n - 1) + data
+            y = [(sum(padded[i:i+n]) + (n >> 1)) >> (n.bit_length() - 1)
+                for i in range(len(data))]
+            self.assertEqual(r, y)
+
+    def test_cic(self):
+        import numpy as np
+
+        # Identical to a cascade of moving averages, keeping every factor-th
+        # output
+        for order, factor in [(1, 4), (3, 4), (2, 8)]:
+            y = self.data.astype(np.float64)
+            for _ in range(order):
+                y = np.convolve(y, np.ones(factor) / factor)[:len(y)]
+            np.testing.assert_allclose(cic(self.data, order, factor),
+                y[::factor], atol=1e-5)
+
+    def test_cic_q15(self):
+        import numpy as np
+
+        data = to_q15(self.data)
+        for order, factor in [(1, 4), (3, 4), (2, 8), (4, 16)]:
+            y = list(data)
+            for _ in range(order):
+                y = list(np.convolve(y, np.ones(factor, dtype=np.int64))[
+                    :len(y)])
+            shift = order * (factor.bit_length() - 1)
+            y = [min(32767, max(-32768, (int(v) + ((1 << shift) >> 1)) >>
+                shift)) for v in y[::factor]]
+            self.assertEqual(cic_q15(data, order, factor), y)
+
+    def test_dc_blocker(self):
+        import numpy as np
+        from scipy import signal
+
+        alpha = 0.98
+        state = []
+        r = [dc_blocker(val, [alpha], state) for val in self.data]
+        y = signal.lfilter([1.0, -1.0], [1.0, -alpha], self.data)
+        np.testing.assert_allclose(r, y, atol=1e-4)
+
+    def test_dc_blocker_q15(self):
+        import numpy as np
+
+        # Close to the float version, without a DC offset after settling
+        alpha = to_q15([0.98])
+        data = to_q15(self.data)
+        state = []
+        r = np.array([dc_blocker_q15(val, alpha, state) for val in data])
+        state = []
+        y = np.array([dc_blocker(val / 32768, [alpha[0] / 32768], state) for
+            val in data]) * 32768
+        self.assertLess(np.max(np.abs(r - y)), 2.0)
+
+        state = []
+        r = [dc_blocker_q15(16384, alpha, state) for _ in range(2000)]
+        self.assertEqual(r[-100:], [0] * 100)
+
+    def test_median_filter(self):
+        import numpy as np
+
+        # Spikes of a single sample are removed
+        d = np.array(self.data)
+        d[100::50] += 10.0
+        state = []
+        r = [median_filter(val, [5], state) for val in d]
+        padded = np.concatenate([np.zeros(4, dtype=np.float32), d])
+        y = [np.median(padded[i:i+5]) for i in range(len(d))]
+        np.testing.assert_allclose(r, y, atol=1e-6)
+        self.assertLess(np.max(r), 2.0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -21,8 +21,15 @@ from os import makedirs
 from distutils.ccompiler import new_compiler
 from shutil import copyfile, rmtree
 
-# TODO The list of filter functions that are implemented in filters.c.
-FUNCTIONS_IN_C_FILE = ['fir']
+# TODO The list of filter functions that are implemented in filters.c and
+#      order_statistics.c.
+FUNCTIONS_IN_C_FILE = ['fir','fir_decimator_init','fir_decimate',
+    'fir_decimator_q15_init','fir_decimate_q15','fir_interpolator_init',
+    'fir_interpolate','fir_interpolator_q15_init','fir_interpolate_q15',
+    'moving_average_init','moving_average','moving_average_q15_init',
+    'moving_average_q15','cic_init','cic_decimate','cic_q15_init',
+    'cic_decimate_q15','dc_blocker_init','dc_blocker','dc_blocker_q15_init',
+    'dc_blocker_q15','median_filter_init','median_filter']
 
 # Set to False if you would like to examine the temporary files that are
 # created.
@@ -38,6 +45,15 @@ int main(void)
 }
 '''
 
+def library_filename():
+    """
+    Returns the path of the dll, which has a platform dependent name, for
+    example filters.dll on Windows and libfilters.so on Linux.
+    """
+    return new_compiler().library_filename(
+        'filters', lib_type='shared',
+        output_dir=cfg.PREPROCESSING_FILTERS_DIR_PATH)
+
 def main():
 
     PROJECT_DIR = join(cfg.PREPROCESSING_FILTERS_DIR_PATH, 'c2dll_project')
@@ -58,13 +74,15 @@ def main():
         join(PROJECT_DIR,'filters.h'))
     copyfile(join(FILTERS_SOURCE_DIR_PATH,'filters.c'),
         join(PROJECT_DIR,'filters.c'))
+    copyfile(join(FILTERS_SOURCE_DIR_PATH,'order_statistics.h'), 
+        join(PROJECT_DIR,'order_statistics.h'))
+    copyfile(join(FILTERS_SOURCE_DIR_PATH,'order_statistics.c'),
+        join(PROJECT_DIR,'order_statistics.c'))
 
     # Compile and link the project
     cc = new_compiler(force=1)
 
-    output_libname = cc.library_filename(
-        'filters', lib_type='shared', 
-        output_dir=cfg.PREPROCESSING_FILTERS_DIR_PATH)
+    output_libname = library_filename()
 
     if platform.startswith('win'):
         libraries = None
@@ -75,7 +93,8 @@ def main():
         cc_args = ["-std=c99"]
 
     objects = cc.compile(
-        sources=[join(PROJECT_DIR,'main.c'),join(PROJECT_DIR,'filters.c')],
+        sources=[join(PROJECT_DIR,'main.c'),join(PROJECT_DIR,'filters.c'),
+            join(PROJECT_DIR,'order_statistics.c')],
         extra_preargs=cc_args,
         output_dir=join(PROJECT_DIR,'build'))
 
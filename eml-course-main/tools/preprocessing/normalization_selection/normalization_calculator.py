@@ -19,12 +19,14 @@ from glob import glob
 import matplotlib.pyplot as plt
 from os.path import join
 import numpy as np
+from copy import deepcopy
 import normalization_functions as nf
 
 
 # TODO Set normalization function here
 NORMALIZATION_FUNCTIONS = [nf.rescale]
 #NORMALIZATION_FUNCTIONS = nf.rescale,nf.clip
+#NORMALIZATION_FUNCTIONS = [nf.online_zscore]
 
 ARGS = [
     [
@@ -37,6 +39,11 @@ ARGS = [
     #     [0],    # Min
     #     [1000]  # Max
     # ],
+    # [
+    #     # Online z-score
+    #     0.001, # Forgetting factor, 0 for none
+    #     []     # State, must be empty
+    # ],
 ]
 
 # TODO Set input file path for calculation normalizations
@@ -80,6 +87,9 @@ def main():
 
             # Loop all filter functions
             for f, arg in zip(NORMALIZATION_FUNCTIONS, ARGS): 
+                # Every attribute starts with its own copy of the arguments,
+                # because stateful functions keep their state in them
+                arg = deepcopy(arg)
                 r = []
                 for val in d:
                     r.append(f(val, arg[0], arg[1]))    
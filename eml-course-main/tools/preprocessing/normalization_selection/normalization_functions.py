@@ -17,15 +17,33 @@ import config as cfg
 import ctypes
 from os.path import join, isfile
 import normalization_functions_c2dll
+import unittest
 
-NORMALIZATIONS_DLL = join(cfg.PREPROCESSING_NORMALIZATIONS_DIR_PATH, 'normalizations.dll')
+NORMALIZATIONS_DLL = normalization_functions_c2dll.library_filename()
+
+class Welford(ctypes.Structure):
+    """
+    Running statistics of a single channel, see welford_t in normalizations.h
+    """
+    _fields_ = [('n', ctypes.c_float),
+                ('mean', ctypes.c_float),
+                ('variance', ctypes.c_float),
+                ('alpha', ctypes.c_float),
+                ('frozen', ctypes.c_bool)]
+
+class ZScore(ctypes.Structure):
+    """
+    Z-score normalization parameters, see zscore_t in normalizations.h
+    """
+    _fields_ = [('scale', ctypes.c_float),
+                ('offset', ctypes.c_float)]
 
 def check_normalizations_dll():
     """
     Create the feature functions dll as soon as needed
     """
     if not isfile(NORMALIZATIONS_DLL):
-        check_normalizations_dll.main()
+        normalization_functions_c2dll.main()
 
 def rescale(data, from_, to_):
     """
@@ -52,3 +70,163 @@ def clip(data, min, max):
     min_ = (ctypes.c_float * 1)(*min)
     max_ = (ctypes.c_float * 1)(*max)
     return c_lib.clip((ctypes.c_float)(data), ctypes.byref(min_), ctypes.byref(max_))
+
+def welford_init(alpha):
+    """
+    Python wrapper for the normalization calculation functions that are also
+    used on the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the initialized Welford structure.
+    """
+    check_normalizations_dll()
+    c_lib = ctypes.CDLL(NORMALIZATIONS_DLL)
+
+    w = Welford()
+    c_lib.welford_init(ctypes.byref(w), (ctypes.c_float)(alpha))
+    return w
+
+def welford_update(w, data):
+    """
+    Python wrapper for the normalization calculation functions that are also
+    used on the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_normalizations_dll()
+    c_lib = ctypes.CDLL(NORMALIZATIONS_DLL)
+
+    c_lib.welford_update(ctypes.byref(w), (ctypes.c_float)(data))
+
+def welford_freeze(w, freeze):
+    """
+    Python wrapper for the normalization calculation functions that are also
+    used on the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_normalizations_dll()
+    c_lib = ctypes.CDLL(NORMALIZATIONS_DLL)
+
+    c_lib.welford_freeze(ctypes.byref(w), (ctypes.c_bool)(freeze))
+
+def zscore_update(w):
+    """
+    Python wrapper for the normalization calculation functions that are also
+    used on the microcontroller. Refer to the C-source files for documentation.
+
+    Returns the ZScore structure computed from the Welford structure.
+    """
+    check_normalizations_dll()
+    c_lib = ctypes.CDLL(NORMALIZATIONS_DLL)
+
+    z = ZScore()
+    c_lib.zscore_update(ctypes.byref(z), ctypes.byref(w))
+    return z
+
+def zscore(data, z):
+    """
+    Python wrapper for the normalization calculation functions that are also
+    used on the microcontroller. Refer to the C-source files for documentation.
+    """
+    check_normalizations_dll()
+    c_lib = ctypes.CDLL(NORMALIZATIONS_DLL)
+
+    c_lib.zscore.restype = ctypes.c_float
+    return c_lib.zscore((ctypes.c_float)(data), ctypes.byref(z))
+
+def online_zscore(data, alpha, state):
+    """
+    Standardizes a sample with the running statistics of all previous samples,
+    as it would be done on the microcontroller.
+
+    The running statistics are stored in state, which must be an empty list
+    for the first sample of a channel.
+    """
+    if len(state) == 0:
+        state.append(welford_init(alpha))
+
+    welford_update(state[0], data)
+    return zscore(data, zscore_update(state[0]))
+
+
+class TestOnlineStandardization(unittest.TestCase):
+    """
+    Tests the running statistics on the captured data. Run with:
+
+        python normalization_functions.py
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        import numpy as np
+        from glob import glob
+        from custom_bunch import CustomBunch
+
+        filenames = sorted(glob(join(cfg.CAPTURED_DIR_PATH, '*testCPR*.csv')))
+        if len(filenames) == 0:
+            raise unittest.SkipTest('No captured CPR data')
+
+        bunch = CustomBunch.load_csv(filenames[0])
+        channels = [a for a in bunch.attributes if a.startswith('FP')]
+        cls.data = np.array([bunch.data[:, bunch.attributes.index(a)]
+                             for a in channels], dtype=np.float32)
+
+    def test_statistics(self):
+        import numpy as np
+
+        for d in self.data:
+            w = welford_init(0.0)
+            for val in d:
+                welford_update(w, val)
+
+            self.assertEqual(w.n, len(d))
+            self.assertAlmostEqual(w.mean, np.mean(d, dtype=np.float64),
+                delta=1e-4 * max(1.0, abs(np.mean(d))))
+            self.assertAlmostEqual(w.variance, np.var(d, dtype=np.float64),
+                delta=1e-3 * max(1.0, np.var(d)))
+
+    def test_standardization(self):
+        import numpy as np
+
+        # Channels with a different range end up in the same range
+        for d in self.data:
+            w = welford_init(0.0)
+            for val in d:
+                welford_update(w, val)
+            z = zscore_update(w)
+            r = np.array([zscore(val, z) for val in d])
+
+            self.assertAlmostEqual(np.mean(r), 0.0, delta=1e-3)
+            if np.var(d) > 0:
+                self.assertAlmostEqual(np.std(r), 1.0, delta=1e-3)
+
+    def test_forgetting(self):
+        # After an offset step, forgetting tracks the new mean
+        d = self.data[0]
+        step = d + 1000.0
+        w = welford_init(0.05)
+        for val in list(d) + list(step):
+            welford_update(w, val)
+        self.assertLess(w.n, 21.0)
+        self.assertAlmostEqual(w.mean, step[-100:].mean(),
+            delta=5.0 * step[-100:].std() + 1.0)
+
+    def test_freeze(self):
+        w = welford_init(0.0)
+        for val in self.data[0]:
+            welford_update(w, val)
+        mean, variance = w.mean, w.variance
+
+        welford_freeze(w, True)
+        welford_update(w, 1e6)
+        self.assertEqual((w.mean, w.variance), (mean, variance))
+
+        welford_freeze(w, False)
+        welford_update(w, 1e6)
+        self.assertNotEqual(w.mean, mean)
+
+    def test_online_zscore(self):
+        state = []
+        r = [online_zscore(val, 0.0, state) for val in self.data[0]]
+        self.assertEqual(len(state), 1)
+        self.assertEqual(len(r), len(self.data[0]))
+
+
+if __name__ == "__main__":
+    unittest.main()
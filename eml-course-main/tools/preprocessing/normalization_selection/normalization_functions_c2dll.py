@@ -23,7 +23,8 @@ from shutil import copyfile, rmtree
 
 # TODO The list of normalization functions that are implemented in 
 #      normalizations.c.
-FUNCTIONS_IN_C_FILE = ['rescale','clip']
+FUNCTIONS_IN_C_FILE = ['rescale','clip','welford_init','welford_update',
+    'welford_freeze','zscore_update','zscore']
 
 # Set to False if you would like to examine the temporary files that are
 # created.
@@ -39,6 +40,15 @@ int main(void)
 }
 '''
 
+def library_filename():
+    """
+    Returns the path of the dll, which has a platform dependent name, for
+    example normalizations.dll on Windows and libnormalizations.so on Linux.
+    """
+    return new_compiler().library_filename(
+        'normalizations', lib_type='shared',
+        output_dir=cfg.PREPROCESSING_NORMALIZATIONS_DIR_PATH)
+
 def main():
 
     PROJECT_DIR = join(cfg.PREPROCESSING_NORMALIZATIONS_DIR_PATH, 'c2dll_project')
@@ -63,9 +73,7 @@ def main():
     # Compile and link the project
     cc = new_compiler(force=1)
 
-    output_libname = cc.library_filename(
-        'normalizations', lib_type='shared', 
-        output_dir=cfg.PREPROCESSING_NORMALIZATIONS_DIR_PATH)
+    output_libname = library_filename()
 
     if platform.startswith('win'):
         libraries = None